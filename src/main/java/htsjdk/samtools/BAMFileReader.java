@@ -415,8 +415,12 @@ public class BAMFileReader extends SamReader.ReaderImplementation {
                 mIndex = mEnableIndexCaching ? new CachingBAMFileIndex(mIndexStream, getFileHeader().getSequenceDictionary())
                         : new DiskBasedBAMFileIndex(mIndexStream, getFileHeader().getSequenceDictionary());
             } else if (samIndex.equals(SamIndexes.BAI)) {
+                if (IndexCache.isEnabled()) {
+                    mIndex = SharedBAMFileIndex.getCachedIndex(mIndexFile, getFileHeader().getSequenceDictionary());
+                } else {
                     mIndex = mEnableIndexCaching ? new CachingBAMFileIndex(mIndexFile, getFileHeader().getSequenceDictionary(), mEnableIndexMemoryMapping)
                             : new DiskBasedBAMFileIndex(mIndexFile, getFileHeader().getSequenceDictionary(), mEnableIndexMemoryMapping);
+                }
             } else if (samIndex.equals(SamIndexes.CSI)) {
                     mIndex = new CSIIndex(mIndexFile, mEnableIndexMemoryMapping, getFileHeader().getSequenceDictionary());
             } else {
@@ -88,6 +88,12 @@ public class BAMRecord extends SAMRecord {
      */
     private boolean mBinaryDataStale;
 
+    /**
+     * Tag translation that has not yet been applied to the tags in mRestOfBinaryData.  It is applied
+     * when the attributes are decoded or the binary block is written, whichever happens first.
+     */
+    private StringTagRemapping mTagRemapping = null;
+
     /**
      * Create a new BAM Record. If the reference sequence index or mate reference sequence index are any value other
      * than NO_ALIGNMENT_REFERENCE_INDEX (-1), then the specified index values must exist in the sequence dictionary
@@ -155,6 +161,7 @@ public class BAMRecord extends SAMRecord {
         if (mBinaryDataStale) {
             return null;
         }
+        applyTagRemapping();
         // This may have been set to null by eagerDecode()
         return mRestOfBinaryData;
     }
@@ -170,10 +177,37 @@ public class BAMRecord extends SAMRecord {
         if (mBinaryDataStale || mRestOfBinaryData == null) {
             return -1;
         }
+        applyTagRemapping();
         final int tagsOffset = readNameSize() + cigarSize() + basesSize() + qualsSize();
         return mRestOfBinaryData.length - tagsOffset;
     }
 
+    /**
+     * Arranges for the values of string tags to be translated without decoding the attributes now.  The
+     * translation is applied to the binary block on first access to the attributes or when the record is
+     * written, so the binary block stays usable for writing.
+     *
+     * @return false if the attributes have already been decoded (or the binary block discarded), in which
+     * case nothing is done and the caller must set the attributes itself.
+     */
+    boolean setTagRemapping(final StringTagRemapping remapping) {
+        if (mAttributesDecoded || mRestOfBinaryData == null) {
+            return false;
+        }
+        applyTagRemapping();
+        mTagRemapping = remapping;
+        return true;
+    }
+
+    private void applyTagRemapping() {
+        if (mTagRemapping != null) {
+            final StringTagRemapping remapping = mTagRemapping;
+            mTagRemapping = null;
+            final int tagsOffset = readNameSize() + cigarSize() + basesSize() + qualsSize();
+            mRestOfBinaryData = remapping.remap(mRestOfBinaryData, tagsOffset);
+        }
+    }
+
     @Override
     public void setReadName(final String value) {
         super.setReadName(value);
@@ -231,6 +265,7 @@ public class BAMRecord extends SAMRecord {
         }
         mAttributesDecoded = true;
         mBinaryDataStale = true;
+        mTagRemapping = null;
         super.clearAttributes();
     }
 
@@ -287,6 +322,37 @@ public class BAMRecord extends SAMRecord {
         return super.getCigar();
     }
 
+    /**
+     * Avoids decoding the cigar to compute the bin of a record whose cigar is unchanged from the binary block.
+     */
+    @Override
+    int computeIndexingBin() {
+        if (mRestOfBinaryData == null || mCigarDecoded) {
+            return super.computeIndexingBin();
+        }
+        final int alignmentEnd = getReadUnmappedFlag() ?
+                NO_ALIGNMENT_START :
+                getAlignmentStart() + binaryCigarReferenceLength() - 1;
+        return computeIndexingBin(getAlignmentStart(), alignmentEnd);
+    }
+
+    /**
+     * Sums the lengths of the reference-consuming operators of the encoded cigar.  A sentinel cigar has the same
+     * reference length as the long cigar it stands for, so there is no need to look at the CG tag.
+     */
+    private int binaryCigarReferenceLength() {
+        final ByteBuffer byteBuffer = ByteBuffer.wrap(mRestOfBinaryData, readNameSize(), cigarSize());
+        byteBuffer.order(ByteOrder.LITTLE_ENDIAN);
+        int referenceLength = 0;
+        for (int i = 0; i < mCigarLength; i++) {
+            final int cigarette = byteBuffer.getInt();
+            if (CigarOperator.binaryToEnum(cigarette & 0xf).consumesReferenceBases()) {
+                referenceLength += cigarette >>> 4;
+            }
+        }
+        return referenceLength;
+    }
+
     /**
      * Checks to see if the provided Cigar could be considered the "sentinel cigar" that indicates
      * that the actual cigar is too long for the BAM spec and should be taken from the CG tag. This
@@ -407,6 +473,7 @@ public class BAMRecord extends SAMRecord {
         }
 
         mAttributesDecoded = true;
+        applyTagRemapping();
         final int tagsOffset = readNameSize() + cigarSize() + basesSize() + qualsSize();
         final int tagsSize = mRestOfBinaryData.length - tagsOffset;
         final SAMBinaryTagAndValue attributes = BinaryTagCodec.readTags(mRestOfBinaryData, tagsOffset, tagsSize, getValidationStringency());
@@ -104,6 +104,16 @@ public class BAMRecordCodec implements SortingCollection.Codec<SAMRecord> {
      */
     @Override
     public void encode(final SAMRecord alignment) {
+        final byte[] unchangedBinaryBlock = alignment.getVariableBinaryRepresentation();
+        if (unchangedBinaryBlock != null) {
+            // The variable-length block is unchanged from when the record was read from a BAM file, so it can be
+            // copied as-is, and the cigar length stored with it is still valid.  Nothing needs to be decoded.
+            writeFixedLengthFields(alignment, BAMFileConstants.FIXED_BLOCK_SIZE + unchangedBinaryBlock.length,
+                    alignment.getCigarLength());
+            this.binaryCodec.writeBytes(unchangedBinaryBlock);
+            return;
+        }
+
         // Compute block size, as it is the first element of the file representation of SAMRecord
         final int readLength = alignment.getReadLength();
 
@@ -138,6 +148,48 @@ public class BAMRecordCodec implements SortingCollection.Codec<SAMRecord> {
             }
         }
 
+        // Blurt out the elements
+        writeFixedLengthFields(alignment, blockSize, cigarToWrite.numCigarElements());
+        if (alignment.getReadLength() != alignment.getBaseQualities().length &&
+                alignment.getBaseQualities().length != 0) {
+            throw new RuntimeException("Mismatch between read length and quals length writing read " +
+                    alignment.getReadName() + "; read length: " + alignment.getReadLength() +
+                    "; quals length: " + alignment.getBaseQualities().length);
+        }
+        this.binaryCodec.writeString(alignment.getReadName(), false, true);
+        final int[] binaryCigar = BinaryCigarCodec.encode(cigarToWrite);
+        for (final int cigarElement : binaryCigar) {
+            // Assumption that this will fit into an integer, despite the fact
+            // that it is spec'ed as a uint.
+            this.binaryCodec.writeInt(cigarElement);
+        }
+        try {
+            this.binaryCodec.writeBytes(SAMUtils.bytesToCompressedBases(alignment.getReadBases()));
+        } catch (final IllegalArgumentException ex) {
+            final String msg = ex.getMessage() + " in read: " + alignment.getReadName();
+            throw new IllegalStateException(msg, ex);
+        }
+        byte[] qualities = alignment.getBaseQualities();
+        if (qualities.length == 0) {
+            qualities = new byte[alignment.getReadLength()];
+            Arrays.fill(qualities, (byte) 0xFF);
+        }
+        this.binaryCodec.writeBytes(qualities);
+        SAMBinaryTagAndValue attribute = alignment.getBinaryAttributes();
+        while (attribute != null) {
+            this.binaryTagCodec.writeTag(attribute.tag, attribute.value, attribute.isUnsignedArray());
+            attribute = attribute.getNext();
+        }
+
+        if (cigarSwitcharoo) {
+            alignment.setAttribute(CG.name(), null);
+        }
+    }
+
+    /**
+     * Writes the fixed-length part of the record, computing the indexing bin from the alignment start and end.
+     */
+    private void writeFixedLengthFields(final SAMRecord alignment, final int blockSize, final int numCigarElements) {
         // shouldn't interact with the long-cigar above since the Sentinel Cigar has the same referenceLength as
         // the actual cigar.
         int indexBin = 0;
@@ -147,7 +199,6 @@ public class BAMRecordCodec implements SortingCollection.Codec<SAMRecord> {
             }
         }
 
-        // Blurt out the elements
         this.binaryCodec.writeInt(blockSize);
         this.binaryCodec.writeInt(alignment.getReferenceIndex());
         // 0-based!!
@@ -155,53 +206,12 @@ public class BAMRecordCodec implements SortingCollection.Codec<SAMRecord> {
         this.binaryCodec.writeUByte((short) (alignment.getReadNameLength() + 1));
         this.binaryCodec.writeUByte((short) alignment.getMappingQuality());
         this.binaryCodec.writeUShort(indexBin);
-        this.binaryCodec.writeUShort(cigarToWrite.numCigarElements());
+        this.binaryCodec.writeUShort(numCigarElements);
         this.binaryCodec.writeUShort(alignment.getFlags());
         this.binaryCodec.writeInt(alignment.getReadLength());
         this.binaryCodec.writeInt(alignment.getMateReferenceIndex());
         this.binaryCodec.writeInt(alignment.getMateAlignmentStart() - 1);
         this.binaryCodec.writeInt(alignment.getInferredInsertSize());
-        final byte[] variableLengthBinaryBlock = alignment.getVariableBinaryRepresentation();
-        if (variableLengthBinaryBlock != null) {
-            // Don't need to encode variable-length block, because it is unchanged from
-            // when the record was read from a BAM file.
-            this.binaryCodec.writeBytes(variableLengthBinaryBlock);
-        } else {
-            if (alignment.getReadLength() != alignment.getBaseQualities().length &&
-                    alignment.getBaseQualities().length != 0) {
-                throw new RuntimeException("Mismatch between read length and quals length writing read " +
-                        alignment.getReadName() + "; read length: " + alignment.getReadLength() +
-                        "; quals length: " + alignment.getBaseQualities().length);
-            }
-            this.binaryCodec.writeString(alignment.getReadName(), false, true);
-            final int[] binaryCigar = BinaryCigarCodec.encode(cigarToWrite);
-            for (final int cigarElement : binaryCigar) {
-                // Assumption that this will fit into an integer, despite the fact
-                // that it is spec'ed as a uint.
-                this.binaryCodec.writeInt(cigarElement);
-            }
-            try {
-                this.binaryCodec.writeBytes(SAMUtils.bytesToCompressedBases(alignment.getReadBases()));
-            } catch (final IllegalArgumentException ex) {
-                final String msg = ex.getMessage() + " in read: " + alignment.getReadName();
-                throw new IllegalStateException(msg, ex);
-            }
-            byte[] qualities = alignment.getBaseQualities();
-            if (qualities.length == 0) {
-                qualities = new byte[alignment.getReadLength()];
-                Arrays.fill(qualities, (byte) 0xFF);
-            }
-            this.binaryCodec.writeBytes(qualities);
-            SAMBinaryTagAndValue attribute = alignment.getBinaryAttributes();
-            while (attribute != null) {
-                this.binaryTagCodec.writeTag(attribute.tag, attribute.value, attribute.isUnsignedArray());
-                attribute = attribute.getNext();
-            }
-        }
-
-        if (cigarSwitcharoo) {
-            alignment.setAttribute(CG.name(), null);
-        }
     }
 
     /**
@@ -190,7 +190,9 @@ public class CRAMFileReader extends SamReader.ReaderImplementation implements Sa
         this.cramFile = cramFile;
         this.referenceSource = referenceSource;
         this.mIndexFile = findIndexForFile(indexFile, cramFile);
-        final SeekableFileStream indexStream = this.mIndexFile == null ? null : new SeekableFileStream(this.mIndexFile);
+        // when the index cache is enabled getIndex() looks up the shared index on first use instead, detecting
+        // BAI or CRAI from the file content just as initWithStreams() does
+        final SeekableFileStream indexStream = this.mIndexFile == null || IndexCache.isEnabled() ? null : new SeekableFileStream(this.mIndexFile);
         initWithStreams(new BufferedInputStream(new FileInputStream(cramFile)), indexStream, validationStringency);
     }
 
@@ -252,6 +254,11 @@ public class CRAMFileReader extends SamReader.ReaderImplementation implements Sa
         }
         if (mIndex == null) {
             final SAMSequenceDictionary dictionary = getFileHeader().getSequenceDictionary();
+            if (IndexCache.isEnabled()) {
+                // like the index stream passed by the constructor, the shared index is recognised by its content
+                mIndex = SharedBAMFileIndex.getCachedIndex(mIndexFile, dictionary);
+                return mIndex;
+            }
             if (mIndexFile.getName().endsWith(FileExtensions.BAI_INDEX)) {
                 mIndex = mEnableIndexCaching ?
                         new CachingBAMFileIndex(mIndexFile, dictionary, mEnableIndexMemoryMapping) :
@@ -0,0 +1,482 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.samtools;
+
+import htsjdk.samtools.util.CloseableIterator;
+import htsjdk.samtools.util.CloserUtil;
+import htsjdk.samtools.util.FileAppendStreamLRUCache;
+import htsjdk.samtools.util.IOUtil;
+import htsjdk.samtools.util.StringUtil;
+
+import java.io.BufferedInputStream;
+import java.io.DataInputStream;
+import java.io.File;
+import java.io.FileInputStream;
+import java.io.IOException;
+import java.io.OutputStream;
+import java.util.AbstractMap;
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.HashSet;
+import java.util.Iterator;
+import java.util.Map;
+import java.util.NoSuchElementException;
+import java.util.Set;
+
+/**
+ * A {@link CoordinateSortedPairInfoMap} specialized for read names and fixed-width records of longs, for holding
+ * mate information while processing a coordinate sorted file with a small and predictable memory footprint.
+ *
+ * As with CoordinateSortedPairInfoMap, the records for one reference sequence are held in RAM and the records for
+ * other sequences are appended to temporary files, and reads must be processed in reference sequence order.  Unlike it,
+ * no objects are kept per record: the records in RAM are in an open-addressing hash table of flat arrays, keyed by a
+ * 64-bit hash of the read name, with the names themselves packed into one byte array so that colliding hashes are
+ * resolved exactly.  On disk each record is the name followed by the longs, so no codec is needed.
+ */
+public class CoordinateSortedPackedPairInfoMap implements Iterable<Map.Entry<String, long[]>> {
+    // -1 is a valid sequence index in this case
+    private static final int INVALID_SEQUENCE_INDEX = -2;
+    /** Read names are at most 254 characters, so their lengths are stored in two bytes */
+    private static final int MAX_NAME_LENGTH = 0xFFFF;
+
+    /**
+     * directory where files will go
+     */
+    private final File workDir = IOUtil.createTempDir("CSPPI.", null);
+    private final int recordWidth;
+    private int sequenceIndexOfMapInRam = INVALID_SEQUENCE_INDEX;
+    private final PackedTable mapInRam;
+    private final FileAppendStreamLRUCache outputStreams;
+    // Key is reference index (which is in the range [-1 .. max sequence index].
+    // Value is the number of records on disk for this index.
+    private final Map<Integer, Integer> sizeOfMapOnDisk = new HashMap<>();
+    /** Reused to encode records for files */
+    private byte[] encodeBuffer;
+
+    // No other methods may be called when iteration is in progress, because iteration depends on and changes
+    // internal state.
+    private boolean iterationInProgress = false;
+
+    /**
+     * @param maxOpenFiles the maximum number of temporary files open for appending at once
+     * @param recordWidth the number of longs in each record
+     */
+    public CoordinateSortedPackedPairInfoMap(final int maxOpenFiles, final int recordWidth) {
+        if (recordWidth <= 0) throw new IllegalArgumentException("recordWidth must be positive");
+        this.recordWidth = recordWidth;
+        this.mapInRam = new PackedTable(recordWidth);
+        this.encodeBuffer = new byte[2 + 64 + 8 * recordWidth];
+        workDir.deleteOnExit();
+        outputStreams = new FileAppendStreamLRUCache(maxOpenFiles);
+    }
+
+    /**
+     * @param record filled in with the record corresponding to the given sequenceIndex and key, if it is present
+     * @return true if the record was present, and has been removed
+     */
+    public boolean remove(final int sequenceIndex, final String key, final long[] record) {
+        if (iterationInProgress) throw new IllegalStateException("Cannot be called when iteration is in progress");
+        ensureSequenceLoaded(sequenceIndex);
+        final byte[] name = StringUtil.stringToBytes(key);
+        final int slot = mapInRam.find(name, 0, name.length, PackedTable.hash(name, 0, name.length));
+        if (slot < 0) {
+            return false;
+        }
+        mapInRam.getRecord(slot, record, 0);
+        mapInRam.removeAt(slot);
+        return true;
+    }
+
+    /**
+     * Store the record with the given sequence index and key.  It is assumed that value did not previously exist
+     * in the map, and an exception is thrown (possibly at a later time) if that is not the case.
+     */
+    public void put(final int sequenceIndex, final String key, final long[] record) {
+        if (iterationInProgress) throw new IllegalStateException("Cannot be called when iteration is in progress");
+        if (record.length != recordWidth) throw new IllegalArgumentException("Record has " + record.length + " longs, not " + recordWidth);
+        final byte[] name = StringUtil.stringToBytes(key);
+        if (name.length > MAX_NAME_LENGTH) throw new IllegalArgumentException("Read name is too long: " + key);
+        if (sequenceIndex == sequenceIndexOfMapInRam) {
+            final long hash = PackedTable.hash(name, 0, name.length);
+            if (mapInRam.find(name, 0, name.length, hash) >= 0)
+                throw new IllegalArgumentException("Putting value into PairInfoMap that already existed. " +
+                        sequenceIndex + ": " + key);
+            mapInRam.add(name, 0, name.length, hash, record, 0);
+        } else {
+            // Append to file
+            final int length = encode(name, 0, name.length, record, 0);
+            writeToSequenceFile(sequenceIndex, length);
+            final Integer prevCount = sizeOfMapOnDisk.get(sequenceIndex);
+            sizeOfMapOnDisk.put(sequenceIndex, prevCount == null ? 1 : prevCount + 1);
+        }
+    }
+
+    /** Encodes a record into encodeBuffer, as a 2-byte name length, the name and the big-endian longs */
+    private int encode(final byte[] names, final int nameOffset, final int nameLength, final long[] records, final int recordOffset) {
+        final int length = 2 + nameLength + 8 * recordWidth;
+        if (encodeBuffer.length < length) {
+            encodeBuffer = new byte[length];
+        }
+        encodeBuffer[0] = (byte) (nameLength >>> 8);
+        encodeBuffer[1] = (byte) nameLength;
+        System.arraycopy(names, nameOffset, encodeBuffer, 2, nameLength);
+        int pos = 2 + nameLength;
+        for (int i = 0; i < recordWidth; i++) {
+            final long value = records[recordOffset + i];
+            for (int shift = 56; shift >= 0; shift -= 8) {
+                encodeBuffer[pos++] = (byte) (value >>> shift);
+            }
+        }
+        return length;
+    }
+
+    private void writeToSequenceFile(final int sequenceIndex, final int length) {
+        try {
+            outputStreams.get(makeFileForSequence(sequenceIndex)).write(encodeBuffer, 0, length);
+        } catch (final IOException e) {
+            throw new SAMException("Error spilling PairInfo to disk", e);
+        }
+    }
+
+    private void ensureSequenceLoaded(final int sequenceIndex) {
+        if (sequenceIndexOfMapInRam == sequenceIndex) {
+            return;
+        }
+
+        // Spill map in RAM to disk
+        if (sequenceIndexOfMapInRam != INVALID_SEQUENCE_INDEX) {
+            final File spillFile = makeFileForSequence(sequenceIndexOfMapInRam);
+            if (spillFile.exists()) throw new IllegalStateException(spillFile + " should not exist.");
+            if (mapInRam.size() > 0) {
+                // Do not create file or entry in sizeOfMapOnDisk if there is nothing to write.
+                for (int slot = mapInRam.nextSlot(0); slot >= 0; slot = mapInRam.nextSlot(slot + 1)) {
+                    final int length = encode(mapInRam.names, mapInRam.nameOffsets[slot], mapInRam.nameLengths[slot],
+                            mapInRam.records, slot * recordWidth);
+                    writeToSequenceFile(sequenceIndexOfMapInRam, length);
+                }
+                sizeOfMapOnDisk.put(sequenceIndexOfMapInRam, mapInRam.size());
+                mapInRam.clear();
+            }
+        }
+
+        sequenceIndexOfMapInRam = sequenceIndex;
+
+        // Load map from disk if it existed
+        final File mapOnDisk = makeFileForSequence(sequenceIndex);
+        if (outputStreams.containsKey(mapOnDisk)) {
+            try {
+                outputStreams.remove(mapOnDisk).close();
+            } catch (final IOException e) {
+                throw new SAMException("Error closing " + mapOnDisk, e);
+            }
+        }
+        final Integer numRecords = sizeOfMapOnDisk.remove(sequenceIndex);
+        if (mapOnDisk.exists()) {
+            if (numRecords == null)
+                throw new IllegalStateException("null numRecords for " + mapOnDisk);
+            DataInputStream in = null;
+            try {
+                in = new DataInputStream(new BufferedInputStream(new FileInputStream(mapOnDisk)));
+                final byte[] name = new byte[MAX_NAME_LENGTH];
+                final long[] record = new long[recordWidth];
+                for (int i = 0; i < numRecords; ++i) {
+                    final int nameLength = in.readUnsignedShort();
+                    in.readFully(name, 0, nameLength);
+                    for (int j = 0; j < recordWidth; j++) {
+                        record[j] = in.readLong();
+                    }
+                    final long hash = PackedTable.hash(name, 0, nameLength);
+                    if (mapInRam.find(name, 0, nameLength, hash) >= 0)
+                        throw new SAMException("Value was put into PairInfoMap more than once.  " +
+                                sequenceIndex + ": " + StringUtil.bytesToString(name, 0, nameLength));
+                    mapInRam.add(name, 0, nameLength, hash, record, 0);
+                }
+            } catch (final IOException e) {
+                throw new SAMException("Error loading new map from disk.", e);
+            } finally {
+                CloserUtil.close(in);
+            }
+            IOUtil.deleteFiles(mapOnDisk);
+        } else if (numRecords != null && numRecords > 0)
+            throw new IllegalStateException("Non-zero numRecords but " + mapOnDisk + " does not exist");
+    }
+
+    private File makeFileForSequence(final int index) {
+        final File file = new File(workDir, index + ".tmp");
+        file.deleteOnExit();
+        return file;
+    }
+
+    public int size() {
+        int total = sizeInRam();
+        for (final Integer mapSize : sizeOfMapOnDisk.values()) {
+            if (mapSize != null) {
+                total += mapSize;
+            }
+        }
+        return total;
+    }
+
+    /**
+     * @return number of elements stored in RAM.  Always <= size()
+     */
+    public int sizeInRam() {
+        return mapInRam.size();
+    }
+
+    /**
+     * Creates an iterator over all elements in map, in arbitrary order.  Elements may not be added
+     * or removed from map when iteration is in progress, nor may a second iteration be started.
+     * Iterator must be closed in order to allow normal access to the map.  Unlike the other methods, this allocates
+     * an entry per record, as it is meant for the few records left unpaired at the end.
+     */
+    @Override
+    public CloseableIterator<Map.Entry<String, long[]>> iterator() {
+        if (iterationInProgress) throw new IllegalStateException("Cannot be called when iteration is in progress");
+        iterationInProgress = true;
+        return new MapIterator();
+    }
+
+    private class MapIterator implements CloseableIterator<Map.Entry<String, long[]>> {
+        private boolean closed = false;
+        private final Iterator<Integer> referenceIndexIterator;
+        private int nextSlot = -1;
+
+        private MapIterator() {
+            final Set<Integer> referenceIndices = new HashSet<>(sizeOfMapOnDisk.keySet());
+            if (sequenceIndexOfMapInRam != INVALID_SEQUENCE_INDEX)
+                referenceIndices.add(sequenceIndexOfMapInRam);
+            referenceIndexIterator = referenceIndices.iterator();
+            advanceToNextNonEmptyReferenceIndex();
+        }
+
+        private void advanceToNextNonEmptyReferenceIndex() {
+            while (referenceIndexIterator.hasNext()) {
+                ensureSequenceLoaded(referenceIndexIterator.next());
+                if (mapInRam.size() > 0) {
+                    nextSlot = mapInRam.nextSlot(0);
+                    return;
+                }
+            }
+            // no more.
+            nextSlot = -1;
+        }
+
+        @Override
+        public void close() {
+            closed = true;
+            iterationInProgress = false;
+        }
+
+        @Override
+        public boolean hasNext() {
+            if (closed) throw new IllegalStateException("Iterator has been closed");
+            return nextSlot >= 0;
+        }
+
+        @Override
+        public Map.Entry<String, long[]> next() {
+            if (!hasNext()) throw new NoSuchElementException();
+            final String name = StringUtil.bytesToString(mapInRam.names, mapInRam.nameOffsets[nextSlot], mapInRam.nameLengths[nextSlot]);
+            final long[] record = new long[recordWidth];
+            mapInRam.getRecord(nextSlot, record, 0);
+            nextSlot = mapInRam.nextSlot(nextSlot + 1);
+            if (nextSlot < 0) advanceToNextNonEmptyReferenceIndex();
+            return new AbstractMap.SimpleImmutableEntry<>(name, record);
+        }
+
+        @Override
+        public void remove() {
+            throw new UnsupportedOperationException();
+        }
+    }
+
+    /**
+     * Open-addressing hash table with linear probing, in which all state is held in primitive arrays.  A hash of 0
+     * marks an empty slot.  Names of removed entries are left in the name pool until it is compacted.
+     */
+    private static final class PackedTable {
+        private static final int INITIAL_CAPACITY = 1024;
+
+        private final int recordWidth;
+        private int size = 0;
+        private long[] hashes = new long[INITIAL_CAPACITY];
+        private int[] nameOffsets = new int[INITIAL_CAPACITY];
+        private int[] nameLengths = new int[INITIAL_CAPACITY];
+        private long[] records;
+        private byte[] names = new byte[INITIAL_CAPACITY * 32];
+        private int namesUsed = 0;
+        private int namesGarbage = 0;
+
+        PackedTable(final int recordWidth) {
+            this.recordWidth = recordWidth;
+            this.records = new long[INITIAL_CAPACITY * recordWidth];
+        }
+
+        /** 64-bit FNV-1a hash of the name, never 0 */
+        static long hash(final byte[] name, final int offset, final int length) {
+            long h = 0xcbf29ce484222325L;
+            for (int i = offset; i < offset + length; i++) {
+                h ^= name[i] & 0xFF;
+                h *= 0x100000001b3L;
+            }
+            return h == 0 ? 1 : h;
+        }
+
+        private int home(final long hash) {
+            // FNV mixes the high bits better than the low ones
+            return (int) (hash ^ (hash >>> 32)) & (hashes.length - 1);
+        }
+
+        int size() {
+            return size;
+        }
+
+        /** @return the slot holding the name, or -1 */
+        int find(final byte[] name, final int offset, final int length, final long hash) {
+            final int mask = hashes.length - 1;
+            for (int slot = home(hash); hashes[slot] != 0; slot = (slot + 1) & mask) {
+                if (hashes[slot] == hash && nameLengths[slot] == length && namesEqual(slot, name, offset, length)) {
+                    return slot;
+                }
+            }
+            return -1;
+        }
+
+        private boolean namesEqual(final int slot, final byte[] name, final int offset, final int length) {
+            final int start = nameOffsets[slot];
+            for (int i = 0; i < length; i++) {
+                if (names[start + i] != name[offset + i]) return false;
+            }
+            return true;
+        }
+
+        /** Adds an entry for a name that is not present */
+        void add(final byte[] name, final int offset, final int length, final long hash, final long[] record, final int recordOffset) {
+            if ((size + 1) * 4L > hashes.length * 3L) {
+                rehash(hashes.length * 2);
+            }
+            if (namesUsed + length > names.length) {
+                if (namesGarbage > namesUsed / 2) {
+                    compactNames();
+                }
+                if (namesUsed + length > names.length) {
+                    final long grown = Math.max((long) names.length * 2, (long) namesUsed + length);
+                    if (grown > Integer.MAX_VALUE - 8) throw new SAMException("Too many read names to hold in RAM");
+                    names = Arrays.copyOf(names, (int) grown);
+                }
+            }
+            final int mask = hashes.length - 1;
+            int slot = home(hash);
+            while (hashes[slot] != 0) {
+                slot = (slot + 1) & mask;
+            }
+            hashes[slot] = hash;
+            nameOffsets[slot] = namesUsed;
+            nameLengths[slot] = length;
+            System.arraycopy(name, offset, names, namesUsed, length);
+            namesUsed += length;
+            System.arraycopy(record, recordOffset, records, slot * recordWidth, recordWidth);
+            size++;
+        }
+
+        void getRecord(final int slot, final long[] record, final int recordOffset) {
+            System.arraycopy(records, slot * recordWidth, record, recordOffset, recordWidth);
+        }
+
+        /** Removes the entry in the slot, shifting back any later entries of its probe sequence */
+        void removeAt(final int slot) {
+            final int mask = hashes.length - 1;
+            namesGarbage += nameLengths[slot];
+            int hole = slot;
+            for (int i = (slot + 1) & mask; hashes[i] != 0; i = (i + 1) & mask) {
+                final int home = home(hashes[i]);
+                // the entry can fill the hole unless its home is cyclically in (hole, i]
+                final boolean homeAfterHole = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+                if (!homeAfterHole) {
+                    hashes[hole] = hashes[i];
+                    nameOffsets[hole] = nameOffsets[i];
+                    nameLengths[hole] = nameLengths[i];
+                    System.arraycopy(records, i * recordWidth, records, hole * recordWidth, recordWidth);
+                    hole = i;
+                }
+            }
+            hashes[hole] = 0;
+            size--;
+        }
+
+        /** @return the first occupied slot at or after from, or -1 */
+        int nextSlot(final int from) {
+            for (int slot = from; slot < hashes.length; slot++) {
+                if (hashes[slot] != 0) return slot;
+            }
+            return -1;
+        }
+
+        void clear() {
+            Arrays.fill(hashes, 0);
+            size = 0;
+            namesUsed = 0;
+            namesGarbage = 0;
+        }
+
+        private void rehash(final int capacity) {
+            final long[] oldHashes = hashes;
+            final int[] oldNameOffsets = nameOffsets;
+            final int[] oldNameLengths = nameLengths;
+            final long[] oldRecords = records;
+            hashes = new long[capacity];
+            nameOffsets = new int[capacity];
+            nameLengths = new int[capacity];
+            records = new long[capacity * recordWidth];
+            final int mask = capacity - 1;
+            for (int i = 0; i < oldHashes.length; i++) {
+                if (oldHashes[i] != 0) {
+                    int slot = home(oldHashes[i]);
+                    while (hashes[slot] != 0) {
+                        slot = (slot + 1) & mask;
+                    }
+                    hashes[slot] = oldHashes[i];
+                    nameOffsets[slot] = oldNameOffsets[i];
+                    nameLengths[slot] = oldNameLengths[i];
+                    System.arraycopy(oldRecords, i * recordWidth, records, slot * recordWidth, recordWidth);
+                }
+            }
+        }
+
+        /** Copies the names of the entries present to the start of the name pool, dropping those of removed ones */
+        private void compactNames() {
+            final byte[] compacted = new byte[names.length];
+            int used = 0;
+            for (int slot = nextSlot(0); slot >= 0; slot = nextSlot(slot + 1)) {
+                System.arraycopy(names, nameOffsets[slot], compacted, used, nameLengths[slot]);
+                nameOffsets[slot] = used;
+                used += nameLengths[slot];
+            }
+            names = compacted;
+            namesUsed = used;
+            namesGarbage = 0;
+        }
+    }
+}
@@ -38,6 +38,16 @@ public class Defaults {
      */
     public static final boolean USE_ASYNC_IO_WRITE_FOR_TRIBBLE;
 
+    /** Should tribble indices (.idx) opened by feature readers be memory mapped and decoded one chromosome at a time
+     *  as they are queried, rather than decoded in full when opened?  Default = false.
+     */
+    public static final boolean LAZY_LOAD_TRIBBLE_INDEX;
+
+    /** Maximum number of parsed BAM, CRAM, tabix and tribble indices kept in a process-wide cache and shared between
+     *  readers of the same files; see {@link htsjdk.samtools.util.IndexCache}.  0 disables the cache.  Default = 0.
+     */
+    public static final int INDEX_CACHE_SIZE;
+
     /** Compression level to be used for writing BAM and other block-compressed outputs.  Default = 5. */
     public static final int COMPRESSION_LEVEL;
 
@@ -118,6 +128,8 @@ public class Defaults {
         USE_ASYNC_IO_READ_FOR_SAMTOOLS = getBooleanProperty("use_async_io_read_samtools", false);
         USE_ASYNC_IO_WRITE_FOR_SAMTOOLS = getBooleanProperty("use_async_io_write_samtools", false);
         USE_ASYNC_IO_WRITE_FOR_TRIBBLE = getBooleanProperty("use_async_io_write_tribble", false);
+        LAZY_LOAD_TRIBBLE_INDEX = getBooleanProperty("lazy_load_tribble_index", false);
+        INDEX_CACHE_SIZE = getIntProperty("index_cache_size", 0);
         COMPRESSION_LEVEL = getIntProperty("compression_level", 5);
         DEFAULT_SAM_EXTENSION = getStringProperty("default_sam_type", "bam");
         DEFAULT_VCF_EXTENSION = getStringProperty("default_vcf_type", "vcf");
@@ -148,6 +160,8 @@ public class Defaults {
         result.put("USE_ASYNC_IO_READ_FOR_SAMTOOLS", USE_ASYNC_IO_READ_FOR_SAMTOOLS);
         result.put("USE_ASYNC_IO_WRITE_FOR_SAMTOOLS", USE_ASYNC_IO_WRITE_FOR_SAMTOOLS);
         result.put("USE_ASYNC_IO_WRITE_FOR_TRIBBLE", USE_ASYNC_IO_WRITE_FOR_TRIBBLE);
+        result.put("LAZY_LOAD_TRIBBLE_INDEX", LAZY_LOAD_TRIBBLE_INDEX);
+        result.put("INDEX_CACHE_SIZE", INDEX_CACHE_SIZE);
         result.put("COMPRESSION_LEVEL", COMPRESSION_LEVEL);
         result.put("BUFFER_SIZE", BUFFER_SIZE);
         result.put("NON_ZERO_BUFFER_SIZE", NON_ZERO_BUFFER_SIZE);
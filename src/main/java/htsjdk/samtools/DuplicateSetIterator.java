@@ -37,7 +37,8 @@ import java.util.Collections;
  * <p/>
  * If the input records are not pre-sorted according to the duplicate ordering, the records
  * will be sorted on-the-fly.  This may require extra memory or disk to buffer records, and
- * also computational time to perform the sorting.
+ * also computational time to perform the sorting.  For coordinate-sorted input,
+ * {@link StreamingDuplicateSetIterator} forms the same sets without sorting.
  *
  * @author nhomer
  */
@@ -24,22 +24,51 @@
 package htsjdk.samtools;
 
 import htsjdk.samtools.util.CloseableIterator;
+import htsjdk.samtools.util.LoserTree;
 
+import java.util.ArrayList;
 import java.util.Collection;
+import java.util.Collections;
+import java.util.HashMap;
+import java.util.LinkedHashMap;
+import java.util.List;
 import java.util.Map;
-import java.util.PriorityQueue;
+import java.util.NoSuchElementException;
+import java.util.concurrent.ExecutionException;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.function.ToLongFunction;
 
 /**
  * Provides an iterator interface for merging multiple underlying iterators into a single
  * iterable stream. The underlying iterators/files must all have the same sort order unless
  * the requested output format is unsorted, in which case any combination is valid.
+ *
+ * By default every input is read on the calling thread as records are needed.  {@link #enablePrefetch(int, long)}
+ * instead reads and decodes batches of records of the inputs on a pool of threads ahead of the merge.
  */
 public class MergingSamRecordIterator implements CloseableIterator<SAMRecord> {
-    private final PriorityQueue<ComparableSamRecordIterator> pq;
+    /** The iterator of each input, in the order in which ties are broken */
+    private final List<CloseableIterator<SAMRecord>> sourceIterators = new ArrayList<>();
+    /** The RG/PG translation of each input; null when the merged headers have no ID collisions */
+    private final List<StringTagRemapping> sourceTagRemappings = new ArrayList<>();
+    /** Holds the next record of each input; null until iteration starts, or if there are no inputs */
+    private LoserTree<SAMRecord> tree = null;
+    private boolean closed = false;
     private final SamFileHeaderMerger samHeaderMerger;
     private final Collection<SamReader> readers;
     private final SAMFileHeader.SortOrder sortOrder;
     private final SAMRecordComparator comparator;
+    /** The iterators to merge if given at construction, until iteration starts */
+    private Map<SamReader, CloseableIterator<SAMRecord>> iterators = null;
+
+    /** The number of records read from an input at a time when prefetching */
+    static final int RECORDS_PER_PREFETCH_BATCH = 256;
+    /** Rough size in memory of a decoded record, used to turn the prefetch memory budget into a number of inputs */
+    static final int ESTIMATED_BYTES_PER_RECORD = 1024;
+    private ExecutorService executor = null;
+    private int freePrefetchSlots = 0;
 
     private boolean initialized = false;
 
@@ -69,8 +98,6 @@ public class MergingSamRecordIterator implements CloseableIterator<SAMRecord> {
         this.comparator = getComparator();
         this.readers = readers;
 
-        this.pq = new PriorityQueue<ComparableSamRecordIterator>(readers.size());
-
         for (final SamReader reader : readers) {
             if (!samHeaderMerger.getHeaders().contains(reader.getFileHeader()))
                 throw new SAMException("All iterators to be merged must be accounted for in the SAM header merger");
@@ -90,78 +117,185 @@ public class MergingSamRecordIterator implements CloseableIterator<SAMRecord> {
      */
     public MergingSamRecordIterator(final SamFileHeaderMerger headerMerger, final Map<SamReader, CloseableIterator<SAMRecord>> iterators, final boolean assumeSorted) {
         this(headerMerger, iterators.keySet(), assumeSorted);
-        for (final Map.Entry<SamReader, CloseableIterator<SAMRecord>> mapping : iterators.entrySet())
-            addIfNotEmpty(new ComparableSamRecordIterator(mapping.getKey(), mapping.getValue(), comparator));
-        initialized = true;
+        this.iterators = new LinkedHashMap<>(iterators);
+    }
+
+    /**
+     * Reads the inputs on a pool of threads ahead of the merge: each input that is prefetching reads and decodes its
+     * next batch of records while its current batch is merged, so that decompression and decoding of the inputs run
+     * concurrently.  As a prefetching input holds up to two batches in memory, the number of inputs prefetching at
+     * once is limited by memoryBudget; the others are read on the calling thread, one record at a time, and take over
+     * the prefetch capacity of inputs that are exhausted.
+     *
+     * Must be called before iteration starts.
+     *
+     * @param numThreads   the number of threads reading inputs
+     * @param memoryBudget the approximate number of bytes of records that may be held by prefetching inputs
+     * @return this iterator
+     */
+    public MergingSamRecordIterator enablePrefetch(final int numThreads, final long memoryBudget) {
+        if (initialized) throw new IllegalStateException("Prefetch must be enabled before iteration starts");
+        if (executor != null) throw new IllegalStateException("Prefetch has already been enabled");
+        if (numThreads < 1) throw new IllegalArgumentException("numThreads must be at least 1: " + numThreads);
+        final long bytesPerInput = 2L * RECORDS_PER_PREFETCH_BATCH * ESTIMATED_BYTES_PER_RECORD;
+        this.freePrefetchSlots = (int) Math.min(readers.size(), Math.max(0, memoryBudget) / bytesPerInput);
+        if (freePrefetchSlots > 0) {
+            this.executor = Executors.newFixedThreadPool(numThreads, r -> {
+                final Thread t = Executors.defaultThreadFactory().newThread(r);
+                t.setDaemon(true);
+                return t;
+            });
+        }
+        return this;
     }
 
     private void startIterationIfRequired() {
         if (initialized)
             return;
-        for (final SamReader reader : readers)
-            addIfNotEmpty(new ComparableSamRecordIterator(reader, reader.iterator(), comparator));
+        if (iterators != null) {
+            for (final Map.Entry<SamReader, CloseableIterator<SAMRecord>> mapping : iterators.entrySet())
+                addSource(mapping.getKey(), prefetching(mapping.getValue()));
+            iterators = null;
+        } else {
+            for (final SamReader reader : readers)
+                addSource(reader, prefetching(reader.iterator()));
+        }
+        final List<SAMRecord> heads = new ArrayList<>(sourceIterators.size());
+        for (final CloseableIterator<SAMRecord> iterator : sourceIterators)
+            heads.add(nextOrClose(iterator));
+        if (!heads.isEmpty())
+            tree = new LoserTree<>(heads, comparator, getCoordinateKey());
         initialized = true;
     }
 
+    private void addSource(final SamReader reader, final CloseableIterator<SAMRecord> iterator) {
+        sourceIterators.add(iterator);
+        sourceTagRemappings.add(getTagRemapping(reader.getFileHeader()));
+    }
+
+    /**
+     * Returns the translation of read group and program group IDs to apply to the records of the input with the
+     * given header, or null if there are no collisions to resolve.
+     */
+    private StringTagRemapping getTagRemapping(final SAMFileHeader header) {
+        if (!samHeaderMerger.hasReadGroupCollisions() && !samHeaderMerger.hasProgramGroupCollisions())
+            return null;
+        final StringTagRemapping remapping = new StringTagRemapping();
+        if (samHeaderMerger.hasReadGroupCollisions()) {
+            final Map<String, String> translation = new HashMap<>();
+            for (final SAMReadGroupRecord readGroup : header.getReadGroups())
+                translation.put(readGroup.getId(), samHeaderMerger.getReadGroupId(header, readGroup.getId()));
+            remapping.addTag(SAMTag.RG.getBinaryTag(), translation);
+        }
+        if (samHeaderMerger.hasProgramGroupCollisions()) {
+            final Map<String, String> translation = new HashMap<>();
+            for (final SAMProgramRecord program : header.getProgramRecords())
+                translation.put(program.getId(), samHeaderMerger.getProgramGroupId(header, program.getId()));
+            remapping.addTag(SAMTag.PG.getBinaryTag(), translation);
+        }
+        return remapping;
+    }
+
+    /**
+     * Returns a key consistent with the comparator when merging in coordinate order, so that most comparisons of
+     * records are comparisons of longs, or null for other orders.
+     */
+    private ToLongFunction<SAMRecord> getCoordinateKey() {
+        if (comparator instanceof MergedSequenceDictionaryCoordinateOrderComparator) {
+            final MergedSequenceDictionaryCoordinateOrderComparator mergedComparator = (MergedSequenceDictionaryCoordinateOrderComparator) comparator;
+            return record -> coordinateKey(mergedComparator.getReferenceIndex(record), record.getAlignmentStart());
+        }
+        if (comparator.getClass() == SAMRecordCoordinateComparator.class) {
+            return record -> coordinateKey(record.getReferenceIndex(), record.getAlignmentStart());
+        }
+        return null;
+    }
+
+    /** Orders by reference index and then start, with all records without a reference index last and equal */
+    private static long coordinateKey(final int referenceIndex, final int alignmentStart) {
+        if (referenceIndex == SAMRecord.NO_ALIGNMENT_REFERENCE_INDEX) {
+            return Long.MAX_VALUE;
+        }
+        return ((long) referenceIndex << 32) + alignmentStart;
+    }
+
+    private CloseableIterator<SAMRecord> prefetching(final CloseableIterator<SAMRecord> iterator) {
+        return executor == null ? iterator : new PrefetchingIterator(iterator);
+    }
+
     /**
      * Close down all open iterators.
      */
     @Override
     public void close() {
-        // Iterators not in the priority queue have already been closed; only close down the iterators that are still in the priority queue.
-        for (CloseableIterator<SAMRecord> iterator : pq)
-            iterator.close();
+        if (closed)
+            return;
+        closed = true;
+        // Exhausted iterators have already been closed; only close down the iterators that still have records.
+        if (tree != null) {
+            for (int i = 0; i < sourceIterators.size(); i++) {
+                if (tree.getHead(i) != null)
+                    sourceIterators.get(i).close();
+            }
+        }
+        if (iterators != null) {
+            for (final CloseableIterator<SAMRecord> iterator : iterators.values())
+                iterator.close();
+            iterators = null;
+        }
+        if (executor != null) {
+            executor.shutdownNow();
+        }
     }
 
     /** Returns true if any of the underlying iterators has more records, otherwise false. */
     @Override
     public boolean hasNext() {
         startIterationIfRequired();
-        return !this.pq.isEmpty();
+        return !closed && tree != null && !tree.isEmpty();
     }
 
     /** Returns the next record from the top most iterator during merging. */
     @Override
     public SAMRecord next() {
-        startIterationIfRequired();
+        if (!hasNext())
+            throw new NoSuchElementException();
 
-        final ComparableSamRecordIterator iterator = this.pq.poll();
-        final SAMRecord record = iterator.next();
-        addIfNotEmpty(iterator);
+        final int source = tree.peekSource();
+        final SAMRecord record = tree.replaceTop(nextOrClose(sourceIterators.get(source)));
         // this will resolve the reference indices against the new, merged header
         record.setHeader(this.samHeaderMerger.getMergedHeader());
 
-        // Fix the read group if needs be
-        if (this.samHeaderMerger.hasReadGroupCollisions()) {
-            final String oldGroupId = (String) record.getAttribute(ReservedTagConstants.READ_GROUP_ID);
-            if (oldGroupId != null) {
-                final String newGroupId = this.samHeaderMerger.getReadGroupId(iterator.getReader().getFileHeader(), oldGroupId);
-                record.setAttribute(ReservedTagConstants.READ_GROUP_ID, newGroupId);
-            }
-        }
-
-        // Fix the program group if needs be
-        if (this.samHeaderMerger.hasProgramGroupCollisions()) {
-            final String oldGroupId = (String) record.getAttribute(ReservedTagConstants.PROGRAM_GROUP_ID);
-            if (oldGroupId != null) {
-                final String newGroupId = this.samHeaderMerger.getProgramGroupId(iterator.getReader().getFileHeader(), oldGroupId);
-                record.setAttribute(ReservedTagConstants.PROGRAM_GROUP_ID, newGroupId);
-            }
+        // Fix the read group and program group if needs be. Records read from BAM defer this until their tags are
+        // decoded or written, and then rewrite the tags in their binary block.
+        final StringTagRemapping remapping = sourceTagRemappings.get(source);
+        if (remapping != null && !(record instanceof BAMRecord && ((BAMRecord) record).setTagRemapping(remapping))) {
+            remapTag(record, SAMTag.RG, remapping);
+            remapTag(record, SAMTag.PG, remapping);
         }
 
         return record;
     }
 
+    private static void remapTag(final SAMRecord record, final SAMTag tag, final StringTagRemapping remapping) {
+        final String oldValue = (String) record.getAttribute(tag);
+        if (oldValue != null) {
+            final String newValue = remapping.remap(tag.getBinaryTag(), oldValue);
+            if (!oldValue.equals(newValue))
+                record.setAttribute(tag, newValue);
+        }
+    }
+
     /**
-     * Adds iterator to priority queue. If the iterator has more records it is added
-     * otherwise it is closed and not added.
+     * Returns the next record of the iterator. If the iterator has no more records it is closed
+     * and null is returned.
      */
-    private void addIfNotEmpty(final ComparableSamRecordIterator iterator) {
+    private static SAMRecord nextOrClose(final CloseableIterator<SAMRecord> iterator) {
         if (iterator.hasNext()) {
-            pq.offer(iterator);
-        } else {
-            iterator.close();
+            return iterator.next();
         }
+        iterator.close();
+        return null;
     }
 
     /** Unsupported operation. */
@@ -170,6 +304,146 @@ public class MergingSamRecordIterator implements CloseableIterator<SAMRecord> {
         throw new UnsupportedOperationException("MergingSAMRecorderIterator.remove()");
     }
 
+    /**
+     * Reads an input in batches, with the next batch read on the executor while the current one is merged if the
+     * input holds one of the prefetch slots, and one record at a time on the calling thread if not.  Records read
+     * on the executor are decoded there, leaving the binary form of BAM records in place.
+     */
+    private final class PrefetchingIterator implements CloseableIterator<SAMRecord> {
+        private final CloseableIterator<SAMRecord> iterator;
+        private Future<RecordBatch> nextBatch = null;
+        private List<SAMRecord> batch = Collections.emptyList();
+        private int batchIndex = 0;
+        private RuntimeException batchError = null;
+        private boolean exhausted = false;
+        private boolean hasPrefetchSlot = false;
+        private boolean closed = false;
+
+        private PrefetchingIterator(final CloseableIterator<SAMRecord> iterator) {
+            this.iterator = iterator;
+        }
+
+        @Override
+        public boolean hasNext() {
+            while (batchIndex == batch.size()) {
+                if (batchError != null) {
+                    final RuntimeException e = batchError;
+                    batchError = null;
+                    throw e;
+                }
+                if (closed || (exhausted && nextBatch == null)) {
+                    releasePrefetchSlot();
+                    return false;
+                }
+                final RecordBatch next = nextBatch != null ? getResult(nextBatch) : readBatch(1, false);
+                nextBatch = null;
+                batch = next.records;
+                batchIndex = 0;
+                batchError = next.error;
+                exhausted = next.last;
+                if (!exhausted && acquirePrefetchSlot()) {
+                    nextBatch = executor.submit(() -> readBatch(RECORDS_PER_PREFETCH_BATCH, true));
+                }
+            }
+            return true;
+        }
+
+        @Override
+        public SAMRecord next() {
+            if (!hasNext()) throw new NoSuchElementException();
+            final SAMRecord record = batch.get(batchIndex);
+            // don't hold on to records that have been merged
+            batch.set(batchIndex++, null);
+            return record;
+        }
+
+        private RecordBatch readBatch(final int size, final boolean decode) {
+            final List<SAMRecord> records = new ArrayList<>(size);
+            try {
+                while (records.size() < size && iterator.hasNext()) {
+                    final SAMRecord record = iterator.next();
+                    if (decode) {
+                        record.getReadName();
+                        record.getCigar();
+                        record.getReadBases();
+                        record.getBaseQualities();
+                        record.getBinaryAttributes();
+                    }
+                    records.add(record);
+                }
+                return new RecordBatch(records, null, !iterator.hasNext());
+            } catch (final RuntimeException e) {
+                return new RecordBatch(records, e, true);
+            }
+        }
+
+        private boolean acquirePrefetchSlot() {
+            if (!hasPrefetchSlot && freePrefetchSlots > 0) {
+                freePrefetchSlots--;
+                hasPrefetchSlot = true;
+            }
+            return hasPrefetchSlot;
+        }
+
+        private void releasePrefetchSlot() {
+            if (hasPrefetchSlot) {
+                hasPrefetchSlot = false;
+                freePrefetchSlots++;
+            }
+        }
+
+        @Override
+        public void close() {
+            if (closed) {
+                return;
+            }
+            closed = true;
+            if (nextBatch != null) {
+                // the underlying iterator must not be closed while a batch is being read from it
+                if (!nextBatch.cancel(false)) {
+                    try {
+                        nextBatch.get();
+                    } catch (final InterruptedException e) {
+                        Thread.currentThread().interrupt();
+                    } catch (final ExecutionException e) {
+                        // the reader is being closed anyway
+                    }
+                }
+                nextBatch = null;
+            }
+            batch = Collections.emptyList();
+            batchIndex = 0;
+            releasePrefetchSlot();
+            iterator.close();
+        }
+    }
+
+    private static final class RecordBatch {
+        private final List<SAMRecord> records;
+        private final RuntimeException error;
+        private final boolean last;
+
+        private RecordBatch(final List<SAMRecord> records, final RuntimeException error, final boolean last) {
+            this.records = records;
+            this.error = error;
+            this.last = last;
+        }
+    }
+
+    private static RecordBatch getResult(final Future<RecordBatch> future) {
+        try {
+            return future.get();
+        } catch (final InterruptedException e) {
+            Thread.currentThread().interrupt();
+            throw new SAMException("Interrupted while reading records", e);
+        } catch (final ExecutionException e) {
+            if (e.getCause() instanceof Error) {
+                throw (Error) e.getCause();
+            }
+            throw new SAMException("Error reading records", e.getCause());
+        }
+    }
+
     /**
      * Get the right comparator for a given sort order (coordinate, alphabetic). In the
      * case of "unsorted" it will return a comparator that gives an arbitrary but reflexive
@@ -1695,8 +1695,15 @@ public class SAMRecord implements Cloneable, Locatable, Serializable {
      * @return indexing bin based on alignment start & end.
      */
     int computeIndexingBin() {
-        final int alignmentStart = getAlignmentStart() - 1; // BIN uses 0-based half-open
-        int alignmentEnd = getAlignmentEnd();
+        return computeIndexingBin(getAlignmentStart(), getAlignmentEnd());
+    }
+
+    /**
+     * Computes the BAI indexing bin for the given 1-based, inclusive alignment start and end.
+     */
+    static int computeIndexingBin(final int oneBasedAlignmentStart, final int oneBasedAlignmentEnd) {
+        final int alignmentStart = oneBasedAlignmentStart - 1; // BIN uses 0-based half-open
+        int alignmentEnd = oneBasedAlignmentEnd;
         if (alignmentEnd <= 0) {
             // If alignment end cannot be determined (e.g. because this read is not really aligned),
             // then treat this as a one base alignment for indexing purposes.
@@ -38,23 +38,22 @@ import htsjdk.samtools.util.FastqQualityFormat;
 import htsjdk.samtools.util.Histogram;
 import htsjdk.samtools.util.IOUtil;
 import htsjdk.samtools.util.Log;
+import htsjdk.samtools.util.Murmur3;
 import htsjdk.samtools.util.ProgressLogger;
 import htsjdk.samtools.util.QualityEncodingDetector;
 import htsjdk.samtools.util.SequenceUtil;
 import htsjdk.samtools.util.StringUtil;
 
 import java.io.BufferedInputStream;
-import java.io.DataInputStream;
-import java.io.DataOutputStream;
 import java.io.File;
 import java.io.FileInputStream;
 import java.io.IOException;
-import java.io.InputStream;
-import java.io.OutputStream;
 import java.io.PrintWriter;
 import java.util.AbstractMap;
+import java.util.ArrayDeque;
 import java.util.ArrayList;
 import java.util.Collection;
+import java.util.Deque;
 import java.util.EnumSet;
 import java.util.HashMap;
 import java.util.HashSet;
@@ -62,6 +61,10 @@ import java.util.Iterator;
 import java.util.List;
 import java.util.Map;
 import java.util.Set;
+import java.util.concurrent.ExecutionException;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
 import java.util.stream.Collectors;
 
 /**
@@ -106,6 +109,10 @@ public class SamFileValidator {
     private int qualityNotStoredErrorCount = 0;
     public static final int MAX_QUALITY_NOT_STORED_ERRORS = 100;
 
+    private int numThreads = 1;
+    /** The number of records checked by a worker thread at a time when validating with more than one thread */
+    private static final int RECORDS_PER_BATCH = 1000;
+
     public SamFileValidator(final PrintWriter out, final int maxTempFiles) {
         this.out = out;
         this.maxTempFiles = maxTempFiles;
@@ -157,6 +164,29 @@ public class SamFileValidator {
         return skipMateValidation;
     }
 
+    /**
+     * Sets the number of threads used to validate records.  With more than one, the checks of each record that do
+     * not depend on other records (CIGAR, tags, NM, read group, ...) are run on a pool of worker threads over batches
+     * of records, while the checks that do (sort order and mate pairing) are applied to the results in file order,
+     * so the same errors are reported in the same order as with one thread.
+     *
+     * @param numThreads the number of threads checking records in addition to the one reading them, or 1 to
+     *                   validate on the calling thread only
+     */
+    public void setNumThreads(final int numThreads) {
+        if (numThreads < 1) {
+            throw new IllegalArgumentException("numThreads must be at least 1: " + numThreads);
+        }
+        this.numThreads = numThreads;
+    }
+
+    /**
+     * @return the number of threads used to validate records
+     */
+    public int getNumThreads() {
+        return numThreads;
+    }
+
     /**
      * Outputs validation summary report to out.
      *
@@ -298,54 +328,20 @@ public class SamFileValidator {
         final SAMRecordIterator iter = (SAMRecordIterator) samRecords.iterator();
         final ProgressLogger progress = new ProgressLogger(log, 10000000, "Validated Read");
         final QualityEncodingDetector qualityDetector = new QualityEncodingDetector();
+        final ExecutorService executor = numThreads > 1 ? Executors.newFixedThreadPool(numThreads, r -> {
+            final Thread t = Executors.defaultThreadFactory().newThread(r);
+            t.setDaemon(true);
+            return t;
+        }) : null;
         try {
-            while (iter.hasNext()) {
-                final SAMRecord record = iter.next();
-
-                qualityDetector.add(record);
-
-                final long recordNumber = progress.getCount() + 1;
-                final Collection<SAMValidationError> errors = record.isValid();
-                if (errors != null) {
-                    for (final SAMValidationError error : errors) {
-                        error.setRecordNumber(recordNumber);
-                        addError(error);
-                    }
-                }
-
-                validateMateFields(record, recordNumber);
-                final boolean hasValidSortOrder = validateSortOrder(record, recordNumber);
-                validateReadGroup(record, header);
-                final boolean cigarIsValid = validateCigar(record, recordNumber);
-                if (cigarIsValid) {
-                    try {
-                        validateNmTag(record, recordNumber);
-                    } catch (SAMException e) {
-                        if (hasValidSortOrder) {
-                            // If a CRAM file has an invalid sort order, the ReferenceFileWalker will throw a
-                            // SAMException due to an out of order request when retrieving reference bases during NM
-                            // tag validation; rethrow the exception only if the sort order is valid, otherwise
-                            // swallow the exception and carry on validating
-                            throw e;
-                        }
-                    }
+            if (executor == null) {
+                while (iter.hasNext()) {
+                    final RecordChecks checks = new RecordChecks(iter.next(), progress.getCount() + 1);
+                    checkRecord(checks, header);
+                    reduceRecord(checks, qualityDetector, progress);
                 }
-                validateSecondaryBaseCalls(record, recordNumber);
-                validateTags(record, recordNumber);
-                if (sequenceDictionaryEmptyAndNoWarningEmitted && !record.getReadUnmappedFlag()) {
-                    addError(new SAMValidationError(Type.MISSING_SEQUENCE_DICTIONARY, "Sequence dictionary is empty", null));
-                    sequenceDictionaryEmptyAndNoWarningEmitted = false;
-
-                }
-
-                if ((qualityNotStoredErrorCount++ < MAX_QUALITY_NOT_STORED_ERRORS) && record.getBaseQualityString().equals("*")) {
-                    addError(new SAMValidationError(Type.QUALITY_NOT_STORED,
-                            "QUAL field is set to * (unspecified quality scores), this is allowed by the SAM" +
-                                    " specification but many tools expect reads to include qualities ",
-                            record.getReadName(), recordNumber));
-                }
-
-                progress.record(record);
+            } else {
+                validateRecordsInParallel(iter, header, executor, qualityDetector, progress);
             }
 
             try {
@@ -368,16 +364,203 @@ public class SamFileValidator {
             addError(new SAMValidationError(Type.TRUNCATED_FILE, "File is truncated", null));
         } finally {
             iter.close();
+            if (executor != null) {
+                executor.shutdownNow();
+            }
+        }
+    }
+
+    /**
+     * Reads batches of records on this thread and checks them on the executor, with at most two batches per thread
+     * in flight, then reduces the checked batches in the order they were read.  An exception reading the records is
+     * rethrown once the records before it have been reduced, as it would have been when validating on one thread.
+     */
+    private void validateRecordsInParallel(final SAMRecordIterator iter, final SAMFileHeader header, final ExecutorService executor,
+                                           final QualityEncodingDetector qualityDetector, final ProgressLogger progress) {
+        final Deque<Future<List<RecordChecks>>> pending = new ArrayDeque<>();
+        List<RecordChecks> batch = new ArrayList<>(RECORDS_PER_BATCH);
+        long recordsRead = 0;
+        RuntimeException readError = null;
+        while (true) {
+            final RecordChecks checks;
+            try {
+                if (!iter.hasNext()) {
+                    break;
+                }
+                checks = new RecordChecks(iter.next(), ++recordsRead);
+                prefetchReference(checks);
+            } catch (final RuntimeException e) {
+                readError = e;
+                break;
+            }
+            batch.add(checks);
+            if (batch.size() == RECORDS_PER_BATCH) {
+                pending.addLast(submitBatch(executor, batch, header));
+                batch = new ArrayList<>(RECORDS_PER_BATCH);
+                if (pending.size() >= 2 * numThreads) {
+                    reduceBatch(getResult(pending.removeFirst()), qualityDetector, progress);
+                }
+            }
+        }
+        if (!batch.isEmpty()) {
+            pending.addLast(submitBatch(executor, batch, header));
+        }
+        while (!pending.isEmpty()) {
+            reduceBatch(getResult(pending.removeFirst()), qualityDetector, progress);
+        }
+        if (readError != null) {
+            throw readError;
+        }
+    }
+
+    private Future<List<RecordChecks>> submitBatch(final ExecutorService executor, final List<RecordChecks> batch, final SAMFileHeader header) {
+        return executor.submit(() -> {
+            for (final RecordChecks checks : batch) {
+                try {
+                    checkRecord(checks, header);
+                } catch (final RuntimeException e) {
+                    // rethrown when the record is reduced, so that the records before it are reported first
+                    checks.failure = e;
+                    break;
+                }
+            }
+            return batch;
+        });
+    }
+
+    private void reduceBatch(final List<RecordChecks> batch, final QualityEncodingDetector qualityDetector, final ProgressLogger progress) {
+        for (final RecordChecks checks : batch) {
+            reduceRecord(checks, qualityDetector, progress);
+        }
+    }
+
+    private static <T> T getResult(final Future<T> future) {
+        try {
+            return future.get();
+        } catch (final InterruptedException e) {
+            Thread.currentThread().interrupt();
+            throw new SAMException("Interrupted while validating records", e);
+        } catch (final ExecutionException e) {
+            if (e.getCause() instanceof Error) {
+                throw (Error) e.getCause();
+            }
+            if (e.getCause() instanceof RuntimeException) {
+                throw (RuntimeException) e.getCause();
+            }
+            throw new SAMException("Error validating records", e.getCause());
+        }
+    }
+
+    /**
+     * Fetches the reference for the NM check of a record before it is handed to a worker thread, as the
+     * reference walker can only be used by one thread and in file order.
+     */
+    private void prefetchReference(final RecordChecks checks) {
+        final SAMRecord record = checks.record;
+        if (refFileWalker == null || record.getReadUnmappedFlag() || record.getAttribute(ReservedTagConstants.NM) == null) {
+            return;
+        }
+        try {
+            checks.reference = refFileWalker.get(record.getReferenceIndex());
+        } catch (final SAMException e) {
+            checks.referenceError = e;
+        }
+    }
+
+    /**
+     * Runs the checks of a record that do not depend on any other record, and so may be run on a worker thread.
+     */
+    private void checkRecord(final RecordChecks checks, final SAMFileHeader header) {
+        final SAMRecord record = checks.record;
+        final long recordNumber = checks.recordNumber;
+
+        final Collection<SAMValidationError> errors = record.isValid();
+        if (errors != null) {
+            for (final SAMValidationError error : errors) {
+                error.setRecordNumber(recordNumber);
+                checks.errorsBeforeMatePairing.add(error);
+            }
+        }
+
+        if (record.getReadPairedFlag() && !record.isSecondaryOrSupplementary()) {
+            validateMateCigar(record, recordNumber, checks.errorsBeforeMatePairing);
+            if (!skipMateValidation) {
+                checks.pairEndInfo = new PairEndInfo(record, recordNumber);
+            }
+        }
+
+        validateReadGroup(record, header, checks.errorsAfterSortOrder);
+        checks.cigarIsValid = validateCigar(record, recordNumber, checks.errorsAfterSortOrder);
+        if (checks.cigarIsValid) {
+            checks.errorsBeforeNmTag = checks.errorsAfterSortOrder.size();
+            try {
+                validateNmTag(checks, checks.errorsAfterSortOrder);
+            } catch (SAMException e) {
+                checks.nmTagException = e;
+            }
         }
+        validateSecondaryBaseCalls(record, recordNumber, checks.errorsAfterSortOrder);
+        validateTags(record, recordNumber, checks.errorsAfterSortOrder);
+        checks.qualityNotStored = record.getBaseQualityString().equals("*");
     }
 
-    private void validateReadGroup(final SAMRecord record, final SAMFileHeader header) {
+    /**
+     * Reports the results of {@link #checkRecord} for a record and runs the checks that depend on the records
+     * before it.  Records must be reduced in file order.
+     */
+    private void reduceRecord(final RecordChecks checks, final QualityEncodingDetector qualityDetector, final ProgressLogger progress) {
+        final SAMRecord record = checks.record;
+        final long recordNumber = checks.recordNumber;
+
+        qualityDetector.add(record);
+        if (checks.failure != null) {
+            throw checks.failure;
+        }
+
+        for (final SAMValidationError error : checks.errorsBeforeMatePairing) {
+            addError(error);
+        }
+        if (checks.pairEndInfo != null) {
+            validateMatePairing(record, checks.pairEndInfo);
+        }
+        final boolean hasValidSortOrder = validateSortOrder(record, recordNumber);
+        if (checks.nmTagException != null && hasValidSortOrder) {
+            // If a CRAM file has an invalid sort order, the ReferenceFileWalker will throw a
+            // SAMException due to an out of order request when retrieving reference bases during NM
+            // tag validation; rethrow the exception only if the sort order is valid, otherwise
+            // swallow the exception and carry on validating
+            for (final SAMValidationError error : checks.errorsAfterSortOrder.subList(0, checks.errorsBeforeNmTag)) {
+                addError(error);
+            }
+            throw checks.nmTagException;
+        }
+        for (final SAMValidationError error : checks.errorsAfterSortOrder) {
+            addError(error);
+        }
+
+        if (sequenceDictionaryEmptyAndNoWarningEmitted && !record.getReadUnmappedFlag()) {
+            addError(new SAMValidationError(Type.MISSING_SEQUENCE_DICTIONARY, "Sequence dictionary is empty", null));
+            sequenceDictionaryEmptyAndNoWarningEmitted = false;
+
+        }
+
+        if ((qualityNotStoredErrorCount++ < MAX_QUALITY_NOT_STORED_ERRORS) && checks.qualityNotStored) {
+            addError(new SAMValidationError(Type.QUALITY_NOT_STORED,
+                    "QUAL field is set to * (unspecified quality scores), this is allowed by the SAM" +
+                            " specification but many tools expect reads to include qualities ",
+                    record.getReadName(), recordNumber));
+        }
+
+        progress.record(record);
+    }
+
+    private void validateReadGroup(final SAMRecord record, final SAMFileHeader header, final List<SAMValidationError> errors) {
         final SAMReadGroupRecord rg = record.getReadGroup();
         if (rg == null) {
-            addError(new SAMValidationError(Type.RECORD_MISSING_READ_GROUP,
+            errors.add(new SAMValidationError(Type.RECORD_MISSING_READ_GROUP,
                     "A record is missing a read group", record.getReadName()));
         } else if (header.getReadGroup(rg.getId()) == null) {
-            addError(new SAMValidationError(Type.READ_GROUP_NOT_FOUND,
+            errors.add(new SAMValidationError(Type.READ_GROUP_NOT_FOUND,
                     "A record has a read group not found in the header: ",
                     record.getReadName() + ", " + rg.getReadGroupId()));
         }
@@ -388,37 +571,37 @@ public class SamFileValidator {
      * or if there's a CG tag is obvered (CG tags are converted to cigars in
      * the bam code, and should not appear in other formats)
      */
-    private void validateTags(final SAMRecord record, final long recordNumber) {
+    private void validateTags(final SAMRecord record, final long recordNumber, final List<SAMValidationError> errors) {
         final List<SAMRecord.SAMTagAndValue> attributes = record.getAttributes();
 
         final Set<String> tags = new HashSet<>(attributes.size());
 
         for (final SAMRecord.SAMTagAndValue tagAndValue : attributes) {
             if (tagAndValue.value instanceof Long) {
-                addError(new SAMValidationError(Type.TAG_VALUE_TOO_LARGE,
+                errors.add(new SAMValidationError(Type.TAG_VALUE_TOO_LARGE,
                         "Numeric value too large for tag " + tagAndValue.tag,
                         record.getReadName(), recordNumber));
             }
 
             if (!tags.add(tagAndValue.tag)) {
-                addError(new SAMValidationError(Type.DUPLICATE_SAM_TAG,
+                errors.add(new SAMValidationError(Type.DUPLICATE_SAM_TAG,
                         "Duplicate SAM tag (" + tagAndValue.tag + ") found.", record.getReadName(), recordNumber));
             }
         }
 
         if (tags.contains(SAMTag.CG.name())){
-            addError(new SAMValidationError(Type.CG_TAG_FOUND_IN_ATTRIBUTES,
+            errors.add(new SAMValidationError(Type.CG_TAG_FOUND_IN_ATTRIBUTES,
                     "The CG Tag should only be used in BAM format to hold a large cigar. " +
                             "It was found containing the value: " +
                             record.getAttribute(SAMTag.CG), record.getReadName(), recordNumber));
         }
     }
 
-    private void validateSecondaryBaseCalls(final SAMRecord record, final long recordNumber) {
+    private void validateSecondaryBaseCalls(final SAMRecord record, final long recordNumber, final List<SAMValidationError> errors) {
         final String e2 = (String) record.getAttribute(SAMTag.E2);
         if (e2 != null) {
             if (e2.length() != record.getReadLength()) {
-                addError(new SAMValidationError(Type.MISMATCH_READ_LENGTH_AND_E2_LENGTH,
+                errors.add(new SAMValidationError(Type.MISMATCH_READ_LENGTH_AND_E2_LENGTH,
                         String.format("E2 tag length (%d) != read length (%d)", e2.length(), record.getReadLength()),
                         record.getReadName(), recordNumber));
             }
@@ -429,7 +612,7 @@ public class SamFileValidator {
                     continue;
                 }
                 if (SequenceUtil.basesEqual(bases[i], secondaryBases[i])) {
-                    addError(new SAMValidationError(Type.E2_BASE_EQUALS_PRIMARY_BASE,
+                    errors.add(new SAMValidationError(Type.E2_BASE_EQUALS_PRIMARY_BASE,
                             String.format("Secondary base call  (%c) == primary base call (%c)",
                                     (char) secondaryBases[i], (char) bases[i]),
                             record.getReadName(), recordNumber));
@@ -439,31 +622,32 @@ public class SamFileValidator {
         }
         final String u2 = (String) record.getAttribute(SAMTag.U2);
         if (u2 != null && u2.length() != record.getReadLength()) {
-            addError(new SAMValidationError(Type.MISMATCH_READ_LENGTH_AND_U2_LENGTH,
+            errors.add(new SAMValidationError(Type.MISMATCH_READ_LENGTH_AND_U2_LENGTH,
                     String.format("U2 tag length (%d) != read length (%d)", u2.length(), record.getReadLength()),
                     record.getReadName(), recordNumber));
         }
     }
 
-    private boolean validateCigar(final SAMRecord record, final long recordNumber) {
-        return record.getReadUnmappedFlag() || validateCigar(record, recordNumber, true);
+    private boolean validateCigar(final SAMRecord record, final long recordNumber, final List<SAMValidationError> errors) {
+        return record.getReadUnmappedFlag() || validateCigar(record, recordNumber, true, errors);
     }
 
-    private boolean validateMateCigar(final SAMRecord record, final long recordNumber) {
-        return validateCigar(record, recordNumber, false);
+    private boolean validateMateCigar(final SAMRecord record, final long recordNumber, final List<SAMValidationError> errors) {
+        return validateCigar(record, recordNumber, false, errors);
     }
 
-    private boolean validateCigar(final SAMRecord record, final long recordNumber, final boolean isReadCigar) {
+    private boolean validateCigar(final SAMRecord record, final long recordNumber, final boolean isReadCigar,
+                                  final List<SAMValidationError> errors) {
         final ValidationStringency savedStringency = record.getValidationStringency();
         record.setValidationStringency(ValidationStringency.LENIENT);
-        final List<SAMValidationError> errors = isReadCigar ? record.validateCigar(recordNumber) : SAMUtils.validateMateCigar(record, recordNumber);
+        final List<SAMValidationError> cigarErrors = isReadCigar ? record.validateCigar(recordNumber) : SAMUtils.validateMateCigar(record, recordNumber);
         record.setValidationStringency(savedStringency);
-        if (errors == null) {
+        if (cigarErrors == null) {
             return true;
         }
         boolean valid = true;
-        for (final SAMValidationError error : errors) {
-            addError(error);
+        for (final SAMValidationError error : cigarErrors) {
+            errors.add(error);
             valid = false;
         }
         return valid;
@@ -505,22 +689,29 @@ public class SamFileValidator {
         this.refFileWalker = null;
     }
 
-    private void validateNmTag(final SAMRecord record, final long recordNumber) {
+    private void validateNmTag(final RecordChecks checks, final List<SAMValidationError> errors) {
+        final SAMRecord record = checks.record;
+        final long recordNumber = checks.recordNumber;
         if (!record.getReadUnmappedFlag()) {
             final Integer tagNucleotideDiffs = record.getIntegerAttribute(ReservedTagConstants.NM);
             if (tagNucleotideDiffs == null) {
-                addError(new SAMValidationError(
+                errors.add(new SAMValidationError(
                         Type.MISSING_TAG_NM,
                         "NM tag (nucleotide differences) is missing",
                         record.getReadName(),
                         recordNumber));
             } else if (refFileWalker != null) {
-                final ReferenceSequence refSequence = refFileWalker.get(record.getReferenceIndex());
+                if (checks.referenceError != null) {
+                    throw checks.referenceError;
+                }
+                // only fetched ahead of time when validating with more than one thread
+                final ReferenceSequence refSequence = checks.reference != null ? checks.reference :
+                        refFileWalker.get(record.getReferenceIndex());
                 final int actualNucleotideDiffs = SequenceUtil.calculateSamNmTag(record, refSequence.getBases(),
                         0, isBisulfiteSequenced());
 
                 if (!tagNucleotideDiffs.equals(actualNucleotideDiffs)) {
-                    addError(new SAMValidationError(
+                    errors.add(new SAMValidationError(
                             Type.INVALID_TAG_NM,
                             "NM tag (nucleotide differences) in file [" + tagNucleotideDiffs +
                                     "] does not match reality [" + actualNucleotideDiffs + "]",
@@ -531,22 +722,17 @@ public class SamFileValidator {
         }
     }
 
-    private void validateMateFields(final SAMRecord record, final long recordNumber) {
-        if (!record.getReadPairedFlag() || record.isSecondaryOrSupplementary()) {
-            return;
-        }
-        validateMateCigar(record, recordNumber);
-
-        if (skipMateValidation) {
-            return;
-        }
-
+    /**
+     * Pairs the record with its mate if the mate has been seen, otherwise holds on to it until the mate is seen.
+     *
+     * @param recordInfo the record's mate information, extracted by {@link #checkRecord}
+     */
+    private void validateMatePairing(final SAMRecord record, final PairEndInfo recordInfo) {
         final PairEndInfo pairEndInfo = pairEndInfoByName.remove(record.getReferenceIndex(), record.getReadName());
         if (pairEndInfo == null) {
-            pairEndInfoByName.put(record.getMateReferenceIndex(), record.getReadName(), new PairEndInfo(record, recordNumber));
+            pairEndInfoByName.put(record.getMateReferenceIndex(), record.getReadName(), recordInfo);
         } else {
-            final List<SAMValidationError> errors =
-                    pairEndInfo.validateMates(new PairEndInfo(record, recordNumber), record.getReadName());
+            final List<SAMValidationError> errors = pairEndInfo.validateMates(recordInfo, record.getReadName());
             for (final SAMValidationError error : errors) {
                 addError(error);
             }
@@ -707,22 +893,60 @@ public class SamFileValidator {
     public static class ValidationMetrics extends MetricBase {
     }
 
+    /**
+     * A record with the results of the checks on it that do not depend on other records.  Errors are kept in the
+     * order in which they are reported, split around the mate pairing and sort order checks, which depend on the
+     * records before this one and are run when the record is reduced.
+     */
+    private static final class RecordChecks {
+        private final SAMRecord record;
+        private final long recordNumber;
+        /** The reference for the NM check, or the error fetching it, if fetched before the checks were run */
+        private ReferenceSequence reference;
+        private SAMException referenceError;
+
+        /** Errors from SAMRecord.isValid() and the mate CIGAR */
+        private final List<SAMValidationError> errorsBeforeMatePairing = new ArrayList<>();
+        /** Null unless the record is a primary paired read and mates are validated */
+        private PairEndInfo pairEndInfo;
+        /** Errors from the read group, CIGAR, NM, secondary base call and tag checks */
+        private final List<SAMValidationError> errorsAfterSortOrder = new ArrayList<>();
+        private boolean cigarIsValid;
+        /** The number of errorsAfterSortOrder found before the NM check, which threw nmTagException if not null */
+        private int errorsBeforeNmTag;
+        private SAMException nmTagException;
+        private boolean qualityNotStored;
+        /** Thrown by the checks on a worker thread */
+        private RuntimeException failure;
+
+        private RecordChecks(final SAMRecord record, final long recordNumber) {
+            this.record = record;
+            this.recordNumber = recordNumber;
+        }
+    }
+
     /**
      * This class is used so we don't have to store the entire SAMRecord in memory while we wait
      * to find a record's mate and also to store the record number.
      */
     private static class PairEndInfo {
+        /** The number of longs in a packed PairEndInfo */
+        private static final int PACKED_WIDTH = 5;
+        private static final Murmur3 CIGAR_HASH_HIGH = new Murmur3(1);
+        private static final Murmur3 CIGAR_HASH_LOW = new Murmur3(2);
+
         private final int readAlignmentStart;
         private final int readReferenceIndex;
         private final boolean readNegStrandFlag;
         private final boolean readUnmappedFlag;
-        private final String readCigarString;
+        private final long readCigarHash;
 
         private final int mateAlignmentStart;
         private final int mateReferenceIndex;
         private final boolean mateNegStrandFlag;
         private final boolean mateUnmappedFlag;
-        private final String mateCigarString;
+        private final boolean hasMateCigar;
+        private final long mateCigarHash;
 
         private final boolean firstOfPairFlag;
 
@@ -735,34 +959,52 @@ public class SamFileValidator {
             this.readNegStrandFlag = record.getReadNegativeStrandFlag();
             this.readReferenceIndex = record.getReferenceIndex();
             this.readUnmappedFlag = record.getReadUnmappedFlag();
-            this.readCigarString = record.getCigarString();
+            this.readCigarHash = hashCigar(record.getCigarString());
 
             this.mateAlignmentStart = record.getMateAlignmentStart();
             this.mateNegStrandFlag = record.getMateNegativeStrandFlag();
             this.mateReferenceIndex = record.getMateReferenceIndex();
             this.mateUnmappedFlag = record.getMateUnmappedFlag();
             final Object mcs = record.getAttribute(SAMTag.MC);
-            this.mateCigarString = (mcs != null) ? (String) mcs : null;
+            this.hasMateCigar = mcs != null;
+            this.mateCigarHash = hasMateCigar ? hashCigar((String) mcs) : 0;
 
             this.firstOfPairFlag = record.getFirstOfPairFlag();
         }
 
-        private PairEndInfo(final int readAlignmentStart, final int readReferenceIndex, final boolean readNegStrandFlag, final boolean readUnmappedFlag,
-                            final String readCigarString,
-                            final int mateAlignmentStart, final int mateReferenceIndex, final boolean mateNegStrandFlag, final boolean mateUnmappedFlag,
-                            final String mateCigarString, final boolean firstOfPairFlag, final long recordNumber) {
-            this.readAlignmentStart = readAlignmentStart;
-            this.readReferenceIndex = readReferenceIndex;
-            this.readNegStrandFlag = readNegStrandFlag;
-            this.readUnmappedFlag = readUnmappedFlag;
-            this.readCigarString = readCigarString;
-            this.mateAlignmentStart = mateAlignmentStart;
-            this.mateReferenceIndex = mateReferenceIndex;
-            this.mateNegStrandFlag = mateNegStrandFlag;
-            this.mateUnmappedFlag = mateUnmappedFlag;
-            this.mateCigarString = mateCigarString;
-            this.firstOfPairFlag = firstOfPairFlag;
-            this.recordNumber = recordNumber;
+        /** Unpacks a PairEndInfo from the longs written by {@link #pack(long[])} */
+        private PairEndInfo(final long[] packed) {
+            this.readAlignmentStart = (int) (packed[0] >> 32);
+            this.readReferenceIndex = (int) packed[0];
+            this.mateAlignmentStart = (int) (packed[1] >> 32);
+            this.mateReferenceIndex = (int) packed[1];
+            final int flags = (int) (packed[2] & 0xFF);
+            this.readNegStrandFlag = (flags & 0x1) != 0;
+            this.readUnmappedFlag = (flags & 0x2) != 0;
+            this.mateNegStrandFlag = (flags & 0x4) != 0;
+            this.mateUnmappedFlag = (flags & 0x8) != 0;
+            this.firstOfPairFlag = (flags & 0x10) != 0;
+            this.hasMateCigar = (flags & 0x20) != 0;
+            this.recordNumber = packed[2] >>> 8;
+            this.readCigarHash = packed[3];
+            this.mateCigarHash = packed[4];
+        }
+
+        /** Packs this PairEndInfo into PACKED_WIDTH longs */
+        private void pack(final long[] packed) {
+            packed[0] = ((long) readAlignmentStart << 32) | (readReferenceIndex & 0xFFFFFFFFL);
+            packed[1] = ((long) mateAlignmentStart << 32) | (mateReferenceIndex & 0xFFFFFFFFL);
+            final int flags = (readNegStrandFlag ? 0x1 : 0) | (readUnmappedFlag ? 0x2 : 0) | (mateNegStrandFlag ? 0x4 : 0) |
+                    (mateUnmappedFlag ? 0x8 : 0) | (firstOfPairFlag ? 0x10 : 0) | (hasMateCigar ? 0x20 : 0);
+            packed[2] = (recordNumber << 8) | flags;
+            packed[3] = readCigarHash;
+            packed[4] = mateCigarHash;
+        }
+
+        /** Only equality of CIGARs is checked, so a 64-bit hash is kept rather than the string */
+        private static long hashCigar(final String cigar) {
+            return ((long) CIGAR_HASH_HIGH.hashUnencodedChars(cigar) << 32) |
+                    (CIGAR_HASH_LOW.hashUnencodedChars(cigar) & 0xFFFFFFFFL);
         }
 
         public List<SAMValidationError> validateMates(final PairEndInfo mate, final String readName) {
@@ -811,7 +1053,7 @@ public class SamFileValidator {
                         readName,
                         end1.recordNumber));
             }
-            if ((end1.mateCigarString != null) && (!end1.mateCigarString.equals(end2.readCigarString))) {
+            if (end1.hasMateCigar && end1.mateCigarHash != end2.readCigarHash) {
                 errors.add(new SAMValidationError(
                         Type.MISMATCH_MATE_CIGAR_STRING,
                         "Mate CIGAR string does not match CIGAR string of mate",
@@ -842,91 +1084,41 @@ public class SamFileValidator {
     }
 
     private class CoordinateSortedPairEndInfoMap implements PairEndInfoMap {
-        private final CoordinateSortedPairInfoMap<String, PairEndInfo> onDiskMap =
-                new CoordinateSortedPairInfoMap<>(maxTempFiles, new Codec());
+        private final CoordinateSortedPackedPairInfoMap onDiskMap =
+                new CoordinateSortedPackedPairInfoMap(maxTempFiles, PairEndInfo.PACKED_WIDTH);
+        private final long[] packed = new long[PairEndInfo.PACKED_WIDTH];
 
         @Override
         public void put(int mateReferenceIndex, String key, PairEndInfo value) {
-            onDiskMap.put(mateReferenceIndex, key, value);
+            value.pack(packed);
+            onDiskMap.put(mateReferenceIndex, key, packed);
         }
 
         @Override
         public PairEndInfo remove(int mateReferenceIndex, String key) {
-            return onDiskMap.remove(mateReferenceIndex, key);
+            return onDiskMap.remove(mateReferenceIndex, key, packed) ? new PairEndInfo(packed) : null;
         }
 
         @Override
         public CloseableIterator<Map.Entry<String, PairEndInfo>> iterator() {
-            return onDiskMap.iterator();
-        }
-
-        private class Codec implements CoordinateSortedPairInfoMap.Codec<String, PairEndInfo> {
-            private DataInputStream in;
-            private DataOutputStream out;
-
-            @Override
-            public void setOutputStream(final OutputStream os) {
-                this.out = new DataOutputStream(os);
-            }
-
-            @Override
-            public void setInputStream(final InputStream is) {
-                this.in = new DataInputStream(is);
-            }
+            final CloseableIterator<Map.Entry<String, long[]>> it = onDiskMap.iterator();
+            return new CloseableIterator<Map.Entry<String, PairEndInfo>>() {
+                @Override
+                public void close() {
+                    it.close();
+                }
 
-            @Override
-            public void encode(final String key, final PairEndInfo record) {
-                try {
-                    out.writeUTF(key);
-                    out.writeInt(record.readAlignmentStart);
-                    out.writeInt(record.readReferenceIndex);
-                    out.writeBoolean(record.readNegStrandFlag);
-                    out.writeBoolean(record.readUnmappedFlag);
-                    out.writeUTF(record.readCigarString);
-                    out.writeInt(record.mateAlignmentStart);
-                    out.writeInt(record.mateReferenceIndex);
-                    out.writeBoolean(record.mateNegStrandFlag);
-                    out.writeBoolean(record.mateUnmappedFlag);
-                    // writeUTF can't take null, so store a null mateCigarString as an empty string
-                    out.writeUTF(record.mateCigarString != null ? record.mateCigarString : "");
-                    out.writeBoolean(record.firstOfPairFlag);
-                    out.writeLong(record.recordNumber);
-                } catch (IOException e) {
-                    throw new SAMException("Error spilling PairInfo to disk", e);
+                @Override
+                public boolean hasNext() {
+                    return it.hasNext();
                 }
-            }
 
-            @Override
-            public Map.Entry<String, PairEndInfo> decode() {
-                try {
-                    final String key = in.readUTF();
-                    final int readAlignmentStart = in.readInt();
-                    final int readReferenceIndex = in.readInt();
-                    final boolean readNegStrandFlag = in.readBoolean();
-                    final boolean readUnmappedFlag = in.readBoolean();
-                    final String readCigarString = in.readUTF();
-
-                    final int mateAlignmentStart = in.readInt();
-                    final int mateReferenceIndex = in.readInt();
-                    final boolean mateNegStrandFlag = in.readBoolean();
-                    final boolean mateUnmappedFlag = in.readBoolean();
-
-                    // read mateCigarString - note that null value is stored as an empty string
-                    final String mcs = in.readUTF();
-                    final String mateCigarString = !mcs.isEmpty() ? mcs : null;
-
-                    final boolean firstOfPairFlag = in.readBoolean();
-
-                    final long recordNumber = in.readLong();
-                    final PairEndInfo rec = new PairEndInfo(readAlignmentStart, readReferenceIndex, readNegStrandFlag,
-                            readUnmappedFlag, readCigarString, mateAlignmentStart, mateReferenceIndex, mateNegStrandFlag,
-                            mateUnmappedFlag, mateCigarString,
-                            firstOfPairFlag, recordNumber);
-                    return new AbstractMap.SimpleEntry(key, rec);
-                } catch (IOException e) {
-                    throw new SAMException("Error reading PairInfo from disk", e);
+                @Override
+                public Map.Entry<String, PairEndInfo> next() {
+                    final Map.Entry<String, long[]> entry = it.next();
+                    return new AbstractMap.SimpleEntry<>(entry.getKey(), new PairEndInfo(entry.getValue()));
                 }
-            }
+            };
         }
     }
 
@@ -0,0 +1,133 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.samtools;
+
+import htsjdk.samtools.cram.CRAIIndex;
+import htsjdk.samtools.seekablestream.SeekableMemoryStream;
+import htsjdk.samtools.seekablestream.SeekableStream;
+import htsjdk.samtools.util.IndexCache;
+import htsjdk.samtools.util.RuntimeIOException;
+
+import java.io.ByteArrayInputStream;
+import java.io.File;
+import java.io.IOException;
+import java.nio.file.Files;
+
+/**
+ * A BAM index held entirely in memory that may be shared by readers on different threads, as stored in the
+ * {@link IndexCache}.  Each reference's index content is parsed the first time it is queried and then kept, and
+ * {@link #close()} does nothing, since the index belongs to the cache rather than to any one reader.
+ */
+class SharedBAMFileIndex extends CachingBAMFileIndex {
+    private final BAMIndexContent[] references;
+    private final boolean[] loaded;
+    private Long startOfLastLinearBin = null;
+
+    private SharedBAMFileIndex(final SeekableStream stream, final SAMSequenceDictionary dictionary) {
+        super(stream, dictionary);
+        final int nReferences = getNumberOfReferences();
+        references = new BAMIndexContent[nReferences];
+        loaded = new boolean[nReferences];
+    }
+
+    /**
+     * Returns the shared index for a BAI or CRAI file, reading it if it is not already in the {@link IndexCache}.
+     * The index type is detected from the file's content rather than its name, and a CRAI index is converted to BAI
+     * form as it is read.
+     */
+    static SharedBAMFileIndex getCachedIndex(final File indexFile, final SAMSequenceDictionary dictionary) {
+        return IndexCache.get(indexFile.toPath(), SharedBAMFileIndex.class, dictionary, () -> readIndex(indexFile, dictionary));
+    }
+
+    private static SharedBAMFileIndex readIndex(final File indexFile, final SAMSequenceDictionary dictionary) {
+        try {
+            final byte[] bytes = Files.readAllBytes(indexFile.toPath());
+            final SeekableStream baiStream;
+            if (startsWith(bytes, SamIndexes.BAI.magic)) {
+                baiStream = new SeekableMemoryStream(bytes, indexFile.getName());
+            } else if (startsWith(bytes, SamIndexes.CRAI.magic)) {
+                baiStream = CRAIIndex.openCraiFileAsBaiStream(new ByteArrayInputStream(bytes), dictionary);
+            } else {
+                throw new SAMFormatException("Index file " + indexFile + " is neither a BAI nor a CRAI index");
+            }
+            return new SharedBAMFileIndex(baiStream, dictionary);
+        } catch (final IOException e) {
+            throw new RuntimeIOException("Unable to read index file " + indexFile, e);
+        }
+    }
+
+    private static boolean startsWith(final byte[] bytes, final byte[] magic) {
+        if (bytes.length < magic.length) {
+            return false;
+        }
+        for (int i = 0; i < magic.length; i++) {
+            if (bytes[i] != magic[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    @Override
+    protected synchronized BAMIndexContent getQueryResults(final int referenceIndex) {
+        if (referenceIndex < 0 || referenceIndex >= references.length) {
+            return null;
+        }
+        if (!loaded[referenceIndex]) {
+            references[referenceIndex] = query(referenceIndex, 1, -1);
+            loaded[referenceIndex] = true;
+        }
+        return references[referenceIndex];
+    }
+
+    @Override
+    public synchronized int getNumberOfReferences() {
+        return super.getNumberOfReferences();
+    }
+
+    @Override
+    public synchronized long getStartOfLastLinearBin() {
+        if (startOfLastLinearBin == null) {
+            startOfLastLinearBin = super.getStartOfLastLinearBin();
+        }
+        return startOfLastLinearBin;
+    }
+
+    @Override
+    public synchronized BAMIndexMetaData getMetaData(final int reference) {
+        return super.getMetaData(reference);
+    }
+
+    @Override
+    public synchronized Long getNoCoordinateCount() {
+        return super.getNoCoordinateCount();
+    }
+
+    /**
+     * Does nothing: the index is shared and owned by the {@link IndexCache}, and holds no file handles.
+     */
+    @Override
+    public void close() {
+    }
+}
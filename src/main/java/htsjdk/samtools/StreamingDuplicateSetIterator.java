@@ -0,0 +1,206 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.samtools;
+
+import htsjdk.samtools.util.CloseableIterator;
+
+import java.util.ArrayDeque;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.Deque;
+import java.util.List;
+import java.util.Map;
+import java.util.NoSuchElementException;
+import java.util.TreeMap;
+
+/**
+ * An iterator of sets of duplicates for coordinate-sorted input that, unlike {@link DuplicateSetIterator}, does not
+ * sort the input into duplicate order first.
+ * <p/>
+ * Records of the current reference are held in buckets keyed by the unclipped 5' position of the read, which is the
+ * first position compared by {@link SAMRecordDuplicateComparator#duplicateSetCompare} after the library.  Once the
+ * input has moved more than {@code windowSize} bases past a bucket no more records can fall into it, so the bucket
+ * is sorted with the comparator and split into duplicate sets exactly as {@link DuplicateSetIterator} would split
+ * the same records.  Only the records of a window are in memory at a time, and the sets come out in order of 5'
+ * position rather than in duplicate order (which puts the library first).
+ * <p/>
+ * {@code windowSize} must therefore be at least as long as the longest leading clip (soft or hard) of a mapped read
+ * in the input.  A record whose 5' position is further before its alignment start arrives after its bucket may have
+ * been emitted, so rather than return different sets than {@link DuplicateSetIterator} would, an exception is thrown
+ * when one is read.  Unmapped reads without a position are never duplicates, and are each returned in a set of their
+ * own, as are unmapped reads placed on the reverse strand, whose 5' position is 0 as they have no alignment end.
+ */
+public class StreamingDuplicateSetIterator implements CloseableIterator<DuplicateSet> {
+    /** The default for how many bases the 5' end of a read may be before its alignment start */
+    public static final int DEFAULT_WINDOW_SIZE = 10000;
+
+    private final CloseableIterator<SAMRecord> iterator;
+    private final SAMRecordDuplicateComparator comparator;
+    private final int windowSize;
+    private final SAMSortOrderChecker sortOrderChecker = new SAMSortOrderChecker(SAMFileHeader.SortOrder.coordinate);
+
+    /** The records of the current reference that are not yet in a set, by 5' position */
+    private final TreeMap<Integer, List<SAMRecord>> buckets = new TreeMap<>();
+    private int currentReferenceIndex = SAMRecord.NO_ALIGNMENT_REFERENCE_INDEX;
+    /** The buckets of the current reference before this position have been emitted */
+    private int emittedBefore = Integer.MIN_VALUE;
+    private final Deque<DuplicateSet> duplicateSets = new ArrayDeque<>();
+
+    public StreamingDuplicateSetIterator(final CloseableIterator<SAMRecord> iterator, final SAMFileHeader header) {
+        this(iterator, header, null, DEFAULT_WINDOW_SIZE);
+    }
+
+    /**
+     * @param iterator   coordinate-sorted records; an exception is thrown during iteration if they are not
+     * @param header     header of the records, used to order libraries if no comparator is given
+     * @param comparator the comparator that defines duplicates, or null for the default comparator of the header
+     * @param windowSize how many bases the 5' end of a read may be before its alignment start, which must be at least
+     *                   the longest leading clip in the input; a {@link SAMException} is thrown during iteration
+     *                   when a read with a longer one is read
+     */
+    public StreamingDuplicateSetIterator(final CloseableIterator<SAMRecord> iterator,
+                                         final SAMFileHeader header,
+                                         final SAMRecordDuplicateComparator comparator,
+                                         final int windowSize) {
+        if (windowSize < 0) {
+            throw new IllegalArgumentException("windowSize must not be negative: " + windowSize);
+        }
+        this.iterator = iterator;
+        this.comparator = (comparator == null) ? new SAMRecordDuplicateComparator(header) : comparator;
+        this.windowSize = windowSize;
+    }
+
+    @Override
+    public boolean hasNext() {
+        while (duplicateSets.isEmpty() && readRecord()) {
+            // keep reading until a set is complete
+        }
+        return !duplicateSets.isEmpty();
+    }
+
+    @Override
+    public DuplicateSet next() {
+        if (!hasNext()) {
+            throw new NoSuchElementException();
+        }
+        return duplicateSets.poll();
+    }
+
+    @Override
+    public void close() {
+        iterator.close();
+    }
+
+    /**
+     * Reads the next record into its bucket and emits the buckets the window has moved past.
+     *
+     * @return false if the input is exhausted and all its records have been emitted
+     */
+    private boolean readRecord() {
+        if (!iterator.hasNext()) {
+            if (buckets.isEmpty()) {
+                return false;
+            }
+            emitAll();
+            return true;
+        }
+
+        final SAMRecord record = iterator.next();
+        final SAMRecord previous = sortOrderChecker.getPreviousRecord();
+        if (!sortOrderChecker.isSorted(record)) {
+            throw new SAMException("The input records were not coordinate sorted:\n" +
+                    previous.getSAMString() + record.getSAMString());
+        }
+
+        final int referenceIndex = record.getReferenceIndex();
+        if (referenceIndex != currentReferenceIndex) {
+            emitAll();
+            currentReferenceIndex = referenceIndex;
+            emittedBefore = Integer.MIN_VALUE;
+        }
+
+        if (referenceIndex == SAMRecord.NO_ALIGNMENT_REFERENCE_INDEX) {
+            emit(Collections.singletonList(record));
+            return true;
+        }
+        if (record.getReadUnmappedFlag() && record.getReadNegativeStrandFlag()) {
+            // has no alignment end, so the comparator puts its 5' end at 0, where no mapped read is its duplicate
+            emit(Collections.singletonList(record));
+            return true;
+        }
+
+        // the same position as SAMRecordDuplicateComparator uses for the read
+        final int position = record.getReadNegativeStrandFlag() ? record.getUnclippedEnd() : record.getUnclippedStart();
+        if (position < emittedBefore) {
+            throw new SAMException("The 5' end of read " + record.getReadName() + " is " +
+                    (record.getAlignmentStart() - position) + " bases before its alignment start, more than the " +
+                    "window of " + windowSize + " bases, so its duplicates may already have been returned; " +
+                    "use a larger window:\n" + record.getSAMString());
+        }
+        buckets.computeIfAbsent(position, p -> new ArrayList<>()).add(record);
+
+        final int windowStart = record.getAlignmentStart() - windowSize;
+        if (windowStart > emittedBefore) {
+            emittedBefore = windowStart;
+            while (!buckets.isEmpty() && buckets.firstKey() < windowStart) {
+                emit(buckets.pollFirstEntry().getValue());
+            }
+        }
+        return true;
+    }
+
+    private void emitAll() {
+        for (final Map.Entry<Integer, List<SAMRecord>> bucket : buckets.entrySet()) {
+            emit(bucket.getValue());
+        }
+        buckets.clear();
+    }
+
+    /**
+     * Splits the records of a bucket into duplicate sets the way {@link DuplicateSetIterator} does: in duplicate
+     * order, a record starts a new set unless it is a duplicate of the representative of the current set, and a set
+     * whose representative is unmapped, secondary or supplementary is not added to.
+     */
+    private void emit(final List<SAMRecord> records) {
+        if (records.size() > 1) {
+            records.sort(comparator);
+        }
+        DuplicateSet duplicateSet = null;
+        for (final SAMRecord record : records) {
+            if (duplicateSet != null) {
+                final SAMRecord representative = duplicateSet.getRepresentative();
+                if (!representative.getReadUnmappedFlag() && !representative.isSecondaryOrSupplementary() &&
+                        duplicateSet.add(record) == 0) {
+                    continue;
+                }
+                duplicateSets.add(duplicateSet);
+            }
+            duplicateSet = new DuplicateSet(comparator);
+            duplicateSet.add(record);
+        }
+        if (duplicateSet != null) {
+            duplicateSets.add(duplicateSet);
+        }
+    }
+}
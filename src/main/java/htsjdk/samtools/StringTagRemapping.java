@@ -0,0 +1,187 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.samtools;
+
+import htsjdk.samtools.util.StringUtil;
+
+import java.io.ByteArrayOutputStream;
+import java.util.Map;
+
+/**
+ * Translation of the values of string (type Z) tags, applied directly to the binary tag block of a
+ * {@link BAMRecord}.  Used by {@link MergingSamRecordIterator} to rename colliding read group and program
+ * group IDs without decoding and re-encoding the attributes of every record.
+ *
+ * For each remapped tag, a value that is mapped to a different string is replaced, a value that is mapped
+ * to itself is kept, and a value that is not in the translation table is removed, which is what
+ * {@link SAMRecord#setAttribute(String, Object)} does when given a null value.
+ */
+final class StringTagRemapping {
+    private final short[] tags;
+    private final Map<String, String>[] translations;
+    private int numTags = 0;
+
+    @SuppressWarnings("unchecked")
+    StringTagRemapping() {
+        this.tags = new short[2];
+        this.translations = new Map[2];
+    }
+
+    /**
+     * @param tag         binary tag whose values should be translated
+     * @param translation map from the original value of the tag to its new value
+     */
+    StringTagRemapping addTag(final short tag, final Map<String, String> translation) {
+        if (numTags == tags.length) {
+            throw new IllegalStateException("Too many remapped tags");
+        }
+        tags[numTags] = tag;
+        translations[numTags] = translation;
+        numTags++;
+        return this;
+    }
+
+    /** Returns the new value for the given tag value, or null if the tag should be removed. */
+    String remap(final short tag, final String value) {
+        final int index = indexOf(tag);
+        return index < 0 ? value : translations[index].get(value);
+    }
+
+    /**
+     * Applies the translation to the tags stored in {@code block} from {@code tagsOffset} to the end.
+     *
+     * @return {@code block} itself if no tag needed to change, otherwise a new array holding the bytes
+     * before {@code tagsOffset} followed by the translated tags.  A truncated or unrecognized tag stops
+     * the scan, leaving the rest of the block as-is for {@link BinaryTagCodec#readTags} to report.
+     */
+    byte[] remap(final byte[] block, final int tagsOffset) {
+        ByteArrayOutputStream out = null;
+        int copiedUpTo = 0;
+        int pos = tagsOffset;
+        while (pos + 3 <= block.length) {
+            final int tagStart = pos;
+            final short tag = (short) ((block[pos] & 0xff) | (block[pos + 1] & 0xff) << 8);
+            final byte tagType = block[pos + 2];
+            pos += 3;
+            final int valueEnd = valueEnd(block, pos, tagType);
+            if (valueEnd < 0) {
+                break;
+            }
+            final int index = indexOf(tag);
+            if (index >= 0 && tagType == 'Z') {
+                final String value = StringUtil.bytesToString(block, pos, valueEnd - pos - 1);
+                final String newValue = translations[index].get(value);
+                if (!value.equals(newValue)) {
+                    if (out == null) {
+                        out = new ByteArrayOutputStream(block.length + 16);
+                    }
+                    out.write(block, copiedUpTo, tagStart - copiedUpTo);
+                    if (newValue != null) {
+                        out.write(block, tagStart, 3);
+                        final byte[] newBytes = StringUtil.stringToBytes(newValue);
+                        out.write(newBytes, 0, newBytes.length);
+                        out.write(0);
+                    }
+                    copiedUpTo = valueEnd;
+                }
+            }
+            pos = valueEnd;
+        }
+        if (out == null) {
+            return block;
+        }
+        out.write(block, copiedUpTo, block.length - copiedUpTo);
+        return out.toByteArray();
+    }
+
+    private int indexOf(final short tag) {
+        for (int i = 0; i < numTags; i++) {
+            if (tags[i] == tag) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /** Returns the offset just past the value of the given type starting at {@code pos}, or -1 if it doesn't fit. */
+    private static int valueEnd(final byte[] block, final int pos, final byte tagType) {
+        final long end;
+        switch (tagType) {
+            case 'A':
+            case 'c':
+            case 'C':
+                end = pos + 1L;
+                break;
+            case 's':
+            case 'S':
+                end = pos + 2L;
+                break;
+            case 'i':
+            case 'I':
+            case 'f':
+                end = pos + 4L;
+                break;
+            case 'Z':
+            case 'H':
+                int terminator = pos;
+                while (terminator < block.length && block[terminator] != 0) {
+                    terminator++;
+                }
+                end = terminator + 1L;
+                break;
+            case 'B':
+                if (pos + 5 > block.length) {
+                    return -1;
+                }
+                final int elementSize = arrayElementSize(block[pos]);
+                final long length = (block[pos + 1] & 0xffL) | (block[pos + 2] & 0xffL) << 8 |
+                        (block[pos + 3] & 0xffL) << 16 | (block[pos + 4] & 0xffL) << 24;
+                if (elementSize < 0) {
+                    return -1;
+                }
+                end = pos + 5L + length * elementSize;
+                break;
+            default:
+                return -1;
+        }
+        return end <= block.length ? (int) end : -1;
+    }
+
+    private static int arrayElementSize(final byte arrayType) {
+        switch (arrayType) {
+            case 'c':
+            case 'C':
+                return 1;
+            case 's':
+            case 'S':
+                return 2;
+            case 'i':
+            case 'I':
+            case 'f':
+                return 4;
+            default:
+                return -1;
+        }
+    }
+}
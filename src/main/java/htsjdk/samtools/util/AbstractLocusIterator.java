@@ -489,6 +489,17 @@ public abstract class AbstractLocusIterator<T extends AbstractRecordAndOffset, K
         }
     }
 
+    /**
+     * @return the reads to iterate over, once {@link #iterator()} has been called
+     */
+    PeekableIterator<SAMRecord> getSamIterator() {
+        return samIterator;
+    }
+
+    ReferenceSequenceMask getReferenceSequenceMask() {
+        return referenceSequenceMask;
+    }
+
     protected SAMSequenceRecord getReferenceSequence(final int referenceSequenceIndex) {
         return samReader.getFileHeader().getSequence(referenceSequenceIndex);
     }
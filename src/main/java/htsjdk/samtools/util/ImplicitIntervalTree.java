@@ -0,0 +1,271 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.samtools.util;
+
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+import java.util.function.IntConsumer;
+
+/**
+ * A static, build-once interval index over closed integer intervals, suitable for very large numbers of
+ * intervals on a single sequence.
+ *
+ * Intervals are stored in flat arrays sorted by start position, and the array itself is interpreted as an implicit
+ * balanced binary tree (node {@code i} is at level {@code k} if the lowest {@code k} bits of {@code i} are all set)
+ * augmented with the maximum end position of each subtree, as in Heng Li's cgranges.  Compared to {@link IntervalTree}
+ * there is no per-interval node object and queries walk contiguous memory, which makes it much cheaper both to hold
+ * and to query millions of intervals.  The price is that the index cannot be modified once built.
+ *
+ * Instances are created with a {@link Builder}:
+ * <pre>{@code
+ *    final ImplicitIntervalTree.Builder<String> builder = new ImplicitIntervalTree.Builder<>();
+ *    builder.add(100, 200, "a");
+ *    builder.add(150, 400, "b");
+ *    final ImplicitIntervalTree<String> tree = builder.build();
+ *    final List<String> hits = tree.getOverlappers(180, 190);
+ * }</pre>
+ *
+ * Overlap is inclusive at both ends, in the same sense as {@link IntervalTree#overlappers(int, int)}.
+ * Instances are immutable and may be queried concurrently from multiple threads.
+ */
+public final class ImplicitIntervalTree<T> {
+    /** Subtrees at or below this level are scanned linearly rather than traversed. */
+    private static final int LINEAR_SCAN_LEVEL = 3;
+    /** Ample for any tree addressable by an int index. */
+    private static final int MAX_STACK_DEPTH = 64;
+
+    private final int[] starts;
+    private final int[] ends;
+    private final int[] maxEnds;
+    private final Object[] values;
+    private final int rootLevel;
+
+    private ImplicitIntervalTree(final int[] starts, final int[] ends, final Object[] values) {
+        this.starts = starts;
+        this.ends = ends;
+        this.values = values;
+        this.maxEnds = new int[starts.length];
+        this.rootLevel = computeMaxEnds(ends, maxEnds);
+    }
+
+    /**
+     * Fills in the per-node maximum end positions bottom-up.
+     * @return the level of the root of the implicit tree, or -1 if there are no intervals
+     */
+    private static int computeMaxEnds(final int[] ends, final int[] maxEnds) {
+        final int n = ends.length;
+        if (n == 0) {
+            return -1;
+        }
+        int lastIndex = 0;
+        int last = 0;
+        for (int i = 0; i < n; i += 2) {
+            lastIndex = i;
+            last = maxEnds[i] = ends[i];
+        }
+        int k = 1;
+        for (; 1L << k <= n; ++k) {
+            final int x = 1 << (k - 1);
+            final long i0 = (x << 1) - 1;
+            final long step = ((long) x) << 2;
+            for (long i = i0; i < n; i += step) {
+                final int node = (int) i;
+                final int leftMax = maxEnds[node - x];
+                final int rightMax = node + (long) x < n ? maxEnds[node + x] : last;
+                maxEnds[node] = Math.max(ends[node], Math.max(leftMax, rightMax));
+            }
+            lastIndex = ((lastIndex >> k) & 1) != 0 ? lastIndex - x : lastIndex + x;
+            if (lastIndex < n && maxEnds[lastIndex] > last) {
+                last = maxEnds[lastIndex];
+            }
+        }
+        return k - 1;
+    }
+
+    /** @return the number of intervals in the index */
+    public int size() {
+        return starts.length;
+    }
+
+    /** @return the start of the i'th interval, in order of increasing start position */
+    public int getStart(final int i) {
+        return starts[i];
+    }
+
+    /** @return the end of the i'th interval, in order of increasing start position */
+    public int getEnd(final int i) {
+        return ends[i];
+    }
+
+    /** @return the value associated with the i'th interval, in order of increasing start position */
+    @SuppressWarnings("unchecked")
+    public T getValue(final int i) {
+        return (T) values[i];
+    }
+
+    /**
+     * Calls the consumer with the index of every interval overlapping [start, end], in order of increasing start.
+     * The index can be passed to {@link #getStart(int)}, {@link #getEnd(int)} and {@link #getValue(int)}.
+     *
+     * @return the number of overlapping intervals
+     */
+    public int forEachOverlapper(final int start, final int end, final IntConsumer consumer) {
+        return query(start, end, consumer, false);
+    }
+
+    /** @return the values of all intervals overlapping [start, end], in order of increasing interval start */
+    public List<T> getOverlappers(final int start, final int end) {
+        final List<T> result = new ArrayList<>();
+        query(start, end, i -> result.add(getValue(i)), false);
+        return result;
+    }
+
+    /** @return true iff any interval overlaps [start, end] */
+    public boolean overlapsAny(final int start, final int end) {
+        return query(start, end, null, true) > 0;
+    }
+
+    /**
+     * Top-down traversal of the implicit tree.  The stack holds (node, level, leftDone) triples packed into longs so
+     * that a query makes a single small allocation.
+     */
+    private int query(final int start, final int end, final IntConsumer consumer, final boolean stopAtFirst) {
+        if (rootLevel < 0) {
+            return 0;
+        }
+        final int n = starts.length;
+        final long[] stack = new long[MAX_STACK_DEPTH];
+        int top = 0;
+        int found = 0;
+        stack[top++] = pack((1L << rootLevel) - 1, rootLevel, false);
+        while (top > 0) {
+            final long z = stack[--top];
+            final long x = unpackNode(z);
+            final int k = unpackLevel(z);
+            if (k <= LINEAR_SCAN_LEVEL) {
+                // small subtree: scan every node in it
+                final long i0 = x >> k << k;
+                final long i1 = Math.min(i0 + (1L << (k + 1)) - 1, n);
+                for (long i = i0; i < i1 && starts[(int) i] <= end; ++i) {
+                    if (start <= ends[(int) i]) {
+                        ++found;
+                        if (stopAtFirst) {
+                            return found;
+                        }
+                        consumer.accept((int) i);
+                    }
+                }
+            } else if (!unpackLeftDone(z)) {
+                // revisit this node after its left child; the left child may lie beyond the end of the array
+                final long left = x - (1L << (k - 1));
+                stack[top++] = pack(x, k, true);
+                if (left >= n || maxEnds[(int) left] >= start) {
+                    stack[top++] = pack(left, k - 1, false);
+                }
+            } else if (x < n && starts[(int) x] <= end) {
+                if (start <= ends[(int) x]) {
+                    ++found;
+                    if (stopAtFirst) {
+                        return found;
+                    }
+                    consumer.accept((int) x);
+                }
+                stack[top++] = pack(x + (1L << (k - 1)), k - 1, false);
+            }
+        }
+        return found;
+    }
+
+    private static long pack(final long node, final int level, final boolean leftDone) {
+        return (node << 8) | ((long) level << 1) | (leftDone ? 1 : 0);
+    }
+
+    private static long unpackNode(final long packed) {
+        return packed >>> 8;
+    }
+
+    private static int unpackLevel(final long packed) {
+        return (int) ((packed >>> 1) & 0x7F);
+    }
+
+    private static boolean unpackLeftDone(final long packed) {
+        return (packed & 1) != 0;
+    }
+
+    /**
+     * Accumulates intervals for an {@link ImplicitIntervalTree}.  Intervals may be added in any order; duplicates are
+     * kept as separate entries.
+     */
+    public static final class Builder<T> {
+        private int[] starts = new int[16];
+        private int[] ends = new int[16];
+        private Object[] values = new Object[16];
+        private int size = 0;
+
+        /** Adds the closed interval [start, end] with the associated value. */
+        public Builder<T> add(final int start, final int end, final T value) {
+            if (size == starts.length) {
+                final int newCapacity = size * 2;
+                starts = Arrays.copyOf(starts, newCapacity);
+                ends = Arrays.copyOf(ends, newCapacity);
+                values = Arrays.copyOf(values, newCapacity);
+            }
+            starts[size] = start;
+            ends[size] = end;
+            values[size] = value;
+            ++size;
+            return this;
+        }
+
+        /** @return the number of intervals added so far */
+        public int size() {
+            return size;
+        }
+
+        /** Sorts the accumulated intervals by start and builds the index.  The builder should not be reused. */
+        public ImplicitIntervalTree<T> build() {
+            // sort (start, insertion order) pairs packed into longs to avoid boxing; the low word is never negative
+            final long[] order = new long[size];
+            for (int i = 0; i < size; i++) {
+                order[i] = ((long) starts[i] << 32) | i;
+            }
+            Arrays.sort(order);
+
+            final int[] sortedStarts = new int[size];
+            final int[] sortedEnds = new int[size];
+            final Object[] sortedValues = new Object[size];
+            for (int i = 0; i < size; i++) {
+                final int from = (int) order[i];
+                sortedStarts[i] = starts[from];
+                sortedEnds[i] = ends[from];
+                sortedValues[i] = values[from];
+            }
+            starts = null;
+            ends = null;
+            values = null;
+            return new ImplicitIntervalTree<>(sortedStarts, sortedEnds, sortedValues);
+        }
+    }
+}
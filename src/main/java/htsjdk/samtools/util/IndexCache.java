@@ -0,0 +1,221 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.samtools.util;
+
+import htsjdk.samtools.Defaults;
+import htsjdk.samtools.seekablestream.SeekableStreamFactory;
+
+import java.io.IOException;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.util.Iterator;
+import java.util.LinkedHashMap;
+import java.util.Map;
+import java.util.Objects;
+import java.util.concurrent.ExecutionException;
+import java.util.concurrent.FutureTask;
+import java.util.function.Supplier;
+
+/**
+ * A bounded, process-wide cache of parsed index files (BAM/CRAM indices opened through
+ * {@link htsjdk.samtools.SamReaderFactory}, tabix indices and tribble indices), so that applications which repeatedly
+ * open the same files, e.g. once per request, only pay for reading and parsing each index once.
+ *
+ * Entries are keyed by the absolute path of the index file together with its size and modification time, so an index
+ * that is rewritten is re-read on next use; entries for the old version simply age out.  At most
+ * {@link #getMaximumSize()} indices are retained, with the least recently used evicted first.  Cached index objects
+ * are shared between readers and are never closed by them, so everything stored here must be safe for concurrent use
+ * and must not hold open file handles.
+ *
+ * The cache is disabled unless {@link Defaults#INDEX_CACHE_SIZE} is positive or {@link #setMaximumSize(int)} is called.
+ * While disabled, {@link #get} simply calls the loader.
+ */
+public final class IndexCache {
+    private static final Log log = Log.getInstance(IndexCache.class);
+
+    private static volatile int maximumSize = Math.max(Defaults.INDEX_CACHE_SIZE, 0);
+
+    private static final LinkedHashMap<Key, FutureTask<Object>> cache = new LinkedHashMap<Key, FutureTask<Object>>(16, 0.75f, true) {
+        @Override
+        protected boolean removeEldestEntry(final Map.Entry<Key, FutureTask<Object>> eldest) {
+            return size() > maximumSize;
+        }
+    };
+
+    private IndexCache() {
+    }
+
+    /** @return true if the cache is retaining indices */
+    public static boolean isEnabled() {
+        return maximumSize > 0;
+    }
+
+    /** @return the maximum number of indices retained */
+    public static int getMaximumSize() {
+        return maximumSize;
+    }
+
+    /**
+     * Sets the maximum number of indices retained, evicting the least recently used entries if there are now too many.
+     * @param size the maximum number of indices to retain, or 0 to disable the cache and discard its contents
+     */
+    public static void setMaximumSize(final int size) {
+        if (size < 0) {
+            throw new IllegalArgumentException("Index cache size must not be negative: " + size);
+        }
+        synchronized (cache) {
+            maximumSize = size;
+            final Iterator<Key> keys = cache.keySet().iterator();
+            for (int excess = cache.size() - size; excess > 0; excess--) {
+                keys.next();
+                keys.remove();
+            }
+        }
+    }
+
+    /** Discards every cached index. */
+    public static void clear() {
+        synchronized (cache) {
+            cache.clear();
+        }
+    }
+
+    /** @return the number of indices currently cached */
+    public static int size() {
+        synchronized (cache) {
+            return cache.size();
+        }
+    }
+
+    /**
+     * Returns the cached index for {@code indexPath}, loading and caching it if necessary.  If several threads ask for
+     * the same index at once it is loaded only once.  If the cache is disabled or the file's size and modification
+     * time cannot be determined, the index is loaded without being cached.
+     *
+     * @param indexPath the index file
+     * @param type the type of the parsed index, which distinguishes different representations of the same file
+     * @param discriminator any further state that the parsed index depends on, such as a sequence dictionary; may be
+     *                      null.  It must implement equals and hashCode.
+     * @param loader reads and parses the index.  Errors are propagated to every caller waiting on the load and the
+     *               failure is not cached.
+     * @return the parsed index
+     */
+    public static <T> T get(final Path indexPath, final Class<T> type, final Object discriminator, final Supplier<? extends T> loader) {
+        if (!isEnabled()) {
+            return loader.get();
+        }
+        final Key key;
+        try {
+            key = new Key(indexPath.toAbsolutePath(), Files.size(indexPath), Files.getLastModifiedTime(indexPath).toMillis(),
+                    type, discriminator);
+        } catch (final IOException | SecurityException e) {
+            log.debug("Not caching index ", indexPath.toUri(), ": ", e.getMessage());
+            return loader.get();
+        }
+
+        final FutureTask<Object> task;
+        boolean mustLoad = false;
+        synchronized (cache) {
+            final FutureTask<Object> existing = cache.get(key);
+            if (existing != null) {
+                task = existing;
+            } else {
+                task = new FutureTask<>(loader::get);
+                cache.put(key, task);
+                mustLoad = true;
+            }
+        }
+        if (mustLoad) {
+            task.run();
+        }
+
+        try {
+            return type.cast(task.get());
+        } catch (final ExecutionException e) {
+            synchronized (cache) {
+                cache.remove(key, task);
+            }
+            final Throwable cause = e.getCause();
+            if (cause instanceof RuntimeException) {
+                throw (RuntimeException) cause;
+            } else if (cause instanceof Error) {
+                throw (Error) cause;
+            }
+            throw new RuntimeException(cause);
+        } catch (final InterruptedException e) {
+            Thread.currentThread().interrupt();
+            throw new RuntimeException("Interrupted while waiting for index " + indexPath.toUri(), e);
+        }
+    }
+
+    /**
+     * @param resource a local file name, or a uri for a {@link Path} file system
+     * @return the resource as a path whose index may be cached, or null if it is a URL (http, https or ftp) or cannot
+     * be represented as a path
+     */
+    public static Path getCacheablePath(final String resource) {
+        if (resource == null || !SeekableStreamFactory.isFilePath(resource)) {
+            return null;
+        }
+        try {
+            return IOUtil.hasScheme(resource) ? IOUtil.getPath(resource) : Paths.get(resource);
+        } catch (final IOException | RuntimeException e) {
+            return null;
+        }
+    }
+
+    private static final class Key {
+        private final Path path;
+        private final long size;
+        private final long lastModified;
+        private final Class<?> type;
+        private final Object discriminator;
+
+        Key(final Path path, final long size, final long lastModified, final Class<?> type, final Object discriminator) {
+            this.path = path;
+            this.size = size;
+            this.lastModified = lastModified;
+            this.type = type;
+            this.discriminator = discriminator;
+        }
+
+        @Override
+        public boolean equals(final Object o) {
+            if (this == o) return true;
+            if (o == null || getClass() != o.getClass()) return false;
+            final Key key = (Key) o;
+            return size == key.size &&
+                    lastModified == key.lastModified &&
+                    path.equals(key.path) &&
+                    type.equals(key.type) &&
+                    Objects.equals(discriminator, key.discriminator);
+        }
+
+        @Override
+        public int hashCode() {
+            return Objects.hash(path, size, lastModified, type, discriminator);
+        }
+    }
+}
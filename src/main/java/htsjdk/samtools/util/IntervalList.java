@@ -580,7 +580,7 @@ public class IntervalList implements Iterable<Interval> {
 
         final IntervalList result = new IntervalList(list1.getHeader().clone());
 
-        final OverlapDetector<Interval> detector = OverlapDetector.create(list1.getIntervals());
+        final OverlapDetector<Interval> detector = OverlapDetector.createFrozen(list1.getIntervals());
 
         for (final Interval i : list2.getIntervals()) {
             detector.getOverlaps(i).stream()
@@ -799,6 +799,7 @@ public class IntervalList implements Iterable<Interval> {
         for (final Interval interval : overlapIntervals.sorted().uniqued()) {
             detector.addLhs(dummy, interval);
         }
+        detector.freeze();
 
         // Go through each input interval in lhs and see if overlaps any interval in rhs
         final IntervalList merged = new IntervalList(header);
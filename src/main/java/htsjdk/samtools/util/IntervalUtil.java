@@ -24,9 +24,16 @@
 package htsjdk.samtools.util;
 
 import htsjdk.samtools.SAMException;
+import htsjdk.samtools.SAMFileHeader;
 import htsjdk.samtools.SAMSequenceDictionary;
+import htsjdk.samtools.SAMSequenceRecord;
+import htsjdk.utils.ValidationUtils;
 
+import java.util.ArrayList;
+import java.util.Collection;
+import java.util.Collections;
 import java.util.Iterator;
+import java.util.List;
 
 /**
  * @author alecw@broadinstitute.org
@@ -74,6 +81,200 @@ public class IntervalUtil {
         }
     }
 
+    /**
+     * Merges any number of coordinate-sorted interval iterators into a single coordinate-sorted iterator in one k-way
+     * pass.  Only one interval per input is held in memory at a time.  Overlapping intervals are not combined; see
+     * {@link #unionSorted(SAMSequenceDictionary, Collection, boolean)} for that.
+     *
+     * @param sequenceDictionary used to determine order of sequences
+     * @param sortedInputs iterators each of which returns intervals in coordinate order
+     * @throws IllegalStateException during iteration if an input is found not to be sorted
+     */
+    public static Iterator<Interval> mergeSorted(final SAMSequenceDictionary sequenceDictionary,
+                                                 final Collection<? extends Iterator<Interval>> sortedInputs) {
+        ValidationUtils.nonNull(sequenceDictionary, "sequenceDictionary");
+        ValidationUtils.nonNull(sortedInputs, "sortedInputs");
+        if (sortedInputs.isEmpty()) {
+            return Collections.emptyIterator();
+        }
+        final List<CloseableIterator<Interval>> inputs = new ArrayList<>(sortedInputs.size());
+        for (final Iterator<Interval> input : sortedInputs) {
+            inputs.add(new DelegatingIterator<>(input));
+        }
+        return new MergingIterator<>(new IntervalCoordinateComparator(new SAMFileHeader(sequenceDictionary)), inputs);
+    }
+
+    /**
+     * Streaming equivalent of {@link IntervalList#union(Collection)}: merges coordinate-sorted inputs and combines
+     * overlapping and abutting intervals as they go by.  Memory use is bounded by the number of intervals that are
+     * being combined into a single output interval.
+     *
+     * @param sequenceDictionary used to determine order of sequences
+     * @param sortedInputs iterators each of which returns intervals in coordinate order
+     * @param concatenateNames if false, each output interval has the name of the first interval combined into it
+     */
+    public static Iterator<Interval> unionSorted(final SAMSequenceDictionary sequenceDictionary,
+                                                 final Collection<? extends Iterator<Interval>> sortedInputs,
+                                                 final boolean concatenateNames) {
+        return new IntervalList.IntervalMergerIterator(mergeSorted(sequenceDictionary, sortedInputs), true, false, concatenateNames);
+    }
+
+    /**
+     * Streaming sweep-line intersection of two coordinate-sorted interval iterators.  The inputs need not be
+     * unique; they are combined on the fly.  Returns the sorted, non-overlapping and non-abutting loci covered by
+     * both inputs, each named after the (first) lhs interval it was derived from.
+     *
+     * @param sequenceDictionary used to determine order of sequences
+     * @throws SAMException during iteration if an input is found not to be sorted
+     */
+    public static Iterator<Interval> intersectSorted(final SAMSequenceDictionary sequenceDictionary,
+                                                     final Iterator<Interval> lhs,
+                                                     final Iterator<Interval> rhs) {
+        final PeekableIterator<Interval> left = uniqueSorted(sequenceDictionary, lhs);
+        final PeekableIterator<Interval> right = uniqueSorted(sequenceDictionary, rhs);
+
+        final Iterator<Interval> overlaps = new AbstractIterator<Interval>() {
+            @Override
+            protected Interval advance() {
+                while (left.hasNext() && right.hasNext()) {
+                    final Interval l = left.peek();
+                    final Interval r = right.peek();
+                    final int order = compareSequences(sequenceDictionary, l, r);
+                    if (order < 0 || (order == 0 && l.getEnd() < r.getStart())) {
+                        left.next();
+                    } else if (order > 0 || r.getEnd() < l.getStart()) {
+                        right.next();
+                    } else {
+                        // consume whichever ends first; the other may overlap further intervals
+                        if (l.getEnd() < r.getEnd()) {
+                            left.next();
+                        } else {
+                            right.next();
+                        }
+                        return new Interval(l.getContig(),
+                                Math.max(l.getStart(), r.getStart()),
+                                Math.min(l.getEnd(), r.getEnd()),
+                                l.isNegativeStrand(),
+                                l.getName());
+                    }
+                }
+                return null;
+            }
+        };
+        // pieces of a single lhs interval can abut if the rhs had abutting intervals
+        return new IntervalList.IntervalMergerIterator(overlaps, true, false, false);
+    }
+
+    /**
+     * Streaming intersection of any number of coordinate-sorted interval iterators, implemented as a chain of
+     * pairwise sweeps so that all inputs are consumed in a single pass.
+     *
+     * @see #intersectSorted(SAMSequenceDictionary, Iterator, Iterator)
+     */
+    public static Iterator<Interval> intersectSorted(final SAMSequenceDictionary sequenceDictionary,
+                                                     final Collection<? extends Iterator<Interval>> sortedInputs) {
+        ValidationUtils.validateArg(!sortedInputs.isEmpty(), "Cannot intersect an empty collection of inputs");
+        final Iterator<? extends Iterator<Interval>> inputs = sortedInputs.iterator();
+        Iterator<Interval> result = uniqueSorted(sequenceDictionary, inputs.next());
+        while (inputs.hasNext()) {
+            result = intersectSorted(sequenceDictionary, result, inputs.next());
+        }
+        return result;
+    }
+
+    /**
+     * Streaming sweep-line subtraction of one coordinate-sorted interval iterator from another.  Returns the sorted,
+     * non-overlapping loci that are in lhs but not in rhs, each named after the lhs interval it was derived from.
+     *
+     * @param sequenceDictionary used to determine order of sequences
+     * @throws SAMException during iteration if an input is found not to be sorted
+     */
+    public static Iterator<Interval> subtractSorted(final SAMSequenceDictionary sequenceDictionary,
+                                                    final Iterator<Interval> lhs,
+                                                    final Iterator<Interval> rhs) {
+        final PeekableIterator<Interval> left = uniqueSorted(sequenceDictionary, lhs);
+        final PeekableIterator<Interval> right = uniqueSorted(sequenceDictionary, rhs);
+
+        return new AbstractIterator<Interval>() {
+            // the part of the current lhs interval that has not yet been emitted or subtracted
+            private Interval remaining = null;
+
+            @Override
+            protected Interval advance() {
+                while (true) {
+                    if (remaining == null) {
+                        if (!left.hasNext()) {
+                            return null;
+                        }
+                        remaining = left.next();
+                    }
+                    while (right.hasNext() && (compareSequences(sequenceDictionary, right.peek(), remaining) < 0 ||
+                            (compareSequences(sequenceDictionary, right.peek(), remaining) == 0 && right.peek().getEnd() < remaining.getStart()))) {
+                        right.next();
+                    }
+                    if (!right.hasNext() || compareSequences(sequenceDictionary, right.peek(), remaining) > 0 ||
+                            right.peek().getStart() > remaining.getEnd()) {
+                        final Interval result = remaining;
+                        remaining = null;
+                        return result;
+                    }
+
+                    final Interval r = right.peek();
+                    final Interval current = remaining;
+                    if (r.getEnd() < current.getEnd()) {
+                        remaining = new Interval(current.getContig(), r.getEnd() + 1, current.getEnd(), current.isNegativeStrand(), current.getName());
+                        right.next();
+                    } else {
+                        // r may also overlap the next lhs interval, so leave it in place
+                        remaining = null;
+                    }
+                    if (r.getStart() > current.getStart()) {
+                        return new Interval(current.getContig(), current.getStart(), r.getStart() - 1, current.isNegativeStrand(), current.getName());
+                    }
+                }
+            }
+        };
+    }
+
+    /** Wraps a sorted iterator so that it returns unique, non-abutting intervals, checking the order as it goes. */
+    private static PeekableIterator<Interval> uniqueSorted(final SAMSequenceDictionary sequenceDictionary, final Iterator<Interval> sorted) {
+        final Iterator<Interval> checked = new AbstractIterator<Interval>() {
+            private Interval previous = null;
+
+            @Override
+            protected Interval advance() {
+                if (!sorted.hasNext()) {
+                    return null;
+                }
+                final Interval interval = sorted.next();
+                if (previous != null) {
+                    final int order = compareSequences(sequenceDictionary, previous, interval);
+                    if (order > 0 || (order == 0 && previous.getStart() > interval.getStart())) {
+                        throw new SAMException("Intervals not in order: " + previous + "; " + interval);
+                    }
+                }
+                previous = interval;
+                return interval;
+            }
+        };
+        return new PeekableIterator<>(new IntervalList.IntervalMergerIterator(checked, true, false, false));
+    }
+
+    private static int compareSequences(final SAMSequenceDictionary sequenceDictionary, final Interval lhs, final Interval rhs) {
+        if (lhs.getContig().equals(rhs.getContig())) {
+            return 0;
+        }
+        return Integer.compare(getSequenceIndex(sequenceDictionary, lhs), getSequenceIndex(sequenceDictionary, rhs));
+    }
+
+    private static int getSequenceIndex(final SAMSequenceDictionary sequenceDictionary, final Interval interval) {
+        final int index = sequenceDictionary.getSequenceIndex(interval.getContig());
+        if (index == SAMSequenceRecord.UNAVAILABLE_SEQUENCE_INDEX) {
+            throw new IllegalArgumentException(String.format("Interval %s is on a contig that is not in the sequence dictionary", interval));
+        }
+        return index;
+    }
+
     public static class IntervalCombiner {
         private boolean combineAbutting = true;
         private boolean concatenateNames = true;
@@ -0,0 +1,206 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.samtools.util;
+
+import htsjdk.samtools.SAMRecord;
+import htsjdk.samtools.SAMSequenceRecord;
+
+import java.util.Arrays;
+
+/**
+ * The bases aligned to one reference position, as passed to the visitor of
+ * {@link SamLocusIterator#forEachPileup(java.util.function.Consumer)}.
+ *
+ * The bases are held in parallel primitive arrays rather than as one {@link SamLocusIterator.RecordAndOffset} per
+ * base, and each LocusPileup is a slot of a ring buffer that is reused for later positions.  A LocusPileup and the
+ * arrays returned by its getters are therefore only valid during the call to the visitor: copy anything that must be
+ * kept.  Only the first {@link #size()} elements of the arrays are meaningful.
+ */
+public final class LocusPileup implements Locus, Locatable {
+    private static final int INITIAL_CAPACITY = 16;
+
+    private SAMSequenceRecord referenceSequence;
+    private int position;
+    private int size = 0;
+
+    private byte[] bases = new byte[INITIAL_CAPACITY];
+    private byte[] qualities = new byte[INITIAL_CAPACITY];
+    private int[] readOffsets = new int[INITIAL_CAPACITY];
+    private boolean[] negativeStrand = new boolean[INITIAL_CAPACITY];
+    private SAMRecord[] records = new SAMRecord[INITIAL_CAPACITY];
+
+    LocusPileup() {
+    }
+
+    /** Empties this pileup and moves it to the given locus */
+    void reset(final SAMSequenceRecord referenceSequence, final int position) {
+        // drop the references to the records of the previous locus so that they can be collected
+        Arrays.fill(records, 0, size, null);
+        this.referenceSequence = referenceSequence;
+        this.position = position;
+        this.size = 0;
+    }
+
+    /**
+     * Adds one aligned base.
+     *
+     * @param record the read
+     * @param readOffset 0-based offset of the base in the read
+     * @param base the base, or 'N' if the read has no bases
+     * @param quality the base quality, or 0 if the read has no qualities
+     */
+    void add(final SAMRecord record, final int readOffset, final byte base, final byte quality) {
+        if (size == bases.length) {
+            final int capacity = size * 2;
+            bases = Arrays.copyOf(bases, capacity);
+            qualities = Arrays.copyOf(qualities, capacity);
+            readOffsets = Arrays.copyOf(readOffsets, capacity);
+            negativeStrand = Arrays.copyOf(negativeStrand, capacity);
+            records = Arrays.copyOf(records, capacity);
+        }
+        bases[size] = base;
+        qualities[size] = quality;
+        readOffsets[size] = readOffset;
+        negativeStrand[size] = record.getReadNegativeStrandFlag();
+        records[size] = record;
+        size++;
+    }
+
+    /**
+     * @return the number of bases aligned to the position
+     */
+    public int size() {
+        return size;
+    }
+
+    /**
+     * @return <code>true</code> if no bases are aligned to the position
+     */
+    public boolean isEmpty() {
+        return size == 0;
+    }
+
+    /** @return the i'th base aligned to the position */
+    public byte getBase(final int i) {
+        checkIndex(i);
+        return bases[i];
+    }
+
+    /** @return the quality of the i'th base aligned to the position */
+    public byte getBaseQuality(final int i) {
+        checkIndex(i);
+        return qualities[i];
+    }
+
+    /** @return the 0-based offset in its read of the i'th base aligned to the position */
+    public int getReadOffset(final int i) {
+        checkIndex(i);
+        return readOffsets[i];
+    }
+
+    /** @return true if the read of the i'th base aligned to the position is on the negative strand */
+    public boolean isNegativeStrand(final int i) {
+        checkIndex(i);
+        return negativeStrand[i];
+    }
+
+    /** @return the read of the i'th base aligned to the position */
+    public SAMRecord getRecord(final int i) {
+        checkIndex(i);
+        return records[i];
+    }
+
+    /** @return the bases aligned to the position.  The array is shared and longer than {@link #size()}. */
+    public byte[] getBases() {
+        return bases;
+    }
+
+    /** @return the qualities of the bases aligned to the position.  The array is shared and longer than {@link #size()}. */
+    public byte[] getBaseQualities() {
+        return qualities;
+    }
+
+    /** @return the read offsets of the bases aligned to the position.  The array is shared and longer than {@link #size()}. */
+    public int[] getReadOffsets() {
+        return readOffsets;
+    }
+
+    /** @return the strands of the bases aligned to the position.  The array is shared and longer than {@link #size()}. */
+    public boolean[] getNegativeStrands() {
+        return negativeStrand;
+    }
+
+    private void checkIndex(final int i) {
+        if (i < 0 || i >= size) {
+            throw new IndexOutOfBoundsException("Index " + i + " is out of range for a pileup of " + size + " bases");
+        }
+    }
+
+    /**
+     * @return the reference sequence to which the bases are aligned
+     */
+    public SAMSequenceRecord getReferenceSequence() {
+        return referenceSequence;
+    }
+
+    @Override
+    public int getSequenceIndex() {
+        return referenceSequence.getSequenceIndex();
+    }
+
+    /**
+     * @return 1-based reference position
+     */
+    @Override
+    public int getPosition() {
+        return position;
+    }
+
+    /**
+     * @return the name of reference sequence
+     */
+    public String getSequenceName() {
+        return referenceSequence.getSequenceName();
+    }
+
+    @Override
+    public String getContig() {
+        return getSequenceName();
+    }
+
+    @Override
+    public int getStart() {
+        return position;
+    }
+
+    @Override
+    public int getEnd() {
+        return position;
+    }
+
+    @Override
+    public String toString() {
+        return referenceSequence.getSequenceName() + ":" + position;
+    }
+}
@@ -0,0 +1,219 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.samtools.util;
+
+import htsjdk.samtools.AlignmentBlock;
+import htsjdk.samtools.SAMException;
+import htsjdk.samtools.SAMRecord;
+import htsjdk.samtools.SAMSequenceRecord;
+
+import java.util.Iterator;
+import java.util.function.Consumer;
+
+/**
+ * Accumulates the aligned bases of coordinate-sorted reads into {@link LocusPileup}s and passes each locus to a
+ * visitor, for {@link SamLocusIterator#forEachPileup(Consumer)}.
+ *
+ * The loci that reads are still being accumulated into are the slots of a ring buffer, from the start of the latest
+ * read to the end of the longest read overlapping it.  Slots are reused once their locus has been visited, so after
+ * the buffer has grown to the depth and span of the data no objects are allocated per read or per base.  Loci are
+ * visited in the same order and with the same filtering as the {@link SamLocusIterator} they are configured from.
+ */
+final class LocusPileupWalker {
+    private static final int INITIAL_CAPACITY = 1024;
+
+    private final AbstractLocusIterator<?, ?> locusIterator;
+    private final ReferenceSequenceMask referenceSequenceMask;
+    private final Consumer<LocusPileup> visitor;
+    private final int qualityScoreCutoff;
+    private final int mappingQualityScoreCutoff;
+    private final boolean includeNonPfReads;
+    private final boolean emitUncoveredLoci;
+    private final int maxReadsToAccumulatePerLocus;
+
+    /** Slots for the loci being accumulated; the length is always a power of 2 */
+    private LocusPileup[] ring;
+    /** Index in ring of the slot for windowStart */
+    private int head = 0;
+    /** Number of loci being accumulated, from windowStart on windowSequence */
+    private int windowSize = 0;
+    private SAMSequenceRecord windowSequence = null;
+    private int windowStart = 0;
+
+    /** Reused for the zero-coverage loci that are visited when emitting uncovered loci */
+    private final LocusPileup uncovered = new LocusPileup();
+    /** The last locus that has been visited or passed over */
+    private int lastSequenceIndex = 0;
+    private int lastPosition = 0;
+
+    private boolean enforcedAccumulationLimit = false;
+
+    LocusPileupWalker(final AbstractLocusIterator<?, ?> locusIterator, final Consumer<LocusPileup> visitor) {
+        this.locusIterator = locusIterator;
+        this.referenceSequenceMask = locusIterator.getReferenceSequenceMask();
+        this.visitor = visitor;
+        this.qualityScoreCutoff = locusIterator.getQualityScoreCutoff();
+        this.mappingQualityScoreCutoff = locusIterator.getMappingQualityScoreCutoff();
+        this.includeNonPfReads = locusIterator.isIncludeNonPfReads();
+        this.emitUncoveredLoci = locusIterator.isEmitUncoveredLoci();
+        this.maxReadsToAccumulatePerLocus = locusIterator.getMaxReadsToAccumulatePerLocus();
+        this.ring = newSlots(INITIAL_CAPACITY);
+    }
+
+    /**
+     * Visits every locus covered by the given reads, and every uncovered locus if emitting uncovered loci.
+     *
+     * @param records coordinate-sorted reads, already filtered by the iterator's SamRecordFilters
+     */
+    void walk(final Iterator<SAMRecord> records) {
+        while (records.hasNext()) {
+            final SAMRecord rec = records.next();
+
+            // unmapped reads without a reference index are sorted after all of the mapped reads
+            if (rec.getReferenceIndex() == -1) {
+                break;
+            }
+            if (rec.getReadUnmappedFlag()
+                    || rec.getMappingQuality() < mappingQualityScoreCutoff
+                    || (!includeNonPfReads && rec.getReadFailsVendorQualityCheckFlag())) {
+                continue;
+            }
+
+            final int sequenceIndex = rec.getReferenceIndex();
+            final int alignmentStart = rec.getAlignmentStart();
+            if (sequenceIndex < lastSequenceIndex || (sequenceIndex == lastSequenceIndex && alignmentStart <= lastPosition)) {
+                throw new SAMException("Records are not coordinate sorted: " + rec.getReadName() + " at " +
+                        rec.getReferenceName() + ":" + alignmentStart + " is before a locus that has already been visited");
+            }
+
+            // no more reads can overlap the loci before the start of this one.  As in AbstractLocusIterator the
+            // locus just before the start is kept, and is the one that maxReadsToAccumulatePerLocus applies to.
+            visitBefore(sequenceIndex, alignmentStart - 1);
+
+            if (windowSize > 0 && ring[head].size() >= maxReadsToAccumulatePerLocus) {
+                if (!enforcedAccumulationLimit) {
+                    AbstractLocusIterator.LOG.warn("We have encountered greater than " + maxReadsToAccumulatePerLocus + " reads at position " + ring[head] + " and will ignore the remaining reads at this position.  Note that further warnings will be suppressed.");
+                    enforcedAccumulationLimit = true;
+                }
+                continue;
+            }
+            accumulate(rec);
+        }
+        visitBefore(Integer.MAX_VALUE, Integer.MAX_VALUE);
+    }
+
+    private void accumulate(final SAMRecord rec) {
+        if (windowSize == 0) {
+            windowSequence = locusIterator.getReferenceSequence(rec.getReferenceIndex());
+            windowStart = rec.getAlignmentStart();
+        }
+        extendWindow(rec.getAlignmentEnd());
+
+        final byte[] bases = rec.getReadBases();
+        final byte[] qualities = rec.getBaseQualities();
+        final int mask = ring.length - 1;
+        for (final AlignmentBlock alignmentBlock : rec.getAlignmentBlocks()) {
+            // 0-based offset into the read of the first base of the block
+            final int readStart = alignmentBlock.getReadStart() - 1;
+            final int blockStartIndex = head + alignmentBlock.getReferenceStart() - windowStart;
+            for (int i = 0; i < alignmentBlock.getLength(); ++i) {
+                final int readOffset = readStart + i;
+                final byte quality = qualities.length == 0 ? 0 : qualities[readOffset];
+                if (qualities.length == 0 || quality >= qualityScoreCutoff) {
+                    final byte base = bases.length == 0 ? (byte) 'N' : bases[readOffset];
+                    ring[(blockStartIndex + i) & mask].add(rec, readOffset, base, quality);
+                }
+            }
+        }
+    }
+
+    /** Makes sure that there are slots for all the loci from windowStart to end, growing the ring if necessary */
+    private void extendWindow(final int end) {
+        final int needed = end - windowStart + 1;
+        if (needed <= windowSize) {
+            return;
+        }
+        if (needed > ring.length) {
+            final LocusPileup[] grown = newSlots(Integer.highestOneBit(needed - 1) << 1);
+            for (int i = 0; i < ring.length; i++) {
+                grown[i] = ring[(head + i) & (ring.length - 1)];
+            }
+            ring = grown;
+            head = 0;
+        }
+        for (int i = windowSize; i < needed; i++) {
+            ring[(head + i) & (ring.length - 1)].reset(windowSequence, windowStart + i);
+        }
+        windowSize = needed;
+    }
+
+    private static LocusPileup[] newSlots(final int capacity) {
+        final LocusPileup[] slots = new LocusPileup[capacity];
+        for (int i = 0; i < capacity; i++) {
+            slots[i] = new LocusPileup();
+        }
+        return slots;
+    }
+
+    /** Visits all the loci before the given one, covered or not */
+    private void visitBefore(final int sequenceIndex, final int position) {
+        while (windowSize > 0 && (windowSequence.getSequenceIndex() < sequenceIndex || windowStart < position)) {
+            final int windowSequenceIndex = windowSequence.getSequenceIndex();
+            visitUncoveredBefore(windowSequenceIndex, windowStart);
+            final LocusPileup pileup = ring[head];
+            // only visit loci that are in the mask (or we have no mask!)
+            if ((emitUncoveredLoci || !pileup.isEmpty()) && referenceSequenceMask.get(windowSequenceIndex, windowStart)) {
+                visitor.accept(pileup);
+            }
+            pileup.reset(null, 0);
+            lastSequenceIndex = windowSequenceIndex;
+            lastPosition = windowStart;
+            head = (head + 1) & (ring.length - 1);
+            windowStart++;
+            windowSize--;
+        }
+        visitUncoveredBefore(sequenceIndex, position);
+    }
+
+    /** If emitting uncovered loci, visits the loci of the mask after the last visited locus and before the given one */
+    private void visitUncoveredBefore(final int sequenceIndex, final int position) {
+        if (!emitUncoveredLoci) {
+            return;
+        }
+        while (lastSequenceIndex <= sequenceIndex && lastSequenceIndex <= referenceSequenceMask.getMaxSequenceIndex()) {
+            final int next = referenceSequenceMask.nextPosition(lastSequenceIndex, lastPosition);
+            if (next == -1 || (lastSequenceIndex == sequenceIndex && next >= position)) {
+                if (lastSequenceIndex == sequenceIndex) {
+                    return;
+                }
+                lastSequenceIndex++;
+                lastPosition = 0;
+            } else {
+                uncovered.reset(locusIterator.getReferenceSequence(lastSequenceIndex), next);
+                visitor.accept(uncovered);
+                lastPosition = next;
+            }
+        }
+    }
+}
@@ -0,0 +1,158 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.samtools.util;
+
+import java.util.Arrays;
+import java.util.Comparator;
+import java.util.List;
+import java.util.function.ToLongFunction;
+
+/**
+ * A tournament tree of losers for k-way merges: holds the next element (the head) of each of k sorted sources and
+ * finds the smallest of them.  Replacing the head of the winning source with the source's next element replays only
+ * the matches on the path from that source to the root, so costs at most ceil(log2 k) comparisons, against about
+ * twice that for a binary heap.
+ *
+ * Ties are broken by source index, so a merge is stable with respect to the order of its sources.  A null head
+ * marks a source that is exhausted, which loses to every other source.
+ *
+ * Optionally, a long key may be given that orders elements consistently with the comparator, i.e. if key(a) &lt;
+ * key(b) then a sorts before b.  The key of each head is computed once, and the comparator is then only called for
+ * heads with equal keys.
+ *
+ * @param <T> the type of the elements being merged
+ */
+public final class LoserTree<T> {
+    private final Comparator<? super T> comparator;
+    private final ToLongFunction<? super T> key;
+    private final int k;
+    private final Object[] heads;
+    private final long[] keys;
+    /** tree[0] is the source of the overall winner, and tree[i] for 0 &lt; i &lt; k the loser of the match at node i */
+    private final int[] tree;
+
+    /**
+     * @param heads      the first element of each source, or null for a source with no elements
+     * @param comparator the order of the elements
+     */
+    public LoserTree(final List<? extends T> heads, final Comparator<? super T> comparator) {
+        this(heads, comparator, null);
+    }
+
+    /**
+     * @param heads      the first element of each source, or null for a source with no elements
+     * @param comparator the order of the elements
+     * @param key        a key of the elements that is consistent with comparator, or null to use only the comparator
+     */
+    public LoserTree(final List<? extends T> heads, final Comparator<? super T> comparator, final ToLongFunction<? super T> key) {
+        if (heads.isEmpty()) throw new IllegalArgumentException("At least one source is required");
+        this.comparator = comparator;
+        this.key = key;
+        this.k = heads.size();
+        this.heads = heads.toArray();
+        this.keys = new long[k];
+        this.tree = new int[k];
+        for (int i = 0; i < k; i++) {
+            if (key != null && this.heads[i] != null) {
+                keys[i] = key.applyAsLong(heads.get(i));
+            }
+        }
+        // -1 is a placeholder that beats every source, and is pushed up and out of the tree as the sources are added
+        Arrays.fill(tree, -1);
+        for (int source = k - 1; source >= 0; source--) {
+            replay(source);
+        }
+    }
+
+    /** @return the number of sources, including exhausted ones */
+    public int numSources() {
+        return k;
+    }
+
+    /** @return true if every source is exhausted */
+    public boolean isEmpty() {
+        return heads[tree[0]] == null;
+    }
+
+    /** @return the index of the source with the smallest head, or of an exhausted source if they all are */
+    public int peekSource() {
+        return tree[0];
+    }
+
+    /** @return the smallest head, or null if every source is exhausted */
+    @SuppressWarnings("unchecked")
+    public T peek() {
+        return (T) heads[tree[0]];
+    }
+
+    /** @return the head of the given source, or null if it is exhausted */
+    @SuppressWarnings("unchecked")
+    public T getHead(final int source) {
+        return (T) heads[source];
+    }
+
+    /**
+     * Replaces the smallest head, typically with the next element of its source, and finds the new smallest head.
+     *
+     * @param next the new head of source {@link #peekSource()}, or null if the source is exhausted
+     * @return the head that was replaced
+     */
+    public T replaceTop(final T next) {
+        final int source = tree[0];
+        final T previous = peek();
+        heads[source] = next;
+        if (key != null && next != null) {
+            keys[source] = key.applyAsLong(next);
+        }
+        replay(source);
+        return previous;
+    }
+
+    /** Plays the source against the losers on its path to the root, leaving the overall winner in tree[0] */
+    private void replay(int winner) {
+        for (int node = (winner + k) >>> 1; node > 0; node >>>= 1) {
+            final int opponent = tree[node];
+            if (opponent == -1 || (winner != -1 && beats(opponent, winner))) {
+                tree[node] = winner;
+                winner = opponent;
+            }
+        }
+        tree[0] = winner;
+    }
+
+    /** @return true if the head of source a sorts before that of source b */
+    @SuppressWarnings("unchecked")
+    private boolean beats(final int a, final int b) {
+        final Object headA = heads[a];
+        final Object headB = heads[b];
+        if (headA == null || headB == null) {
+            return headB == null && (headA != null || a < b);
+        }
+        if (key != null && keys[a] != keys[b]) {
+            return keys[a] < keys[b];
+        }
+        final int cmp = comparator.compare((T) headA, (T) headB);
+        return cmp < 0 || (cmp == 0 && a < b);
+    }
+}
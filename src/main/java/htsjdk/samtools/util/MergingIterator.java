@@ -23,45 +23,27 @@
  */
 package htsjdk.samtools.util;
 
+import java.util.ArrayList;
 import java.util.Collection;
 import java.util.Comparator;
-import java.util.Iterator;
+import java.util.List;
 import java.util.NoSuchElementException;
-import java.util.PriorityQueue;
 
 /**
  * An iterator over Iterators that return Ts. Calling next() returns the next T ordered according
  * to Comparator provided at construction time. Importantly, the elements in the input Iterators
- * must already be sorted according to the provided Comparator.
+ * must already be sorted according to the provided Comparator.  Elements that compare equal are
+ * returned in the order of the input Iterators.
  */
 public class MergingIterator<T> implements CloseableIterator<T> {
 
-	/*
-	 * An Iterator whose natural ordering is by the T that will be returned by the next call to
-	 * next().
-	 */
-	private class ComparableIterator extends PeekableIterator<T> implements Comparable<ComparableIterator> {
-
-		public ComparableIterator(final Iterator<T> iterator) {
-			super(iterator);
-		}
-
-		@Override
-		public int compareTo(final ComparableIterator that) {
-			if (comparator.getClass() != comparator.getClass()) {
-				throw new IllegalStateException("Can't compare two ComparableIterators that have different orderings.");
-			}
-
-			return comparator.compare(this.peek(), that.peek());
-		}
-	}
+	private final List<CloseableIterator<T>> iterators;
 
 	/*
-	 * The general flow is to pull the "top" (according to the ComparableIterator's compareTo())
-	 * iterator off on calls to this.next(), get iterator.next() and then re-add the iterator to
-	 * the queue. Readding reorders the queue so the next "top" iterator is ready.
+	 * Holds the next T of each iterator. On calls to this.next(), the smallest one is returned
+	 * and replaced with the next T of its iterator.
 	 */
-	private final PriorityQueue<ComparableIterator> queue;
+	private final LoserTree<T> tree;
 
 	private final Comparator<T> comparator;
 
@@ -69,6 +51,8 @@ public class MergingIterator<T> implements CloseableIterator<T> {
 	// always return correctly ordered Ts.
 	private T lastReturned;
 
+	private boolean closed = false;
+
 	/**
 	 * Creates a MergingIterator over the given Collection of iterators whose elements will be
 	 * returned in the order defined by the given Comparator.
@@ -77,28 +61,25 @@ public class MergingIterator<T> implements CloseableIterator<T> {
 		if (iterators.isEmpty()) throw new IllegalArgumentException("One or more CloseableIterators must be provided.");
 
 		this.comparator = comparator;
+		this.iterators = new ArrayList<>(iterators);
 
-		this.queue = new PriorityQueue<ComparableIterator>();
-		for (final CloseableIterator<T> iterator : iterators) {
-			this.addIfNotEmpty(new ComparableIterator(iterator));
+		final List<T> heads = new ArrayList<>(this.iterators.size());
+		for (final CloseableIterator<T> iterator : this.iterators) {
+			heads.add(nextOrClose(iterator));
 		}
-
-		// If there are no iterators to read from after adding them all to the prioqueue,
-		// should we throw? it's prob'ly an error.
+		this.tree = new LoserTree<>(heads, comparator);
 	}
 
 	@Override
 	public boolean hasNext() {
-		return ! this.queue.isEmpty();
+		return !this.closed && !this.tree.isEmpty();
 	}
 
 	@Override
 	public T next() {
 		if ( ! this.hasNext()) throw new NoSuchElementException();
 
-		final ComparableIterator recordIterator = this.queue.poll();
-		// Assumes the iterator is closed & removed from the queue before recordIterator.hasNext() == false
-		final T next = recordIterator.next();
+		final T next = this.tree.replaceTop(nextOrClose(this.iterators.get(this.tree.peekSource())));
 		// I don't like having to test for null here -- it's really only null before the first call
 		// to next() -- but I don't see any other way
 		if (this.lastReturned != null && this.comparator.compare(lastReturned, next) > 0) {
@@ -107,7 +88,6 @@ public class MergingIterator<T> implements CloseableIterator<T> {
 							this.comparator.getClass().getName());
 		}
 
-		addIfNotEmpty(recordIterator);
 		this.lastReturned = next;
 		return next;
 	}
@@ -126,16 +106,20 @@ public class MergingIterator<T> implements CloseableIterator<T> {
 	 */
 	@Override
 	public void close() {
-		final Iterator<ComparableIterator> iterator = this.queue.iterator();
-		while (iterator.hasNext()) {
-			final ComparableIterator subIterator = iterator.next();
-			subIterator.close();
-			iterator.remove();
+		if (this.closed) return;
+		this.closed = true;
+		// exhausted iterators have already been closed
+		for (int i = 0; i < this.iterators.size(); i++) {
+			if (this.tree.getHead(i) != null) {
+				this.iterators.get(i).close();
+			}
 		}
 	}
 
-	private void addIfNotEmpty(final ComparableIterator iterator) {
-		if (iterator.hasNext()) queue.offer(iterator);
-		else iterator.close();
+	/** Returns the next T of the iterator, or closes it and returns null if it has none */
+	private T nextOrClose(final CloseableIterator<T> iterator) {
+		if (iterator.hasNext()) return iterator.next();
+		iterator.close();
+		return null;
 	}
 }
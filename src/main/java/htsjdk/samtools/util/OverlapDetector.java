@@ -37,9 +37,14 @@ import java.util.function.BiFunction;
  *
  *    boolean anyOverlap = detector.overlapsAny(query); //faster API for checking presence of any overlap
  * }</pre>
+ *
+ * Once all mappings have been added, {@link #freeze()} can be called to convert the detector to a read-only,
+ * array-backed {@link ImplicitIntervalTree} per sequence, which uses much less memory and is much faster to query
+ * when there are many mappings.  {@link #createFrozen(List)} does both steps at once.
  */
 public class OverlapDetector<T> {
     private final Map<Object, IntervalTree<Set<T>>> cache = new HashMap<>();
+    private Map<String, ImplicitIntervalTree<T>> frozen = null;
     private final int lhsBuffer;
     private final int rhsBuffer;
 
@@ -64,6 +69,46 @@ public class OverlapDetector<T> {
         return detector;
     }
 
+    /**
+     * Creates a new frozen OverlapDetector with no trim and the given set of intervals.
+     * @see #freeze()
+     */
+    public static <T extends Locatable> OverlapDetector<T> createFrozen(final List<T> intervals) {
+        final OverlapDetector<T> detector = create(intervals);
+        detector.freeze();
+        return detector;
+    }
+
+    /**
+     * Converts the contents of this detector into a static, array-backed index and releases the mutable trees.
+     * Queries on a frozen detector return the same results as before, but no further mappings may be added.
+     *
+     * @return this detector
+     */
+    public OverlapDetector<T> freeze() {
+        if (frozen != null) {
+            return this;
+        }
+        final Map<String, ImplicitIntervalTree<T>> index = new HashMap<>(this.cache.size() * 2);
+        for (final Map.Entry<Object, IntervalTree<Set<T>>> entry : this.cache.entrySet()) {
+            final ImplicitIntervalTree.Builder<T> builder = new ImplicitIntervalTree.Builder<>();
+            for (final IntervalTree.Node<Set<T>> node : entry.getValue()) {
+                for (final T object : node.getValue()) {
+                    builder.add(node.getStart(), node.getEnd(), object);
+                }
+            }
+            index.put((String) entry.getKey(), builder.build());
+        }
+        this.cache.clear();
+        this.frozen = index;
+        return this;
+    }
+
+    /** @return true if {@link #freeze()} has been called on this detector */
+    public boolean isFrozen() {
+        return frozen != null;
+    }
+
     /** Adds a Locatable to the set of Locatables against which to match candidates. */
     public void addLhs(final T object, final Locatable interval) {
         if (object == null) {
@@ -72,6 +117,9 @@ public class OverlapDetector<T> {
         if (interval == null) {
             throw new IllegalArgumentException("null interval");
         }
+        if (frozen != null) {
+            throw new IllegalStateException("Cannot add to an OverlapDetector after it has been frozen");
+        }
         final String seqId = interval.getContig();
 
         IntervalTree<Set<T>> tree = this.cache.get(seqId);
@@ -129,6 +177,14 @@ public class OverlapDetector<T> {
      */
     public Set<T> getAll() {
         final Set<T> all = new HashSet<>();
+        if (frozen != null) {
+            for (final ImplicitIntervalTree<T> tree : this.frozen.values()) {
+                for (int i = 0; i < tree.size(); i++) {
+                    all.add(tree.getValue(i));
+                }
+            }
+            return all;
+        }
         for (final IntervalTree<Set<T>> tree : this.cache.values()) {
             for (IntervalTree.Node<Set<T>> node : tree) {
                 all.addAll(node.getValue());
@@ -150,12 +206,18 @@ public class OverlapDetector<T> {
             throw new IllegalArgumentException("null locatable");
         }
         final String seqId = locatable.getContig();
+        final int start = locatable.getStart() + this.rhsBuffer;
+        final int end   = locatable.getEnd()   - this.rhsBuffer;
+
+        if (frozen != null) {
+            final ImplicitIntervalTree<T> index = this.frozen.get(seqId);
+            return index != null && start <= end && index.overlapsAny(start, end);
+        }
+
         final IntervalTree<Set<T>> tree = this.cache.get(seqId);
         if (tree == null) {
             return false;
         }
-        final int start = locatable.getStart() + this.rhsBuffer;
-        final int end   = locatable.getEnd()   - this.rhsBuffer;
 
         if (start > end) {
             return false;
@@ -180,12 +242,23 @@ public class OverlapDetector<T> {
             throw new IllegalArgumentException("null locatable");
         }
         final String seqId = locatable.getContig();
+        final int start = locatable.getStart() + this.rhsBuffer;
+        final int end   = locatable.getEnd()   - this.rhsBuffer;
+
+        if (frozen != null) {
+            final ImplicitIntervalTree<T> index = this.frozen.get(seqId);
+            if (index == null || start > end) {
+                return Collections.emptySet();
+            }
+            final Set<T> matches = new HashSet<>();
+            index.forEachOverlapper(start, end, i -> matches.add(index.getValue(i)));
+            return matches;
+        }
+
         final IntervalTree<Set<T>> tree = this.cache.get(seqId);
         if (tree == null) {
             return Collections.emptySet();
         }
-        final int start = locatable.getStart() + this.rhsBuffer;
-        final int end   = locatable.getEnd()   - this.rhsBuffer;
 
         if (start > end) {
             return Collections.emptySet();
@@ -28,6 +28,7 @@ import htsjdk.samtools.*;
 import java.util.ArrayList;
 import java.util.Collections;
 import java.util.List;
+import java.util.function.Consumer;
 
 /**
  * Iterator that traverses a SAM File, accumulating information on a per-locus basis.
@@ -77,6 +78,23 @@ public class SamLocusIterator extends AbstractLocusIterator<SamLocusIterator.Rec
         super(samReader, intervalList, useIndex);
     }
 
+    /**
+     * Passes each locus to the given visitor, as an alternative to iterating over <code>LocusInfo</code>s.
+     * The loci visited and the reads and bases included are the same as for iteration, but the bases at each locus are
+     * accumulated into the primitive arrays of a reused {@link LocusPileup} instead of one <code>RecordAndOffset</code>
+     * per base, so this is much cheaper when only the bases, qualities, offsets or strands are needed.
+     * Insertions and deletions are not reported, even if {@link #isIncludeIndels()}.
+     * <p>
+     * The <code>LocusPileup</code> is only valid during the call to the visitor.  This may be called instead of
+     * {@link #iterator()}, not as well, and this iterator should be closed afterwards.
+     *
+     * @param visitor called with the pileup of each locus, in order
+     */
+    public void forEachPileup(final Consumer<LocusPileup> visitor) {
+        iterator();
+        new LocusPileupWalker(this, visitor).walk(getSamIterator());
+    }
+
     /**
      * Capture the loci covered by the given SAMRecord in the LocusInfos in the accumulator,
      * creating new LocusInfos as needed. RecordAndOffset object are created for each aligned base of
@@ -480,15 +480,21 @@ public class SequenceUtil {
             int mismatches = 0;
 
             final byte[] readBases = read.getReadBases();
+            final boolean negativeStrand = read.getReadNegativeStrandFlag();
+            final boolean exactMatch = !bisulfiteSequence && !matchAmbiguousRef;
 
             for (final AlignmentBlock block : read.getAlignmentBlocks()) {
                 final int readBlockStart = block.getReadStart() - 1;
                 final int referenceBlockStart = block.getReferenceStart() - 1 - referenceOffset;
                 final int length = block.getLength();
 
+                if (exactMatch) {
+                    mismatches += countMismatches(readBases, readBlockStart, referenceBases, referenceBlockStart, length);
+                    continue;
+                }
                 for (int i = 0; i < length; ++i) {
                     if (!basesMatch(readBases[readBlockStart + i], referenceBases[referenceBlockStart + i],
-                            read.getReadNegativeStrandFlag(), bisulfiteSequence, matchAmbiguousRef)) {
+                            negativeStrand, bisulfiteSequence, matchAmbiguousRef)) {
                         ++mismatches;
                     }
                 }
@@ -499,6 +505,34 @@ public class SequenceUtil {
         }
     }
 
+    /**
+     * Counts the positions at which two ranges of bases differ, according to {@link #basesEqual(byte, byte)}.
+     * Identical bytes, by far the most common case when comparing a read to the reference, are passed over
+     * without looking up their IUPAC codes, so this is much cheaper than calling basesEqual for each base.
+     *
+     * @param readBases       the read bases
+     * @param readStart       0-based offset of the first read base to compare
+     * @param referenceBases  the reference bases
+     * @param referenceStart  0-based offset of the first reference base to compare
+     * @param length          the number of bases to compare
+     */
+    public static int countMismatches(final byte[] readBases, final int readStart,
+                                      final byte[] referenceBases, final int referenceStart, final int length) {
+        int mismatches = 0;
+        for (int i = 0; i < length; ++i) {
+            final byte readBase = readBases[readStart + i];
+            final byte refBase = referenceBases[referenceStart + i];
+            if ((readBase != refBase || !isInBasesArray(readBase)) && !basesEqual(readBase, refBase)) {
+                ++mismatches;
+            }
+        }
+        return mismatches;
+    }
+
+    private static boolean isInBasesArray(final byte base) {
+        return base >= 0 && base < BASES_ARRAY_LENGTH;
+    }
+
     /**
      * Calculates the number of mismatches between the read and the reference sequence provided.
      *
@@ -558,20 +592,22 @@ public class SequenceUtil {
                     ") <= referenceOffset(" + referenceOffset + ")");
         }
 
+        final boolean negativeStrand = read.getReadNegativeStrandFlag();
         for (final AlignmentBlock block : read.getAlignmentBlocks()) {
             final int readBlockStart = block.getReadStart() - 1;
             final int referenceBlockStart = block.getReferenceStart() - 1 - referenceOffset;
             final int length = block.getLength();
 
             for (int i = 0; i < length; ++i) {
+                final byte readBase = readBases[readBlockStart + i];
+                final byte refBase = referenceBases[referenceBlockStart + i];
                 if (!bisulfiteSequence) {
-                    if (!basesEqual(readBases[readBlockStart + i], referenceBases[referenceBlockStart + i])) {
+                    if ((readBase != refBase || !isInBasesArray(readBase)) && !basesEqual(readBase, refBase)) {
                         qualities += readQualities[readBlockStart + i];
                     }
 
                 } else {
-                    if (!bisulfiteBasesEqual(read.getReadNegativeStrandFlag(), readBases[readBlockStart + i],
-                            referenceBases[referenceBlockStart + i])) {
+                    if (!bisulfiteBasesEqual(negativeStrand, readBase, refBase)) {
                         qualities += readQualities[readBlockStart + i];
                     }
                 }
@@ -982,22 +1018,20 @@ public class SequenceUtil {
             final CigarOperator op = ce.getOperator();
             if (op == CigarOperator.MATCH_OR_MISMATCH || op == CigarOperator.EQ
                     || op == CigarOperator.X) {
-                for (inBlockOffset = 0; inBlockOffset < blockLength; ++inBlockOffset) {
-                    final int readOffset = blockReadStart + inBlockOffset;
-
-                    if (ref.length <= blockRefPos + inBlockOffset) break; // out of boundary
-
-                    final byte readBase = seq[readOffset];
-                    final byte refBase = ref[blockRefPos + inBlockOffset];
-
-                    if ((bases[readBase] == bases[refBase]) || readBase == 0) {
-                        // a match
-                        ++matchCount;
-                    } else {
+                // stop at the end of the reference if the block runs off it
+                final int inBounds = Math.max(0, Math.min(blockLength, ref.length - blockRefPos));
+                inBlockOffset = 0;
+                while (inBlockOffset < inBounds) {
+                    final int matches = countMdMatches(seq, blockReadStart + inBlockOffset,
+                            ref, blockRefPos + inBlockOffset, inBounds - inBlockOffset);
+                    matchCount += matches;
+                    inBlockOffset += matches;
+                    if (inBlockOffset < inBounds) {
                         mdString.append(matchCount);
-                        mdString.appendCodePoint(refBase);
+                        mdString.appendCodePoint(ref[blockRefPos + inBlockOffset]);
                         matchCount = 0;
                         ++nmCount;
+                        ++inBlockOffset;
                     }
                 }
                 if (inBlockOffset < blockLength) break;
@@ -1028,6 +1062,23 @@ public class SequenceUtil {
         if (calcNM) record.setAttribute(SAMTag.NM, nmCount);
     }
 
+    /**
+     * @return the number of bases from the given offsets up to the first mismatch, or length if there is none, where
+     * as for MD and NM bases match if they have the same IUPAC code or the read base is 0
+     */
+    private static int countMdMatches(final byte[] readBases, final int readStart,
+                                      final byte[] referenceBases, final int referenceStart, final int length) {
+        for (int i = 0; i < length; ++i) {
+            final byte readBase = readBases[readStart + i];
+            final byte refBase = referenceBases[referenceStart + i];
+            if ((readBase != refBase || !isInBasesArray(readBase))
+                    && !(bases[readBase] == bases[refBase] || readBase == 0)) {
+                return i;
+            }
+        }
+        return length;
+    }
+
     public static byte upperCase(final byte base) {
         return base >= a ? (byte) (base - (a - A)) : base;
     }
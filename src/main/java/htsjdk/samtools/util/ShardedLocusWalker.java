@@ -0,0 +1,364 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.samtools.util;
+
+import htsjdk.samtools.SAMException;
+import htsjdk.samtools.SAMFileHeader;
+import htsjdk.samtools.SAMSequenceRecord;
+import htsjdk.samtools.SamReader;
+import htsjdk.utils.ValidationUtils;
+
+import java.io.Closeable;
+import java.util.ArrayDeque;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.Deque;
+import java.util.Iterator;
+import java.util.List;
+import java.util.NoSuchElementException;
+import java.util.concurrent.ArrayBlockingQueue;
+import java.util.concurrent.BlockingQueue;
+import java.util.concurrent.ConcurrentLinkedQueue;
+import java.util.concurrent.ExecutionException;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.concurrent.TimeUnit;
+import java.util.function.BiFunction;
+import java.util.function.Supplier;
+
+/**
+ * Walks the loci of an indexed, coordinate-sorted SAM/BAM/CRAM in parallel, by splitting the reference (or a list
+ * of intervals) into shards of at most a given number of loci and running a locus iterator over each shard on a pool
+ * of threads.
+ *
+ * The locus iterator for a shard is made by the given factory from a reader and an IntervalList holding just that
+ * shard, e.g. <code>(reader, shard) -&gt; new SamLocusIterator(reader, shard, true)</code>, and can be configured there
+ * as usual.  Because the reads are fetched by an indexed query for the shard, reads that straddle a shard boundary are
+ * seen by the iterators of both shards, but each locus is only returned by the shard that contains it.  The only
+ * visible difference from walking the whole input with one iterator is that maxReadsToAccumulatePerLocus is applied
+ * separately within each shard.
+ *
+ * Each thread keeps reusing the readers it has opened from the given supplier, so at most one reader per thread is
+ * open at once; they are closed by {@link #close()}.
+ *
+ * The results can either be reduced per shard, with {@link #reduceShards(BiFunction)}, or returned in genomic order
+ * by {@link #iterator()}, which walks a bounded number of shards ahead of the caller, each of which buffers a bounded
+ * number of loci, so that memory use does not depend on the shard size.
+ *
+ * @param <K> the type of locus returned by the locus iterators
+ */
+public final class ShardedLocusWalker<K> implements Closeable {
+    /** The default maximum number of loci in a shard */
+    public static final int DEFAULT_SHARD_SIZE = 1_000_000;
+
+    /** The number of loci passed from a worker to {@link #iterator()} at a time */
+    private static final int LOCI_PER_CHUNK = 1024;
+    /** The maximum number of chunks of loci of a shard waiting for {@link #iterator()} */
+    private static final int CHUNKS_PER_SHARD = 4;
+
+    private final Supplier<SamReader> readerSupplier;
+    private final BiFunction<SamReader, IntervalList, ? extends CloseableIterator<K>> iteratorFactory;
+    private final SAMFileHeader header;
+    private final List<Interval> shards;
+    private final int numThreads;
+    private final ExecutorService executor;
+    private final ConcurrentLinkedQueue<SamReader> idleReaders = new ConcurrentLinkedQueue<>();
+    private final List<SamReader> allReaders = Collections.synchronizedList(new ArrayList<>());
+    private boolean closed = false;
+
+    /**
+     * @param readerSupplier opens a new reader of the input, which must be indexed
+     * @param iteratorFactory makes the locus iterator for a shard, from a reader and an interval list of the shard
+     * @param intervals the loci to walk, or null for the whole reference
+     * @param numThreads the number of shards walked at once
+     * @param shardSize the maximum number of loci in a shard
+     */
+    public ShardedLocusWalker(final Supplier<SamReader> readerSupplier,
+                              final BiFunction<SamReader, IntervalList, ? extends CloseableIterator<K>> iteratorFactory,
+                              final IntervalList intervals, final int numThreads, final int shardSize) {
+        ValidationUtils.nonNull(readerSupplier, "readerSupplier");
+        ValidationUtils.nonNull(iteratorFactory, "iteratorFactory");
+        ValidationUtils.validateArg(numThreads > 0, "numThreads must be positive");
+        ValidationUtils.validateArg(shardSize > 0, "shardSize must be positive");
+        this.readerSupplier = readerSupplier;
+        this.iteratorFactory = iteratorFactory;
+
+        final SamReader reader = readerSupplier.get();
+        if (!reader.hasIndex()) {
+            CloserUtil.close(reader);
+            throw new IllegalArgumentException("Sharded locus iteration requires an indexed input");
+        }
+        this.header = reader.getFileHeader();
+        idleReaders.add(reader);
+        allReaders.add(reader);
+
+        this.shards = makeShards(intervals != null ? intervals : wholeReference(header), shardSize);
+        this.numThreads = numThreads;
+        this.executor = Executors.newFixedThreadPool(numThreads, r -> {
+            final Thread t = Executors.defaultThreadFactory().newThread(r);
+            t.setDaemon(true);
+            return t;
+        });
+    }
+
+    private static IntervalList wholeReference(final SAMFileHeader header) {
+        final IntervalList intervals = new IntervalList(header);
+        for (final SAMSequenceRecord sequence : header.getSequenceDictionary().getSequences()) {
+            intervals.add(new Interval(sequence.getSequenceName(), 1, sequence.getSequenceLength()));
+        }
+        return intervals;
+    }
+
+    /** Splits the uniqued intervals into pieces of at most shardSize loci, in genomic order */
+    private static List<Interval> makeShards(final IntervalList intervals, final int shardSize) {
+        final List<Interval> shards = new ArrayList<>();
+        for (final Interval interval : intervals.uniqued().getIntervals()) {
+            for (long start = interval.getStart(); start <= interval.getEnd(); start += shardSize) {
+                final int end = (int) Math.min(interval.getEnd(), start + shardSize - 1);
+                shards.add(new Interval(interval.getContig(), (int) start, end));
+            }
+        }
+        return Collections.unmodifiableList(shards);
+    }
+
+    /**
+     * @return the shards, in genomic order
+     */
+    public List<Interval> getShards() {
+        return shards;
+    }
+
+    /**
+     * Runs the reducer over the loci of each shard, in parallel.
+     *
+     * @param reducer called with each shard and the loci in it, on a worker thread, so it must be thread-safe
+     * @return the result of the reducer for each shard, in the order of {@link #getShards()}
+     */
+    public <R> List<R> reduceShards(final BiFunction<Interval, Iterator<K>, R> reducer) {
+        checkNotClosed();
+        final List<Future<R>> futures = new ArrayList<>(shards.size());
+        try {
+            for (final Interval shard : shards) {
+                futures.add(executor.submit(() -> walkShard(shard, reducer)));
+            }
+            final List<R> results = new ArrayList<>(shards.size());
+            for (final Future<R> future : futures) {
+                results.add(getResult(future));
+            }
+            return results;
+        } finally {
+            futures.forEach(f -> f.cancel(false));
+        }
+    }
+
+    /**
+     * Returns all the loci, in genomic order.  Up to twice as many shards as there are threads are walked ahead of the
+     * caller, each of which stops once a few thousand of its loci are waiting to be returned.  Closing the returned
+     * iterator abandons the shards that are in flight.
+     */
+    public CloseableIterator<K> iterator() {
+        checkNotClosed();
+        return new OrderedLocusIterator();
+    }
+
+    private <R> R walkShard(final Interval shard, final BiFunction<Interval, Iterator<K>, R> reducer) {
+        SamReader reader = idleReaders.poll();
+        if (reader == null) {
+            reader = readerSupplier.get();
+            allReaders.add(reader);
+        }
+        try {
+            final IntervalList shardList = new IntervalList(header);
+            shardList.add(shard);
+            try (final CloseableIterator<K> loci = iteratorFactory.apply(reader, shardList)) {
+                return reducer.apply(shard, loci);
+            }
+        } finally {
+            idleReaders.add(reader);
+        }
+    }
+
+    private static <R> R getResult(final Future<R> future) {
+        try {
+            return future.get();
+        } catch (final InterruptedException e) {
+            Thread.currentThread().interrupt();
+            throw new SAMException("Interrupted while walking loci", e);
+        } catch (final ExecutionException e) {
+            if (e.getCause() instanceof Error) {
+                throw (Error) e.getCause();
+            }
+            if (e.getCause() instanceof RuntimeException) {
+                throw (RuntimeException) e.getCause();
+            }
+            throw new SAMException("Error walking loci", e.getCause());
+        }
+    }
+
+    private void checkNotClosed() {
+        if (closed) {
+            throw new IllegalStateException("ShardedLocusWalker has been closed");
+        }
+    }
+
+    /**
+     * Stops the worker threads and closes the readers.
+     */
+    @Override
+    public void close() {
+        if (!closed) {
+            closed = true;
+            executor.shutdownNow();
+            try {
+                // readers may still be in use by a shard that is being abandoned
+                executor.awaitTermination(1, TimeUnit.MINUTES);
+            } catch (final InterruptedException e) {
+                Thread.currentThread().interrupt();
+            }
+            synchronized (allReaders) {
+                allReaders.forEach(CloserUtil::close);
+            }
+        }
+    }
+
+    /** Walks shards on the pool, passing their loci back through a bounded queue per shard, and returns them in shard order */
+    private final class OrderedLocusIterator implements CloseableIterator<K> {
+        private final Iterator<Interval> nextShard = shards.iterator();
+        private final Deque<ShardLoci> pending = new ArrayDeque<>();
+        private Iterator<K> current = Collections.emptyIterator();
+        private boolean iteratorClosed = false;
+
+        @Override
+        public boolean hasNext() {
+            if (iteratorClosed) {
+                return false;
+            }
+            while (!current.hasNext()) {
+                submitShards();
+                if (pending.isEmpty()) {
+                    return false;
+                }
+                final List<K> chunk = pending.getFirst().take();
+                if (chunk.isEmpty()) {
+                    // the shard is done; raise any error from walking it
+                    getResult(pending.removeFirst().future);
+                } else {
+                    current = chunk.iterator();
+                }
+            }
+            return true;
+        }
+
+        private void submitShards() {
+            while (pending.size() < 2 * numThreads && nextShard.hasNext()) {
+                final Interval shard = nextShard.next();
+                final ShardLoci shardLoci = new ShardLoci();
+                shardLoci.future = executor.submit(() -> {
+                    try {
+                        return walkShard(shard, (s, loci) -> {
+                            shardLoci.fill(loci);
+                            return null;
+                        });
+                    } finally {
+                        shardLoci.finish();
+                    }
+                });
+                pending.add(shardLoci);
+            }
+        }
+
+        @Override
+        public K next() {
+            if (!hasNext()) {
+                throw new NoSuchElementException();
+            }
+            return current.next();
+        }
+
+        @Override
+        public void close() {
+            if (!iteratorClosed) {
+                iteratorClosed = true;
+                for (final ShardLoci shardLoci : pending) {
+                    shardLoci.abandoned = true;
+                    shardLoci.future.cancel(false);
+                }
+                pending.clear();
+                current = Collections.emptyIterator();
+            }
+        }
+    }
+
+    /**
+     * The loci of a shard, passed in chunks from the worker walking it to {@link OrderedLocusIterator}, which the
+     * worker waits for when too many are waiting.  An empty chunk marks the end of the shard.
+     */
+    private final class ShardLoci {
+        private final BlockingQueue<List<K>> chunks = new ArrayBlockingQueue<>(CHUNKS_PER_SHARD);
+        private volatile boolean abandoned = false;
+        private Future<?> future;
+
+        /** Called on the worker to pass all of the loci of the shard to the caller, unless it is abandoned */
+        void fill(final Iterator<K> loci) {
+            List<K> chunk = new ArrayList<>(LOCI_PER_CHUNK);
+            while (!abandoned && loci.hasNext()) {
+                chunk.add(loci.next());
+                if (chunk.size() == LOCI_PER_CHUNK) {
+                    put(chunk);
+                    chunk = new ArrayList<>(LOCI_PER_CHUNK);
+                }
+            }
+            if (!chunk.isEmpty()) {
+                put(chunk);
+            }
+        }
+
+        /** Called on the worker once it is done with the shard, whether or not walking it succeeded */
+        void finish() {
+            put(Collections.emptyList());
+        }
+
+        private void put(final List<K> chunk) {
+            try {
+                // the caller may abandon the shard rather than take any more chunks, so wait for it in steps
+                while (!abandoned && !chunks.offer(chunk, 100, TimeUnit.MILLISECONDS)) {
+                }
+            } catch (final InterruptedException e) {
+                Thread.currentThread().interrupt();
+                throw new SAMException("Interrupted while walking loci", e);
+            }
+        }
+
+        /** Called by the caller to take the next chunk of loci, which is empty at the end of the shard */
+        List<K> take() {
+            try {
+                return chunks.take();
+            } catch (final InterruptedException e) {
+                Thread.currentThread().interrupt();
+                throw new SAMException("Interrupted while walking loci", e);
+            }
+        }
+    }
+}
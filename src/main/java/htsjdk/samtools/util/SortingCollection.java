@@ -37,10 +37,8 @@ import java.util.ArrayList;
 import java.util.Arrays;
 import java.util.Collection;
 import java.util.Comparator;
-import java.util.Iterator;
 import java.util.List;
 import java.util.NoSuchElementException;
-import java.util.TreeSet;
 
 /**
  * Collection to which many records can be added.  After all records are added, the collection can be
@@ -490,31 +488,27 @@ public class SortingCollection<T> implements Iterable<T> {
      * This iterator automatically closes when it iterates to the end, but if not iterating
      * to the end it is a good idea to call close().
      * <p>
-     * Algorithm: MergingIterator maintains a PriorityQueue of PeekFileRecordIterators.
-     * Each PeekFileRecordIterator iterates through a file in which the records are sorted.
-     * The comparator for PeekFileRecordIterator used by the PriorityQueue peeks at the next record from
-     * the file, so the first element in the PriorityQueue is the file that has the next record to be emitted.
-     * In order to get the next record, the first PeekFileRecordIterator in the PriorityQueue is popped,
-     * the record is obtained from that iterator, and then if that iterator is not empty, it is pushed back into
-     * the PriorityQueue.  Because it now has a different record as its next element, it may go into another
-     * location in the PriorityQueue
+     * Algorithm: MergingIterator holds the next record of each file in a {@link LoserTree}, which finds the file
+     * with the smallest next record, breaking ties by the order of the files.  In order to get the next record, the
+     * smallest record is taken from the tree and replaced by the next record of its file, or by null if the file
+     * is exhausted, which replays only the comparisons on the path from that file to the root of the tree.
      */
     class MergingIterator implements CloseableIterator<T> {
-        private final TreeSet<PeekFileRecordIterator> queue;
+        private final List<FileRecordIterator> iterators;
+        private final LoserTree<T> tree;
+        private boolean closed = false;
 
         MergingIterator() {
-            this.queue = new TreeSet<>(new PeekFileRecordIteratorComparator());
-            int n = 0;
             log.debug(String.format("Creating merging iterator from %d files", files.size()));
             int suggestedBufferSize = checkMemoryAndAdjustBuffer(files.size());
+            this.iterators = new ArrayList<>(files.size());
+            final List<T> heads = new ArrayList<>(files.size());
             for (final Path f : files) {
                 final FileRecordIterator it = new FileRecordIterator(f, suggestedBufferSize);
-                if (it.hasNext()) {
-                    this.queue.add(new PeekFileRecordIterator(it, n++));
-                } else {
-                    it.close();
-                }
+                this.iterators.add(it);
+                heads.add(nextOrClose(it));
             }
+            this.tree = new LoserTree<>(heads, comparator);
         }
 
         // Since we need to open and buffer all temp files in the sorting collection at once it is important
@@ -551,7 +545,7 @@ public class SortingCollection<T> implements Iterable<T> {
 
         @Override
         public boolean hasNext() {
-            return !this.queue.isEmpty();
+            return !closed && !this.tree.isEmpty();
         }
 
         @Override
@@ -559,16 +553,7 @@ public class SortingCollection<T> implements Iterable<T> {
             if (!hasNext()) {
                 throw new NoSuchElementException();
             }
-
-            final PeekFileRecordIterator fileIterator = queue.pollFirst();
-            final T ret = fileIterator.next();
-            if (fileIterator.hasNext()) {
-                this.queue.add(fileIterator);
-            } else {
-                ((CloseableIterator<T>) fileIterator.getUnderlyingIterator()).close();
-            }
-
-            return ret;
+            return this.tree.replaceTop(nextOrClose(this.iterators.get(this.tree.peekSource())));
         }
 
         @Override
@@ -578,11 +563,25 @@ public class SortingCollection<T> implements Iterable<T> {
 
         @Override
         public void close() {
-            while (!this.queue.isEmpty()) {
-                final PeekFileRecordIterator it = this.queue.pollFirst();
-                ((CloseableIterator<T>) it.getUnderlyingIterator()).close();
+            if (closed) {
+                return;
+            }
+            closed = true;
+            // exhausted files have already been closed
+            for (int i = 0; i < this.iterators.size(); i++) {
+                if (this.tree.getHead(i) != null) {
+                    this.iterators.get(i).close();
+                }
             }
         }
+
+        private T nextOrClose(final FileRecordIterator it) {
+            if (it.hasNext()) {
+                return it.next();
+            }
+            it.close();
+            return null;
+        }
     }
 
     /**
@@ -635,26 +634,4 @@ public class SortingCollection<T> implements Iterable<T> {
             CloserUtil.close(this.is);
         }
     }
-
-
-    /**
-     * Just a typedef
-     */
-    class PeekFileRecordIterator extends PeekIterator<T> {
-        final int n; // A serial number used for tie-breaking in the sort
-
-        PeekFileRecordIterator(final Iterator<T> underlyingIterator, final int n) {
-            super(underlyingIterator);
-            this.n = n;
-        }
-    }
-
-    class PeekFileRecordIteratorComparator implements Comparator<PeekFileRecordIterator> {
-        @Override
-        public int compare(final PeekFileRecordIterator lhs, final PeekFileRecordIterator rhs) {
-            final int result = comparator.compare(lhs.peek(), rhs.peek());
-            if (result == 0) return lhs.n - rhs.n;
-            else return result;
-        }
-    }
 }
@@ -23,9 +23,11 @@
  */
 package htsjdk.tribble;
 
+import htsjdk.samtools.Defaults;
 import htsjdk.samtools.seekablestream.SeekableStream;
 import htsjdk.samtools.seekablestream.SeekableStreamFactory;
 import htsjdk.samtools.util.IOUtil;
+import htsjdk.samtools.util.IndexCache;
 import htsjdk.samtools.util.RuntimeIOException;
 import htsjdk.tribble.index.Block;
 import htsjdk.tribble.index.Index;
@@ -39,6 +41,7 @@ import java.io.InputStream;
 import java.net.URI;
 import java.net.URLEncoder;
 import java.nio.channels.SeekableByteChannel;
+import java.nio.file.Path;
 import java.util.ArrayList;
 import java.util.Iterator;
 import java.util.List;
@@ -126,7 +129,7 @@ public class TribbleIndexedFeatureReader<T extends Feature, SOURCE> extends Abst
                                        Function<SeekableByteChannel, SeekableByteChannel> indexWrapper) throws IOException {
         this(featureFile, codec, false, wrapper, indexWrapper); // required to read the header
         if (indexFile != null && ParsingUtils.resourceExists(indexFile)) {
-            index = IndexFactory.loadIndex(indexFile, indexWrapper);
+            index = readIndex(indexFile);
             this.needCheckForIndex = false;
         } else {
             if (requireIndex) {
@@ -160,17 +163,32 @@ public class TribbleIndexedFeatureReader<T extends Feature, SOURCE> extends Abst
     private void loadIndex() throws IOException {
         String indexFile = Tribble.indexFile(this.path);
         if (ParsingUtils.resourceExists(indexFile)) {
-            index = IndexFactory.loadIndex(indexFile, indexWrapper);
+            index = readIndex(indexFile);
         } else {
             // See if the index itself is gzipped
             indexFile = ParsingUtils.appendToPath(indexFile, ".gz");
             if (ParsingUtils.resourceExists(indexFile)) {
-                index = IndexFactory.loadIndex(indexFile, indexWrapper);
+                index = readIndex(indexFile);
             }
         }
         this.needCheckForIndex = false;
     }
 
+    /**
+     * Reads the index.  If the index is a local or {@link java.nio.file.Path} resource that is read without a wrapper,
+     * it is shared through the {@link IndexCache} when that is enabled, and is read lazily if either the cache or
+     * {@link Defaults#LAZY_LOAD_TRIBBLE_INDEX} is enabled.
+     */
+    private Index readIndex(final String indexFile) {
+        final Path indexPath = indexWrapper == null ? IndexCache.getCacheablePath(indexFile) : null;
+        if (indexPath != null && IndexCache.isEnabled()) {
+            return IndexCache.get(indexPath, Index.class, null, () -> IndexFactory.loadIndexLazily(indexPath));
+        } else if (indexPath != null && Defaults.LAZY_LOAD_TRIBBLE_INDEX) {
+            return IndexFactory.loadIndexLazily(indexPath);
+        }
+        return IndexFactory.loadIndex(indexFile, indexWrapper);
+    }
+
     /**
      * Get a seekable stream appropriate to read information from the current feature path
      * <p/>
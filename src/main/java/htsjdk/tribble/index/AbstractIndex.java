@@ -27,8 +27,13 @@ import htsjdk.tribble.util.LittleEndianInputStream;
 import htsjdk.tribble.util.LittleEndianOutputStream;
 
 import java.io.BufferedOutputStream;
+import java.io.EOFException;
 import java.io.File;
 import java.io.IOException;
+import java.io.InputStream;
+import java.nio.BufferUnderflowException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.nio.file.Files;
 import java.nio.file.Path;
 import java.util.ArrayList;
@@ -93,10 +98,22 @@ public abstract class AbstractIndex implements MutableIndex {
     private LinkedHashMap<String, String> properties;
 
     /**
-     * the map of our chromosome bins
+     * the map of our chromosome bins.  For an index read with {@link #readLazily(int, ByteBuffer)} this only holds the
+     * chromosomes loaded so far; subclasses must call {@link #loadAllChrIndices()} before iterating over it.
      */
     protected LinkedHashMap<String, ChrIndex> chrIndices;
 
+    /**
+     * For a lazily read index, the offset of each chromosome's serialized index within {@link #lazySource}, in file
+     * order.  null once every chromosome has been loaded, or if the index was read eagerly.
+     */
+    private volatile LinkedHashMap<String, Integer> chrIndexOffsets = null;
+
+    /**
+     * The serialized index that chromosomes are lazily loaded from.
+     */
+    private ByteBuffer lazySource = null;
+
     /**
      * Any flags we're using
      */
@@ -115,6 +132,8 @@ public abstract class AbstractIndex implements MutableIndex {
         }
 
         final AbstractIndex other = (AbstractIndex) obj;
+        loadAllChrIndices();
+        other.loadAllChrIndices();
 
         if (version != other.version) {
             System.err.printf("equals version: this %d != other %d%n", version, other.version);
@@ -254,7 +273,8 @@ public abstract class AbstractIndex implements MutableIndex {
 
     @Override
     public boolean containsChromosome(final String chr) {
-        return chrIndices.containsKey(chr);
+        final Map<String, Integer> offsets = chrIndexOffsets;
+        return offsets != null ? offsets.containsKey(chr) : chrIndices.containsKey(chr);
     }
 
     public void finalizeIndex() {
@@ -339,7 +359,8 @@ public abstract class AbstractIndex implements MutableIndex {
 
     @Override
     public List<String> getSequenceNames() {
-        return new ArrayList<String>(chrIndices.keySet());
+        final Map<String, Integer> offsets = chrIndexOffsets;
+        return new ArrayList<String>(offsets != null ? offsets.keySet() : chrIndices.keySet());
     }
 
     @Override
@@ -357,7 +378,7 @@ public abstract class AbstractIndex implements MutableIndex {
      * @throws IllegalArgumentException if {@code chr} not found
      */
     private final ChrIndex getChrIndex(final String chr) {
-        final ChrIndex chrIdx = chrIndices.get(chr);
+        final ChrIndex chrIdx = lookupChrIndex(chr);
         if (chrIdx == null) {
             throw new IllegalArgumentException("getBlocks() called with of unknown contig " + chr);
         } else {
@@ -365,8 +386,62 @@ public abstract class AbstractIndex implements MutableIndex {
         }
     }
 
+    /**
+     * @return the ChrIndex for chr, loading it first if this index is being read lazily, or null if chr is unknown
+     */
+    private synchronized ChrIndex lookupChrIndex(final String chr) {
+        ChrIndex chrIdx = chrIndices.get(chr);
+        if (chrIdx == null && chrIndexOffsets != null) {
+            final Integer offset = chrIndexOffsets.get(chr);
+            if (offset != null) {
+                chrIdx = loadChrIndex(chr, offset);
+                chrIndices.put(chr, chrIdx);
+            }
+        }
+        return chrIdx;
+    }
+
+    /**
+     * Ensures that every chromosome of a lazily read index has been loaded into {@link #chrIndices}, in file order,
+     * and releases the underlying buffer.  Does nothing for an index that was read eagerly or built in memory.
+     */
+    protected synchronized void loadAllChrIndices() {
+        if (chrIndexOffsets == null) {
+            return;
+        }
+        final LinkedHashMap<String, ChrIndex> all = new LinkedHashMap<String, ChrIndex>(chrIndexOffsets.size() * 2);
+        for (final Map.Entry<String, Integer> entry : chrIndexOffsets.entrySet()) {
+            final ChrIndex loaded = chrIndices.get(entry.getKey());
+            all.put(entry.getKey(), loaded != null ? loaded : loadChrIndex(entry.getKey(), entry.getValue()));
+        }
+        chrIndices = all;
+        lazySource = null;
+        chrIndexOffsets = null;
+    }
+
+    private ChrIndex loadChrIndex(final String chr, final int offset) {
+        final ByteBuffer source = lazySource.duplicate();
+        source.position(offset);
+        final ChrIndex chrIdx = newChrIndex();
+        try {
+            chrIdx.read(new LittleEndianInputStream(new ByteBufferInputStream(source)));
+        } catch (final IOException e) {
+            throw new TribbleException("Unable to read index for contig " + chr, e);
+        }
+        return chrIdx;
+    }
+
+    private ChrIndex newChrIndex() {
+        try {
+            return (ChrIndex) getChrIndexClass().newInstance();
+        } catch (final InstantiationException | IllegalAccessException e) {
+            throw new TribbleException.UnableToCreateCorrectIndexType("Unable to create class " + getChrIndexClass(), e);
+        }
+    }
+
     @Override
     public void write(final LittleEndianOutputStream stream) throws IOException {
+        loadAllChrIndices();
         writeHeader(stream);
 
         //# of chromosomes
@@ -400,15 +475,11 @@ public abstract class AbstractIndex implements MutableIndex {
             chrIndices = new LinkedHashMap<String, ChrIndex>(nChromosomes);
 
             while (nChromosomes-- > 0) {
-                final ChrIndex chrIdx = (ChrIndex) getChrIndexClass().newInstance();
+                final ChrIndex chrIdx = newChrIndex();
                 chrIdx.read(dis);
                 chrIndices.put(chrIdx.getName(), chrIdx);
             }
 
-        } catch (final InstantiationException e) {
-            throw new TribbleException.UnableToCreateCorrectIndexType("Unable to create class " + getChrIndexClass(), e);
-        } catch (final IllegalAccessException e) {
-            throw new TribbleException.UnableToCreateCorrectIndexType("Unable to create class " + getChrIndexClass(), e);
         } finally {
             dis.close();
         }
@@ -416,6 +487,114 @@ public abstract class AbstractIndex implements MutableIndex {
         //printIndexInfo();
     }
 
+    /**
+     * Reads the index header, including the magic number and type, from {@code buffer} along with a table of where
+     * each chromosome's index starts, but does not decode the per-chromosome indices.  Each chromosome is decoded the
+     * first time it is queried, so opening a large index to look up a single region only pays for that region's
+     * chromosome.  The buffer, typically a read-only memory mapping of the index file, is retained until every
+     * chromosome has been loaded and must not be modified.
+     *
+     * Lazily read indices are safe to share between readers on different threads.
+     *
+     * @param indexType the expected index type
+     * @param buffer the serialized index, positioned at the magic number
+     */
+    protected void readLazily(final int indexType, final ByteBuffer buffer) throws IOException {
+        final ByteBuffer source = buffer.slice().order(ByteOrder.LITTLE_ENDIAN);
+        final LittleEndianInputStream dis = new LittleEndianInputStream(new ByteBufferInputStream(source));
+        validateIndexHeader(indexType, dis);
+        readHeader(dis);
+
+        int nChromosomes = dis.readInt();
+        final LinkedHashMap<String, Integer> offsets = new LinkedHashMap<String, Integer>(Math.max(nChromosomes, 0) * 2);
+        try {
+            while (nChromosomes-- > 0) {
+                final int offset = source.position();
+                offsets.put(skipChrIndex(source), offset);
+            }
+        } catch (final BufferUnderflowException | IndexOutOfBoundsException e) {
+            throw new EOFException("Unexpected end of index: " + e.getMessage());
+        }
+
+        chrIndices = new LinkedHashMap<String, ChrIndex>(offsets.size() * 2);
+        lazySource = source;
+        chrIndexOffsets = offsets;
+    }
+
+    /**
+     * Advances {@code buffer} past one serialized chromosome index, as written by {@link ChrIndex#write}.  Subclasses
+     * should override this to skip over the chromosome's contents without decoding them; the default implementation
+     * decodes the whole chromosome index.
+     *
+     * @param buffer little-endian buffer positioned at the start of a chromosome index
+     * @return the chromosome name
+     */
+    protected String skipChrIndex(final ByteBuffer buffer) throws IOException {
+        final ChrIndex chrIdx = newChrIndex();
+        chrIdx.read(new LittleEndianInputStream(new ByteBufferInputStream(buffer)));
+        return chrIdx.getName();
+    }
+
+    /**
+     * Reads a null terminated string, as written by {@link LittleEndianOutputStream#writeString(String)}.
+     */
+    protected static String readString(final ByteBuffer buffer) {
+        final int start = buffer.position();
+        int end = start;
+        while (buffer.get(end) != 0) {
+            end++;
+        }
+        final byte[] bytes = new byte[end - start];
+        buffer.get(bytes);
+        buffer.get(); // the terminator
+        return new String(bytes);
+    }
+
+    /**
+     * Advances the position of buffer by n bytes.
+     * @throws EOFException if fewer than n bytes remain
+     */
+    protected static void skipBytes(final ByteBuffer buffer, final long n) throws EOFException {
+        if (n < 0 || n > buffer.remaining()) {
+            throw new EOFException("Unexpected end of index: cannot skip " + n + " bytes");
+        }
+        buffer.position(buffer.position() + (int) n);
+    }
+
+    /**
+     * Unbuffered stream over the remaining bytes of a ByteBuffer, which advances the buffer's position as it is read.
+     */
+    private static final class ByteBufferInputStream extends InputStream {
+        private final ByteBuffer buffer;
+
+        ByteBufferInputStream(final ByteBuffer buffer) {
+            this.buffer = buffer;
+        }
+
+        @Override
+        public int read() {
+            return buffer.hasRemaining() ? buffer.get() & 0xFF : -1;
+        }
+
+        @Override
+        public int read(final byte[] b, final int off, final int len) {
+            if (len == 0) {
+                return 0;
+            }
+            if (!buffer.hasRemaining()) {
+                return -1;
+            }
+            final int n = Math.min(len, buffer.remaining());
+            buffer.get(b, off, n);
+            return n;
+        }
+
+        @Override
+        public int available() {
+            return buffer.remaining();
+        }
+    }
+
     protected void printIndexInfo() {
         System.out.println(String.format("Index for %s with %d indices", indexedPath, chrIndices.size()));
         final BlockStats stats = getBlockStats(true);
@@ -428,6 +607,7 @@ public abstract class AbstractIndex implements MutableIndex {
     }
 
     protected BlockStats getBlockStats(final boolean logDetails) {
+        loadAllChrIndices();
         final BlockStats stats = new BlockStats();
         for (final Map.Entry<String, ChrIndex> elt : chrIndices.entrySet()) {
             final List<Block> blocks = elt.getValue().getBlocks();
@@ -40,6 +40,7 @@ import htsjdk.tribble.index.interval.IntervalIndexCreator;
 import htsjdk.tribble.index.interval.IntervalTreeIndex;
 import htsjdk.tribble.index.linear.LinearIndex;
 import htsjdk.tribble.index.linear.LinearIndexCreator;
+import htsjdk.tribble.index.tabix.FastTabixIndexer;
 import htsjdk.tribble.index.tabix.TabixFormat;
 import htsjdk.tribble.index.tabix.TabixIndex;
 import htsjdk.tribble.index.tabix.TabixIndexCreator;
@@ -54,6 +55,9 @@ import java.io.File;
 import java.io.FileNotFoundException;
 import java.io.IOException;
 import java.io.InputStream;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.channels.FileChannel;
 import java.nio.channels.SeekableByteChannel;
 import java.nio.file.Files;
 import java.nio.file.Path;
@@ -203,6 +207,69 @@ public class IndexFactory {
         }
     }
 
+    /**
+     * Load a tribble index (LinearIndex or IntervalTreeIndex) lazily from the specified path.  The file is memory
+     * mapped if it is on the default file system, or read into memory otherwise, and only the header and a table of
+     * where each chromosome starts are parsed up front; each chromosome's index is decoded the first time it is
+     * queried.  The returned index may be shared between readers, including readers on different threads, by passing
+     * it to {@link htsjdk.tribble.AbstractFeatureReader#getFeatureReader(String, FeatureCodec, Index)}.
+     *
+     * Gzipped indexes, tabix indexes and indexes larger than 2GB are loaded eagerly, as by {@link #loadIndex(String)}.
+     *
+     * @param indexPath the index file
+     */
+    public static Index loadIndexLazily(final Path indexPath) {
+        final String source = indexPath.toUri().toString();
+        final String fileName = indexPath.toString();
+        if (fileName.endsWith(".gz") || fileName.endsWith(FileExtensions.TABIX_INDEX)) {
+            return loadIndex(source);
+        }
+        try {
+            final ByteBuffer buffer = readIndexBuffer(indexPath);
+            if (buffer != null && buffer.remaining() >= 2 * Integer.BYTES
+                    && buffer.getInt(0) == AbstractIndex.MAGIC_NUMBER) {
+                final int type = buffer.getInt(Integer.BYTES);
+                if (type == LinearIndex.INDEX_TYPE) {
+                    return new LinearIndex(buffer);
+                } else if (type == IntervalTreeIndex.INDEX_TYPE) {
+                    return new IntervalTreeIndex(buffer);
+                }
+            }
+            // too large to map, or not a tribble index: the eager path handles (or reports) everything else
+            return loadIndex(source);
+        } catch (final EOFException ex) {
+            throw new TribbleException.CorruptedIndexFile("Index file is corrupted", source, ex);
+        } catch (final IOException ex) {
+            throw new TribbleException.UnableToReadIndexFile("Failed to read index file", source, ex);
+        }
+    }
+
+    /**
+     * @return the contents of the index file as a little-endian buffer, memory mapped where possible, or null if the
+     * file is too large to be held in a single buffer
+     */
+    private static ByteBuffer readIndexBuffer(final Path indexPath) throws IOException {
+        try (final SeekableByteChannel channel = Files.newByteChannel(indexPath)) {
+            final long size = channel.size();
+            if (size > Integer.MAX_VALUE) {
+                return null;
+            }
+            final ByteBuffer buffer;
+            if (channel instanceof FileChannel) {
+                buffer = ((FileChannel) channel).map(FileChannel.MapMode.READ_ONLY, 0, size);
+            } else {
+                buffer = ByteBuffer.allocate((int) size);
+                while (buffer.hasRemaining()) {
+                    if (channel.read(buffer) < 0) {
+                        throw new EOFException("Unexpected end of index file " + indexPath.toUri());
+                    }
+                }
+                buffer.flip();
+            }
+            return buffer.order(ByteOrder.LITTLE_ENDIAN);
+        }
+    }
+
     private static Index createIndex(BufferedInputStream bufferedInputStream) throws IOException {
         return IndexType.getIndexType(bufferedInputStream).createIndex(bufferedInputStream);
     }
@@ -502,6 +569,27 @@ public class IndexFactory {
         return createTabixIndex(inputPath, codec, codec.getTabixFormat(), sequenceDictionary);
     }
 
+    /**
+     * Creates a tabix index for a block-compressed file without decoding its records with a codec: only the columns
+     * named by the {@link TabixFormat} are parsed, and the file is decompressed and scanned on {@code numThreads}
+     * threads.  The result is the same as that of {@link #createTabixIndex(Path, FeatureCodec, TabixFormat, SAMSequenceDictionary)}
+     * with the codec for the format.
+     *
+     * @param inputPath The block-compressed path to be indexed.
+     * @param tabixFormat Header fields for TabixIndex to be produced.  SAM formats are not supported.
+     * @param sequenceDictionary May be null, but if present may reduce memory footprint for index creation.  Features
+     *                           in inputFile must be in the order defined by sequenceDictionary, if it is present.
+     * @param numThreads number of threads to use for decompression and parsing
+     * @see FastTabixIndexer
+     */
+    public static TabixIndex createTabixIndexWithoutDecoding(final Path inputPath,
+                                                             final TabixFormat tabixFormat,
+                                                             final SAMSequenceDictionary sequenceDictionary,
+                                                             final int numThreads) {
+        ValidationUtils.nonNull(inputPath, "input path must be non-null");
+        return new FastTabixIndexer(tabixFormat, sequenceDictionary, numThreads).createIndex(inputPath);
+    }
+
     private static Index createIndex(final Path inputPath, final FeatureIterator iterator, final IndexCreator creator) {
         Feature lastFeature = null;
         Feature currentFeature;
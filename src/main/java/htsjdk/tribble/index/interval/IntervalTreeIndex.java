@@ -25,6 +25,7 @@ import htsjdk.tribble.util.LittleEndianOutputStream;
 
 import java.io.IOException;
 import java.io.InputStream;
+import java.nio.ByteBuffer;
 import java.nio.file.Path;
 import java.util.ArrayList;
 import java.util.Arrays;
@@ -53,6 +54,17 @@ public class IntervalTreeIndex extends AbstractIndex {
         read(dis);
     }
 
+    /**
+     * Load lazily from a serialized index: each chromosome is decoded the first time it is queried.
+     *
+     * @param buffer the serialized index, positioned at the magic number.  The buffer is retained and must not be
+     *               modified.
+     * @see AbstractIndex#readLazily(int, ByteBuffer)
+     */
+    public IntervalTreeIndex(final ByteBuffer buffer) throws IOException {
+        readLazily(INDEX_TYPE, buffer);
+    }
+
     /**
      * Prepare to build an index.
      *
@@ -81,6 +93,15 @@ public class IntervalTreeIndex extends AbstractIndex {
         return INDEX_TYPE;
     }
 
+    @Override
+    protected String skipChrIndex(final ByteBuffer buffer) throws IOException {
+        // name, nIntervals, then (start, end, position, size) for each interval
+        final String name = readString(buffer);
+        final int nIntervals = buffer.getInt();
+        skipBytes(buffer, nIntervals * (2L * Integer.BYTES + Long.BYTES + Integer.BYTES));
+        return name;
+    }
+
     /**
      * Add a new interval to this index
      *
@@ -88,6 +109,7 @@ public class IntervalTreeIndex extends AbstractIndex {
      * @param interval
      */
     public void insert(final String chr, final Interval interval) {
+        loadAllChrIndices();
         ChrIndex chrIdx = (ChrIndex) chrIndices.get(chr);
         if (chrIdx == null) {
             chrIdx = new ChrIndex(chr);
@@ -97,13 +119,14 @@ public class IntervalTreeIndex extends AbstractIndex {
     }
 
     protected void setChrIndex(final List<ChrIndex> indicies) {
+        loadAllChrIndices();
         for (final ChrIndex index : indicies) {
             chrIndices.put(index.getName(), index);
         }
     }
 
     public void printTree() {
-
+        loadAllChrIndices();
         for (final String chr : chrIndices.keySet()) {
             System.out.println(chr + ":");
             final ChrIndex chrIdx = (ChrIndex) chrIndices.get(chr);
@@ -168,16 +191,17 @@ public class IntervalTreeIndex extends AbstractIndex {
                 }
             });
 
-            // Consolidate blocks  that are close together
+            // Consolidate blocks  that are close together.  The blocks belong to the tree, so extend copies rather
+            // than the originals, which would change the results of later (or concurrent) queries.
             final List<Block> consolidatedBlocks = new ArrayList<Block>(blocks.length);
-            Block lastBlock = blocks[0];
+            Block lastBlock = new Block(blocks[0].getStartPosition(), blocks[0].getSize());
             consolidatedBlocks.add(lastBlock);
             for (int i = 1; i < blocks.length; i++) {
                 final Block block = blocks[i];
                 if (block.getStartPosition() < (lastBlock.getEndPosition() + 1000)) {
                     lastBlock.setEndPosition(block.getEndPosition());
                 } else {
-                    lastBlock = block;
+                    lastBlock = new Block(block.getStartPosition(), block.getSize());
                     consolidatedBlocks.add(lastBlock);
                 }
             }
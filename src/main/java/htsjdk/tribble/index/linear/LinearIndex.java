@@ -29,6 +29,7 @@ import java.io.File;
 import java.io.IOException;
 import java.io.InputStream;
 import java.io.PrintStream;
+import java.nio.ByteBuffer;
 import java.nio.file.Path;
 import java.util.*;
 
@@ -116,9 +117,19 @@ public class LinearIndex extends AbstractIndex {
         read(dis);
     }
 
+    /**
+     * Load lazily from a serialized index: each chromosome is decoded the first time it is queried.
+     * @param buffer the serialized index, positioned at the magic number.  The buffer is retained and must not be modified.
+     * @see AbstractIndex#readLazily(int, ByteBuffer)
+     */
+    public LinearIndex(final ByteBuffer buffer) throws IOException {
+        readLazily(INDEX_TYPE, buffer);
+    }
+
     @Override
     public boolean isCurrentVersion() {
         if (!super.isCurrentVersion()) return false;
+        loadAllChrIndices();
 
         // todo fixme nasty hack to determine if this is an old style V3 linear index (without nFeaturesPerBin)
         for (final htsjdk.tribble.index.ChrIndex chrIndex : chrIndices.values())
@@ -136,7 +147,17 @@ public class LinearIndex extends AbstractIndex {
     @Override
     public List<String> getSequenceNames() {
         return (chrIndices == null ? Collections.emptyList() :
-                Collections.unmodifiableList(new ArrayList<>(chrIndices.keySet())));
+                Collections.unmodifiableList(super.getSequenceNames()));
+    }
+
+    @Override
+    protected String skipChrIndex(final ByteBuffer buffer) throws IOException {
+        // name, binWidth, nBins, longestFeature, (unused), nFeatures, then nBins + 1 block positions
+        final String name = readString(buffer);
+        buffer.getInt();
+        final int nBins = buffer.getInt();
+        skipBytes(buffer, 3L * Integer.BYTES + (nBins + 1L) * Long.BYTES);
+        return name;
     }
 
     @Override
@@ -419,6 +440,7 @@ public class LinearIndex extends AbstractIndex {
      */
     public Index optimize(final double threshold) {
         if (enableAdaptiveIndexing) {
+            loadAllChrIndices();
 
             final List<ChrIndex> newIndices = new ArrayList<ChrIndex>(this.chrIndices.size());
             for (final String name : chrIndices.keySet()) {
@@ -442,6 +464,7 @@ public class LinearIndex extends AbstractIndex {
      */
     public void writeTable(final PrintStream out) {
         out.printf("chr binWidth avg.feature.size nFeatures.total block.id start.pos size nFeatures%n");
+        loadAllChrIndices();
         for (final String name : chrIndices.keySet()) {
             final LinearIndex.ChrIndex chrIdx = (LinearIndex.ChrIndex) chrIndices.get(name);
             int blockCount = 0;
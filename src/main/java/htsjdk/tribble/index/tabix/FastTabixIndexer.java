@@ -0,0 +1,711 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.tribble.index.tabix;
+
+import htsjdk.samtools.SAMSequenceDictionary;
+import htsjdk.samtools.seekablestream.SeekablePathStream;
+import htsjdk.samtools.util.BlockCompressedFilePointerUtil;
+import htsjdk.samtools.util.BlockCompressedInputStream;
+import htsjdk.samtools.util.BlockCompressedStreamConstants;
+import htsjdk.samtools.util.BlockGunzipper;
+import htsjdk.tribble.Feature;
+import htsjdk.tribble.TribbleException;
+import htsjdk.utils.ValidationUtils;
+import htsjdk.variant.vcf.VCFConstants;
+
+import java.io.EOFException;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.channels.SeekableByteChannel;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.util.ArrayDeque;
+import java.util.Arrays;
+import java.util.Deque;
+import java.util.HashSet;
+import java.util.Set;
+import java.util.concurrent.Callable;
+import java.util.concurrent.ExecutionException;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.concurrent.FutureTask;
+import java.util.zip.DataFormatException;
+import java.util.zip.Inflater;
+
+/**
+ * Builds a {@link TabixIndex} for a block-compressed, tab-delimited text file (VCF, BED and other generic formats
+ * described by a {@link TabixFormat}) without decoding records through a {@link htsjdk.tribble.FeatureCodec}.
+ *
+ * Only the sequence, start and end columns (and, for VCF, the REF column and the END key of the INFO column) are
+ * looked at, directly in the decompressed bytes.  The file is split on BGZF block boundaries into runs of blocks that
+ * are decompressed and scanned for line starts on a pool of worker threads; the results are fed to a
+ * {@link TabixIndexCreator} in file order on the calling thread.  The resulting index is identical to the one built by
+ * {@link htsjdk.tribble.index.IndexFactory#createTabixIndex(Path, htsjdk.tribble.FeatureCodec, TabixFormat, SAMSequenceDictionary)}
+ * for files with '\n' or "\r\n" line endings.
+ *
+ * SAM-flavoured tabix formats, which need the CIGAR to compute the end position, are not supported.
+ */
+public class FastTabixIndexer {
+    /** Number of BGZF blocks (a few MB of uncompressed text) handed to a worker at a time. */
+    static final int DEFAULT_BLOCKS_PER_TASK = 64;
+
+    private static final int VCF_REF_COLUMN = 4;
+    private static final int VCF_INFO_COLUMN = 8;
+    private static final byte[] INFO_END_PREFIX = (VCFConstants.END_KEY + "=").getBytes(StandardCharsets.US_ASCII);
+    private static final byte[] UCSC_TRACK_PREFIX = "track".getBytes(StandardCharsets.US_ASCII);
+    private static final byte[] UCSC_BROWSER_PREFIX = "browser".getBytes(StandardCharsets.US_ASCII);
+
+    private final TabixFormat formatSpec;
+    private final SAMSequenceDictionary sequenceDictionary;
+    private final int numThreads;
+    private final int blocksPerTask;
+    private final boolean isVcf;
+    private final boolean isZeroBased;
+    private final int lastColumnNeeded;
+
+    /**
+     * @param formatSpec describes the columns to index; must not be a SAM format
+     * @param sequenceDictionary may be null, see {@link TabixIndexCreator#TabixIndexCreator(SAMSequenceDictionary, TabixFormat)}
+     * @param numThreads number of threads used to decompress and scan the input; 1 does all the work on the calling thread
+     */
+    public FastTabixIndexer(final TabixFormat formatSpec, final SAMSequenceDictionary sequenceDictionary, final int numThreads) {
+        this(formatSpec, sequenceDictionary, numThreads, DEFAULT_BLOCKS_PER_TASK);
+    }
+
+    FastTabixIndexer(final TabixFormat formatSpec, final SAMSequenceDictionary sequenceDictionary, final int numThreads, final int blocksPerTask) {
+        ValidationUtils.nonNull(formatSpec, "formatSpec");
+        ValidationUtils.validateArg(numThreads > 0, "numThreads must be positive");
+        ValidationUtils.validateArg(blocksPerTask > 0, "blocksPerTask must be positive");
+        final int format = formatSpec.flags & 0xffff;
+        ValidationUtils.validateArg(format == TabixFormat.GENERIC_FLAGS || format == TabixFormat.VCF_FLAGS,
+                () -> "Only generic and VCF tabix formats can be indexed without decoding records, but flags were " + formatSpec.flags);
+        ValidationUtils.validateArg(formatSpec.sequenceColumn > 0 && formatSpec.startPositionColumn > 0,
+                "sequence and start columns must be specified");
+
+        this.formatSpec = formatSpec.clone();
+        this.sequenceDictionary = sequenceDictionary;
+        this.numThreads = numThreads;
+        this.blocksPerTask = blocksPerTask;
+        this.isVcf = format == TabixFormat.VCF_FLAGS;
+        this.isZeroBased = (formatSpec.flags & TabixFormat.ZERO_BASED) != 0;
+        int lastColumn = Math.max(Math.max(formatSpec.sequenceColumn, formatSpec.startPositionColumn), formatSpec.endPositionColumn);
+        if (isVcf) {
+            lastColumn = Math.max(lastColumn, VCF_INFO_COLUMN);
+        }
+        this.lastColumnNeeded = lastColumn;
+    }
+
+    /**
+     * Indexes the given block-compressed file.
+     *
+     * @throws TribbleException.MalformedFeatureFile if the file is not block-compressed, cannot be parsed, or is not sorted
+     */
+    public TabixIndex createIndex(final Path inputPath) {
+        ValidationUtils.nonNull(inputPath, "inputPath");
+        final BlockLayout layout = BlockLayout.scan(inputPath);
+        final long dataStart = findDataStart(inputPath);
+        final IndexState state = new IndexState(inputPath, layout);
+
+        final int nTasks = (layout.numberOfBlocks() + blocksPerTask - 1) / blocksPerTask;
+        final ExecutorService executor = numThreads > 1 ? Executors.newFixedThreadPool(numThreads, r -> {
+            final Thread t = Executors.defaultThreadFactory().newThread(r);
+            t.setDaemon(true);
+            return t;
+        }) : null;
+        try {
+            // keep a bounded number of chunks in flight so that memory use does not depend on the file size
+            final Deque<FutureTask<ParsedLines>> pending = new ArrayDeque<>();
+            int nextTask = 0;
+            while (nextTask < nTasks || !pending.isEmpty()) {
+                while (nextTask < nTasks && pending.size() < 2 * numThreads) {
+                    final int firstBlock = nextTask * blocksPerTask;
+                    final int lastBlock = Math.min(firstBlock + blocksPerTask, layout.numberOfBlocks());
+                    final FutureTask<ParsedLines> task = new FutureTask<>(new ChunkParser(inputPath, layout, firstBlock, lastBlock, dataStart));
+                    if (executor == null) {
+                        task.run();
+                    } else {
+                        executor.execute(task);
+                    }
+                    pending.add(task);
+                    nextTask++;
+                }
+                state.addLines(getResult(pending.removeFirst()));
+            }
+        } finally {
+            if (executor != null) {
+                executor.shutdownNow();
+            }
+        }
+        return state.finish();
+    }
+
+    private static <T> T getResult(final Future<T> future) {
+        try {
+            return future.get();
+        } catch (final InterruptedException e) {
+            Thread.currentThread().interrupt();
+            throw new TribbleException("Interrupted while building tabix index", e);
+        } catch (final ExecutionException e) {
+            if (e.getCause() instanceof RuntimeException) {
+                throw (RuntimeException) e.getCause();
+            }
+            throw new TribbleException("Error building tabix index", e.getCause());
+        }
+    }
+
+    /** @return the uncompressed offset of the first line after the {@link TabixFormat#numHeaderLinesToSkip} lines */
+    private long findDataStart(final Path inputPath) {
+        if (formatSpec.numHeaderLinesToSkip <= 0) {
+            return 0;
+        }
+        try (final BlockCompressedInputStream in = new BlockCompressedInputStream(new SeekablePathStream(inputPath))) {
+            long offset = 0;
+            int linesSeen = 0;
+            int b;
+            while (linesSeen < formatSpec.numHeaderLinesToSkip && (b = in.read()) != -1) {
+                offset++;
+                if (b == '\n') {
+                    linesSeen++;
+                }
+            }
+            return offset;
+        } catch (final IOException e) {
+            throw new TribbleException.MalformedFeatureFile("Error reading header lines", inputPath.toString(), e);
+        }
+    }
+
+    /**
+     * Addresses and sizes of every BGZF block in the file, read from the block headers and footers without
+     * decompressing anything.
+     */
+    static final class BlockLayout {
+        private final long[] addresses;
+        private final int[] compressedSizes;
+        private final int[] uncompressedSizes;
+        /** uncompressed offset of the start of each block, plus the total uncompressed size at the end */
+        private final long[] uncompressedStarts;
+        private final int numberOfBlocks;
+
+        private BlockLayout(final long[] addresses, final int[] compressedSizes, final int[] uncompressedSizes, final int numberOfBlocks) {
+            this.numberOfBlocks = numberOfBlocks;
+            this.addresses = addresses;
+            this.compressedSizes = compressedSizes;
+            this.uncompressedSizes = uncompressedSizes;
+            this.uncompressedStarts = new long[numberOfBlocks + 1];
+            for (int i = 0; i < numberOfBlocks; i++) {
+                uncompressedStarts[i + 1] = uncompressedStarts[i] + uncompressedSizes[i];
+            }
+        }
+
+        static BlockLayout scan(final Path inputPath) {
+            long[] addresses = new long[1024];
+            int[] compressedSizes = new int[1024];
+            int[] uncompressedSizes = new int[1024];
+            int n = 0;
+            try (final SeekableByteChannel channel = Files.newByteChannel(inputPath)) {
+                final long fileSize = channel.size();
+                final ByteBuffer header = ByteBuffer.allocate(BlockCompressedStreamConstants.BLOCK_HEADER_LENGTH).order(ByteOrder.LITTLE_ENDIAN);
+                final ByteBuffer footer = ByteBuffer.allocate(4).order(ByteOrder.LITTLE_ENDIAN);
+                long position = 0;
+                while (position < fileSize) {
+                    readFully(channel, header, position);
+                    if (header.get(0) != BlockCompressedStreamConstants.GZIP_ID1 ||
+                            header.get(1) != (byte) BlockCompressedStreamConstants.GZIP_ID2 ||
+                            header.get(3) != BlockCompressedStreamConstants.GZIP_FLG ||
+                            header.get(12) != BlockCompressedStreamConstants.BGZF_ID1 ||
+                            header.get(13) != BlockCompressedStreamConstants.BGZF_ID2) {
+                        throw new TribbleException.MalformedFeatureFile("Input file is not in valid block compressed format.",
+                                inputPath.toString());
+                    }
+                    final int blockSize = (header.getShort(BlockCompressedStreamConstants.BLOCK_LENGTH_OFFSET) & 0xffff) + 1;
+                    readFully(channel, footer, position + blockSize - 4);
+                    if (n == addresses.length) {
+                        addresses = Arrays.copyOf(addresses, n * 2);
+                        compressedSizes = Arrays.copyOf(compressedSizes, n * 2);
+                        uncompressedSizes = Arrays.copyOf(uncompressedSizes, n * 2);
+                    }
+                    addresses[n] = position;
+                    compressedSizes[n] = blockSize;
+                    uncompressedSizes[n] = footer.getInt(0);
+                    n++;
+                    position += blockSize;
+                }
+                if (n == addresses.length) {
+                    addresses = Arrays.copyOf(addresses, n + 1);
+                }
+                addresses[n] = position;
+            } catch (final IOException e) {
+                throw new TribbleException.MalformedFeatureFile("Error reading block compressed file", inputPath.toString(), e);
+            }
+            return new BlockLayout(addresses, compressedSizes, uncompressedSizes, n);
+        }
+
+        int numberOfBlocks() {
+            return numberOfBlocks;
+        }
+
+        long uncompressedStart(final int block) {
+            return uncompressedStarts[block];
+        }
+
+        long totalUncompressedSize() {
+            return uncompressedStarts[numberOfBlocks];
+        }
+
+        /**
+         * Converts an uncompressed offset at the start of a line to the virtual file pointer that
+         * {@link BlockCompressedInputStream#getFilePointer()} reports after reading the preceding byte, which is what
+         * codec-based indexing records.  In particular a line starting exactly at a block boundary is reported as offset
+         * 0 in the next block.
+         */
+        long toVirtualOffset(final long uncompressedOffset) {
+            if (uncompressedOffset == 0) {
+                return BlockCompressedFilePointerUtil.makeFilePointer(0, 0);
+            }
+            // the last block whose start is at or before the preceding byte contains that byte
+            int index = Arrays.binarySearch(uncompressedStarts, 0, numberOfBlocks, uncompressedOffset - 1);
+            if (index < 0) {
+                index = -index - 2;
+            } else {
+                while (index + 1 < numberOfBlocks && uncompressedStarts[index + 1] == uncompressedOffset - 1) {
+                    index++;
+                }
+            }
+            final int blockOffset = (int) (uncompressedOffset - uncompressedStarts[index]);
+            if (blockOffset == uncompressedSizes[index]) {
+                return BlockCompressedFilePointerUtil.makeFilePointer(addresses[index + 1], 0);
+            }
+            return BlockCompressedFilePointerUtil.makeFilePointer(addresses[index], blockOffset);
+        }
+    }
+
+    /** Fills the buffer from its start up to its limit with bytes read from the given position. */
+    private static void readFully(final SeekableByteChannel channel, final ByteBuffer buffer, final long position) throws IOException {
+        buffer.rewind();
+        channel.position(position);
+        while (buffer.hasRemaining()) {
+            if (channel.read(buffer) < 0) {
+                throw new EOFException("Premature end of file at " + channel.position());
+            }
+        }
+    }
+
+    /** Kinds of lines reported by the workers. */
+    private static final byte FEATURE_LINE = 0;
+    /** Header and comment lines, which codecs consume as part of the header */
+    private static final byte META_LINE = 1;
+    /** Lines that are neither features nor meta lines, such as blank lines */
+    private static final byte OTHER_LINE = 2;
+
+    /** The lines starting within a run of blocks, in file order. */
+    private static final class ParsedLines {
+        private long[] lineStarts = new long[1024];
+        private byte[] kinds = new byte[1024];
+        private String[] contigs = new String[1024];
+        private int[] starts = new int[1024];
+        private int[] ends = new int[1024];
+        private int size = 0;
+
+        void add(final long lineStart, final byte kind, final String contig, final int start, final int end) {
+            if (size == lineStarts.length) {
+                final int newCapacity = size * 2;
+                lineStarts = Arrays.copyOf(lineStarts, newCapacity);
+                kinds = Arrays.copyOf(kinds, newCapacity);
+                contigs = Arrays.copyOf(contigs, newCapacity);
+                starts = Arrays.copyOf(starts, newCapacity);
+                ends = Arrays.copyOf(ends, newCapacity);
+            }
+            lineStarts[size] = lineStart;
+            kinds[size] = kind;
+            contigs[size] = contig;
+            starts[size] = start;
+            ends[size] = end;
+            size++;
+        }
+    }
+
+    /**
+     * Decompresses a run of blocks and parses the coordinates of every line starting in it.  A line belongs to the
+     * run that contains the newline preceding it, so lines are never reported twice; a worker decompresses blocks
+     * past the end of its run only as far as needed to read the coordinate columns of its last line.
+     */
+    private final class ChunkParser implements Callable<ParsedLines> {
+        private final Path inputPath;
+        private final BlockLayout layout;
+        private final int firstBlock;
+        private final int lastBlock;
+        private final long dataStart;
+
+        private byte[] data = new byte[0];
+        private long dataOffset;
+        private int dataLength = 0;
+        private int nextBlockToLoad;
+
+        private SeekableByteChannel channel;
+        private Inflater inflater;
+        private final byte[] compressedBlock = new byte[BlockCompressedStreamConstants.MAX_COMPRESSED_BLOCK_SIZE];
+
+        private final int[] columnStarts = new int[lastColumnNeeded + 1];
+        private final int[] columnEnds = new int[lastColumnNeeded + 1];
+        private byte[] lastContigBytes = new byte[0];
+        private String lastContig = null;
+
+        ChunkParser(final Path inputPath, final BlockLayout layout, final int firstBlock, final int lastBlock, final long dataStart) {
+            this.inputPath = inputPath;
+            this.layout = layout;
+            this.firstBlock = firstBlock;
+            this.lastBlock = lastBlock;
+            this.dataStart = dataStart;
+            this.dataOffset = layout.uncompressedStart(firstBlock);
+            this.nextBlockToLoad = firstBlock;
+        }
+
+        @Override
+        public ParsedLines call() throws IOException {
+            final ParsedLines lines = new ParsedLines();
+            try (final SeekableByteChannel in = Files.newByteChannel(inputPath)) {
+                channel = in;
+                inflater = BlockGunzipper.getDefaultInflaterFactory().makeInflater(true);
+                while (nextBlockToLoad < lastBlock) {
+                    loadNextBlock();
+                }
+                final long total = layout.totalUncompressedSize();
+                if (firstBlock == 0 && total > 0) {
+                    parseLine(0, lines);
+                }
+                final int runLength = (int) (layout.uncompressedStart(lastBlock) - dataOffset);
+                for (int i = 0; i < runLength; i++) {
+                    // NB: parseLine may grow data, but never moves the bytes of this run
+                    if (data[i] == '\n' && dataOffset + i + 1 < total) {
+                        parseLine(dataOffset + i + 1, lines);
+                    }
+                }
+            } finally {
+                if (inflater != null) {
+                    inflater.end();
+                }
+            }
+            return lines;
+        }
+
+        private void loadNextBlock() throws IOException {
+            final int block = nextBlockToLoad++;
+            final int uncompressedSize = layout.uncompressedSizes[block];
+            if (dataLength + uncompressedSize > data.length) {
+                data = Arrays.copyOf(data, Math.max(data.length * 2, dataLength + uncompressedSize));
+            }
+            if (uncompressedSize == 0) {
+                return;
+            }
+            final int compressedSize = layout.compressedSizes[block];
+            readFully(channel, ByteBuffer.wrap(compressedBlock, 0, compressedSize), layout.addresses[block]);
+            inflater.reset();
+            inflater.setInput(compressedBlock, BlockCompressedStreamConstants.BLOCK_HEADER_LENGTH,
+                    compressedSize - BlockCompressedStreamConstants.BLOCK_HEADER_LENGTH - BlockCompressedStreamConstants.BLOCK_FOOTER_LENGTH);
+            try {
+                int inflated = 0;
+                while (inflated < uncompressedSize) {
+                    final int n = inflater.inflate(data, dataLength + inflated, uncompressedSize - inflated);
+                    if (n == 0 && (inflater.finished() || inflater.needsInput())) {
+                        break;
+                    }
+                    inflated += n;
+                }
+                if (inflated != uncompressedSize) {
+                    throw new TribbleException.MalformedFeatureFile("Block at " + layout.addresses[block] +
+                            " did not decompress to the size in its footer", inputPath.toString());
+                }
+            } catch (final DataFormatException e) {
+                throw new TribbleException.MalformedFeatureFile("Corrupt block at " + layout.addresses[block], inputPath.toString(), e);
+            }
+            dataLength += uncompressedSize;
+        }
+
+        /** @return the byte at the given uncompressed offset, decompressing further blocks if needed, or -1 at end of file */
+        private int byteAt(final long offset) throws IOException {
+            while (offset >= dataOffset + dataLength) {
+                if (nextBlockToLoad >= layout.numberOfBlocks()) {
+                    return -1;
+                }
+                loadNextBlock();
+            }
+            return data[(int) (offset - dataOffset)];
+        }
+
+        private boolean startsWith(final long offset, final byte[] prefix) throws IOException {
+            for (int i = 0; i < prefix.length; i++) {
+                if (byteAt(offset + i) != prefix[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        private void parseLine(final long lineStart, final ParsedLines lines) throws IOException {
+            if (lineStart < dataStart) {
+                lines.add(lineStart, META_LINE, null, 0, 0);
+                return;
+            }
+            final int first = byteAt(lineStart);
+            if (first == -1 || first == '\n' || first == '\r') {
+                lines.add(lineStart, OTHER_LINE, null, 0, 0);
+                return;
+            }
+            if (first == formatSpec.metaCharacter ||
+                    (isZeroBased && (startsWith(lineStart, UCSC_TRACK_PREFIX) || startsWith(lineStart, UCSC_BROWSER_PREFIX)))) {
+                lines.add(lineStart, META_LINE, null, 0, 0);
+                return;
+            }
+
+            // find the extent of the columns we need; column ends exclude any trailing '\r'
+            Arrays.fill(columnStarts, -1);
+            int column = 1;
+            long offset = lineStart;
+            columnStarts[1] = (int) (lineStart - dataOffset);
+            while (column <= lastColumnNeeded) {
+                final int b = byteAt(offset);
+                if (b == '\t' || b == '\n' || b == -1) {
+                    int end = (int) (offset - dataOffset);
+                    if (b != '\t' && end > columnStarts[column] && data[end - 1] == '\r') {
+                        end--;
+                    }
+                    columnEnds[column] = end;
+                    if (b != '\t') {
+                        break;
+                    }
+                    column++;
+                    if (column <= lastColumnNeeded) {
+                        columnStarts[column] = (int) (offset + 1 - dataOffset);
+                    }
+                }
+                offset++;
+            }
+
+            final int sequenceColumn = formatSpec.sequenceColumn;
+            final int startColumn = formatSpec.startPositionColumn;
+            if (columnStarts[sequenceColumn] < 0 || columnStarts[startColumn] < 0 || (isVcf && columnStarts[VCF_INFO_COLUMN] < 0)) {
+                throw new TribbleException.MalformedFeatureFile("Line at offset " + lineStart +
+                        " does not have enough columns", inputPath.toString());
+            }
+
+            final String contig = getContig(columnStarts[sequenceColumn], columnEnds[sequenceColumn]);
+            int start = parseInt(columnStarts[startColumn], columnEnds[startColumn], lineStart);
+            if (isZeroBased) {
+                start++;
+            }
+            int end = start;
+            if (isVcf) {
+                final int infoEnd = findInfoEnd(columnStarts[VCF_INFO_COLUMN], columnEnds[VCF_INFO_COLUMN]);
+                if (infoEnd >= 0) {
+                    end = parseInt(infoEnd, infoValueEnd(infoEnd, columnEnds[VCF_INFO_COLUMN]), lineStart);
+                } else {
+                    end = start + (columnEnds[VCF_REF_COLUMN] - columnStarts[VCF_REF_COLUMN]) - 1;
+                }
+            } else if (formatSpec.endPositionColumn > 0 && columnStarts[formatSpec.endPositionColumn] >= 0) {
+                end = parseInt(columnStarts[formatSpec.endPositionColumn], columnEnds[formatSpec.endPositionColumn], lineStart);
+            }
+            lines.add(lineStart, FEATURE_LINE, contig, start, end);
+        }
+
+        /** Reuses the previous contig String when the bytes match, which is nearly always the case in sorted files. */
+        private String getContig(final int from, final int to) {
+            final int length = to - from;
+            if (lastContig != null && length == lastContigBytes.length) {
+                boolean same = true;
+                for (int i = 0; i < length && same; i++) {
+                    same = data[from + i] == lastContigBytes[i];
+                }
+                if (same) {
+                    return lastContig;
+                }
+            }
+            lastContigBytes = Arrays.copyOfRange(data, from, to);
+            lastContig = new String(lastContigBytes, StandardCharsets.US_ASCII);
+            return lastContig;
+        }
+
+        /** @return the index in data of the value of the INFO END key, or -1 if there is none */
+        private int findInfoEnd(final int from, final int to) {
+            int tokenStart = from;
+            while (tokenStart < to) {
+                if (to - tokenStart > INFO_END_PREFIX.length) {
+                    boolean match = true;
+                    for (int i = 0; i < INFO_END_PREFIX.length && match; i++) {
+                        match = data[tokenStart + i] == INFO_END_PREFIX[i];
+                    }
+                    if (match) {
+                        return tokenStart + INFO_END_PREFIX.length;
+                    }
+                }
+                while (tokenStart < to && data[tokenStart] != VCFConstants.INFO_FIELD_SEPARATOR_CHAR) {
+                    tokenStart++;
+                }
+                tokenStart++;
+            }
+            return -1;
+        }
+
+        private int infoValueEnd(final int from, final int to) {
+            int i = from;
+            while (i < to && data[i] != VCFConstants.INFO_FIELD_SEPARATOR_CHAR) {
+                i++;
+            }
+            return i;
+        }
+
+        private int parseInt(final int from, final int to, final long lineStart) {
+            int i = from;
+            boolean negative = false;
+            if (i < to && (data[i] == '-' || data[i] == '+')) {
+                negative = data[i] == '-';
+                i++;
+            }
+            if (i == to) {
+                throw invalidNumber(from, to, lineStart);
+            }
+            long value = 0;
+            for (; i < to; i++) {
+                final int digit = data[i] - '0';
+                if (digit < 0 || digit > 9) {
+                    throw invalidNumber(from, to, lineStart);
+                }
+                value = value * 10 + digit;
+                if (value > Integer.MAX_VALUE + 1L) {
+                    throw invalidNumber(from, to, lineStart);
+                }
+            }
+            value = negative ? -value : value;
+            if (value > Integer.MAX_VALUE || value < Integer.MIN_VALUE) {
+                throw invalidNumber(from, to, lineStart);
+            }
+            return (int) value;
+        }
+
+        private TribbleException invalidNumber(final int from, final int to, final long lineStart) {
+            return new TribbleException.MalformedFeatureFile("Invalid position '" +
+                    new String(data, from, to - from, StandardCharsets.US_ASCII) + "' in line at offset " + lineStart,
+                    inputPath.toString());
+        }
+    }
+
+    /** Consumes parsed lines in file order, validates the ordering and feeds features to a {@link TabixIndexCreator}. */
+    private final class IndexState {
+        private final Path inputPath;
+        private final BlockLayout layout;
+        private final TabixIndexCreator creator = new TabixIndexCreator(sequenceDictionary, formatSpec);
+        private final Set<String> visitedContigs = new HashSet<>();
+        private final LocatedFeature feature = new LocatedFeature();
+
+        private boolean inHeader = true;
+        private boolean awaitingNextLine = false;
+        private long positionForNextFeature = 0;
+        private long lastLineStart = 0;
+        private String lastContig = null;
+        private int lastStart = 0;
+
+        IndexState(final Path inputPath, final BlockLayout layout) {
+            this.inputPath = inputPath;
+            this.layout = layout;
+        }
+
+        void addLines(final ParsedLines lines) {
+            for (int i = 0; i < lines.size; i++) {
+                final byte kind = lines.kinds[i];
+                final long lineStart = lines.lineStarts[i];
+                lastLineStart = lineStart;
+                // a codec reports the position of a feature as the position after the previous feature, or after the header
+                if (awaitingNextLine || (inHeader && kind != META_LINE)) {
+                    positionForNextFeature = lineStart;
+                    awaitingNextLine = false;
+                }
+                if (kind != META_LINE) {
+                    inHeader = false;
+                }
+                if (kind == FEATURE_LINE) {
+                    addFeature(lines.contigs[i], lines.starts[i], lines.ends[i]);
+                }
+            }
+        }
+
+        private void addFeature(final String contig, final int start, final int end) {
+            if (!contig.equals(lastContig)) {
+                if (!visitedContigs.add(contig)) {
+                    throw new TribbleException.MalformedFeatureFile("Input file must have contiguous chromosomes. Saw feature " +
+                            contig + ":" + start + "-" + end + " after features on " + lastContig, inputPath.toString());
+                }
+            } else if (start < lastStart) {
+                throw new TribbleException.MalformedFeatureFile("Input file is not sorted by start position. \n" +
+                        "We saw a record with a start of " + contig + ":" + start +
+                        " after a record with a start of " + lastContig + ":" + lastStart, inputPath.toString());
+            }
+            feature.contig = contig;
+            feature.start = start;
+            feature.end = end;
+            creator.addFeature(feature, layout.toVirtualOffset(positionForNextFeature));
+            lastContig = contig;
+            lastStart = start;
+            awaitingNextLine = true;
+        }
+
+        TabixIndex finish() {
+            // Read the tail of the file with a stream so the final position is exactly the one codec-based indexing sees
+            try (final BlockCompressedInputStream in = new BlockCompressedInputStream(new SeekablePathStream(inputPath))) {
+                if (layout.totalUncompressedSize() > 0) {
+                    in.seek(layout.toVirtualOffset(lastLineStart));
+                }
+                while (in.read() != -1) {
+                    // skip to the end
+                }
+                return (TabixIndex) creator.finalizeIndex(in.getFilePointer());
+            } catch (final IOException e) {
+                throw new TribbleException.MalformedFeatureFile("Error reading end of file", inputPath.toString(), e);
+            }
+        }
+    }
+
+    /** A reusable Feature; {@link TabixIndexCreator} copies the coordinates out of each feature it is given. */
+    private static final class LocatedFeature implements Feature {
+        private String contig;
+        private int start;
+        private int end;
+
+        @Override
+        public String getContig() {
+            return contig;
+        }
+
+        @Override
+        public int getStart() {
+            return start;
+        }
+
+        @Override
+        public int getEnd() {
+            return end;
+        }
+    }
+}
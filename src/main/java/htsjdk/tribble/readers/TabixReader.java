@@ -28,6 +28,8 @@ import htsjdk.samtools.seekablestream.SeekableStream;
 import htsjdk.samtools.seekablestream.SeekableStreamFactory;
 import htsjdk.samtools.util.BlockCompressedInputStream;
 import htsjdk.samtools.util.FileExtensions;
+import htsjdk.samtools.util.IndexCache;
+import htsjdk.samtools.util.RuntimeIOException;
 import htsjdk.tribble.util.ParsingUtils;
 
 import java.io.IOException;
@@ -35,6 +37,7 @@ import java.io.InputStream;
 import java.nio.ByteBuffer;
 import java.nio.ByteOrder;
 import java.nio.channels.SeekableByteChannel;
+import java.nio.file.Path;
 import java.util.Arrays;
 import java.util.Collections;
 import java.util.HashMap;
@@ -220,24 +223,41 @@ public class TabixReader implements AutoCloseable {
 
     
     
+    /**
+     * The parsed contents of a tabix index.  Never modified once read, so it may be shared between readers through
+     * the {@link IndexCache}.
+     */
+    private static final class ParsedIndex {
+        int preset;
+        int sc;
+        int bc;
+        int ec;
+        int meta;
+        String[] seq;
+        Map<String, Integer> chr2tid;
+        TIndex[] index;
+    }
+
     /**
      * Read the Tabix index from a file
      *
      * @param fp File pointer
+     * @return the parsed index, or null if fp is null
      */
-    private void readIndex(final SeekableStream fp) throws IOException {
-        if (fp == null) return;
+    private static ParsedIndex readIndex(final SeekableStream fp) throws IOException {
+        if (fp == null) return null;
+        final ParsedIndex parsed = new ParsedIndex();
         final  BlockCompressedInputStream is = new BlockCompressedInputStream(fp);
         byte[] buf = new byte[4];
 
         is.read(buf, 0, 4); // read "TBI\1"
-        mSeq = new String[readInt(is)]; // # sequences
-        mChr2tid = new HashMap<String, Integer>( this.mSeq.length );
-        mPreset = readInt(is);
-        mSc = readInt(is);
-        mBc = readInt(is);
-        mEc = readInt(is);
-        mMeta = readInt(is);
+        parsed.seq = new String[readInt(is)]; // # sequences
+        parsed.chr2tid = new HashMap<String, Integer>( parsed.seq.length );
+        parsed.preset = readInt(is);
+        parsed.sc = readInt(is);
+        parsed.bc = readInt(is);
+        parsed.ec = readInt(is);
+        parsed.meta = readInt(is);
         readInt(is);//unused
         // read sequence dictionary
         int i, j, k, l = readInt(is);
@@ -248,18 +268,18 @@ public class TabixReader implements AutoCloseable {
                 byte[] b = new byte[i - j];
                 System.arraycopy(buf, j, b, 0, b.length);
                 final String contig = new String(b);
-                mChr2tid.put(contig, k);
-                mSeq[k++] = contig;
+                parsed.chr2tid.put(contig, k);
+                parsed.seq[k++] = contig;
                 j = i + 1;
             }
         }
         // read the index
-        mIndex = new TIndex[mSeq.length];
-        for (i = 0; i < mSeq.length; ++i) {
+        parsed.index = new TIndex[parsed.seq.length];
+        for (i = 0; i < parsed.seq.length; ++i) {
             // the binning index
             int n_bin = readInt(is);
-            mIndex[i] = new TIndex();
-            mIndex[i].b = new HashMap<Integer, TPair64[]>(n_bin);
+            parsed.index[i] = new TIndex();
+            parsed.index[i].b = new HashMap<Integer, TPair64[]>(n_bin);
             for (j = 0; j < n_bin; ++j) {
                 int bin = readInt(is);
                 TPair64[] chunks = new TPair64[readInt(is)];
@@ -268,23 +288,57 @@ public class TabixReader implements AutoCloseable {
                     long v = readLong(is);
                     chunks[k] = new TPair64(u, v); // in C, this is inefficient
                 }
-                mIndex[i].b.put(bin, chunks);
+                parsed.index[i].b.put(bin, chunks);
             }
             // the linear index
-            mIndex[i].l = new long[readInt(is)];
-            for (k = 0; k < mIndex[i].l.length; ++k)
-                mIndex[i].l[k] = readLong(is);
+            parsed.index[i].l = new long[readInt(is)];
+            for (k = 0; k < parsed.index[i].l.length; ++k)
+                parsed.index[i].l[k] = readLong(is);
         }
         // close
         is.close();
+        return parsed;
     }
 
     /**
-     * Read the Tabix index from the default file.
+     * Read the Tabix index from the default file, or take it from the {@link IndexCache} if that is enabled.
      */
     private void readIndex() throws IOException {
+        final Path cacheablePath = mIndexWrapper == null ? IndexCache.getCacheablePath(mIndexPath) : null;
+        final ParsedIndex parsed;
+        if (cacheablePath != null && IndexCache.isEnabled()) {
+            try {
+                parsed = IndexCache.get(cacheablePath, ParsedIndex.class, null, () -> {
+                    try {
+                        return readIndexFile();
+                    } catch (final IOException e) {
+                        throw new RuntimeIOException(e);
+                    }
+                });
+            } catch (final RuntimeIOException e) {
+                if (e.getCause() instanceof IOException) {
+                    throw (IOException) e.getCause();
+                }
+                throw e;
+            }
+        } else {
+            parsed = readIndexFile();
+        }
+        if (parsed != null) {
+            mPreset = parsed.preset;
+            mSc = parsed.sc;
+            mBc = parsed.bc;
+            mEc = parsed.ec;
+            mMeta = parsed.meta;
+            mSeq = parsed.seq;
+            mChr2tid = parsed.chr2tid;
+            mIndex = parsed.index;
+        }
+    }
+
+    private ParsedIndex readIndexFile() throws IOException {
         final ISeekableStreamFactory ssf = SeekableStreamFactory.getInstance();
-        readIndex(ssf.getBufferedStream(ssf.getStreamFor(mIndexPath, mIndexWrapper), 128000));
+        return readIndex(ssf.getBufferedStream(ssf.getStreamFor(mIndexPath, mIndexWrapper), 128000));
     }
 
     /**
@@ -33,6 +33,7 @@ import htsjdk.tribble.TribbleException;
 import htsjdk.tribble.readers.*;
 import htsjdk.variant.utils.GeneralUtils;
 import htsjdk.variant.variantcontext.Allele;
+import htsjdk.variant.variantcontext.ColumnarGenotypes;
 import htsjdk.variant.variantcontext.GenotypeBuilder;
 import htsjdk.variant.variantcontext.LazyGenotypesContext;
 import htsjdk.variant.variantcontext.VariantContext;
@@ -44,21 +45,32 @@ import htsjdk.variant.vcf.VCFConstants;
 import htsjdk.variant.vcf.VCFContigHeaderLine;
 import htsjdk.variant.vcf.VCFHeader;
 import htsjdk.variant.vcf.VCFHeaderLineType;
+import htsjdk.variant.vcf.VCFSampleSubset;
 
 import java.io.*;
 import java.nio.file.Files;
 import java.util.ArrayList;
+import java.util.Collection;
+import java.util.Collections;
 import java.util.HashMap;
+import java.util.HashSet;
+import java.util.LinkedHashSet;
 import java.util.List;
 import java.util.Map;
+import java.util.Set;
 
 /**
  * Decode BCF2 files
+ *
+ * Both BCF 2.1 and BCF 2.2 are supported.  BCF 2.2 files, such as the ones written by bcftools, may fix the dictionary
+ * offsets of header lines with IDX attributes, and pad vectors with END_OF_VECTOR values rather than MISSING values.
  */
 public class BCF2Codec extends BinaryFeatureCodec<VariantContext> {
     protected final static int ALLOWED_MAJOR_VERSION = 2;
     protected final static int ALLOWED_MINOR_VERSION = 1;
+    protected final static int MAX_ALLOWED_MINOR_VERSION = 2;
     public static final BCFVersion ALLOWED_BCF_VERSION = new BCFVersion(ALLOWED_MAJOR_VERSION, ALLOWED_MINOR_VERSION);
+    public static final BCFVersion BCF_VERSION_2_2 = new BCFVersion(ALLOWED_MAJOR_VERSION, MAX_ALLOWED_MINOR_VERSION);
 
     /** sizeof a BCF header (+ min/max version). Used when trying to detect when a streams starts with a bcf header */
     public static final int SIZEOF_BCF_HEADER =  BCFVersion.MAGIC_HEADER_START.length + 2*Byte.BYTES;
@@ -102,6 +114,38 @@ public class BCF2Codec extends BinaryFeatureCodec<VariantContext> {
      */
     private GenotypeBuilder[] builders = null;
 
+    /**
+     * If true, genotypes are decoded into {@link ColumnarGenotypes} rather than one Genotype object per sample
+     */
+    private boolean useColumnarGenotypes = false;
+
+    /**
+     * The FORMAT fields to decode when genotypes are decoded, or null to decode all of them
+     */
+    private Set<String> genotypeFieldsToDecode = null;
+
+    /**
+     * If true, the genotype block of each record is skipped
+     */
+    private boolean sitesOnly = false;
+
+    /**
+     * The samples whose genotypes are decoded, or null to decode those of all samples
+     */
+    private Set<String> samplesToDecode = null;
+
+    /**
+     * The selected samples, grouped into runs of consecutive samples of the header: the header index of the first
+     * sample of each run, and the builders of the samples of the run.  Null when all samples are decoded.
+     */
+    private int[] sampleRunStarts = null;
+    private GenotypeBuilder[][] sampleRunBuilders = null;
+
+    /**
+     * The sorted names and offsets of the selected samples, or null when all samples are decoded
+     */
+    private VCFSampleSubset sampleSubset = null;
+
     // for error handling
     private int recordNo = 0;
     private int pos = 0;
@@ -131,8 +175,12 @@ public class BCF2Codec extends BinaryFeatureCodec<VariantContext> {
             decodeSiteLoc(builder);
             final SitesInfoForDecoding info = decodeSitesExtendedInfo(builder);
 
-            decoder.readNextBlock(genotypeBlockSize, inputStream);
-            createLazyGenotypesDecoder(info, builder);
+            if ( sitesOnly ) {
+                decoder.skipNextBlock(genotypeBlockSize, inputStream);
+            } else {
+                decoder.readNextBlock(genotypeBlockSize, inputStream);
+                createLazyGenotypesDecoder(info, builder);
+            }
             return builder.fullyDecoded(true).make();
         } catch ( IOException e ) {
             throw new TribbleException("Failed to read BCF file", e);
@@ -150,7 +198,8 @@ public class BCF2Codec extends BinaryFeatureCodec<VariantContext> {
      * this to provide a custom version compatibility policy, but allowing something other than the
      * supported version is dangerous and should be done with great care.
      *
-     * The default policy is to require an exact version match.
+     * The default policy is to accept minor versions {@link #ALLOWED_MINOR_VERSION} (BCF 2.1) through
+     * {@link #MAX_ALLOWED_MINOR_VERSION} (BCF 2.2).
      * @param supportedVersion the current BCF implementation version
      * @param actualVersion the actual version
      * @thows TribbleException if the version policy determines that {@code actualVersion} is not compatible
@@ -158,12 +207,13 @@ public class BCF2Codec extends BinaryFeatureCodec<VariantContext> {
      */
     protected void validateVersionCompatibility(final BCFVersion supportedVersion, final BCFVersion actualVersion) {
         if ( actualVersion.getMajorVersion() != ALLOWED_MAJOR_VERSION ) {
-            error("BCF2Codec can only process BCF2 files, this file has major version " + bcfVersion.getMajorVersion());
+            error("BCF2Codec can only process BCF2 files, this file has major version " + actualVersion.getMajorVersion());
         }
 
-        // require the minor version to be an exact match and reject minor versions form the future
-        if ( actualVersion.getMinorVersion() != ALLOWED_MINOR_VERSION ) {
-            error("BCF2Codec can only process BCF2 files with minor version = " + ALLOWED_MINOR_VERSION + " but this file has minor version " + bcfVersion.getMinorVersion());
+        // reject minor versions from the future
+        if ( actualVersion.getMinorVersion() < ALLOWED_MINOR_VERSION || actualVersion.getMinorVersion() > MAX_ALLOWED_MINOR_VERSION ) {
+            error("BCF2Codec can only process BCF2 files with minor version " + ALLOWED_MINOR_VERSION + " to " + MAX_ALLOWED_MINOR_VERSION +
+                    " but this file has minor version " + actualVersion.getMinorVersion());
         }
     }
 
@@ -177,6 +227,7 @@ public class BCF2Codec extends BinaryFeatureCodec<VariantContext> {
             }
 
             validateVersionCompatibility(BCF2Codec.ALLOWED_BCF_VERSION, bcfVersion);
+            decoder.setBCFVersion(bcfVersion);
             if ( GeneralUtils.DEBUG_MODE_ENABLED ) {
                 System.err.println("Parsing data stream with BCF version " + bcfVersion);
             }
@@ -199,35 +250,152 @@ public class BCF2Codec extends BinaryFeatureCodec<VariantContext> {
             throw new TribbleException("I/O error while reading BCF2 header");
         }
 
-        // create the config offsets
+        // create the config offsets, which BCF 2.2 may fix with IDX attributes
+        final boolean useIDX = bcfVersion.getMinorVersion() >= 2;
         if ( ! header.getContigLines().isEmpty() ) {
             contigNames.clear();
             for ( final VCFContigHeaderLine contig : header.getContigLines()) {
                 if ( contig.getID() == null || contig.getID().equals("") )
                     error("found a contig with an invalid ID " + contig);
-                contigNames.add(contig.getID());
+                BCF2Utils.addToDictionary(contigNames, useIDX ? BCF2Utils.getIDX(contig) : null, contig.getID());
             }
         } else {
             error("Didn't find any contig lines in BCF2 file header");
         }
 
         // create the string dictionary
-        dictionary = parseDictionary(header);
+        dictionary = parseDictionary(header, useIDX);
 
         // prepare the genotype field decoders
         gtFieldDecoders = new BCF2GenotypeFieldDecoders(header);
 
-        // create and initialize the genotype builder array
-        final int nSamples = header.getNGenotypeSamples();
-        builders = new GenotypeBuilder[nSamples];
-        for ( int i = 0; i < nSamples; i++ ) {
-            builders[i] = new GenotypeBuilder(header.getGenotypeSamples().get(i));
-        }
+        createGenotypeBuilders();
 
         // position right before next line (would be right before first real record byte at end of header)
         return new FeatureCodecHeader(header, inputStream.getPosition());
     }
 
+    /**
+     * Decode genotypes into {@link ColumnarGenotypes}, which store GT, GQ, DP, AD and PL as primitive arrays across
+     * samples and create Genotype objects only on demand.  This greatly reduces the memory used by the genotypes of
+     * records with many samples.
+     *
+     * @param useColumnarGenotypes true to decode genotypes into columnar form
+     */
+    public void setUseColumnarGenotypes(final boolean useColumnarGenotypes) {
+        this.useColumnarGenotypes = useColumnarGenotypes;
+    }
+
+    /**
+     * @return true if genotypes are decoded into {@link ColumnarGenotypes}
+     */
+    public boolean getUseColumnarGenotypes() {
+        return useColumnarGenotypes;
+    }
+
+    /**
+     * Decode only the given FORMAT fields when the genotypes of a record are decoded.  The values of the other
+     * fields are skipped without being decoded, so the genotypes will lack them; include GT to get the alleles
+     * of each sample.  Together with the lazy decoding of genotypes, this lets a consumer that filters records on
+     * INFO fields decode just the FORMAT fields it needs, for just the records it keeps.
+     *
+     * @param fields the FORMAT fields to decode, or null to decode all of them
+     */
+    public void setGenotypeFieldsToDecode(final Collection<String> fields) {
+        this.genotypeFieldsToDecode = fields == null ? null : new HashSet<String>(fields);
+    }
+
+    /**
+     * @return the FORMAT fields decoded when genotypes are decoded, or null if all of them are
+     */
+    public Set<String> getGenotypeFieldsToDecode() {
+        return genotypeFieldsToDecode == null ? null : Collections.unmodifiableSet(genotypeFieldsToDecode);
+    }
+
+    /**
+     * Decode the genotypes of only the given samples.  The values of the other samples are skipped in each FORMAT
+     * field without being decoded, so decoded records have genotypes for just the selected samples, in the order in
+     * which they appear in the file.  This is much cheaper than decoding all genotypes and then calling
+     * {@link VariantContext#subContextFromSamples(Set)}.  The header is unchanged, and still lists all samples.
+     *
+     * @param samples the samples whose genotypes to decode, or null to decode those of all samples
+     * @throws IllegalArgumentException if the header has been read and a sample is not in it
+     */
+    public void setSamplesToDecode(final Collection<String> samples) {
+        this.samplesToDecode = samples == null ? null : new LinkedHashSet<String>(samples);
+        if ( header != null )
+            createGenotypeBuilders();
+    }
+
+    /**
+     * @return the samples whose genotypes are decoded, or null if those of all samples are
+     */
+    public Set<String> getSamplesToDecode() {
+        return samplesToDecode == null ? null : Collections.unmodifiableSet(samplesToDecode);
+    }
+
+    /**
+     * Creates the genotype builders of the samples whose genotypes are decoded, and the runs of consecutive samples
+     * they form if only some samples are decoded
+     */
+    private void createGenotypeBuilders() {
+        final List<String> samples = header.getGenotypeSamples();
+        if ( samplesToDecode == null ) {
+            builders = new GenotypeBuilder[samples.size()];
+            for ( int i = 0; i < samples.size(); i++ ) {
+                builders[i] = new GenotypeBuilder(samples.get(i));
+            }
+            sampleSubset = null;
+            sampleRunStarts = null;
+            sampleRunBuilders = null;
+            return;
+        }
+
+        final VCFSampleSubset subset = new VCFSampleSubset(header, samplesToDecode);
+        builders = new GenotypeBuilder[subset.size()];
+        final List<Integer> runStarts = new ArrayList<>();
+        final List<GenotypeBuilder[]> runBuilders = new ArrayList<>();
+        for ( int runStart = 0; runStart < subset.size(); ) {
+            int runEnd = runStart + 1;
+            while ( runEnd < subset.size() && subset.getHeaderIndex(runEnd) == subset.getHeaderIndex(runEnd - 1) + 1 )
+                runEnd++;
+            final GenotypeBuilder[] run = new GenotypeBuilder[runEnd - runStart];
+            for ( int i = runStart; i < runEnd; i++ ) {
+                builders[i] = run[i - runStart] = new GenotypeBuilder(samples.get(subset.getHeaderIndex(i)));
+            }
+            runStarts.add(subset.getHeaderIndex(runStart));
+            runBuilders.add(run);
+            runStart = runEnd;
+        }
+        sampleSubset = subset;
+        sampleRunStarts = runStarts.stream().mapToInt(Integer::intValue).toArray();
+        sampleRunBuilders = runBuilders.toArray(new GenotypeBuilder[0][]);
+    }
+
+    /**
+     * Read only the site data of records.  The genotype block of each record is skipped without being read into
+     * memory, and decoded records have no genotypes.  The header is unchanged, and still lists the samples of the file.
+     *
+     * @param sitesOnly true to read only the site data of records
+     */
+    public void setSitesOnly(final boolean sitesOnly) {
+        this.sitesOnly = sitesOnly;
+    }
+
+    /**
+     * @return true if only the site data of records is read
+     */
+    public boolean getSitesOnly() {
+        return sitesOnly;
+    }
+
+    /**
+     * @return the version of the BCF file whose header was read, or null if no header has been read
+     */
+    public BCFVersion getBCFVersion() {
+        return bcfVersion;
+    }
+
     @Override
     public boolean canDecode( final String path ) {
         try (InputStream fis = Files.newInputStream(IOUtil.getPath(path)) ){
@@ -433,13 +601,15 @@ public class BCF2Codec extends BinaryFeatureCodec<VariantContext> {
                                              final VariantContextBuilder builder ) {
         if (siteInfo.nSamples > 0) {
             final LazyGenotypesContext.LazyParser lazyParser =
-                    new BCF2LazyGenotypesDecoder(this, siteInfo.alleles, siteInfo.nSamples, siteInfo.nFormatFields, builders);
+                    new BCF2LazyGenotypesDecoder(this, siteInfo.alleles, siteInfo.nSamples, siteInfo.nFormatFields, builders,
+                            useColumnarGenotypes, genotypeFieldsToDecode, sampleRunStarts, sampleRunBuilders, sampleSubset);
 
-            final LazyData lazyData = new LazyData(header, siteInfo.nFormatFields, decoder.getRecordBytes());
-            final LazyGenotypesContext lazy = new LazyGenotypesContext(lazyParser, lazyData, header.getNGenotypeSamples());
+            final LazyData lazyData = new LazyData(header, siteInfo.nFormatFields, decoder.getRecordBytes(), bcfVersion, dictionary);
+            final LazyGenotypesContext lazy = new LazyGenotypesContext(lazyParser, lazyData, builders.length);
 
-            // did we resort the sample names?  If so, we need to load the genotype data
-            if ( !header.samplesWereAlreadySorted() )
+            // did we resort the sample names?  If so, we need to load the genotype data.  So too if only some samples
+            // are decoded, as the raw genotype data holds those of all samples, so must not be written out as it is
+            if ( sampleSubset != null || !header.samplesWereAlreadySorted() )
                 lazy.decode();
 
             builder.genotypesNoValidation(lazy);
@@ -450,11 +620,25 @@ public class BCF2Codec extends BinaryFeatureCodec<VariantContext> {
         final public VCFHeader header;
         final public int nGenotypeFields;
         final public byte[] bytes;
+        /** the version of the BCF file the bytes were read from, which determines how vectors are padded */
+        final public BCFVersion bcfVersion;
+        /**
+         * the string dictionary the FORMAT keys of the bytes are offsets into, which follows the IDX attributes of a
+         * BCF 2.2 header, or null if it follows the order of the lines of the header
+         */
+        final public List<String> dictionary;
 
         public LazyData(final VCFHeader header, final int nGenotypeFields, final byte[] bytes) {
+            this(header, nGenotypeFields, bytes, ALLOWED_BCF_VERSION, null);
+        }
+
+        public LazyData(final VCFHeader header, final int nGenotypeFields, final byte[] bytes,
+                        final BCFVersion bcfVersion, final List<String> dictionary) {
             this.header = header;
             this.nGenotypeFields = nGenotypeFields;
             this.bytes = bytes;
+            this.bcfVersion = bcfVersion;
+            this.dictionary = dictionary;
         }
     }
 
@@ -463,7 +647,10 @@ public class BCF2Codec extends BinaryFeatureCodec<VariantContext> {
     }
 
     protected final String getDictionaryString(final int offset) {
-        return dictionary.get(offset);
+        final String s = offset < dictionary.size() ? dictionary.get(offset) : null;
+        if ( s == null )
+            error("Dictionary offset " + offset + " is not defined in the BCF2 header");
+        return s;
     }
 
     /**
@@ -477,8 +664,8 @@ public class BCF2Codec extends BinaryFeatureCodec<VariantContext> {
         return contigNames.get(contigOffset);
     }
 
-    private final ArrayList<String> parseDictionary(final VCFHeader header) {
-        final ArrayList<String> dict = BCF2Utils.makeDictionary(header);
+    private final ArrayList<String> parseDictionary(final VCFHeader header, final boolean useIDX) {
+        final ArrayList<String> dict = useIDX ? BCF2Utils.makeDictionaryFromIDX(header) : BCF2Utils.makeDictionary(header);
 
         // if we got here we never found a dictionary, or there are no elements in the dictionary
         if ( dict.isEmpty() )
@@ -38,6 +38,11 @@ public final class BCF2Decoder {
     byte[] recordBytes = null;
     ByteArrayInputStream recordStream = null;
 
+    /**
+     * True when decoding BCF 2.2, whose vectors are padded with END_OF_VECTOR values rather than MISSING values
+     */
+    private boolean hasEndOfVectorValues = false;
+
     public BCF2Decoder() {
         // nothing to do
     }
@@ -114,6 +119,26 @@ public final class BCF2Decoder {
         this.recordStream = new ByteArrayInputStream(recordBytes);
     }
 
+    /**
+     * Decode values following the conventions of the given BCF version.  BCF 2.2 pads vectors with
+     * END_OF_VECTOR values, which are dropped along with MISSING values when decoding
+     *
+     * @param version the version of the BCF file being decoded
+     */
+    public void setBCFVersion(final BCFVersion version) {
+        this.hasEndOfVectorValues = version.getMinorVersion() >= 2;
+    }
+
+    /**
+     * Skip over bytes of the current block without decoding them
+     *
+     * @param nBytes the number of bytes to skip
+     */
+    public void skipBytes(final int nBytes) {
+        if ( recordStream.skip(nBytes) != nBytes )
+            throw new TribbleException("Cannot skip " + nBytes + " bytes past the end of the BCF2 block");
+    }
+
     // ----------------------------------------------------------------------
     //
     // High-level decoder
@@ -156,7 +181,7 @@ public final class BCF2Decoder {
         // TODO -- decodeTypedValue should integrate this routine
         final int value = decodeInt(type);
 
-        if ( value == type.getMissingBytes() )
+        if ( isMissingValue(type, value) )
             return null;
         else {
             switch (type) {
@@ -219,7 +244,7 @@ public final class BCF2Decoder {
     public final int decodeInt(final byte typeDescriptor, final int missingValue) throws IOException {
         final BCF2Type type = BCF2Utils.decodeType(typeDescriptor);
         final int i = decodeInt(type);
-        return i == type.getMissingBytes() ? missingValue : i;
+        return isMissingValue(type, i) ? missingValue : i;
     }
 
     public final int decodeInt(final BCF2Type type) throws IOException {
@@ -252,7 +277,7 @@ public final class BCF2Decoder {
                 maybeDest = null; // by nulling this out we ensure that we do fresh allocations as maybeDest is too small
 
             final int val1 = decodeInt(type);
-            if ( val1 == type.getMissingBytes() ) {
+            if ( isMissingValue(type, val1) ) {
                 // fast path for first element being missing
                 for ( int i = 1; i < size; i++ ) decodeInt(type);
                 return null;
@@ -262,7 +287,7 @@ public final class BCF2Decoder {
                 ints[0] = val1; // we already read the first one
                 for ( int i = 1; i < size; i++ ) {
                     ints[i] = decodeInt(type);
-                    if ( ints[i] == type.getMissingBytes() ) {
+                    if ( isMissingValue(type, ints[i]) ) {
                         // read the rest of the missing values, dropping them
                         for ( int j = i + 1; j < size; j++ ) decodeInt(type);
                         // deal with auto-pruning by returning an int[] containing
@@ -281,6 +306,17 @@ public final class BCF2Decoder {
         return decodeIntArray(size, type, null);
     }
 
+    /**
+     * Is value, as read by decodeInt, a MISSING value of type, or the END_OF_VECTOR value padding a BCF 2.2 vector?
+     *
+     * @param type the type the value was read with
+     * @param value the raw value
+     * @return true if value doesn't hold actual data
+     */
+    public final boolean isMissingValue(final BCF2Type type, final int value) {
+        return value == type.getMissingBytes() || (hasEndOfVectorValues && value == type.getEndOfVectorBytes());
+    }
+
     private double rawFloatToFloat(final int rawFloat) {
         return (double)Float.intBitsToFloat(rawFloat);
     }
@@ -141,11 +141,11 @@ public class BCF2GenotypeFieldDecoders {
                 final int a1 = decoder.decodeInt(type);
                 final int a2 = decoder.decodeInt(type);
 
-                if ( a1 == type.getMissingBytes() ) {
-                    assert a2 == type.getMissingBytes();
+                if ( decoder.isMissingValue(type, a1) ) {
+                    assert decoder.isMissingValue(type, a2);
                     // no called sample GT = .
                     gb.alleles(null);
-                } else if ( a2 == type.getMissingBytes() ) {
+                } else if ( decoder.isMissingValue(type, a2) ) {
                     gb.alleles(Arrays.asList(getAlleleFromEncoded(siteAlleles, a1)));
                 } else {
                     // downshift to remove phase
@@ -164,7 +164,8 @@ public class BCF2GenotypeFieldDecoders {
                     gb.alleles(gt);
                 }
 
-                final boolean phased = (a2 & 0x01) == 1;
+                // the BCF 2.2 END_OF_VECTOR value padding a haploid genotype has its low bit set, but isn't phased
+                final boolean phased = (a2 & 0x01) == 1 && ! decoder.isMissingValue(type, a2);
                 gb.phased(phased);
             }
         }
@@ -27,13 +27,17 @@ package htsjdk.variant.bcf2;
 
 import htsjdk.tribble.TribbleException;
 import htsjdk.variant.variantcontext.Allele;
+import htsjdk.variant.variantcontext.ColumnarGenotypes;
 import htsjdk.variant.variantcontext.Genotype;
 import htsjdk.variant.variantcontext.GenotypeBuilder;
 import htsjdk.variant.variantcontext.LazyGenotypesContext;
+import htsjdk.variant.vcf.VCFSampleSubset;
 
 import java.io.IOException;
 import java.util.ArrayList;
 import java.util.List;
+import java.util.Map;
+import java.util.Set;
 
 /**
  * Lazy version of genotypes decoder for BCF2 genotypes
@@ -50,14 +54,34 @@ public class BCF2LazyGenotypesDecoder implements LazyGenotypesContext.LazyParser
     private final int nSamples;
     private final int nFields;
     private final GenotypeBuilder[] builders;
+    private final boolean useColumnarGenotypes;
+    // the FORMAT fields to decode, or null for all of them
+    private final Set<String> fieldsToDecode;
+    // when only some samples are decoded, the index of the first sample of each run of consecutive selected samples,
+    // the builders of each run, and the selected samples; all null when every sample is decoded
+    private final int[] sampleRunStarts;
+    private final GenotypeBuilder[][] sampleRunBuilders;
+    private final VCFSampleSubset sampleSubset;
 
     BCF2LazyGenotypesDecoder(final BCF2Codec codec, final List<Allele> alleles, final int nSamples,
                              final int nFields, final GenotypeBuilder[] builders) {
+        this(codec, alleles, nSamples, nFields, builders, false, null, null, null, null);
+    }
+
+    BCF2LazyGenotypesDecoder(final BCF2Codec codec, final List<Allele> alleles, final int nSamples,
+                             final int nFields, final GenotypeBuilder[] builders, final boolean useColumnarGenotypes,
+                             final Set<String> fieldsToDecode, final int[] sampleRunStarts,
+                             final GenotypeBuilder[][] sampleRunBuilders, final VCFSampleSubset sampleSubset) {
         this.codec = codec;
         this.siteAlleles = alleles;
         this.nSamples = nSamples;
         this.nFields = nFields;
         this.builders = builders;
+        this.useColumnarGenotypes = useColumnarGenotypes;
+        this.fieldsToDecode = fieldsToDecode;
+        this.sampleRunStarts = sampleRunStarts;
+        this.sampleRunBuilders = sampleRunBuilders;
+        this.sampleSubset = sampleSubset;
     }
 
     @Override
@@ -66,9 +90,10 @@ public class BCF2LazyGenotypesDecoder implements LazyGenotypesContext.LazyParser
 
             // load our byte[] data into the decoder
             final BCF2Decoder decoder = new BCF2Decoder(((BCF2Codec.LazyData)data).bytes);
+            decoder.setBCFVersion(codec.getBCFVersion());
 
-            for ( int i = 0; i < nSamples; i++ )
-                builders[i].reset(true);
+            for ( final GenotypeBuilder gb : builders )
+                gb.reset(true);
 
             for ( int i = 0; i < nFields; i++ ) {
                 // get the field name
@@ -78,20 +103,47 @@ public class BCF2LazyGenotypesDecoder implements LazyGenotypesContext.LazyParser
                 // the type of each element
                 final byte typeDescriptor = decoder.readTypeDescriptor();
                 final int numElements = decoder.decodeNumberOfElements(typeDescriptor);
+                if ( fieldsToDecode != null && ! fieldsToDecode.contains(field) ) {
+                    // the values of every sample have the same size, so the field is skipped without decoding it
+                    decoder.skipBytes(nSamples * numElements * BCF2Utils.decodeType(typeDescriptor).getSizeInBytes());
+                    continue;
+                }
                 final BCF2GenotypeFieldDecoders.Decoder fieldDecoder = codec.getGenotypeFieldDecoder(field);
                 try {
-                    fieldDecoder.decode(siteAlleles, field, decoder, typeDescriptor, numElements, builders);
+                    if ( sampleRunStarts == null ) {
+                        fieldDecoder.decode(siteAlleles, field, decoder, typeDescriptor, numElements, builders);
+                    } else {
+                        // decode the values of each run of selected samples, skipping over those of the other samples
+                        final int sampleSize = numElements * BCF2Utils.decodeType(typeDescriptor).getSizeInBytes();
+                        int nextSample = 0;
+                        for ( int run = 0; run < sampleRunStarts.length; run++ ) {
+                            decoder.skipBytes((sampleRunStarts[run] - nextSample) * sampleSize);
+                            fieldDecoder.decode(siteAlleles, field, decoder, typeDescriptor, numElements, sampleRunBuilders[run]);
+                            nextSample = sampleRunStarts[run] + sampleRunBuilders[run].length;
+                        }
+                        decoder.skipBytes((nSamples - nextSample) * sampleSize);
+                    }
                 } catch ( ClassCastException e ) {
                     throw new TribbleException("BUG: expected encoding of field " + field
                             + " inconsistent with the value observed in the decoded value");
                 }
             }
 
-            final ArrayList<Genotype> genotypes = new ArrayList<Genotype>(nSamples);
+            final List<String> sampleNamesInOrder = sampleSubset == null ? codec.getHeader().getSampleNamesInOrder() : sampleSubset.getSampleNamesInOrder();
+            final Map<String, Integer> sampleNameToOffset = sampleSubset == null ? codec.getHeader().getSampleNameToOffset() : sampleSubset.getSampleNameToOffset();
+
+            if ( useColumnarGenotypes ) {
+                final ColumnarGenotypes.Builder columns = new ColumnarGenotypes.Builder(builders.length);
+                for ( final GenotypeBuilder gb : builders )
+                    columns.add(gb);
+                return new LazyGenotypesContext.LazyData(columns.make(), sampleNamesInOrder, sampleNameToOffset);
+            }
+
+            final ArrayList<Genotype> genotypes = new ArrayList<Genotype>(builders.length);
             for ( final GenotypeBuilder gb : builders )
                 genotypes.add(gb.make());
 
-            return new LazyGenotypesContext.LazyData(genotypes, codec.getHeader().getSampleNamesInOrder(), codec.getHeader().getSampleNameToOffset());
+            return new LazyGenotypesContext.LazyData(genotypes, sampleNamesInOrder, sampleNameToOffset);
         } catch ( IOException e ) {
             throw new TribbleException("Unexpected IOException parsing already read genotypes data block", e);
         }
@@ -38,7 +38,7 @@ import java.util.EnumSet;
  */
 public enum BCF2Type {
     // the actual values themselves
-    MISSING(0, 0, 0x00) {
+    MISSING(0, 0, 0x00, 0x00) {
         @Override public int read(final InputStream in) throws IOException {
             throw new IllegalArgumentException("Cannot read MISSING type");
         }
@@ -47,7 +47,7 @@ public enum BCF2Type {
         }
     },
 
-    INT8 (1, 1, 0xFFFFFF80,        -127,        127) {
+    INT8 (1, 1, 0xFFFFFF80, 0xFFFFFF81,        -120,        127) {
         @Override
         public int read(final InputStream in) throws IOException {
             return BCF2Utils.readByte(in);
@@ -59,7 +59,7 @@ public enum BCF2Type {
         }
     },
 
-    INT16(2, 2, 0xFFFF8000,      -32767,      32767) {
+    INT16(2, 2, 0xFFFF8000, 0xFFFF8001,      -32760,      32767) {
         @Override
         public int read(final InputStream in) throws IOException {
             final int b2 = BCF2Utils.readByte(in) & 0xFF;
@@ -75,7 +75,7 @@ public enum BCF2Type {
         }
     },
 
-    INT32(3, 4, 0x80000000, -2147483647, 2147483647) {
+    INT32(3, 4, 0x80000000, 0x80000001, -2147483640, 2147483647) {
         @Override
         public int read(final InputStream in) throws IOException {
             final int b4 = BCF2Utils.readByte(in) & 0xFF;
@@ -94,7 +94,7 @@ public enum BCF2Type {
         }
     },
 
-    FLOAT(5, 4, 0x7F800001) {
+    FLOAT(5, 4, 0x7F800001, 0x7F800002) {
         @Override
         public int read(final InputStream in) throws IOException {
             return INT32.read(in);
@@ -106,7 +106,7 @@ public enum BCF2Type {
         }
     },
 
-    CHAR (7, 1, 0x00000000) {
+    CHAR (7, 1, 0x00000000, 0x00000000) {
         @Override
         public int read(final InputStream in) throws IOException {
             return INT8.read(in);
@@ -121,18 +121,20 @@ public enum BCF2Type {
     private final int id;
     private final Object missingJavaValue;
     private final int missingBytes;
+    private final int endOfVectorBytes;
     private final int sizeInBytes;
     private final long minValue, maxValue;
 
-    BCF2Type(final int id, final int sizeInBytes, final int missingBytes) {
-        this(id, sizeInBytes, missingBytes, 0, 0);
+    BCF2Type(final int id, final int sizeInBytes, final int missingBytes, final int endOfVectorBytes) {
+        this(id, sizeInBytes, missingBytes, endOfVectorBytes, 0, 0);
     }
 
-    BCF2Type(final int id, final int sizeInBytes, final int missingBytes, final long minValue, final long maxValue) {
+    BCF2Type(final int id, final int sizeInBytes, final int missingBytes, final int endOfVectorBytes, final long minValue, final long maxValue) {
         this.id = id;
         this.sizeInBytes = sizeInBytes;
         this.missingJavaValue = null;
         this.missingBytes = missingBytes;
+        this.endOfVectorBytes = endOfVectorBytes;
         this.minValue = minValue;
         this.maxValue = maxValue;
     }
@@ -154,7 +156,9 @@ public enum BCF2Type {
     /**
      * Can we encode value v in this type, according to its declared range.
      *
-     * Only makes sense for integer values
+     * Only makes sense for integer values.  The smallest values of each integer type are reserved by BCF 2.2 for
+     * the missing and end-of-vector sentinels, so they are never used for real values, which keeps the integer
+     * encoding the same in BCF 2.1 and 2.2
      *
      * @param v
      * @return
@@ -177,6 +181,14 @@ public enum BCF2Type {
      */
     public int getMissingBytes() { return missingBytes; }
 
+    /**
+     * The bytes (encoded as an int) that BCF 2.2 uses to pad a vector after its last value.
+     * BCF 2.1 pads vectors with the missing value instead
+     *
+     * @return
+     */
+    public int getEndOfVectorBytes() { return endOfVectorBytes; }
+
     /**
      * An enum set of the types that might represent Integer values
      */
@@ -40,7 +40,10 @@ import java.util.Arrays;
 import java.util.Collections;
 import java.util.HashSet;
 import java.util.Iterator;
+import java.util.LinkedHashMap;
+import java.util.LinkedHashSet;
 import java.util.List;
+import java.util.Map;
 import java.util.Set;
 
 /**
@@ -104,6 +107,104 @@ public final class BCF2Utils {
         return dict;
     }
 
+    /**
+     * Create the strings dictionary of a BCF 2.2 file from its header
+     *
+     * BCF 2.2 header lines may fix the offset of their ID in the dictionary with an IDX attribute.  Lines
+     * without one take the next offset, as in {@link #makeDictionary(VCFHeader)}, so a header without any
+     * IDX attributes gives the same dictionary as in BCF 2.1.  Offsets no line claims are left null.
+     *
+     * @param header the VCFHeader from which to build the dictionary
+     * @return a non-null dictionary of elements, may be empty
+     */
+    public static ArrayList<String> makeDictionaryFromIDX(final VCFHeader header) {
+        final Set<String> seen = new HashSet<String>();
+        final ArrayList<String> dict = new ArrayList<String>();
+
+        // PASS is always at offset 0, whether or not the header has a FILTER line for it
+        seen.add(VCFConstants.PASSES_FILTERS_v4);
+        dict.add(VCFConstants.PASSES_FILTERS_v4);
+
+        // the same ID in INFO and FORMAT lines shares a single offset
+        for ( final VCFHeaderLine line : header.getMetaDataInInputOrder() ) {
+            if ( line.shouldBeAddedToDictionary() ) {
+                final String id = ((VCFIDHeaderLine)line).getID();
+                if ( seen.add(id) )
+                    addToDictionary(dict, getIDX(line), id);
+            }
+        }
+
+        return dict;
+    }
+
+    /**
+     * Add id to a BCF dictionary, at the offset given by idx or at the end if idx is null
+     *
+     * @param dict the dictionary, grown with null entries as needed
+     * @param idx the value of the IDX attribute of the header line of id, or null
+     * @param id the string to add
+     */
+    public static void addToDictionary(final List<String> dict, final String idx, final String id) {
+        if ( idx == null ) {
+            dict.add(id);
+            return;
+        }
+
+        final int offset;
+        try {
+            offset = Integer.parseInt(idx);
+        } catch ( NumberFormatException e ) {
+            throw new TribbleException("Invalid " + VCFConstants.BCF_IDX_ATTRIBUTE + " value " + idx + " for " + id + " in BCF2 header");
+        }
+        if ( offset < 0 )
+            throw new TribbleException("Negative " + VCFConstants.BCF_IDX_ATTRIBUTE + " value " + idx + " for " + id + " in BCF2 header");
+
+        while ( dict.size() <= offset )
+            dict.add(null);
+        final String previous = dict.get(offset);
+        if ( previous != null && ! previous.equals(id) )
+            throw new TribbleException("BCF2 header gives both " + previous + " and " + id + " the " + VCFConstants.BCF_IDX_ATTRIBUTE + " " + offset);
+        dict.set(offset, id);
+    }
+
+    /**
+     * @param line a header line
+     * @return the value of the BCF 2.2 IDX attribute of line, or null if it has none
+     */
+    public static String getIDX(final VCFHeaderLine line) {
+        if ( line instanceof VCFCompoundHeaderLine )
+            return ((VCFCompoundHeaderLine)line).getIDX();
+        else if ( line instanceof VCFSimpleHeaderLine )
+            return ((VCFSimpleHeaderLine)line).getGenericFields().get(VCFConstants.BCF_IDX_ATTRIBUTE);
+        else
+            return null;
+    }
+
+    /**
+     * Drop the BCF 2.2 IDX attributes of FILTER and contig lines, which give offsets into the dictionaries
+     * of the file the lines were read from, before the lines are written to another BCF file.  INFO and FORMAT
+     * lines never write their IDX attribute
+     *
+     * @param lines the header lines
+     * @return the lines in the same order, with new FILTER and contig lines where needed
+     */
+    public static Set<VCFHeaderLine> removeIDX(final Set<VCFHeaderLine> lines) {
+        final Set<VCFHeaderLine> result = new LinkedHashSet<VCFHeaderLine>(lines.size());
+        for ( final VCFHeaderLine line : lines ) {
+            if ( line instanceof VCFContigHeaderLine && getIDX(line) != null ) {
+                final Map<String, String> fields = new LinkedHashMap<String, String>(((VCFContigHeaderLine)line).getGenericFields());
+                fields.remove(VCFConstants.BCF_IDX_ATTRIBUTE);
+                result.add(new VCFContigHeaderLine(fields, ((VCFContigHeaderLine)line).getContigIndex()));
+            } else if ( line instanceof VCFFilterHeaderLine && getIDX(line) != null ) {
+                final VCFFilterHeaderLine filter = (VCFFilterHeaderLine)line;
+                result.add(new VCFFilterHeaderLine(filter.getID(), filter.getDescription() == null ? "" : filter.getDescription()));
+            } else {
+                result.add(line);
+            }
+        }
+        return result;
+    }
+
     public static byte encodeTypeDescriptor(final int nElements, final BCF2Type type ) {
         return (byte)((0x0F & nElements) << 4 | (type.getID() & 0x0F));
     }
@@ -0,0 +1,97 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.variant.variantcontext;
+
+import java.util.List;
+import java.util.Map;
+
+/**
+ * A {@link Genotype} view of one sample in {@link ColumnarGenotypes}.  Holds only a reference to the columns and the
+ * sample's index, so creating one is cheap; AD, PL and the extended attributes are copied out of the columns each
+ * time they are requested.
+ */
+final class ColumnarGenotype extends Genotype {
+    public static final long serialVersionUID = 1L;
+
+    private final ColumnarGenotypes columns;
+    private final int index;
+
+    ColumnarGenotype(final ColumnarGenotypes columns, final int index) {
+        super(columns.getSampleName(index), columns.getFilters(index));
+        this.columns = columns;
+        this.index = index;
+    }
+
+    @Override public List<Allele> getAlleles() {
+        return columns.getAlleles(index);
+    }
+
+    @Override public Allele getAllele(final int i) {
+        return columns.getAlleles(index).get(i);
+    }
+
+    @Override public boolean isPhased() {
+        return columns.isPhased(index);
+    }
+
+    @Override public int getDP() {
+        return columns.getDP(index);
+    }
+
+    @Override public int[] getAD() {
+        return columns.getAD(index);
+    }
+
+    @Override public boolean hasAD() {
+        return columns.hasAD(index);
+    }
+
+    @Override public int getGQ() {
+        return columns.getGQ(index);
+    }
+
+    @Override public int[] getPL() {
+        return columns.getPL(index);
+    }
+
+    @Override public boolean hasPL() {
+        return columns.hasPL(index);
+    }
+
+    @Override
+    public Map<String, Object> getExtendedAttributes() {
+        return columns.getExtendedAttributes(index);
+    }
+
+    @Override
+    public boolean hasExtendedAttribute(final String key) {
+        return columns.getExtendedAttribute(index, key) != null;
+    }
+
+    @Override
+    public Object getExtendedAttribute(final String key, final Object defaultValue) {
+        final Object value = columns.getExtendedAttribute(index, key);
+        return value == null ? defaultValue : value;
+    }
+}
@@ -0,0 +1,418 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.variant.variantcontext;
+
+import java.io.Serializable;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.BitSet;
+import java.util.Collections;
+import java.util.HashMap;
+import java.util.LinkedHashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.Objects;
+
+/**
+ * The genotypes of every sample at a site, stored column by column rather than as one {@link Genotype} object per
+ * sample.
+ *
+ * GT is stored as an index into the distinct allele lists seen at the site (in practice a handful, such as 0/0, 0/1
+ * and ./.), GQ and DP as int arrays, AD and PL as flat int arrays with per-sample offsets, and other FORMAT fields as
+ * one array of values per key.  For cohorts of hundreds of thousands of samples this takes a few bytes per sample per
+ * field, compared to the several objects per sample that {@link FastGenotype} requires.
+ *
+ * {@link Genotype} objects are created on demand, by {@link #getGenotype(int)}, as lightweight views over the columns.
+ * A {@link GenotypesContext} created from columnar genotypes hands out such views, the same one for a sample each time,
+ * and only converts to one Genotype object per sample if it is modified.  Instances are immutable and are built with a {@link Builder}.
+ */
+public final class ColumnarGenotypes implements Serializable {
+    public static final long serialVersionUID = 1L;
+
+    private final String[] sampleNames;
+
+    // GT: genotypeAlleles.get(genotypeIndex[i]) and genotypePhased[genotypeIndex[i]] are the alleles and phasing of sample i
+    private final List<List<Allele>> genotypeAlleles;
+    private final boolean[] genotypePhased;
+    private final int[] genotypeIndex;
+
+    // -1 if missing; null if missing for every sample
+    private final int[] GQ;
+    private final int[] DP;
+
+    // null if missing for every sample
+    private final IntArrayColumn AD;
+    private final IntArrayColumn PL;
+
+    // null if no sample is filtered
+    private final String[] filters;
+
+    // one value per sample, null where missing, for each extended attribute key
+    private final Map<String, Object[]> attributes;
+
+    private ColumnarGenotypes(final Builder builder) {
+        final int n = builder.size;
+        this.sampleNames = Arrays.copyOf(builder.sampleNames, n);
+        this.genotypeAlleles = Collections.unmodifiableList(builder.genotypeAlleles);
+        this.genotypePhased = new boolean[builder.genotypeAlleles.size()];
+        for (final Map.Entry<GenotypeKey, Integer> e : builder.genotypeKeys.entrySet()) {
+            genotypePhased[e.getValue()] = e.getKey().phased;
+        }
+        this.genotypeIndex = Arrays.copyOf(builder.genotypeIndex, n);
+        this.GQ = builder.GQ == null ? null : Arrays.copyOf(builder.GQ, n);
+        this.DP = builder.DP == null ? null : Arrays.copyOf(builder.DP, n);
+        this.AD = builder.AD == null ? null : builder.AD.make(n);
+        this.PL = builder.PL == null ? null : builder.PL.make(n);
+        this.filters = builder.filters == null ? null : Arrays.copyOf(builder.filters, n);
+        this.attributes = new LinkedHashMap<>(builder.attributes.size());
+        for (final Map.Entry<String, Object[]> e : builder.attributes.entrySet()) {
+            this.attributes.put(e.getKey(), Arrays.copyOf(e.getValue(), n));
+        }
+    }
+
+    /** @return the number of samples */
+    public int size() {
+        return sampleNames.length;
+    }
+
+    /** @return the name of the i'th sample */
+    public String getSampleName(final int i) {
+        return sampleNames[i];
+    }
+
+    /** @return a Genotype view of the i'th sample */
+    public Genotype getGenotype(final int i) {
+        return new ColumnarGenotype(this, i);
+    }
+
+    /** @return the alleles of the i'th sample's genotype.  The list is shared by all samples with the same genotype. */
+    public List<Allele> getAlleles(final int i) {
+        return genotypeAlleles.get(genotypeIndex[i]);
+    }
+
+    /** @return true if the i'th sample's genotype is phased */
+    public boolean isPhased(final int i) {
+        return genotypePhased[genotypeIndex[i]];
+    }
+
+    /** @return the GQ of the i'th sample, or -1 if missing */
+    public int getGQ(final int i) {
+        return GQ == null ? -1 : GQ[i];
+    }
+
+    /** @return the DP of the i'th sample, or -1 if missing */
+    public int getDP(final int i) {
+        return DP == null ? -1 : DP[i];
+    }
+
+    /** @return true if the i'th sample has AD */
+    public boolean hasAD(final int i) {
+        return AD != null && AD.isPresent(i);
+    }
+
+    /** @return a copy of the AD of the i'th sample, or null if missing */
+    public int[] getAD(final int i) {
+        return AD == null ? null : AD.get(i);
+    }
+
+    /** @return true if the i'th sample has PL */
+    public boolean hasPL(final int i) {
+        return PL != null && PL.isPresent(i);
+    }
+
+    /** @return a copy of the PL of the i'th sample, or null if missing */
+    public int[] getPL(final int i) {
+        return PL == null ? null : PL.get(i);
+    }
+
+    /** @return the filters of the i'th sample, or null if it is not filtered */
+    public String getFilters(final int i) {
+        return filters == null ? null : filters[i];
+    }
+
+    /** @return the keys of the extended attributes present in any sample */
+    public List<String> getExtendedAttributeKeys() {
+        return Collections.unmodifiableList(new ArrayList<>(attributes.keySet()));
+    }
+
+    /** @return the value of an extended attribute for the i'th sample, or null if missing */
+    public Object getExtendedAttribute(final int i, final String key) {
+        final Object[] values = attributes.get(key);
+        return values == null ? null : values[i];
+    }
+
+    /** @return a freshly allocated map of the extended attributes of the i'th sample */
+    public Map<String, Object> getExtendedAttributes(final int i) {
+        Map<String, Object> result = null;
+        for (final Map.Entry<String, Object[]> e : attributes.entrySet()) {
+            final Object value = e.getValue()[i];
+            if (value != null) {
+                if (result == null) {
+                    result = new HashMap<>();
+                }
+                result.put(e.getKey(), value);
+            }
+        }
+        return result == null ? Collections.emptyMap() : result;
+    }
+
+    /** @return the largest ploidy of any sample's genotype, or 0 if there are no called genotypes */
+    public int getMaxPloidy() {
+        int maxPloidy = 0;
+        final boolean[] used = new boolean[genotypeAlleles.size()];
+        for (final int index : genotypeIndex) {
+            used[index] = true;
+        }
+        for (int i = 0; i < used.length; i++) {
+            if (used[i]) {
+                maxPloidy = Math.max(maxPloidy, genotypeAlleles.get(i).size());
+            }
+        }
+        return maxPloidy;
+    }
+
+    /**
+     * Int array values for each sample, held in one flat array.  The values of sample i are
+     * values[starts[i], starts[i + 1]), and are missing if the sample is not in present.
+     */
+    private static final class IntArrayColumn implements Serializable {
+        public static final long serialVersionUID = 1L;
+
+        private final int[] starts;
+        private final int[] values;
+        private final BitSet present;
+
+        private IntArrayColumn(final int[] starts, final int[] values, final BitSet present) {
+            this.starts = starts;
+            this.values = values;
+            this.present = present;
+        }
+
+        boolean isPresent(final int i) {
+            return present.get(i);
+        }
+
+        int[] get(final int i) {
+            return present.get(i) ? Arrays.copyOfRange(values, starts[i], starts[i + 1]) : null;
+        }
+    }
+
+    /** Accumulates an {@link IntArrayColumn} one sample at a time. */
+    private static final class IntArrayColumnBuilder {
+        private int[] starts;
+        private int[] values;
+        private final BitSet present = new BitSet();
+        private int size = 0;
+
+        IntArrayColumnBuilder(final int expectedSamples, final int firstSample) {
+            starts = new int[Math.max(expectedSamples, firstSample) + 1];
+            values = new int[Math.max(expectedSamples, 16)];
+            // samples before the first one with a value are all missing
+            size = firstSample;
+        }
+
+        void add(final int sample, final int[] array) {
+            while (size < sample) {
+                set(null);
+            }
+            set(array);
+        }
+
+        private void set(final int[] array) {
+            if (size + 2 > starts.length) {
+                starts = Arrays.copyOf(starts, starts.length * 2);
+            }
+            final int start = starts[size];
+            if (array != null) {
+                if (start + array.length > values.length) {
+                    values = Arrays.copyOf(values, Math.max(values.length * 2, start + array.length));
+                }
+                System.arraycopy(array, 0, values, start, array.length);
+                present.set(size);
+                starts[size + 1] = start + array.length;
+            } else {
+                starts[size + 1] = start;
+            }
+            size++;
+        }
+
+        IntArrayColumn make(final int nSamples) {
+            while (size < nSamples) {
+                set(null);
+            }
+            return new IntArrayColumn(Arrays.copyOf(starts, nSamples + 1), Arrays.copyOf(values, starts[nSamples]), (BitSet) present.clone());
+        }
+    }
+
+    private static final class GenotypeKey {
+        private final List<Allele> alleles;
+        private final boolean phased;
+
+        GenotypeKey(final List<Allele> alleles, final boolean phased) {
+            this.alleles = alleles;
+            this.phased = phased;
+        }
+
+        @Override
+        public boolean equals(final Object o) {
+            if (this == o) return true;
+            if (o == null || getClass() != o.getClass()) return false;
+            final GenotypeKey that = (GenotypeKey) o;
+            return phased == that.phased && alleles.equals(that.alleles);
+        }
+
+        @Override
+        public int hashCode() {
+            return Objects.hash(alleles, phased);
+        }
+    }
+
+    /**
+     * Accumulates the genotypes of a site one sample at a time, in sample order.  Values can be added from a
+     * {@link GenotypeBuilder}, without creating a Genotype, or from a Genotype.
+     */
+    public static final class Builder {
+        private final int expectedSamples;
+        private String[] sampleNames;
+        private int size = 0;
+
+        private final List<List<Allele>> genotypeAlleles = new ArrayList<>();
+        private final Map<GenotypeKey, Integer> genotypeKeys = new HashMap<>();
+        private int[] genotypeIndex;
+        // the most recently added genotype, as neighbouring samples very often have the same genotype
+        private List<Allele> lastAlleles = null;
+        private boolean lastPhased = false;
+        private int lastIndex = -1;
+
+        private int[] GQ = null;
+        private int[] DP = null;
+        private IntArrayColumnBuilder AD = null;
+        private IntArrayColumnBuilder PL = null;
+        private String[] filters = null;
+        private final Map<String, Object[]> attributes = new LinkedHashMap<>();
+
+        /**
+         * @param expectedSamples the expected number of samples, used to size the columns
+         */
+        public Builder(final int expectedSamples) {
+            this.expectedSamples = Math.max(expectedSamples, 1);
+            this.sampleNames = new String[this.expectedSamples];
+            this.genotypeIndex = new int[this.expectedSamples];
+        }
+
+        /** Adds the next sample, with the values currently set in a GenotypeBuilder. */
+        public Builder add(final GenotypeBuilder genotypeBuilder) {
+            genotypeBuilder.appendTo(this);
+            return this;
+        }
+
+        /** Adds the next sample, with the values of a Genotype. */
+        public Builder add(final Genotype genotype) {
+            return add(genotype.getSampleName(), genotype.getAlleles(), genotype.isPhased(), genotype.getGQ(),
+                    genotype.getDP(), genotype.getAD(), genotype.getPL(), genotype.getFilters(),
+                    genotype.getExtendedAttributes());
+        }
+
+        /** @return the number of samples added so far */
+        public int size() {
+            return size;
+        }
+
+        Builder add(final String sampleName, final List<Allele> alleles, final boolean phased, final int gq,
+                    final int dp, final int[] ad, final int[] pl, final String filter,
+                    final Map<String, Object> extendedAttributes) {
+            if (size == sampleNames.length) {
+                final int newCapacity = size * 2;
+                sampleNames = Arrays.copyOf(sampleNames, newCapacity);
+                genotypeIndex = Arrays.copyOf(genotypeIndex, newCapacity);
+                if (GQ != null) GQ = grow(GQ, newCapacity);
+                if (DP != null) DP = grow(DP, newCapacity);
+                if (filters != null) filters = Arrays.copyOf(filters, newCapacity);
+                for (final Map.Entry<String, Object[]> e : attributes.entrySet()) {
+                    e.setValue(Arrays.copyOf(e.getValue(), newCapacity));
+                }
+            }
+            final int i = size++;
+            sampleNames[i] = sampleName;
+            genotypeIndex[i] = indexOf(alleles, phased);
+
+            if (gq != -1) {
+                if (GQ == null) GQ = grow(new int[0], sampleNames.length);
+                GQ[i] = gq;
+            }
+            if (dp != -1) {
+                if (DP == null) DP = grow(new int[0], sampleNames.length);
+                DP[i] = dp;
+            }
+            if (ad != null) {
+                if (AD == null) AD = new IntArrayColumnBuilder(expectedSamples, i);
+                AD.add(i, ad);
+            }
+            if (pl != null) {
+                if (PL == null) PL = new IntArrayColumnBuilder(expectedSamples, i);
+                PL.add(i, pl);
+            }
+            if (filter != null) {
+                if (filters == null) filters = new String[sampleNames.length];
+                filters[i] = filter;
+            }
+            if (extendedAttributes != null) {
+                for (final Map.Entry<String, Object> e : extendedAttributes.entrySet()) {
+                    attributes.computeIfAbsent(e.getKey(), k -> new Object[sampleNames.length])[i] = e.getValue();
+                }
+            }
+            return this;
+        }
+
+        private int indexOf(final List<Allele> alleles, final boolean phased) {
+            if (phased == lastPhased && (alleles == lastAlleles || alleles.equals(lastAlleles))) {
+                return lastIndex;
+            }
+            final GenotypeKey key = new GenotypeKey(alleles, phased);
+            Integer index = genotypeKeys.get(key);
+            if (index == null) {
+                final List<Allele> copy = Collections.unmodifiableList(new ArrayList<>(alleles));
+                index = genotypeAlleles.size();
+                genotypeAlleles.add(copy);
+                genotypeKeys.put(new GenotypeKey(copy, phased), index);
+            }
+            lastAlleles = alleles;
+            lastPhased = phased;
+            lastIndex = index;
+            return index;
+        }
+
+        /** @return a copy of values with the given length, in which any new elements are -1 (missing) */
+        private static int[] grow(final int[] values, final int length) {
+            final int[] grown = Arrays.copyOf(values, length);
+            Arrays.fill(grown, values.length, length, -1);
+            return grown;
+        }
+
+        /** @return the columnar genotypes of the samples added so far */
+        public ColumnarGenotypes make() {
+            return new ColumnarGenotypes(this);
+        }
+    }
+}
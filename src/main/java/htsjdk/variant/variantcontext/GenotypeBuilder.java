@@ -219,6 +219,16 @@ public final class GenotypeBuilder {
         return new FastGenotype(sampleName, al, isPhased, GQ, DP, copyAD, copyPL, filters, ea);
     }
 
+    /**
+     * Add the values set in this builder as the next sample of a {@link ColumnarGenotypes.Builder}, without creating a
+     * Genotype.  The values are copied, so this builder can be reset and reused for the next sample.
+     *
+     * @param columns the columnar genotypes being built
+     */
+    void appendTo(final ColumnarGenotypes.Builder columns) {
+        columns.add(sampleName, alleles, isPhased, GQ, DP, AD, PL, filters, extendedAttributes);
+    }
+
     /**
      * Set this genotype's name
      * @param sampleName
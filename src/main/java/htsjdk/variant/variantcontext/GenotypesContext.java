@@ -37,6 +37,7 @@ import java.util.Iterator;
 import java.util.List;
 import java.util.ListIterator;
 import java.util.Map;
+import java.util.NoSuchElementException;
 import java.util.Set;
 
 /**
@@ -72,6 +73,21 @@ public class GenotypesContext implements List<Genotype>, Serializable {
      */
     protected ArrayList<Genotype> notToBeDirectlyAccessedGenotypes;
 
+    /**
+     * The genotypes of this context stored column by column, if it was created from {@link ColumnarGenotypes}
+     * and has not yet needed a list of genotypes.  While this is non-null notToBeDirectlyAccessedGenotypes
+     * is not used.
+     *
+     * WARNING: AS FOR notToBeDirectlyAccessedGenotypes, USE getColumnarGenotypes() INSTEAD.
+     */
+    protected ColumnarGenotypes notToBeDirectlyAccessedColumnarGenotypes = null;
+
+    /**
+     * The views over the columnar genotypes handed out so far, by sample offset, so that the same Genotype is
+     * returned for a sample each time and can be found again by contains(), indexOf() and remove()
+     */
+    private transient Genotype[] columnarGenotypeViews = null;
+
     /**
      * Cached value of the maximum ploidy observed among all samples
      */
@@ -147,6 +163,22 @@ public class GenotypesContext implements List<Genotype>, Serializable {
         this.sampleNamesInOrder = sampleNamesInOrder;
     }
 
+    /**
+     * Create a GenotypeContext whose genotypes are views over columnar genotypes
+     *
+     * @param genotypes the genotypes, in order
+     * @param sampleNameToOffset map from sample name to offset in genotypes, or null to compute it when needed
+     * @param sampleNamesInOrder the sample names sorted in alphabetical order, or null to compute them when needed
+     */
+    protected GenotypesContext(final ColumnarGenotypes genotypes,
+                               final Map<String, Integer> sampleNameToOffset,
+                               final List<String> sampleNamesInOrder) {
+        this.notToBeDirectlyAccessedGenotypes = null;
+        this.notToBeDirectlyAccessedColumnarGenotypes = genotypes;
+        this.sampleNameToOffset = sampleNameToOffset;
+        this.sampleNamesInOrder = sampleNamesInOrder;
+    }
+
     // ---------------------------------------------------------------------------
     //
     // public static factory methods
@@ -197,6 +229,17 @@ public class GenotypesContext implements List<Genotype>, Serializable {
         return genotypes == null ? NO_GENOTYPES : new GenotypesContext(genotypes);
     }
 
+    /**
+     * Create a GenotypeContext containing columnar genotypes.  Genotypes are returned as lightweight views over the
+     * columns until the context is modified, at which point it holds a list of the views instead.
+     *
+     * @param genotypes our genotypes, stored column by column
+     * @return an mutable GenotypeContext containing genotypes
+     */
+    public static final GenotypesContext create(final ColumnarGenotypes genotypes) {
+        return genotypes == null ? NO_GENOTYPES : new GenotypesContext(genotypes, null, null);
+    }
+
     /**
      * Create a fully resolved GenotypeContext containing genotypes
      *
@@ -266,8 +309,9 @@ public class GenotypesContext implements List<Genotype>, Serializable {
         if ( sampleNamesInOrder == null ) {
             sampleNamesInOrder = new ArrayList<String>(size());
 
+            final ColumnarGenotypes columns = getColumnarGenotypes();
             for ( int i = 0; i < size(); i++ ) {
-                sampleNamesInOrder.add(getGenotypes().get(i).getSampleName());
+                sampleNamesInOrder.add(columns != null ? columns.getSampleName(i) : getGenotypes().get(i).getSampleName());
             }
             Collections.sort(sampleNamesInOrder);
         }
@@ -277,8 +321,9 @@ public class GenotypesContext implements List<Genotype>, Serializable {
         if ( sampleNameToOffset == null ) {
             sampleNameToOffset = new HashMap<String, Integer>(size());
 
+            final ColumnarGenotypes columns = getColumnarGenotypes();
             for ( int i = 0; i < size(); i++ ) {
-                sampleNameToOffset.put(getGenotypes().get(i).getSampleName(), i);
+                sampleNameToOffset.put(columns != null ? columns.getSampleName(i) : getGenotypes().get(i).getSampleName(), i);
             }
         }
     }
@@ -300,10 +345,43 @@ public class GenotypesContext implements List<Genotype>, Serializable {
     //
     // ---------------------------------------------------------------------------
 
+    /**
+     * Returns the list of genotypes, first converting any columnar genotypes to a list of views over the columns
+     */
     protected ArrayList<Genotype> getGenotypes() {
+        final ColumnarGenotypes columns = notToBeDirectlyAccessedColumnarGenotypes;
+        if ( columns != null ) {
+            final ArrayList<Genotype> genotypes = new ArrayList<Genotype>(columns.size());
+            for ( int i = 0; i < columns.size(); i++ ) {
+                genotypes.add(getColumnarGenotypeView(columns, i));
+            }
+            notToBeDirectlyAccessedGenotypes = genotypes;
+            notToBeDirectlyAccessedColumnarGenotypes = null;
+            columnarGenotypeViews = null;
+        }
         return notToBeDirectlyAccessedGenotypes;
     }
 
+    /**
+     * @return the view of the i'th sample of columns, the same one each time it is asked for
+     */
+    private Genotype getColumnarGenotypeView(final ColumnarGenotypes columns, final int i) {
+        if ( columnarGenotypeViews == null ) {
+            columnarGenotypeViews = new Genotype[columns.size()];
+        }
+        if ( columnarGenotypeViews[i] == null ) {
+            columnarGenotypeViews[i] = columns.getGenotype(i);
+        }
+        return columnarGenotypeViews[i];
+    }
+
+    /**
+     * @return the columnar genotypes of this context, or null if it holds a list of genotypes
+     */
+    protected ColumnarGenotypes getColumnarGenotypes() {
+        return notToBeDirectlyAccessedColumnarGenotypes;
+    }
+
     @Override
     public void clear() {
         checkImmutability();
@@ -314,12 +392,13 @@ public class GenotypesContext implements List<Genotype>, Serializable {
 
     @Override
     public int size() {
-        return getGenotypes().size();
+        final ColumnarGenotypes columns = getColumnarGenotypes();
+        return columns != null ? columns.size() : getGenotypes().size();
     }
 
     @Override
     public boolean isEmpty() {
-        return getGenotypes().isEmpty();
+        return size() == 0;
     }
 
     /**
@@ -414,7 +493,8 @@ public class GenotypesContext implements List<Genotype>, Serializable {
 
     @Override
     public Genotype get(final int i) {
-        return getGenotypes().get(i);
+        final ColumnarGenotypes columns = getColumnarGenotypes();
+        return columns != null ? getColumnarGenotypeView(columns, i) : getGenotypes().get(i);
     }
 
     /**
@@ -428,8 +508,13 @@ public class GenotypesContext implements List<Genotype>, Serializable {
 
         if ( maxPloidy == -1 ) {
             maxPloidy = 0; // necessary in the case where there are no genotypes
-            for ( final Genotype g : getGenotypes() ) {
-                maxPloidy = Math.max(g.getPloidy(), maxPloidy);
+            final ColumnarGenotypes columns = getColumnarGenotypes();
+            if ( columns != null ) {
+                maxPloidy = columns.getMaxPloidy();
+            } else {
+                for ( final Genotype g : getGenotypes() ) {
+                    maxPloidy = Math.max(g.getPloidy(), maxPloidy);
+                }
             }
 
             // everything is no called so we return the default ploidy
@@ -447,7 +532,7 @@ public class GenotypesContext implements List<Genotype>, Serializable {
      */
     public Genotype get(final String sampleName) {
         Integer offset = getSampleI(sampleName);
-        return offset == null ? null : getGenotypes().get(offset);
+        return offset == null ? null : get(offset);
     }
 
     private Integer getSampleI(final String sampleName) {
@@ -462,7 +547,25 @@ public class GenotypesContext implements List<Genotype>, Serializable {
 
     @Override
     public Iterator<Genotype> iterator() {
-        return getGenotypes().iterator();
+        final ColumnarGenotypes columns = getColumnarGenotypes();
+        if ( columns == null ) {
+            return getGenotypes().iterator();
+        }
+        // iterating over columnar genotypes doesn't require converting them to a list
+        return new Iterator<Genotype>() {
+            private int i = 0;
+
+            @Override
+            public boolean hasNext() {
+                return i < columns.size();
+            }
+
+            @Override
+            public Genotype next() {
+                if ( ! hasNext() ) throw new NoSuchElementException();
+                return getColumnarGenotypeView(columns, i++);
+            }
+        };
     }
 
     @Override
@@ -108,6 +108,7 @@ public class LazyGenotypesContext extends GenotypesContext {
      */
     public static class LazyData {
         final ArrayList<Genotype> genotypes;
+        final ColumnarGenotypes columnarGenotypes;
         final Map<String, Integer> sampleNameToOffset;
         final List<String> sampleNamesInOrder;
 
@@ -115,6 +116,21 @@ public class LazyGenotypesContext extends GenotypesContext {
                         final List<String> sampleNamesInOrder,
                         final Map<String, Integer> sampleNameToOffset) {
             this.genotypes = genotypes;
+            this.columnarGenotypes = null;
+            this.sampleNamesInOrder = sampleNamesInOrder;
+            this.sampleNameToOffset = sampleNameToOffset;
+        }
+
+        /**
+         * Lazy data for genotypes decoded into columnar form
+         *
+         * {@link GenotypesContext#GenotypesContext(ColumnarGenotypes, java.util.Map, java.util.List)}
+         */
+        public LazyData(final ColumnarGenotypes genotypes,
+                        final List<String> sampleNamesInOrder,
+                        final Map<String, Integer> sampleNameToOffset) {
+            this.genotypes = null;
+            this.columnarGenotypes = genotypes;
             this.sampleNamesInOrder = sampleNamesInOrder;
             this.sampleNameToOffset = sampleNameToOffset;
         }
@@ -146,7 +162,13 @@ public class LazyGenotypesContext extends GenotypesContext {
     @Override
     protected ArrayList<Genotype> getGenotypes() {
         decode();
-        return notToBeDirectlyAccessedGenotypes;
+        return super.getGenotypes();
+    }
+
+    @Override
+    protected ColumnarGenotypes getColumnarGenotypes() {
+        decode();
+        return super.getColumnarGenotypes();
     }
 
     /**
@@ -157,6 +179,7 @@ public class LazyGenotypesContext extends GenotypesContext {
             //System.out.printf("Loading genotypes... %s:%d%n", contig, start);
             LazyData parsed = parser.parse(unparsedGenotypeData);
             notToBeDirectlyAccessedGenotypes = parsed.genotypes;
+            notToBeDirectlyAccessedColumnarGenotypes = parsed.columnarGenotypes;
             sampleNamesInOrder = parsed.sampleNamesInOrder;
             sampleNameToOffset = parsed.sampleNameToOffset;
             loaded = true;
@@ -25,8 +25,10 @@
 
 package htsjdk.variant.variantcontext.writer;
 
+import htsjdk.variant.bcf2.BCF2Codec;
 import htsjdk.variant.bcf2.BCF2Type;
 import htsjdk.variant.bcf2.BCF2Utils;
+import htsjdk.variant.bcf2.BCFVersion;
 
 import java.io.ByteArrayOutputStream;
 import java.io.IOException;
@@ -46,6 +48,20 @@ public final class BCF2Encoder {
     public static final int WRITE_BUFFER_INITIAL_SIZE = 16384;
     private ByteArrayOutputStream encodeStream = new ByteArrayOutputStream(WRITE_BUFFER_INITIAL_SIZE);
 
+    // BCF 2.2 pads vectors with END_OF_VECTOR values, BCF 2.1 with MISSING values
+    private final boolean padWithEndOfVector;
+
+    public BCF2Encoder() {
+        this(BCF2Codec.ALLOWED_BCF_VERSION);
+    }
+
+    /**
+     * @param version the BCF version whose conventions are used to pad vectors
+     */
+    public BCF2Encoder(final BCFVersion version) {
+        this.padWithEndOfVector = version.getMinorVersion() >= 2;
+    }
+
     // --------------------------------------------------------------------------------
     //
     // Functions to return the data being encoded here
@@ -163,6 +179,23 @@ public final class BCF2Encoder {
             encodeRawMissingValue(type);
     }
 
+    /**
+     * Pad a vector holding count values up to size values.  BCF 2.1 pads with MISSING values.  BCF 2.2 pads
+     * with END_OF_VECTOR values, except that a vector without any values starts with a MISSING value
+     *
+     * @param count the number of values already encoded in the vector
+     * @param size the size of the vector
+     * @param type the type of the vector
+     */
+    public final void encodeRawPadding(final int count, final int size, final BCF2Type type) throws IOException {
+        for ( int i = count; i < size; i++ ) {
+            if ( padWithEndOfVector && i > 0 )
+                encodeRawBytes(type.getEndOfVectorBytes(), type);
+            else
+                encodeRawMissingValue(type);
+        }
+    }
+
     // --------------------------------------------------------------------------------
     //
     // low-level encoders
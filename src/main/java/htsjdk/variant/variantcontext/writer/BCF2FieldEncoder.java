@@ -362,7 +362,7 @@ public abstract class BCF2FieldEncoder {
                     }
                 }
             }
-            for ( ; count < minValues; count++ ) encoder.encodeRawMissingValue(type);
+            encoder.encodeRawPadding(count, minValues, type);
         }
     }
 
@@ -396,7 +396,7 @@ public abstract class BCF2FieldEncoder {
                     count++;
                 }
             }
-            for ( ; count < minValues; count++ ) encoder.encodeRawMissingValue(type);
+            encoder.encodeRawPadding(count, minValues, type);
         }
     }
 
@@ -426,7 +426,7 @@ public abstract class BCF2FieldEncoder {
                 encoder.encodeRawInt((Integer)value, type);
                 count++;
             }
-            for ( ; count < minValues; count++ ) encoder.encodeRawMissingValue(type);
+            encoder.encodeRawPadding(count, minValues, type);
         }
     }
 
@@ -449,7 +449,7 @@ public abstract class BCF2FieldEncoder {
                     count++;
                 }
             }
-            for ( ; count < minValues; count++ ) encoder.encodeRawMissingValue(type);
+            encoder.encodeRawPadding(count, minValues, type);
         }
     }
 }
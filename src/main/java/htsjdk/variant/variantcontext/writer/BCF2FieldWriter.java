@@ -276,8 +276,9 @@ public abstract class BCF2FieldWriter {
                     final int encoded = ((offset+1) << 1) | ((g.isPhased() && i!=0) ? 0x01 : 0x00);
                     encoder.encodeRawBytes(encoded, encodingType);
                 } else {
-                    // we need to pad with missing as we have ploidy < max for this sample
-                    encoder.encodeRawBytes(encodingType.getMissingBytes(), encodingType);
+                    // we need to pad as we have ploidy < max for this sample
+                    encoder.encodeRawPadding(samplePloidy, nValuesPerGenotype, encodingType);
+                    break;
                 }
             }
         }
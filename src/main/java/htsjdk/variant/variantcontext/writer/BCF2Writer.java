@@ -43,6 +43,7 @@ import htsjdk.variant.variantcontext.VariantContextBuilder;
 import htsjdk.variant.vcf.VCFConstants;
 import htsjdk.variant.vcf.VCFContigHeaderLine;
 import htsjdk.variant.vcf.VCFHeader;
+import htsjdk.variant.vcf.VCFHeaderLine;
 import htsjdk.variant.vcf.VCFUtils;
 
 import java.io.ByteArrayOutputStream;
@@ -58,6 +59,7 @@ import java.util.HashMap;
 import java.util.LinkedHashMap;
 import java.util.List;
 import java.util.Map;
+import java.util.Set;
 
 /**
  * VariantContextWriter that emits BCF2 binary encoding
@@ -112,17 +114,12 @@ class BCF2Writer extends IndexingVariantContextWriter {
     private VCFHeader header;
     private final Map<String, Integer> contigDictionary = new HashMap<String, Integer>();
     private final Map<String, Integer> stringDictionaryMap = new LinkedHashMap<String, Integer>();
+    private List<String> stringDictionary = null;
     private final boolean doNotWriteGenotypes;
+    private final BCFVersion bcfVersion;
     private String[] sampleNames = null;
 
-    private final BCF2Encoder encoder = new BCF2Encoder(); // initialized after the header arrives
-    final BCF2FieldWriterManager fieldManager = new BCF2FieldWriterManager();
-
-    /**
-     * cached results for whether we can write out raw genotypes data.
-     */
-    private VCFHeader lastVCFHeaderOfUnparsedGenotypes = null;
-    private boolean canPassOnUnparsedGenotypeDataForLastVCFHeader = false;
+    private BCF2RecordEncoder recordEncoder = null; // initialized after the header arrives
 
     // is the header or body written to the output stream?
     private boolean outputHasBeenWritten;
@@ -135,9 +132,15 @@ class BCF2Writer extends IndexingVariantContextWriter {
 
     public BCF2Writer(final Path location, final OutputStream output, final SAMSequenceDictionary refDict,
         final boolean enableOnTheFlyIndexing, final boolean doNotWriteGenotypes) {
+        this(location, output, refDict, enableOnTheFlyIndexing, doNotWriteGenotypes, BCF2Codec.ALLOWED_BCF_VERSION);
+    }
+
+    public BCF2Writer(final Path location, final OutputStream output, final SAMSequenceDictionary refDict,
+                      final boolean enableOnTheFlyIndexing, final boolean doNotWriteGenotypes, final BCFVersion bcfVersion) {
         super(writerName(location, output), location, output, refDict, enableOnTheFlyIndexing);
         this.outputStream = getOutputStream();
         this.doNotWriteGenotypes = doNotWriteGenotypes;
+        this.bcfVersion = checkBCFVersion(bcfVersion);
     }
 
     public BCF2Writer(final File location, final OutputStream output, final SAMSequenceDictionary refDict,
@@ -150,9 +153,26 @@ class BCF2Writer extends IndexingVariantContextWriter {
     public BCF2Writer(final Path location, final OutputStream output, final SAMSequenceDictionary refDict,
                       final IndexCreator indexCreator,
                       final boolean enableOnTheFlyIndexing, final boolean doNotWriteGenotypes) {
+        this(location, output, refDict, indexCreator, enableOnTheFlyIndexing, doNotWriteGenotypes, BCF2Codec.ALLOWED_BCF_VERSION);
+    }
+
+    public BCF2Writer(final Path location, final OutputStream output, final SAMSequenceDictionary refDict,
+                      final IndexCreator indexCreator,
+                      final boolean enableOnTheFlyIndexing, final boolean doNotWriteGenotypes, final BCFVersion bcfVersion) {
         super(writerName(location, output), location, output, refDict, enableOnTheFlyIndexing, indexCreator);
         this.outputStream = getOutputStream();
         this.doNotWriteGenotypes = doNotWriteGenotypes;
+        this.bcfVersion = checkBCFVersion(bcfVersion);
+    }
+
+    /**
+     * The writer can emit BCF 2.1, or BCF 2.2 whose vectors are padded with END_OF_VECTOR values.  The header lines
+     * never get IDX attributes, as BCF 2.2 allows the dictionaries to follow the order of the header lines
+     */
+    private static BCFVersion checkBCFVersion(final BCFVersion bcfVersion) {
+        if ( ! bcfVersion.equals(BCF2Codec.ALLOWED_BCF_VERSION) && ! bcfVersion.equals(BCF2Codec.BCF_VERSION_2_2) )
+            throw new IllegalArgumentException("BCF2Writer can only write " + BCF2Codec.ALLOWED_BCF_VERSION + " or " + BCF2Codec.BCF_VERSION_2_2 + ", not " + bcfVersion);
+        return bcfVersion;
     }
 
     // --------------------------------------------------------------------------------
@@ -174,7 +194,7 @@ class BCF2Writer extends IndexingVariantContextWriter {
             writer.close();
 
             final byte[] headerBytes = capture.toByteArray();
-            new BCFVersion(MAJOR_VERSION, MINOR_VERSION).write(outputStream);
+            bcfVersion.write(outputStream);
             BCF2Type.INT32.write(headerBytes.length, outputStream);
             outputStream.write(headerBytes);
             outputHasBeenWritten = true;
@@ -185,18 +205,10 @@ class BCF2Writer extends IndexingVariantContextWriter {
 
     @Override
     public void add( VariantContext vc ) {
-        if ( doNotWriteGenotypes )
-            vc = new VariantContextBuilder(vc).noGenotypes().make();
-        vc = vc.fullyDecode(header, false);
-
         super.add(vc); // allow on the fly indexing
 
         try {
-            final byte[] infoBlock = buildSitesData(vc);
-            final byte[] genotypesBlock = buildSamplesData(vc);
-
-            // write the two blocks to disk
-            writeBlock(infoBlock, genotypesBlock);
+            recordEncoder.encode(vc, outputStream);
             outputHasBeenWritten = true;
         }
         catch ( IOException e ) {
@@ -204,6 +216,24 @@ class BCF2Writer extends IndexingVariantContextWriter {
         }
     }
 
+    @Override
+    BCF2RecordEncoder newRecordEncoder() {
+        if ( header == null )
+            throw new IllegalStateException("Unable to encode BCF2 records: header is missing, try to call writeHeader or setHeader first.");
+        return new BCF2RecordEncoder();
+    }
+
+    @Override
+    boolean writesUnparsedGenotypes(final VariantContext vc) {
+        return doNotWriteGenotypes || (recordEncoder != null && recordEncoder.writesUnparsedGenotypes(vc));
+    }
+
+    @Override
+    void addEncoded(final VariantContext vc, final byte[] bytes, final int offset, final int length) throws IOException {
+        super.addEncoded(vc, bytes, offset, length);
+        outputHasBeenWritten = true;
+    }
+
     @Override
     public void close() {
         try {
@@ -220,9 +250,9 @@ class BCF2Writer extends IndexingVariantContextWriter {
         if (outputHasBeenWritten) {
             throw new IllegalStateException("The header cannot be modified after the header or variants have been written to the output stream.");
         }
-        // make sure the header is sorted correctly
-        this.header = doNotWriteGenotypes ? new VCFHeader(header.getMetaDataInSortedOrder()) : new VCFHeader(
-                header.getMetaDataInSortedOrder(), header.getGenotypeSamples());
+        // make sure the header is sorted correctly, and drop the dictionary offsets of any BCF 2.2 file it was read from
+        final Set<VCFHeaderLine> metaData = BCF2Utils.removeIDX(header.getMetaDataInSortedOrder());
+        this.header = doNotWriteGenotypes ? new VCFHeader(metaData) : new VCFHeader(metaData, header.getGenotypeSamples());
         // create the config offsets map
         if ( this.header.getContigLines().isEmpty() ) {
             if ( ALLOW_MISSING_CONTIG_LINES ) {
@@ -241,220 +271,276 @@ class BCF2Writer extends IndexingVariantContextWriter {
         for ( int i = 0; i < dict.size(); i++ ) {
             stringDictionaryMap.put(dict.get(i), i);
         }
+        stringDictionary = dict;
 
         sampleNames = this.header.getGenotypeSamples().toArray(new String[this.header.getNGenotypeSamples()]);
-        // setup the field encodings
-        fieldManager.setup(this.header, encoder, stringDictionaryMap);
-
+        recordEncoder = newRecordEncoder();
     }
 
-    // --------------------------------------------------------------------------------
-    //
-    // implicit block
-    //
-    // The first four records of BCF are inline untype encoded data of:
-    //
-    // 4 byte integer chrom offset
-    // 4 byte integer start
-    // 4 byte integer ref length
-    // 4 byte float qual
-    //
-    // --------------------------------------------------------------------------------
-    private byte[] buildSitesData( VariantContext vc ) throws IOException {
-        final int contigIndex = contigDictionary.get(vc.getContig());
-        if ( contigIndex == -1 )
-            throw new IllegalStateException(String.format("Contig %s not found in sequence dictionary from reference", vc.getContig()));
-
-        // note use of encodeRawValue to not insert the typing byte
-        encoder.encodeRawValue(contigIndex, BCF2Type.INT32);
-
-        // pos.  GATK is 1 based, BCF2 is 0 based
-        encoder.encodeRawValue(vc.getStart() - 1, BCF2Type.INT32);
-
-        // ref length.  GATK is closed, but BCF2 is open so the ref length is GATK end - GATK start + 1
-        // for example, a SNP is in GATK at 1:10-10, which has ref length 10 - 10 + 1 = 1
-        encoder.encodeRawValue(vc.getEnd() - vc.getStart() + 1, BCF2Type.INT32);
-
-        // qual
-        if ( vc.hasLog10PError() )
-            encoder.encodeRawFloat((float) vc.getPhredScaledQual());
-        else
-            encoder.encodeRawMissingValue(BCF2Type.FLOAT);
-
-        // info fields
-        final int nAlleles = vc.getNAlleles();
-        final int nInfo = vc.getAttributes().size();
-        final int nGenotypeFormatFields = getNGenotypeFormatFields(vc);
-        final int nSamples = header.getNGenotypeSamples();
-
-        encoder.encodeRawInt((nAlleles << 16) | (nInfo & 0x0000FFFF), BCF2Type.INT32);
-        encoder.encodeRawInt((nGenotypeFormatFields << 24) | (nSamples & 0x00FFFFF), BCF2Type.INT32);
-
-        buildID(vc);
-        buildAlleles(vc);
-        buildFilter(vc);
-        buildInfo(vc);
-
-        return encoder.getRecordBytes();
-    }
-
-
     /**
-     * Can we safely write on the raw (undecoded) genotypes of an input VC?
-     *
-     * The cache depends on the undecoded lazy data header == lastVCFHeaderOfUnparsedGenotypes, in
-     * which case we return the previous result.  If it's not cached, we use the BCF2Util to
-     * compare the VC header with our header (expensive) and cache it.
-     *
-     * @param lazyData
-     * @return
+     * Encodes records with its own low-level encoder and field writers, so that several records can be encoded at once
+     * on different threads.  The header, dictionaries and sample names of the writer are only read.
      */
-    private boolean canSafelyWriteRawGenotypesBytes(final BCF2Codec.LazyData lazyData) {
-        if ( lazyData.header != lastVCFHeaderOfUnparsedGenotypes ) {
-            // result is already cached
-            canPassOnUnparsedGenotypeDataForLastVCFHeader = BCF2Utils.headerLinesAreOrderedConsistently(this.header,lazyData.header);
-            lastVCFHeaderOfUnparsedGenotypes = lazyData.header;
+    final class BCF2RecordEncoder implements RecordEncoder {
+        private final BCF2Encoder encoder = new BCF2Encoder(bcfVersion);
+        private final BCF2FieldWriterManager fieldManager = new BCF2FieldWriterManager();
+
+        /**
+         * cached results for whether we can write out raw genotypes data.
+         */
+        private VCFHeader lastVCFHeaderOfUnparsedGenotypes = null;
+        private BCFVersion lastBCFVersionOfUnparsedGenotypes = null;
+        private List<String> lastDictionaryOfUnparsedGenotypes = null;
+        private boolean canPassOnUnparsedGenotypeDataForLastVCFHeader = false;
+
+        private BCF2RecordEncoder() {
+            // setup the field encodings
+            fieldManager.setup(header, encoder, stringDictionaryMap);
         }
 
-        return canPassOnUnparsedGenotypeDataForLastVCFHeader;
-    }
+        @Override
+        public void encode( VariantContext vc, final OutputStream out ) throws IOException {
+            if ( doNotWriteGenotypes )
+                vc = new VariantContextBuilder(vc).noGenotypes().make();
+            vc = vc.fullyDecode(header, false);
 
-    private BCF2Codec.LazyData getLazyData(final VariantContext vc) {
-        if ( vc.getGenotypes().isLazyWithData() ) {
-            final LazyGenotypesContext lgc = (LazyGenotypesContext)vc.getGenotypes();
+            final byte[] infoBlock = buildSitesData(vc);
+            final byte[] genotypesBlock = buildSamplesData(vc);
 
-            if ( lgc.getUnparsedGenotypeData() instanceof BCF2Codec.LazyData &&
-                    canSafelyWriteRawGenotypesBytes((BCF2Codec.LazyData) lgc.getUnparsedGenotypeData())) {
-                return (BCF2Codec.LazyData)lgc.getUnparsedGenotypeData();
-            } else {
-                lgc.decode(); // WARNING -- required to avoid keeping around bad lazy data for too long
-            }
+            // write the two blocks to disk
+            writeBlock(infoBlock, genotypesBlock, out);
         }
 
-        return null;
-    }
+        // --------------------------------------------------------------------------------
+        //
+        // implicit block
+        //
+        // The first four records of BCF are inline untype encoded data of:
+        //
+        // 4 byte integer chrom offset
+        // 4 byte integer start
+        // 4 byte integer ref length
+        // 4 byte float qual
+        //
+        // --------------------------------------------------------------------------------
+        private byte[] buildSitesData( VariantContext vc ) throws IOException {
+            final int contigIndex = contigDictionary.get(vc.getContig());
+            if ( contigIndex == -1 )
+                throw new IllegalStateException(String.format("Contig %s not found in sequence dictionary from reference", vc.getContig()));
+
+            // note use of encodeRawValue to not insert the typing byte
+            encoder.encodeRawValue(contigIndex, BCF2Type.INT32);
+
+            // pos.  GATK is 1 based, BCF2 is 0 based
+            encoder.encodeRawValue(vc.getStart() - 1, BCF2Type.INT32);
+
+            // ref length.  GATK is closed, but BCF2 is open so the ref length is GATK end - GATK start + 1
+            // for example, a SNP is in GATK at 1:10-10, which has ref length 10 - 10 + 1 = 1
+            encoder.encodeRawValue(vc.getEnd() - vc.getStart() + 1, BCF2Type.INT32);
+
+            // qual
+            if ( vc.hasLog10PError() )
+                encoder.encodeRawFloat((float) vc.getPhredScaledQual());
+            else
+                encoder.encodeRawMissingValue(BCF2Type.FLOAT);
+
+            // info fields
+            final int nAlleles = vc.getNAlleles();
+            final int nInfo = vc.getAttributes().size();
+            final int nGenotypeFormatFields = getNGenotypeFormatFields(vc);
+            final int nSamples = header.getNGenotypeSamples();
+
+            encoder.encodeRawInt((nAlleles << 16) | (nInfo & 0x0000FFFF), BCF2Type.INT32);
+            encoder.encodeRawInt((nGenotypeFormatFields << 24) | (nSamples & 0x00FFFFF), BCF2Type.INT32);
+
+            buildID(vc);
+            buildAlleles(vc);
+            buildFilter(vc);
+            buildInfo(vc);
+
+            return encoder.getRecordBytes();
+        }
 
-    /**
-     * Try to get the nGenotypeFields as efficiently as possible.
-     *
-     * If this is a lazy BCF2 object just grab the field count from there,
-     * otherwise do the whole counting by types test in the actual data
-     *
-     * @param vc
-     * @return
-     */
-    private int getNGenotypeFormatFields(final VariantContext vc) {
-        final BCF2Codec.LazyData lazyData = getLazyData(vc);
-        return lazyData != null ? lazyData.nGenotypeFields : vc.calcVCFGenotypeKeys(header).size();
-    }
 
-    private void buildID( VariantContext vc ) throws IOException {
-        encoder.encodeTypedString(vc.getID());
-    }
+        /**
+         * Can we safely write on the raw (undecoded) genotypes of an input VC?
+         *
+         * The cache depends on the undecoded lazy data header == lastVCFHeaderOfUnparsedGenotypes (and on its
+         * version and dictionary being the last ones too), in which case we return the previous result.  If it's
+         * not cached, we use the BCF2Util to compare the VC header with our header (expensive) and cache it.
+         *
+         * The bytes must also come from a file of the version we write, as BCF 2.2 pads vectors with END_OF_VECTOR
+         * values that BCF 2.1 reads as numbers, and their FORMAT keys must be offsets into the same dictionary as
+         * ours, which is not so if the file they come from had IDX attributes that leave gaps in its dictionary.
+         *
+         * @param lazyData
+         * @return
+         */
+        private boolean canSafelyWriteRawGenotypesBytes(final BCF2Codec.LazyData lazyData) {
+            if ( lazyData.header != lastVCFHeaderOfUnparsedGenotypes ||
+                    lazyData.bcfVersion != lastBCFVersionOfUnparsedGenotypes ||
+                    lazyData.dictionary != lastDictionaryOfUnparsedGenotypes ) {
+                // result is not cached
+                final List<String> dictionary = lazyData.dictionary != null ? lazyData.dictionary : BCF2Utils.makeDictionary(lazyData.header);
+                canPassOnUnparsedGenotypeDataForLastVCFHeader = bcfVersion.equals(lazyData.bcfVersion) &&
+                        stringDictionary.equals(dictionary) &&
+                        BCF2Utils.headerLinesAreOrderedConsistently(this.header,lazyData.header);
+                lastVCFHeaderOfUnparsedGenotypes = lazyData.header;
+                lastBCFVersionOfUnparsedGenotypes = lazyData.bcfVersion;
+                lastDictionaryOfUnparsedGenotypes = lazyData.dictionary;
+            }
 
-    private void buildAlleles( VariantContext vc ) throws IOException {
-        for ( Allele allele : vc.getAlleles() ) {
-            final byte[] s = allele.getDisplayBases();
-            if ( s == null )
-                throw new IllegalStateException("BUG: BCF2Writer encountered null padded allele" + allele);
-            encoder.encodeTypedString(s);
+            return canPassOnUnparsedGenotypeDataForLastVCFHeader;
         }
-    }
 
-    private void buildFilter( VariantContext vc ) throws IOException {
-        if ( vc.isFiltered() ) {
-            encodeStringsByRef(vc.getFilters());
-        } else if ( vc.filtersWereApplied() ) {
-            encodeStringsByRef(Collections.singleton(VCFConstants.PASSES_FILTERS_v4));
-        } else {
-            encoder.encodeTypedMissing(BCF2Type.INT8);
+        /**
+         * @return true if the genotypes of the record are lazy BCF2 data that are written as they are, which is
+         * only so if the record needs no other decoding
+         */
+        private boolean writesUnparsedGenotypes(final VariantContext vc) {
+            if ( !vc.isFullyDecoded() || !vc.getGenotypes().isLazyWithData() )
+                return false;
+            final Object unparsedGenotypes = ((LazyGenotypesContext)vc.getGenotypes()).getUnparsedGenotypeData();
+            return unparsedGenotypes instanceof BCF2Codec.LazyData && canSafelyWriteRawGenotypesBytes((BCF2Codec.LazyData) unparsedGenotypes);
         }
-    }
 
-    private void buildInfo( VariantContext vc ) throws IOException {
-        for ( Map.Entry<String, Object> infoFieldEntry : vc.getAttributes().entrySet() ) {
-            final String field = infoFieldEntry.getKey();
-            final BCF2FieldWriter.SiteWriter writer = fieldManager.getSiteFieldWriter(field);
-            if ( writer == null ) errorUnexpectedFieldToWrite(vc, field, "INFO");
-            writer.start(encoder, vc);
-            writer.site(encoder, vc);
-            writer.done(encoder, vc);
+        private BCF2Codec.LazyData getLazyData(final VariantContext vc) {
+            if ( vc.getGenotypes().isLazyWithData() ) {
+                final LazyGenotypesContext lgc = (LazyGenotypesContext)vc.getGenotypes();
+
+                if ( lgc.getUnparsedGenotypeData() instanceof BCF2Codec.LazyData &&
+                        canSafelyWriteRawGenotypesBytes((BCF2Codec.LazyData) lgc.getUnparsedGenotypeData())) {
+                    return (BCF2Codec.LazyData)lgc.getUnparsedGenotypeData();
+                } else {
+                    lgc.decode(); // WARNING -- required to avoid keeping around bad lazy data for too long
+                }
+            }
+
+            return null;
         }
-    }
 
-    private byte[] buildSamplesData(final VariantContext vc) throws IOException {
-        final BCF2Codec.LazyData lazyData = getLazyData(vc);  // has critical side effects
-        if ( lazyData != null ) {
-            // we never decoded any data from this BCF file, so just pass it back
-            return lazyData.bytes;
+        /**
+         * Try to get the nGenotypeFields as efficiently as possible.
+         *
+         * If this is a lazy BCF2 object just grab the field count from there,
+         * otherwise do the whole counting by types test in the actual data
+         *
+         * @param vc
+         * @return
+         */
+        private int getNGenotypeFormatFields(final VariantContext vc) {
+            final BCF2Codec.LazyData lazyData = getLazyData(vc);
+            return lazyData != null ? lazyData.nGenotypeFields : vc.calcVCFGenotypeKeys(header).size();
         }
 
-        // we have to do work to convert the VC into a BCF2 byte stream
-        final List<String> genotypeFields = vc.calcVCFGenotypeKeys(header);
-        for ( final String field : genotypeFields ) {
-            final BCF2FieldWriter.GenotypesWriter writer = fieldManager.getGenotypeFieldWriter(field);
-            if ( writer == null ) errorUnexpectedFieldToWrite(vc, field, "FORMAT");
+        private void buildID( VariantContext vc ) throws IOException {
+            encoder.encodeTypedString(vc.getID());
+        }
 
-            assert writer != null;
+        private void buildAlleles( VariantContext vc ) throws IOException {
+            for ( Allele allele : vc.getAlleles() ) {
+                final byte[] s = allele.getDisplayBases();
+                if ( s == null )
+                    throw new IllegalStateException("BUG: BCF2Writer encountered null padded allele" + allele);
+                encoder.encodeTypedString(s);
+            }
+        }
 
-            writer.start(encoder, vc);
-            for ( final String name : sampleNames ) {
-                Genotype g = vc.getGenotype(name);
-                if ( g == null ) g = GenotypeBuilder.createMissing(name, writer.nValuesPerGenotype);
-                writer.addGenotype(encoder, vc, g);
+        private void buildFilter( VariantContext vc ) throws IOException {
+            if ( vc.isFiltered() ) {
+                encodeStringsByRef(vc.getFilters());
+            } else if ( vc.filtersWereApplied() ) {
+                encodeStringsByRef(Collections.singleton(VCFConstants.PASSES_FILTERS_v4));
+            } else {
+                encoder.encodeTypedMissing(BCF2Type.INT8);
             }
-            writer.done(encoder, vc);
         }
-        return encoder.getRecordBytes();
-    }
 
-    /**
-     * Throws a meaningful error message when a field (INFO or FORMAT) is found when writing out a file
-     * but there's no header line for it.
-     *
-     * @param vc
-     * @param field
-     * @param fieldType
-     */
-    private void errorUnexpectedFieldToWrite(final VariantContext vc, final String field, final String fieldType) {
-        throw new IllegalStateException("Found field " + field + " in the " + fieldType + " fields of VariantContext at " +
-                vc.getContig() + ":" + vc.getStart() + " from " + vc.getSource() + " but this hasn't been defined in the VCFHeader");
-    }
+        private void buildInfo( VariantContext vc ) throws IOException {
+            for ( Map.Entry<String, Object> infoFieldEntry : vc.getAttributes().entrySet() ) {
+                final String field = infoFieldEntry.getKey();
+                final BCF2FieldWriter.SiteWriter writer = fieldManager.getSiteFieldWriter(field);
+                if ( writer == null ) errorUnexpectedFieldToWrite(vc, field, "INFO");
+                writer.start(encoder, vc);
+                writer.site(encoder, vc);
+                writer.done(encoder, vc);
+            }
+        }
 
-    // --------------------------------------------------------------------------------
-    //
-    // Low-level block encoding
-    //
-    // --------------------------------------------------------------------------------
+        private byte[] buildSamplesData(final VariantContext vc) throws IOException {
+            final BCF2Codec.LazyData lazyData = getLazyData(vc);  // has critical side effects
+            if ( lazyData != null ) {
+                // we never decoded any data from this BCF file, so just pass it back
+                return lazyData.bytes;
+            }
 
-    /**
-     * Write the data in the encoder to the outputstream as a length encoded
-     * block of data.  After this call the encoder stream will be ready to
-     * start a new data block
-     *
-     * @throws IOException
-     */
-    private void writeBlock(final byte[] infoBlock, final byte[] genotypesBlock) throws IOException {
-        BCF2Type.INT32.write(infoBlock.length, outputStream);
-        BCF2Type.INT32.write(genotypesBlock.length, outputStream);
-        outputStream.write(infoBlock);
-        outputStream.write(genotypesBlock);
-    }
+            // we have to do work to convert the VC into a BCF2 byte stream
+            final List<String> genotypeFields = vc.calcVCFGenotypeKeys(header);
+            for ( final String field : genotypeFields ) {
+                final BCF2FieldWriter.GenotypesWriter writer = fieldManager.getGenotypeFieldWriter(field);
+                if ( writer == null ) errorUnexpectedFieldToWrite(vc, field, "FORMAT");
+
+                assert writer != null;
 
-    private BCF2Type encodeStringsByRef(final Collection<String> strings) throws IOException {
-        final List<Integer> offsets = new ArrayList<Integer>(strings.size());
+                writer.start(encoder, vc);
+                for ( final String name : sampleNames ) {
+                    Genotype g = vc.getGenotype(name);
+                    if ( g == null ) g = GenotypeBuilder.createMissing(name, writer.nValuesPerGenotype);
+                    writer.addGenotype(encoder, vc, g);
+                }
+                writer.done(encoder, vc);
+            }
+            return encoder.getRecordBytes();
+        }
 
-        // iterate over strings until we find one that needs 16 bits, and break
-        for ( final String string : strings ) {
-            final Integer got = stringDictionaryMap.get(string);
-            if ( got == null ) throw new IllegalStateException("Format error: could not find string " + string + " in header as required by BCF");
-            final int offset = got;
-            offsets.add(offset);
+        /**
+         * Throws a meaningful error message when a field (INFO or FORMAT) is found when writing out a file
+         * but there's no header line for it.
+         *
+         * @param vc
+         * @param field
+         * @param fieldType
+         */
+        private void errorUnexpectedFieldToWrite(final VariantContext vc, final String field, final String fieldType) {
+            throw new IllegalStateException("Found field " + field + " in the " + fieldType + " fields of VariantContext at " +
+                    vc.getContig() + ":" + vc.getStart() + " from " + vc.getSource() + " but this hasn't been defined in the VCFHeader");
         }
 
-        final BCF2Type type = BCF2Utils.determineIntegerType(offsets);
-        encoder.encodeTyped(offsets, type);
-        return type;
+        // --------------------------------------------------------------------------------
+        //
+        // Low-level block encoding
+        //
+        // --------------------------------------------------------------------------------
+
+        /**
+         * Write the data in the encoder to the outputstream as a length encoded
+         * block of data.  After this call the encoder stream will be ready to
+         * start a new data block
+         *
+         * @throws IOException
+         */
+        private void writeBlock(final byte[] infoBlock, final byte[] genotypesBlock, final OutputStream out) throws IOException {
+            BCF2Type.INT32.write(infoBlock.length, out);
+            BCF2Type.INT32.write(genotypesBlock.length, out);
+            out.write(infoBlock);
+            out.write(genotypesBlock);
+        }
+
+        private BCF2Type encodeStringsByRef(final Collection<String> strings) throws IOException {
+            final List<Integer> offsets = new ArrayList<Integer>(strings.size());
+
+            // iterate over strings until we find one that needs 16 bits, and break
+            for ( final String string : strings ) {
+                final Integer got = stringDictionaryMap.get(string);
+                if ( got == null ) throw new IllegalStateException("Format error: could not find string " + string + " in header as required by BCF");
+                final int offset = got;
+                offsets.add(offset);
+            }
+
+            final BCF2Type type = BCF2Utils.determineIntegerType(offsets);
+            encoder.encodeTyped(offsets, type);
+            return type;
+        }
     }
 
     /**
@@ -64,6 +64,14 @@ abstract class IndexingVariantContextWriter implements VariantContextWriter {
 
     static String DEFAULT_READER_NAME = "Reader Name";
 
+    /**
+     * Encodes records into exactly the bytes the writer would write for them, so that records can be encoded on other
+     * threads and written in order with {@link #addEncoded}.  An encoder is only used by one thread at a time.
+     */
+    interface RecordEncoder {
+        void encode(VariantContext vc, OutputStream out) throws IOException;
+    }
+
     /**
      * Create a VariantContextWriter with an associated index using the default index creator
      *
@@ -203,6 +211,34 @@ abstract class IndexingVariantContextWriter implements VariantContextWriter {
             indexer.addFeature(vc, locationSource.getPosition());
     }
 
+    /**
+     * Create an encoder that produces the same bytes for a record as {@link #add} would write.  The header must have
+     * been set, and encoders must not be used after the header changes.
+     */
+    abstract RecordEncoder newRecordEncoder();
+
+    /**
+     * @return true if the genotypes of a record whose genotypes have not been decoded yet are written without being
+     * decoded, as they were read
+     */
+    boolean writesUnparsedGenotypes(final VariantContext vc) {
+        return false;
+    }
+
+    /**
+     * add a record that has already been encoded by one of this writer's {@link RecordEncoder}s
+     *
+     * @param vc     the Variant Context object, used for on the fly indexing
+     * @param bytes  the buffer holding the encoded record
+     * @param offset the offset of the record in the buffer
+     * @param length the length of the encoded record
+     */
+    void addEncoded(final VariantContext vc, final byte[] bytes, final int offset, final int length) throws IOException {
+        if ( indexer != null )
+            indexer.addFeature(vc, locationSource.getPosition());
+        outputStream.write(bytes, offset, length);
+    }
+
     /**
      * Returns a reasonable "name" for this writer, to display to the user if something goes wrong
      *
@@ -0,0 +1,103 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.variant.variantcontext.writer;
+
+import java.io.IOException;
+import java.io.OutputStream;
+import java.util.Arrays;
+
+/**
+ * A growable byte buffer that characters can be appended to directly, encoding them as ISO-8859-1 (the
+ * {@link htsjdk.variant.vcf.VCFEncoder#VCF_CHARSET}) without going through a {@link java.io.Writer}.
+ *
+ * Characters that cannot be encoded are replaced by '?', as the JDK encoder does; a surrogate pair is replaced by a
+ * single '?'.
+ */
+final class Latin1LineBuffer implements Appendable {
+    private static final byte REPLACEMENT = (byte) '?';
+
+    private byte[] bytes;
+    private int length = 0;
+    private boolean afterHighSurrogate = false;
+
+    Latin1LineBuffer(final int initialCapacity) {
+        bytes = new byte[initialCapacity];
+    }
+
+    @Override
+    public Latin1LineBuffer append(final CharSequence csq) {
+        return append(csq, 0, csq.length());
+    }
+
+    @Override
+    public Latin1LineBuffer append(final CharSequence csq, final int start, final int end) {
+        ensureCapacity(length + end - start);
+        for (int i = start; i < end; i++) {
+            appendChar(csq.charAt(i));
+        }
+        return this;
+    }
+
+    @Override
+    public Latin1LineBuffer append(final char c) {
+        ensureCapacity(length + 1);
+        appendChar(c);
+        return this;
+    }
+
+    private void appendChar(final char c) {
+        if (c <= 0xFF) {
+            bytes[length++] = (byte) c;
+            afterHighSurrogate = false;
+        } else if (Character.isLowSurrogate(c) && afterHighSurrogate) {
+            // the pair has already been replaced
+            afterHighSurrogate = false;
+        } else {
+            bytes[length++] = REPLACEMENT;
+            afterHighSurrogate = Character.isHighSurrogate(c);
+        }
+    }
+
+    private void ensureCapacity(final int capacity) {
+        if (capacity > bytes.length) {
+            bytes = Arrays.copyOf(bytes, Math.max(capacity, 2 * bytes.length));
+        }
+    }
+
+    /** @return the number of bytes in the buffer */
+    int size() {
+        return length;
+    }
+
+    /** Writes the contents of the buffer to a stream */
+    void writeTo(final OutputStream out) throws IOException {
+        out.write(bytes, 0, length);
+    }
+
+    /** Empties the buffer, keeping its capacity */
+    void reset() {
+        length = 0;
+        afterHighSurrogate = false;
+    }
+}
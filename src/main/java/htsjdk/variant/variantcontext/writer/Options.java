@@ -37,5 +37,6 @@ public enum Options {
     ALLOW_MISSING_FIELDS_IN_HEADER,
     FORCE_BCF,
     USE_ASYNC_IO,            // Turn on or off the use of asynchronous IO for writing output VCF files.
-    WRITE_FULL_FORMAT_FIELD  // Write the complete format field, even if trailing missing values could be trimmed?
+    WRITE_FULL_FORMAT_FIELD, // Write the complete format field, even if trailing missing values could be trimmed?
+    WRITE_BCF_2_2            // Write BCF 2.2, as bcftools does, rather than BCF 2.1
 }
@@ -0,0 +1,244 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.variant.variantcontext.writer;
+
+import htsjdk.samtools.util.RuntimeIOException;
+import htsjdk.utils.ValidationUtils;
+import htsjdk.variant.variantcontext.GenotypesContext;
+import htsjdk.variant.variantcontext.LazyGenotypesContext;
+import htsjdk.variant.variantcontext.VariantContext;
+import htsjdk.variant.vcf.VCFHeader;
+
+import java.io.ByteArrayOutputStream;
+import java.io.IOException;
+import java.util.ArrayDeque;
+import java.util.ArrayList;
+import java.util.Deque;
+import java.util.List;
+import java.util.concurrent.ArrayBlockingQueue;
+import java.util.concurrent.BlockingQueue;
+import java.util.concurrent.ExecutionException;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+
+/**
+ * Wraps a VCF or BCF writer and encodes the records added to it on a pool of worker threads.
+ *
+ * Records are handed to the workers in batches.  Each worker encodes a batch into bytes with its own
+ * {@link IndexingVariantContextWriter.RecordEncoder}, and the encoded batches are written by the underlying writer in
+ * the order the records were added, so the output, and any index created on the fly, is the same as if the underlying
+ * writer had been used directly.  A bounded number of batches is encoded ahead of the output.
+ *
+ * Genotypes that have not been decoded yet are decoded by add(), on the calling thread, unless the underlying writer
+ * writes them as they were read.  Records must not be modified after they are added.  Errors from a worker are raised
+ * by a later call to add() or close(), after the records added before the failing one have been written.
+ *
+ * Not thread-safe: the writer itself must be used from one thread.
+ */
+final class ParallelEncodingVariantContextWriter implements VariantContextWriter {
+    /** The default number of records encoded by each task */
+    static final int DEFAULT_RECORDS_PER_BATCH = 1000;
+
+    private final IndexingVariantContextWriter underlyingWriter;
+    private final int numThreads;
+    private final int recordsPerBatch;
+    private final int maxBatchesInFlight;
+    private final ExecutorService executor;
+
+    // created when the first batch is submitted, as the header may not be known before then
+    private BlockingQueue<IndexingVariantContextWriter.RecordEncoder> encoders = null;
+    private final Deque<Future<EncodedBatch>> pending = new ArrayDeque<>();
+    private List<VariantContext> currentBatch;
+    private boolean closed = false;
+    // set when a record could not be encoded or written, after which nothing more is written
+    private boolean failed = false;
+
+    /**
+     * @param underlyingWriter the writer the encoded records are written to
+     * @param numThreads the number of worker threads
+     * @param recordsPerBatch the number of records encoded by each task
+     */
+    ParallelEncodingVariantContextWriter(final IndexingVariantContextWriter underlyingWriter, final int numThreads,
+                                         final int recordsPerBatch) {
+        ValidationUtils.nonNull(underlyingWriter, "underlyingWriter");
+        ValidationUtils.validateArg(numThreads > 0, "numThreads must be positive");
+        ValidationUtils.validateArg(recordsPerBatch > 0, "recordsPerBatch must be positive");
+        this.underlyingWriter = underlyingWriter;
+        this.numThreads = numThreads;
+        this.recordsPerBatch = recordsPerBatch;
+        this.maxBatchesInFlight = 2 * numThreads;
+        this.currentBatch = new ArrayList<>(recordsPerBatch);
+        this.executor = Executors.newFixedThreadPool(numThreads, r -> {
+            final Thread t = Executors.defaultThreadFactory().newThread(r);
+            t.setDaemon(true);
+            return t;
+        });
+    }
+
+    @Override
+    public void writeHeader(final VCFHeader header) {
+        underlyingWriter.writeHeader(header);
+    }
+
+    @Override
+    public void setHeader(final VCFHeader header) {
+        if (encoders != null || !currentBatch.isEmpty()) {
+            throw new IllegalStateException("The header cannot be modified after variants have been added.");
+        }
+        underlyingWriter.setHeader(header);
+    }
+
+    @Override
+    public boolean checkError() {
+        return underlyingWriter.checkError();
+    }
+
+    @Override
+    public void add(final VariantContext vc) {
+        if (closed) {
+            throw new IllegalStateException("writer has been closed");
+        }
+        if (failed) {
+            throw new IllegalStateException("writer has failed to write an earlier variant");
+        }
+        // genotypes that have not been decoded yet are decoded with the caches of the codec that read them, which must
+        // not be used by the workers, so they are decoded here unless they will be written without being decoded
+        final GenotypesContext genotypes = vc.getGenotypes();
+        if (genotypes.isLazyWithData() && !underlyingWriter.writesUnparsedGenotypes(vc)) {
+            ((LazyGenotypesContext) genotypes).decode();
+        }
+        currentBatch.add(vc);
+        if (currentBatch.size() == recordsPerBatch) {
+            submitCurrentBatch();
+            while (pending.size() >= maxBatchesInFlight) {
+                writeBatch(pending.removeFirst());
+            }
+        }
+    }
+
+    private void submitCurrentBatch() {
+        if (encoders == null) {
+            encoders = new ArrayBlockingQueue<>(numThreads);
+            for (int i = 0; i < numThreads; i++) {
+                encoders.add(underlyingWriter.newRecordEncoder());
+            }
+        }
+        final List<VariantContext> batch = currentBatch;
+        currentBatch = new ArrayList<>(recordsPerBatch);
+        pending.add(executor.submit(() -> encode(batch)));
+    }
+
+    private EncodedBatch encode(final List<VariantContext> records) throws InterruptedException {
+        // there is one encoder for each thread, so this never waits
+        final IndexingVariantContextWriter.RecordEncoder encoder = encoders.take();
+        final ByteArrayOutputStream bytes = new ByteArrayOutputStream();
+        final int[] ends = new int[records.size()];
+        int nEncoded = 0;
+        try {
+            for (final VariantContext vc : records) {
+                encoder.encode(vc, bytes);
+                ends[nEncoded++] = bytes.size();
+            }
+            return new EncodedBatch(records, bytes.toByteArray(), ends, nEncoded, null);
+        } catch (final IOException | RuntimeException e) {
+            return new EncodedBatch(records, bytes.toByteArray(), ends, nEncoded, e);
+        } finally {
+            encoders.add(encoder);
+        }
+    }
+
+    private void writeBatch(final Future<EncodedBatch> future) {
+        // cleared once the batch has been written without error
+        failed = true;
+        final EncodedBatch batch = getResult(future);
+        try {
+            int start = 0;
+            for (int i = 0; i < batch.nEncoded; i++) {
+                underlyingWriter.addEncoded(batch.records.get(i), batch.bytes, start, batch.ends[i] - start);
+                start = batch.ends[i];
+            }
+        } catch (final IOException e) {
+            throw new RuntimeIOException("Unable to write variants to " + underlyingWriter.getStreamName(), e);
+        }
+        if (batch.error instanceof IOException) {
+            throw new RuntimeIOException("Unable to encode variants for " + underlyingWriter.getStreamName(),
+                    batch.error);
+        } else if (batch.error != null) {
+            throw (RuntimeException) batch.error;
+        }
+        failed = false;
+    }
+
+    private static EncodedBatch getResult(final Future<EncodedBatch> future) {
+        try {
+            return future.get();
+        } catch (final InterruptedException e) {
+            Thread.currentThread().interrupt();
+            throw new RuntimeException("Interrupted while encoding variants", e);
+        } catch (final ExecutionException e) {
+            if (e.getCause() instanceof Error) {
+                throw (Error) e.getCause();
+            }
+            throw new RuntimeException("Error encoding variants", e.getCause());
+        }
+    }
+
+    @Override
+    public void close() {
+        if (closed) {
+            return;
+        }
+        closed = true;
+        try {
+            if (!failed && !currentBatch.isEmpty()) {
+                submitCurrentBatch();
+            }
+            while (!failed && !pending.isEmpty()) {
+                writeBatch(pending.removeFirst());
+            }
+        } finally {
+            executor.shutdownNow();
+            pending.clear();
+            underlyingWriter.close();
+        }
+    }
+
+    private static final class EncodedBatch {
+        private final List<VariantContext> records;
+        private final byte[] bytes;
+        private final int[] ends;
+        private final int nEncoded;
+        private final Exception error;
+
+        EncodedBatch(final List<VariantContext> records, final byte[] bytes, final int[] ends, final int nEncoded,
+                     final Exception error) {
+            this.records = records;
+            this.bytes = bytes;
+            this.ends = ends;
+            this.nEncoded = nEncoded;
+            this.error = error;
+        }
+    }
+}
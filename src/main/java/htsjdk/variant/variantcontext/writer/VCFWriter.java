@@ -55,7 +55,7 @@ class VCFWriter extends IndexingVariantContextWriter {
             VCFHeader.METADATA_INDICATOR + VCFHeaderVersion.VCF4_2.getFormatString() + "=" + VCFHeaderVersion.VCF4_2.getVersionString();
 
 	// Initialized when the header is written to the output stream
-	private VCFEncoder vcfEncoder = null;
+	private VCFRecordEncoder recordEncoder = null;
 
 	// the VCF header we're storing
 	protected VCFHeader mHeader = null;
@@ -126,18 +126,6 @@ class VCFWriter extends IndexingVariantContextWriter {
     //
     // --------------------------------------------------------------------------------
 
-    /*
-     * Write String s to the internal buffered writer.
-     *
-     * writeAndResetBuffer() must be called to actually write the data to the true output stream.
-     *
-     * @param s the string to write
-     * @throws IOException
-     */
-    private void write(final String s) throws IOException {
-        writer.write(s);
-    }
-
     /*
      * Actually write the line buffer contents to the destination output stream. After calling this function
      * the line buffer is reset so the contents of the buffer can be reused
@@ -244,20 +232,34 @@ class VCFWriter extends IndexingVariantContextWriter {
                 throw new IllegalStateException("Unable to write the VCF: header is missing, " +
                                                    "try to call writeHeader or setHeader first.");
             }
-            if (this.doNotWriteGenotypes) {
-                this.vcfEncoder.write(this.writer, new VariantContextBuilder(context).noGenotypes().make());
-            } else {
-                this.vcfEncoder.write(this.writer, context);
-            }
-            write("\n");
-
-            writeAndResetBuffer();
+            this.recordEncoder.encode(context, getOutputStream());
             outputHasBeenWritten = true;
         } catch (IOException e) {
             throw new RuntimeIOException("Unable to write the VCF object to " + getStreamName(), e);
         }
     }
 
+    @Override
+    VCFRecordEncoder newRecordEncoder() {
+        if (this.mHeader == null) {
+            throw new IllegalStateException("Unable to encode VCF records: header is missing, " +
+                                               "try to call writeHeader or setHeader first.");
+        }
+        return new VCFRecordEncoder(new VCFEncoder(this.mHeader, this.allowMissingFieldsInHeader, this.writeFullFormatField),
+                this.doNotWriteGenotypes);
+    }
+
+    @Override
+    boolean writesUnparsedGenotypes(final VariantContext vc) {
+        return doNotWriteGenotypes || VCFEncoder.writesUnparsedGenotypes(vc);
+    }
+
+    @Override
+    void addEncoded(final VariantContext vc, final byte[] bytes, final int offset, final int length) throws IOException {
+        super.addEncoded(vc, bytes, offset, length);
+        outputHasBeenWritten = true;
+    }
+
     @Override
     public void setHeader(final VCFHeader header) {
         rejectVCFV43Headers(header);
@@ -266,7 +268,34 @@ class VCFWriter extends IndexingVariantContextWriter {
             throw new IllegalStateException("The header cannot be modified after the header or variants have been written to the output stream.");
         }
         this.mHeader = doNotWriteGenotypes ? new VCFHeader(header.getMetaDataInSortedOrder()) : header;
-        this.vcfEncoder = new VCFEncoder(this.mHeader, this.allowMissingFieldsInHeader, this.writeFullFormatField);
+        this.recordEncoder = newRecordEncoder();
+    }
+
+    /**
+     * Encodes each record as a line of text, straight into bytes rather than through a Writer and its charset encoder
+     */
+    private static final class VCFRecordEncoder implements RecordEncoder {
+        private final VCFEncoder vcfEncoder;
+        private final boolean doNotWriteGenotypes;
+        private final Latin1LineBuffer lineBuffer = new Latin1LineBuffer(INITIAL_BUFFER_SIZE);
+
+        private VCFRecordEncoder(final VCFEncoder vcfEncoder, final boolean doNotWriteGenotypes) {
+            this.vcfEncoder = vcfEncoder;
+            this.doNotWriteGenotypes = doNotWriteGenotypes;
+        }
+
+        @Override
+        public void encode(final VariantContext context, final OutputStream out) throws IOException {
+            // discard anything left over from a record that failed to encode
+            lineBuffer.reset();
+            if (doNotWriteGenotypes) {
+                vcfEncoder.write(lineBuffer, new VariantContextBuilder(context).noGenotypes().make());
+            } else {
+                vcfEncoder.write(lineBuffer, context);
+            }
+            lineBuffer.append('\n');
+            lineBuffer.writeTo(out);
+        }
     }
 
     // writing vcf v4.3 is not implemented
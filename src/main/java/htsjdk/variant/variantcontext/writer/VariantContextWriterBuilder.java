@@ -36,6 +36,8 @@ import htsjdk.samtools.util.RuntimeIOException;
 import htsjdk.tribble.index.IndexCreator;
 import htsjdk.tribble.index.tabix.TabixFormat;
 import htsjdk.tribble.index.tabix.TabixIndexCreator;
+import htsjdk.variant.bcf2.BCF2Codec;
+import htsjdk.variant.bcf2.BCFVersion;
 
 import java.io.File;
 import java.io.FileNotFoundException;
@@ -130,6 +132,7 @@ public class VariantContextWriterBuilder {
     private IndexCreator idxCreator = null;
     private int bufferSize = Defaults.BUFFER_SIZE;
     private boolean createMD5 = Defaults.CREATE_MD5;
+    private int encodingThreads = 1;
     protected EnumSet<Options> options = DEFAULT_OPTIONS.clone();
 
     /**
@@ -318,6 +321,21 @@ public class VariantContextWriterBuilder {
         return setCreateMD5(false);
     }
 
+    /**
+     * Set the number of threads used to encode records for the next <code>VariantContextWriter</code> created by this builder.
+     * With more than one thread, batches of records are encoded concurrently and written in the order they were added,
+     * so the output is the same as with a single thread.  Records must not be modified after they are added.
+     * @param encodingThreads the number of encoding threads, 1 to encode records on the thread that adds them
+     * @return this <code>VariantContextWriterBuilder</code>
+     * @throws IllegalArgumentException if <code>encodingThreads</code> is less than 1
+     */
+    public VariantContextWriterBuilder setEncodingThreads(final int encodingThreads) {
+        if (encodingThreads < 1)
+            throw new IllegalArgumentException("The number of encoding threads must be at least 1, not " + encodingThreads);
+        this.encodingThreads = encodingThreads;
+        return this;
+    }
+
     /**
      * Replace the set of <code>Options</code> for the <code>VariantContextWriterBuilder</code> with a new set.
      *
@@ -428,7 +446,7 @@ public class VariantContextWriterBuilder {
      * @throws IllegalArgumentException if <code>Options.INDEX_ON_THE_FLY</code> is specified and a stream output is specified.
      */
     public VariantContextWriter build(OpenOption... openOptions) {
-        VariantContextWriter writer = null;
+        IndexingVariantContextWriter writer = null;
 
         // don't allow FORCE_BCF to modify the outType state
         OutputType typeToBuild = this.outType;
@@ -496,10 +514,14 @@ public class VariantContextWriterBuilder {
                 break;
         }
 
+        VariantContextWriter result = writer;
+        if (this.encodingThreads > 1)
+            result = new ParallelEncodingVariantContextWriter(writer, this.encodingThreads, ParallelEncodingVariantContextWriter.DEFAULT_RECORDS_PER_BATCH);
+
         if (this.options.contains(Options.USE_ASYNC_IO))
-            writer = new AsyncVariantContextWriter(writer, AsyncVariantContextWriter.DEFAULT_QUEUE_SIZE);
+            result = new AsyncVariantContextWriter(result, AsyncVariantContextWriter.DEFAULT_QUEUE_SIZE);
 
-        return writer;
+        return result;
      }
 
     /**
@@ -568,7 +590,7 @@ public class VariantContextWriterBuilder {
         return IOUtil.hasBlockCompressedExtension(outPath);
     }
 
-    private VariantContextWriter createVCFWriter(final Path writerPath, final OutputStream writerStream) {
+    private IndexingVariantContextWriter createVCFWriter(final Path writerPath, final OutputStream writerStream) {
         if (idxCreator == null) {
             return new VCFWriter(writerPath, writerStream, refDict,
                     options.contains(Options.INDEX_ON_THE_FLY),
@@ -585,16 +607,19 @@ public class VariantContextWriterBuilder {
         }
     }
 
-    private VariantContextWriter createBCFWriter(final Path writerPath, final OutputStream writerStream) {
+    private IndexingVariantContextWriter createBCFWriter(final Path writerPath, final OutputStream writerStream) {
+        final BCFVersion bcfVersion = options.contains(Options.WRITE_BCF_2_2) ? BCF2Codec.BCF_VERSION_2_2 : BCF2Codec.ALLOWED_BCF_VERSION;
         if (idxCreator == null) {
             return new BCF2Writer(writerPath, writerStream, refDict,
                     options.contains(Options.INDEX_ON_THE_FLY),
-                    options.contains(Options.DO_NOT_WRITE_GENOTYPES));
+                    options.contains(Options.DO_NOT_WRITE_GENOTYPES),
+                    bcfVersion);
         }
         else {
             return new BCF2Writer(writerPath, writerStream, refDict, idxCreator,
                     options.contains(Options.INDEX_ON_THE_FLY),
-                    options.contains(Options.DO_NOT_WRITE_GENOTYPES));
+                    options.contains(Options.DO_NOT_WRITE_GENOTYPES),
+                    bcfVersion);
         }
     }
 }
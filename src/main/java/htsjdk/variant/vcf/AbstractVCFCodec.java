@@ -32,7 +32,7 @@ import htsjdk.tribble.Feature;
 import htsjdk.tribble.NameAwareCodec;
 import htsjdk.tribble.TribbleException;
 import htsjdk.tribble.index.tabix.TabixFormat;
-import htsjdk.tribble.util.ParsingUtils;
+import htsjdk.tribble.readers.LineIterator;
 import htsjdk.utils.ValidationUtils;
 import htsjdk.variant.utils.GeneralUtils;
 import htsjdk.variant.variantcontext.*;
@@ -40,6 +40,7 @@ import htsjdk.variant.variantcontext.*;
 import java.io.FileNotFoundException;
 import java.io.IOException;
 import java.io.InputStream;
+import java.nio.charset.StandardCharsets;
 import java.nio.file.Files;
 import java.nio.file.Path;
 import java.util.*;
@@ -59,18 +60,64 @@ public abstract class AbstractVCFCodec extends AsciiFeatureCodec<VariantContext>
     //by default, we use the passThruTextTransformer (assume pre v4.3)
     private VCFTextTransformer vcfTextTransformer = passThruTextTransformer;
 
-    // a mapping of the allele
+    /**
+     * @deprecated never populated, as genotype alleles are cached internally while genotypes are decoded.  Subclasses
+     * should read the alleles of the decoded {@link Genotype}s instead.  To be removed in a future release.
+     */
+    @Deprecated
     protected Map<String, List<Allele>> alleleMap = new HashMap<String, List<Allele>>(3);
     
     // for performance testing purposes
     public static boolean validate = true;
 
-    // a key optimization -- we need a per thread string parts array, so we don't allocate a big array over and over
-    // todo: make this thread safe?
+    /**
+     * @deprecated never populated, as records are split into columns by offset rather than into Strings (see
+     * {@link #decode(byte[], int)}).  Subclasses should read the fields of the decoded {@link VariantContext}
+     * instead.  To be removed in a future release.
+     */
+    @Deprecated
     protected String[] parts = null;
+    /** @deprecated never populated, see {@link #parts}.  To be removed in a future release. */
+    @Deprecated
     protected String[] genotypeParts = null;
+    /** @deprecated never populated, see {@link #parts}.  To be removed in a future release. */
+    @Deprecated
     protected final String[] locParts = new String[6];
 
+    // a key optimization -- records are split into columns by offset, so that no String is created for a column
+    // unless its value is needed.  Column i of the current record is [columnStarts[i], columnEnds[i]).
+    private final int[] columnStarts = new int[NUM_STANDARD_FIELDS + 1];
+    private final int[] columnEnds = new int[NUM_STANDARD_FIELDS + 1];
+    // reused to hold the bytes of each line decoded by decode(String)
+    private byte[] stringLineBytes = new byte[1024];
+
+    // upper bound on the number of distinct contigs, keys and filters whose canonical Strings are kept
+    private static final int MAX_CACHED_STRINGS = 100000;
+    // upper bound on the number of distinct GT values whose alleles are kept while decoding the genotypes of a record
+    private static final int MAX_CACHED_GENOTYPE_ALLELES = 1000;
+    // REF and ALT alleles no longer than this are interned, which covers single bases, short indels and symbolic alleles
+    private static final int MAX_INTERNED_ALLELE_LENGTH = 32;
+    // upper bound on the number of distinct REF and ALT alleles that are interned
+    private static final int MAX_INTERNED_ALLELES = 10000;
+
+    // canonical copies of contig names, INFO and FORMAT keys and filters, found directly from the bytes of a record.
+    // Seeded from the header, so keys are the same String instances as the IDs of the header lines.
+    private ByteKeyCache<String> byteStringCache = new ByteKeyCache<>(MAX_CACHED_STRINGS);
+    // canonical REF and ALT alleles, found directly from the bytes of a record, so that records with the same short
+    // alleles share Allele objects rather than each creating their own
+    private final ByteKeyCache<Allele> refAllelePool = new ByteKeyCache<>(MAX_INTERNED_ALLELES);
+    private final ByteKeyCache<Allele> altAllelePool = new ByteKeyCache<>(MAX_INTERNED_ALLELES);
+    // the alleles for each GT value, kept for as long as the genotypes of records with the same alleles are decoded
+    private final ByteKeyCache<List<Allele>> genotypeAlleleCache = new ByteKeyCache<>(MAX_CACHED_GENOTYPE_ALLELES);
+    // the alleles of the records for which genotypeAlleleCache holds GT values
+    private List<Allele> genotypeAlleleCacheAlleles = null;
+    // the FORMAT field of the last record whose genotypes were decoded, and its keys
+    private byte[] lastFormatField = null;
+    private String[] lastFormatKeys = null;
+    // offsets of the values for each FORMAT key in a sample's genotype field
+    private int[] genotypeValueStarts = new int[0];
+    private int[] genotypeValueEnds = new int[0];
+
     // for performance we cache the hashmap of filter encodings for quick lookup
     protected HashMap<String,List<String>> filterHash = new HashMap<String,List<String>>();
 
@@ -94,6 +141,32 @@ public abstract class AbstractVCFCodec extends AsciiFeatureCodec<VariantContext>
      */
     protected String remappedSampleName = null;
 
+    /**
+     * If true, genotypes are decoded into {@link ColumnarGenotypes} rather than one Genotype object per sample
+     */
+    private boolean useColumnarGenotypes = false;
+
+    /**
+     * If true, only the site columns of records are read, and the FORMAT and genotype columns are skipped
+     */
+    private boolean sitesOnly = false;
+
+    /**
+     * The samples whose genotypes are decoded, or null to decode those of all samples
+     */
+    private Set<String> samplesToDecode = null;
+
+    /**
+     * The samples of the header whose genotypes are decoded, or null to decode those of all samples
+     */
+    private VCFSampleSubset sampleSubset = null;
+
+    /**
+     * The codec that decodes the genotypes of records when they are first accessed, which is this codec unless
+     * set by {@link #setGenotypeCodec(AbstractVCFCodec)}
+     */
+    private AbstractVCFCodec genotypeCodec = this;
+
     protected AbstractVCFCodec() {
         super(VariantContext.class);
     }
@@ -108,17 +181,55 @@ public abstract class AbstractVCFCodec extends AsciiFeatureCodec<VariantContext>
         final List<Allele> alleles;
         final String contig;
         final int start;
+        // the codec whose caches are used to decode the genotypes
+        final AbstractVCFCodec decoder;
 
         LazyVCFGenotypesParser(final List<Allele> alleles, final String contig, final int start) {
+            this(alleles, contig, start, genotypeCodec);
+        }
+
+        LazyVCFGenotypesParser(final List<Allele> alleles, final String contig, final int start, final AbstractVCFCodec decoder) {
             this.alleles = alleles;
             this.contig = contig;
             this.start = start;
+            this.decoder = decoder;
         }
 
         @Override
         public LazyGenotypesContext.LazyData parse(final Object data) {
             //System.out.printf("Loading genotypes... %s:%d%n", contig, start);
-            return createGenotypeMap((String) data, alleles, contig, start);
+            if ( data instanceof UnparsedGenotypes ) {
+                final byte[] bytes = ((UnparsedGenotypes) data).bytes;
+                return decoder.createGenotypeMap(bytes, 0, bytes.length, alleles, contig, start);
+            }
+            return decoder.createGenotypeMap((String) data, alleles, contig, start);
+        }
+    }
+
+    /**
+     * The FORMAT and sample columns of a record, held unparsed as the bytes of the line until its genotypes are
+     * decoded, so that they are never converted to a String unless they are written out as they are
+     */
+    public static final class UnparsedGenotypes {
+        private final byte[] bytes;
+
+        UnparsedGenotypes(final byte[] bytes) {
+            this.bytes = bytes;
+        }
+
+        /**
+         * @return the UTF-8 bytes of the columns, separated by tabs.  Must not be modified.
+         */
+        public byte[] getBytes() {
+            return bytes;
+        }
+
+        /**
+         * @return the text of the columns, as in the VCF
+         */
+        @Override
+        public String toString() {
+            return new String(bytes, StandardCharsets.UTF_8);
         }
     }
 
@@ -261,10 +372,92 @@ public abstract class AbstractVCFCodec extends AsciiFeatureCodec<VariantContext>
 
         this.version = newVersion;
         this.vcfTextTransformer = getTextTransformerForVCFVersion(newVersion);
+        this.byteStringCache = createByteStringCache(this.header);
+        this.lastFormatField = null;
+        this.lastFormatKeys = null;
+        this.sampleSubset = samplesToDecode == null ? null : new VCFSampleSubset(this.header, samplesToDecode);
 
         return this.header;
     }
 
+    /**
+     * Creates a codec that decodes records in the same way as this one, for decoding records on another thread.  The
+     * copy shares this codec's header, which must not be modified while the copy is in use, and its settings, but has
+     * its own caches, so that the two can be used concurrently.
+     *
+     * @return a copy of this codec, ready to decode records
+     * @throws IllegalStateException if this codec does not have a header yet
+     * @throws UnsupportedOperationException if this codec cannot be copied (see {@link #canCopyForDecoding()})
+     */
+    public AbstractVCFCodec copyForDecoding() {
+        if ( header == null ) throw new IllegalStateException("The header must be read or set before a codec can be copied");
+        final AbstractVCFCodec copy = newCodec();
+        if ( copy == null ) throw new UnsupportedOperationException(getClass().getSimpleName() + " cannot be copied for decoding on another thread");
+        copy.header = header;
+        copy.version = version;
+        copy.vcfTextTransformer = vcfTextTransformer;
+        copy.byteStringCache = createByteStringCache(header);
+        copy.name = name;
+        copy.lineNo = lineNo;
+        copy.doOnTheFlyModifications = doOnTheFlyModifications;
+        copy.remappedSampleName = remappedSampleName;
+        copy.useColumnarGenotypes = useColumnarGenotypes;
+        copy.sitesOnly = sitesOnly;
+        copy.samplesToDecode = samplesToDecode;
+        copy.sampleSubset = sampleSubset;
+        copy.warnedAboutNoEqualsForNonFlag = warnedAboutNoEqualsForNonFlag;
+        return copy;
+    }
+
+    /**
+     * Sets the codec that decodes the genotypes of the records decoded by this one when they are first accessed.  The
+     * caches of a codec must only be used by one thread at a time, so when records are decoded on one thread and
+     * their genotypes are accessed on another, each thread needs its own codec (see {@link #copyForDecoding()}).
+     *
+     * @param genotypeCodec a codec with the same header and settings as this one, or this codec
+     */
+    void setGenotypeCodec(final AbstractVCFCodec genotypeCodec) {
+        ValidationUtils.nonNull(genotypeCodec, "genotypeCodec");
+        this.genotypeCodec = genotypeCodec;
+    }
+
+    /**
+     * @return true if {@link #copyForDecoding()} can copy this codec, so that its records can be decoded on several
+     * threads.  Readers decode the records of a codec that cannot be copied on the thread that reads them.
+     */
+    public boolean canCopyForDecoding() {
+        return newCodec() != null;
+    }
+
+    /**
+     * @return a new codec of the same type as this one, for {@link #copyForDecoding()} to configure, or null if this
+     * codec cannot be copied.  Subclasses of VCFCodec and VCF3Codec cannot be copied unless they override this, as
+     * a copy would not have their own state.
+     */
+    protected AbstractVCFCodec newCodec() {
+        return null;
+    }
+
+    /**
+     * @return a cache seeded with the IDs of the INFO, FORMAT, FILTER and contig lines of the header, so that keys in
+     * decoded records are the header's own Strings
+     */
+    private static ByteKeyCache<String> createByteStringCache(final VCFHeader header) {
+        final ByteKeyCache<String> cache = new ByteKeyCache<>(MAX_CACHED_STRINGS);
+        final List<String> ids = new ArrayList<>();
+        header.getInfoHeaderLines().forEach(line -> ids.add(line.getID()));
+        header.getFormatHeaderLines().forEach(line -> ids.add(line.getID()));
+        header.getFilterLines().forEach(line -> ids.add(line.getID()));
+        header.getContigLines().forEach(line -> ids.add(line.getID()));
+        for (final String id : ids) {
+            final byte[] bytes = id.getBytes(StandardCharsets.UTF_8);
+            if (cache.get(bytes, 0, bytes.length) == null) {
+                cache.put(bytes, 0, bytes.length, id);
+            }
+        }
+        return cache;
+    }
+
     /**
      * Create and return a VCFAltHeaderLine object from a header line string that conforms to the {@code sourceVersion}
      * @param headerLineString VCF header line being parsed without the leading "##ALT="
@@ -318,6 +511,16 @@ public abstract class AbstractVCFCodec extends AsciiFeatureCodec<VariantContext>
         return decodeLine(line, false);
     }
 
+    /**
+     * the fast decode function, for a line held as bytes
+     * @param line buffer holding the line of text for the record, without its line terminator
+     * @param length the number of bytes of the line in the buffer
+     * @return a feature, (not guaranteed complete) that has the correct start and stop
+     */
+    public Feature decodeLoc(final byte[] line, final int length) {
+        return decodeLine(line, length, false);
+    }
+
     /**
      * decode the line into a feature (VariantContext)
      * @param line the line
@@ -328,6 +531,35 @@ public abstract class AbstractVCFCodec extends AsciiFeatureCodec<VariantContext>
         return decodeLine(line, true);
     }
 
+    /**
+     * decode a line held as bytes into a VariantContext, without first converting the line to a String.  The
+     * record is tokenized in place and Strings are only created for the values that a VariantContext holds; the
+     * genotypes are decoded lazily, as for {@link #decode(String)}.  The buffer is not retained, so it may be reused
+     * for the next line.
+     * @param line buffer holding the line, without its line terminator
+     * @param length the number of bytes of the line in the buffer
+     * @return a VariantContext, or null for a header line
+     */
+    public VariantContext decode(final byte[] line, final int length) {
+        return decodeLine(line, length, true);
+    }
+
+    /**
+     * decode the next line of a source made by {@link #makeSourceFromStream(InputStream)} directly from its bytes,
+     * without converting it to a String; lines of other sources are decoded as by {@link #decode(String)}
+     * @param lineIterator the source of lines
+     * @return a VariantContext, or null for a header line
+     */
+    @Override
+    public VariantContext decode(final LineIterator lineIterator) {
+        if ( lineIterator instanceof VCFLineIterator ) {
+            final VCFLineIterator lines = (VCFLineIterator) lineIterator;
+            final int length = lines.nextLineBytes();
+            return decode(lines.getLineBuffer(), length);
+        }
+        return super.decode(lineIterator);
+    }
+
     /**
      * Throw if new a version/header are not compatible with the existing version/header. Generally, any version
      * before v4.2 can be up-converted to v4.2, but not to v4.3. Once a header is established as v4.3, it cannot
@@ -363,34 +595,73 @@ public abstract class AbstractVCFCodec extends AsciiFeatureCodec<VariantContext>
     }
 
     private VariantContext decodeLine(final String line, final boolean includeGenotypes) {
+        final int end = sitesOnly ? siteColumnsEnd(line) : line.length();
+        if ( stringLineBytes.length < end ) {
+            stringLineBytes = new byte[Math.max(end, 2 * stringLineBytes.length)];
+        }
+        // lines are almost always ASCII, whose chars are their own UTF-8 bytes, so no byte[] is allocated per line
+        for ( int i = 0; i < end; i++ ) {
+            final char c = line.charAt(i);
+            if ( c >= 0x80 ) {
+                final byte[] bytes = line.substring(0, end).getBytes(StandardCharsets.UTF_8);
+                return decodeLine(bytes, bytes.length, includeGenotypes);
+            }
+            stringLineBytes[i] = (byte) c;
+        }
+        return decodeLine(stringLineBytes, end, includeGenotypes);
+    }
+
+    /**
+     * @return the end of the site columns of a line, up to and including INFO, so that the genotype columns are not
+     * copied
+     */
+    private static int siteColumnsEnd(final String line) {
+        int tab = -1;
+        for (int i = 0; i < NUM_STANDARD_FIELDS; i++) {
+            tab = line.indexOf(VCFConstants.FIELD_SEPARATOR_CHAR, tab + 1);
+            if (tab == -1) return line.length();
+        }
+        return tab;
+    }
+
+    private VariantContext decodeLine(final byte[] line, final int length, final boolean includeGenotypes) {
         // the same line reader is not used for parsing the header and parsing lines, if we see a #, we've seen a header line
-        if (line.startsWith(VCFHeader.HEADER_INDICATOR)) return null;
+        if (length > 0 && line[0] == VCFHeader.HEADER_INDICATOR.charAt(0)) return null;
 
         // our header cannot be null, we need the genotype sample names and counts
         if (header == null) throw new TribbleException("VCF Header cannot be null when decoding a record");
 
-        if (parts == null)
-            parts = new String[Math.min(header.getColumnCount(), NUM_STANDARD_FIELDS+1)];
-
-        final int nParts = ParsingUtils.split(line, parts, VCFConstants.FIELD_SEPARATOR_CHAR, true);
-
-        // if we have don't have a header, or we have a header with no genotyping data check that we
-        // have eight columns.  Otherwise check that we have nine (normal columns + genotyping data)
-        if (( (header == null || !header.hasGenotypingData()) && nParts != NUM_STANDARD_FIELDS) ||
-                (header != null && header.hasGenotypingData() && nParts != (NUM_STANDARD_FIELDS + 1)) )
-            throw new TribbleException("Line " + lineNo + ": there aren't enough columns for line " + line + " (we expected " + (header == null ? NUM_STANDARD_FIELDS : NUM_STANDARD_FIELDS + 1) +
-                    " tokens, and saw " + nParts + " )");
-
-        return parseVCFLine(parts, includeGenotypes);
+        // split into the standard columns, with all of the genotype columns (if any) condensed into the last one,
+        // or dropped when reading only sites
+        final int maxColumns = sitesOnly ? NUM_STANDARD_FIELDS : Math.min(header.getColumnCount(), NUM_STANDARD_FIELDS + 1);
+        int nColumns = 0;
+        int start = 0;
+        for (int tab; nColumns < maxColumns - 1 && (tab = VCFByteUtils.indexOf(line, start, length, VCFConstants.FIELD_SEPARATOR_CHAR)) != -1; start = tab + 1) {
+            columnStarts[nColumns] = start;
+            columnEnds[nColumns++] = tab;
+        }
+        final int lastColumnEnd = sitesOnly ? VCFByteUtils.indexOf(line, start, length, VCFConstants.FIELD_SEPARATOR_CHAR) : -1;
+        columnStarts[nColumns] = start;
+        columnEnds[nColumns++] = lastColumnEnd == -1 ? length : lastColumnEnd;
+
+        // if we have don't have a header, or we have a header with no genotyping data, or we are reading only sites,
+        // check that we have eight columns.  Otherwise check that we have nine (normal columns + genotyping data)
+        final int expectedColumns = header.hasGenotypingData() && !sitesOnly ? NUM_STANDARD_FIELDS + 1 : NUM_STANDARD_FIELDS;
+        if ( nColumns != expectedColumns )
+            throw new TribbleException("Line " + lineNo + ": there aren't enough columns for line " + VCFByteUtils.toString(line, 0, length) + " (we expected " + expectedColumns +
+                    " tokens, and saw " + nColumns + " )");
+
+        return parseVCFLine(line, nColumns, includeGenotypes);
     }
 
     /**
      * parse out the VCF line
      *
-     * @param parts the parts split up
+     * @param line the bytes of the line, already split into columns
+     * @param nColumns the number of columns
      * @return a variant context object
      */
-    private VariantContext parseVCFLine(final String[] parts, final boolean includeGenotypes) {
+    private VariantContext parseVCFLine(final byte[] line, final int nColumns, final boolean includeGenotypes) {
         VariantContextBuilder builder = new VariantContextBuilder();
         builder.source(getName());
 
@@ -400,32 +671,32 @@ public abstract class AbstractVCFCodec extends AsciiFeatureCodec<VariantContext>
         lineNo++;
 
         // parse out the required fields
-        final String chr = getCachedString(parts[0]);
+        final String chr = getCachedString(line, columnStarts[0], columnEnds[0]);
         builder.chr(chr);
         int pos = -1;
         try {
-            pos = Integer.parseInt(parts[1]);
+            pos = VCFByteUtils.parseInt(line, columnStarts[1], columnEnds[1]);
         } catch (NumberFormatException e) {
-            generateException(parts[1] + " is not a valid start position in the VCF format");
+            generateException(column(line, 1) + " is not a valid start position in the VCF format");
         }
         builder.start(pos);
 
-        if ( parts[2].isEmpty() )
+        if ( columnStarts[2] == columnEnds[2] )
             generateException("The VCF specification requires a valid ID field");
-        else if ( parts[2].equals(VCFConstants.EMPTY_ID_FIELD) )
+        else if ( VCFByteUtils.equalsAscii(line, columnStarts[2], columnEnds[2], VCFConstants.EMPTY_ID_FIELD) )
             builder.noID();
         else
-            builder.id(parts[2]);
+            builder.id(column(line, 2));
 
-        final String ref = parts[3].toUpperCase();
-        final String alts = parts[4];
-        builder.log10PError(parseQual(parts[5]));
+        final int refLength = columnEnds[3] - columnStarts[3];
+        builder.log10PError(VCFByteUtils.equalsAscii(line, columnStarts[5], columnEnds[5], VCFConstants.MISSING_VALUE_v4) ?
+                VariantContext.NO_LOG10_PERROR : parseQual(column(line, 5)));
 
-        final List<String> filters = parseFilters(getCachedString(parts[6]));
+        final List<String> filters = parseFilters(getCachedString(line, columnStarts[6], columnEnds[6]));
         if ( filters != null ) {
             builder.filters(new HashSet<>(filters));
         }
-        final Map<String, Object> attrs = parseInfo(parts[7]);
+        final Map<String, Object> attrs = parseInfo(line, columnStarts[7], columnEnds[7]);
         builder.attributes(attrs);
 
         if ( attrs.containsKey(VCFConstants.END_KEY) ) {
@@ -436,21 +707,24 @@ public abstract class AbstractVCFCodec extends AsciiFeatureCodec<VariantContext>
                 generateException("the END value in the INFO field is not valid");
             }
         } else {
-            builder.stop(pos + ref.length() - 1);
+            builder.stop(pos + refLength - 1);
         }
 
         // get our alleles, filters, and setup an attribute map
-        final List<Allele> alleles = parseAlleles(ref, alts, lineNo);
+        final List<Allele> alleles = parseAlleles(line);
         builder.alleles(alleles);
 
         // do we have genotyping data
-        if (parts.length > NUM_STANDARD_FIELDS && includeGenotypes) {
-            final LazyGenotypesContext.LazyParser lazyParser = new LazyVCFGenotypesParser(alleles, chr, pos);
-            final int nGenotypes = header.getNGenotypeSamples();
-            LazyGenotypesContext lazy = new LazyGenotypesContext(lazyParser, parts[8], nGenotypes);
-
-            // did we resort the sample names?  If so, we need to load the genotype data
-            if ( !header.samplesWereAlreadySorted() )
+        if (nColumns > NUM_STANDARD_FIELDS && includeGenotypes) {
+            // did we resort the sample names?  If so, we need to load the genotype data now, with this codec.  So too if
+            // only some samples are decoded, as the unparsed data holds those of all samples, so must not be written out
+            final boolean decodeNow = sampleSubset != null || !header.samplesWereAlreadySorted();
+            final LazyGenotypesContext.LazyParser lazyParser = new LazyVCFGenotypesParser(alleles, chr, pos, decodeNow ? this : genotypeCodec);
+            final int nGenotypes = sampleSubset == null ? header.getNGenotypeSamples() : sampleSubset.size();
+            final byte[] genotypeColumns = Arrays.copyOfRange(line, columnStarts[NUM_STANDARD_FIELDS], columnEnds[NUM_STANDARD_FIELDS]);
+            LazyGenotypesContext lazy = new LazyGenotypesContext(lazyParser, new UnparsedGenotypes(genotypeColumns), nGenotypes);
+
+            if ( decodeNow )
                 lazy.decode();
 
             builder.genotypesNoValidation(lazy);
@@ -466,6 +740,13 @@ public abstract class AbstractVCFCodec extends AsciiFeatureCodec<VariantContext>
         return vc;
     }
 
+    /**
+     * @return the text of the i'th column of the current record
+     */
+    private String column(final byte[] line, final int i) {
+        return VCFByteUtils.toString(line, columnStarts[i], columnEnds[i]);
+    }
+
     /**
      * get the name of this codec
      * @return our set name
@@ -499,45 +780,72 @@ public abstract class AbstractVCFCodec extends AsciiFeatureCodec<VariantContext>
         return internedString;
     }
 
+    /**
+     * Return a cached copy of the text in a range of bytes, only creating a String the first time the text is seen.
+     *
+     * @param bytes buffer holding the text
+     * @param start offset of the first byte of the text
+     * @param end offset one past the last byte of the text
+     * @return interned string
+     */
+    private String getCachedString(final byte[] bytes, final int start, final int end) {
+        String internedString = byteStringCache.get(bytes, start, end);
+        if ( internedString == null ) {
+            internedString = getCachedString(VCFByteUtils.toString(bytes, start, end));
+            byteStringCache.put(bytes, start, end, internedString);
+        }
+        return internedString;
+    }
+
     /**
      * parse out the info fields
-     * @param infoField the fields
+     * @param line the bytes of the line
+     * @param start offset of the first byte of the info field
+     * @param end offset one past the last byte of the info field
      * @return a mapping of keys to objects
      */
-    private Map<String, Object> parseInfo(String infoField) {
+    private Map<String, Object> parseInfo(final byte[] line, final int start, final int end) {
         Map<String, Object> attributes = new HashMap<String, Object>();
 
-        if ( infoField.isEmpty() )
+        if ( start == end )
             generateException("The VCF specification requires a valid (non-zero length) info field");
 
-        if ( !infoField.equals(VCFConstants.EMPTY_INFO_FIELD) ) {
-            if ( infoField.indexOf('\t') != -1 || infoField.indexOf(' ') != -1 )
-                generateException("The VCF specification does not allow for whitespace in the INFO field. Offending field value was \"" + infoField + "\"");
+        if ( !VCFByteUtils.equalsAscii(line, start, end, VCFConstants.EMPTY_INFO_FIELD) ) {
+            if ( VCFByteUtils.indexOf(line, start, end, '\t') != -1 || VCFByteUtils.indexOf(line, start, end, ' ') != -1 )
+                generateException("The VCF specification does not allow for whitespace in the INFO field. Offending field value was \"" + VCFByteUtils.toString(line, start, end) + "\"");
+
+            int fieldEnd;
+            for (int fieldStart = start; fieldStart <= end; fieldStart = fieldEnd + 1) {
+                fieldEnd = VCFByteUtils.indexOf(line, fieldStart, end, VCFConstants.INFO_FIELD_SEPARATOR_CHAR);
+                if ( fieldEnd == -1 ) fieldEnd = end;
 
-            List<String> infoFields = ParsingUtils.split(infoField, VCFConstants.INFO_FIELD_SEPARATOR_CHAR);
-            for (int i = 0; i < infoFields.size(); i++) {
                 String key;
                 Object value;
 
-                int eqI = infoFields.get(i).indexOf("=");
+                int eqI = VCFByteUtils.indexOf(line, fieldStart, fieldEnd, '=');
                 if ( eqI != -1 ) {
-                    key = infoFields.get(i).substring(0, eqI);
-                    String valueString = infoFields.get(i).substring(eqI + 1);
+                    key = getCachedString(line, fieldStart, eqI);
 
                     // split on the INFO field separator
-                    List<String> infoValueSplit = ParsingUtils.split(valueString, VCFConstants.INFO_FIELD_ARRAY_SEPARATOR_CHAR);
-                    if ( infoValueSplit.size() == 1 ) {
-                        value = vcfTextTransformer.decodeText(infoValueSplit.get(0));
+                    if ( VCFByteUtils.indexOf(line, eqI + 1, fieldEnd, VCFConstants.INFO_FIELD_ARRAY_SEPARATOR_CHAR) == -1 ) {
+                        value = vcfTextTransformer.decodeText(VCFByteUtils.toString(line, eqI + 1, fieldEnd));
                         final VCFInfoHeaderLine headerLine = header.getInfoHeaderLine(key);
                         if ( headerLine != null && headerLine.getType() == VCFHeaderLineType.Flag && value.equals("0") ) {
                             // deal with the case where a flag field has =0, such as DB=0, by skipping the add
                             continue;
                         }
                     } else {
+                        final List<String> infoValueSplit = new ArrayList<>(VCFByteUtils.count(line, eqI + 1, fieldEnd, VCFConstants.INFO_FIELD_ARRAY_SEPARATOR_CHAR) + 1);
+                        int valueEnd;
+                        for (int valueStart = eqI + 1; valueStart <= fieldEnd; valueStart = valueEnd + 1) {
+                            valueEnd = VCFByteUtils.indexOf(line, valueStart, fieldEnd, VCFConstants.INFO_FIELD_ARRAY_SEPARATOR_CHAR);
+                            if ( valueEnd == -1 ) valueEnd = fieldEnd;
+                            infoValueSplit.add(VCFByteUtils.toString(line, valueStart, valueEnd));
+                        }
                         value = vcfTextTransformer.decodeText(infoValueSplit);
                     }
                 } else {
-                    key = infoFields.get(i);
+                    key = getCachedString(line, fieldStart, fieldEnd);
                     final VCFInfoHeaderLine headerLine = header.getInfoHeaderLine(key);
                     if ( headerLine != null && headerLine.getType() != VCFHeaderLineType.Flag ) {
                         if ( GeneralUtils.DEBUG_MODE_ENABLED && ! warnedAboutNoEqualsForNonFlag ) {
@@ -650,6 +958,51 @@ public abstract class AbstractVCFCodec extends AsciiFeatureCodec<VariantContext>
         return alleles;
     }
 
+    /**
+     * parse the REF and ALT columns of the current record into alleles, reusing the interned Allele objects of
+     * short alleles that have been seen before
+     *
+     * @param line the bytes of the line, already split into columns
+     * @return the alleles, starting with the reference allele
+     */
+    private List<Allele> parseAlleles(final byte[] line) {
+        final List<Allele> alleles = new ArrayList<Allele>(2); // we are almost always biallelic
+        alleles.add(getAllele(line, columnStarts[3], columnEnds[3], true));
+
+        final int altStart = columnStarts[4];
+        int altEnd = columnEnds[4];
+        if ( VCFByteUtils.indexOf(line, altStart, altEnd, ',') != -1 ) {
+            // like String.split, ignore trailing empty alleles
+            while ( altEnd > altStart && line[altEnd - 1] == ',' ) altEnd--;
+            if ( altEnd == altStart ) return alleles;
+        }
+        for ( int start = altStart, comma; start <= altEnd; start = comma + 1 ) {
+            comma = VCFByteUtils.indexOf(line, start, altEnd, ',');
+            if ( comma == -1 ) comma = altEnd;
+            final Allele allele = getAllele(line, start, comma, false);
+            if ( ! allele.isNoCall() )
+                alleles.add(allele);
+        }
+        return alleles;
+    }
+
+    /**
+     * @return the allele for the bytes in [start, end), checked and created only if it is not already interned
+     */
+    private Allele getAllele(final byte[] line, final int start, final int end, final boolean isRef) {
+        final ByteKeyCache<Allele> pool = isRef ? refAllelePool : altAllelePool;
+        final boolean intern = end - start <= MAX_INTERNED_ALLELE_LENGTH;
+        Allele allele = intern ? pool.get(line, start, end) : null;
+        if ( allele == null ) {
+            final String text = VCFByteUtils.toString(line, start, end);
+            final String bases = isRef ? text.toUpperCase() : text;
+            checkAllele(bases, isRef, lineNo);
+            allele = Allele.create(bases, isRef);
+            if ( intern ) pool.put(line, start, end, allele);
+        }
+        return allele;
+    }
+
     /**
      * check to make sure the allele is an acceptable allele
      * @param allele the allele to check
@@ -751,79 +1104,157 @@ public abstract class AbstractVCFCodec extends AsciiFeatureCodec<VariantContext>
                                                               final List<Allele> alleles,
                                                               final String chr,
                                                               final int pos) {
-        if (genotypeParts == null)
-            genotypeParts = new String[header.getColumnCount() - NUM_STANDARD_FIELDS];
+        final byte[] bytes = str.getBytes(StandardCharsets.UTF_8);
+        return createGenotypeMap(bytes, 0, bytes.length, alleles, chr, pos);
+    }
 
-        int nParts = ParsingUtils.split(str, genotypeParts, VCFConstants.FIELD_SEPARATOR_CHAR);
-        if ( nParts != genotypeParts.length )
-            generateException("there are " + (nParts-1) + " genotypes while the header requires that " + (genotypeParts.length-1) + " genotypes be present for all records at " + chr + ":" + pos, lineNo);
+    /**
+     * create a genotype map from the genotype columns of a record held as bytes.  The columns are tokenized in place,
+     * so Strings are only created for FORMAT values that are stored as generic attributes; GT, GQ, DP, AD and PL are
+     * decoded directly from the bytes.
+     *
+     * @param bytes buffer holding the FORMAT column followed by the sample columns
+     * @param start offset of the first byte of the FORMAT column
+     * @param end offset one past the last byte of the last sample column
+     * @param alleles the list of alleles
+     * @return a mapping of sample name to genotype object
+     */
+    public LazyGenotypesContext.LazyData createGenotypeMap(final byte[] bytes,
+                                                              final int start,
+                                                              final int end,
+                                                              final List<Allele> alleles,
+                                                              final String chr,
+                                                              final int pos) {
+        // the FORMAT column and one column per sample; any columns beyond those in the header are ignored
+        final int nColumns = header.getColumnCount() - NUM_STANDARD_FIELDS;
+        int nParts = 1;
+        for (int i = start; i < end && nParts < nColumns; i++) {
+            if (bytes[i] == VCFConstants.FIELD_SEPARATOR_CHAR) nParts++;
+        }
+        if ( nParts != nColumns )
+            generateException("there are " + (nParts-1) + " genotypes while the header requires that " + (nColumns-1) + " genotypes be present for all records at " + chr + ":" + pos, lineNo);
 
-        ArrayList<Genotype> genotypes = new ArrayList<Genotype>(nParts);
+        // in columnar mode one builder is reused for every sample, as its values are copied into the columns
+        final VCFSampleSubset subset = sampleSubset;
+        final int nGenotypes = subset == null ? nParts - 1 : subset.size();
+        final ArrayList<Genotype> genotypes = useColumnarGenotypes ? null : new ArrayList<Genotype>(nGenotypes);
+        final ColumnarGenotypes.Builder columns = useColumnarGenotypes ? new ColumnarGenotypes.Builder(nGenotypes) : null;
+        final GenotypeBuilder reusedBuilder = useColumnarGenotypes ? new GenotypeBuilder() : null;
 
         // get the format keys
-        List<String> genotypeKeys = ParsingUtils.split(genotypeParts[0], VCFConstants.GENOTYPE_FIELD_SEPARATOR_CHAR);
+        int formatEnd = VCFByteUtils.indexOf(bytes, start, end, VCFConstants.FIELD_SEPARATOR_CHAR);
+        if ( formatEnd == -1 ) formatEnd = end;
+        final String[] genotypeKeys = getFormatKeys(bytes, start, formatEnd);
+        if ( genotypeValueStarts.length < genotypeKeys.length ) {
+            genotypeValueStarts = new int[genotypeKeys.length];
+            genotypeValueEnds = new int[genotypeKeys.length];
+        }
+        final boolean percentEncoded = vcfTextTransformer != passThruTextTransformer;
 
-        // cycle through the sample names
-        Iterator<String> sampleNameIterator = header.getGenotypeSamples().iterator();
+        // the sample names, in column order
+        final List<String> sampleNames = header.getGenotypeSamples();
 
-        // clear out our allele mapping
-        alleleMap.clear();
+        // the alleles of GT values can only be reused for records with the same alleles
+        if ( !sameAlleles(alleles, genotypeAlleleCacheAlleles) ) {
+            genotypeAlleleCache.clear();
+            genotypeAlleleCacheAlleles = alleles;
+        }
 
         // cycle through the genotype strings
         boolean PlIsSet = false;
+        int sampleEnd = formatEnd;
         for (int genotypeOffset = 1; genotypeOffset < nParts; genotypeOffset++) {
-            List<String> genotypeValues = ParsingUtils.split(genotypeParts[genotypeOffset], VCFConstants.GENOTYPE_FIELD_SEPARATOR_CHAR);
-            genotypeValues = vcfTextTransformer.decodeText(genotypeValues);
+            final int sampleStart = sampleEnd + 1;
+            sampleEnd = VCFByteUtils.indexOf(bytes, sampleStart, end, VCFConstants.FIELD_SEPARATOR_CHAR);
+            if ( sampleEnd == -1 ) sampleEnd = end;
+
+            // the columns of samples that are not selected are skipped without being split
+            if ( subset != null && !subset.isSelected(genotypeOffset - 1) )
+                continue;
+
+            // split the sample's column into values; only the offsets of values that have a key are kept
+            int nValues = 0;
+            int fieldEnd;
+            for (int fieldStart = sampleStart; fieldStart <= sampleEnd; fieldStart = fieldEnd + 1) {
+                fieldEnd = VCFByteUtils.indexOf(bytes, fieldStart, sampleEnd, VCFConstants.GENOTYPE_FIELD_SEPARATOR_CHAR);
+                if ( fieldEnd == -1 ) fieldEnd = sampleEnd;
+                if ( nValues < genotypeKeys.length ) {
+                    genotypeValueStarts[nValues] = fieldStart;
+                    genotypeValueEnds[nValues] = fieldEnd;
+                }
+                nValues++;
+            }
 
-            final String sampleName = sampleNameIterator.next();
-            final GenotypeBuilder gb = new GenotypeBuilder(sampleName);
+            final String sampleName = sampleNames.get(genotypeOffset - 1);
+            final GenotypeBuilder gb;
+            if ( reusedBuilder != null ) {
+                reusedBuilder.reset(false);
+                gb = reusedBuilder.name(sampleName);
+            } else {
+                gb = new GenotypeBuilder(sampleName);
+            }
 
             // check to see if the value list is longer than the key list, which is a problem
-            if (genotypeKeys.size() < genotypeValues.size())
-                generateException("There are too many keys for the sample " + sampleName + ", keys = " + parts[8] + ", values = " + parts[genotypeOffset]);
+            if (genotypeKeys.length < nValues)
+                generateException("There are too many keys for the sample " + sampleName + ", keys = " + VCFByteUtils.toString(bytes, start, formatEnd) + ", values = " + VCFByteUtils.toString(bytes, sampleStart, sampleEnd));
 
             int genotypeAlleleLocation = -1;
-            if (!genotypeKeys.isEmpty()) {
-                gb.maxAttributes(genotypeKeys.size() - 1);
-
-                for (int i = 0; i < genotypeKeys.size(); i++) {
-                    final String gtKey = genotypeKeys.get(i);
-                    boolean missing = i >= genotypeValues.size();
-
-                    // todo -- all of these on the fly parsing of the missing value should be static constants
-                    if (gtKey.equals(VCFConstants.GENOTYPE_KEY)) {
-                        genotypeAlleleLocation = i;
-                    } else if ( missing ) {
-                        // if its truly missing (there no provided value) skip adding it to the attributes
-                    } else if (gtKey.equals(VCFConstants.GENOTYPE_FILTER_KEY)) {
-                        final List<String> filters = parseFilters(getCachedString(genotypeValues.get(i)));
-                        if ( filters != null ) gb.filters(filters);
-                    } else if ( genotypeValues.get(i).equals(VCFConstants.MISSING_VALUE_v4) ) {
-                        // don't add missing values to the map
-                    } else {
-                        if (gtKey.equals(VCFConstants.GENOTYPE_QUALITY_KEY)) {
-                            if ( genotypeValues.get(i).equals(VCFConstants.MISSING_GENOTYPE_QUALITY_v3) )
-                                gb.noGQ();
-                            else
-                                gb.GQ((int)Math.round(VCFUtils.parseVcfDouble(genotypeValues.get(i))));
-                        } else if (gtKey.equals(VCFConstants.GENOTYPE_ALLELE_DEPTHS)) {
-                            gb.AD(decodeInts(genotypeValues.get(i)));
-                        } else if (gtKey.equals(VCFConstants.GENOTYPE_PL_KEY)) {
-                            gb.PL(decodeInts(genotypeValues.get(i)));
-                            PlIsSet = true;
-                        } else if (gtKey.equals(VCFConstants.GENOTYPE_LIKELIHOODS_KEY)) {
-                            // Do not overwrite PL with data from GL
-                            if (!PlIsSet) {
-                                gb.PL(GenotypeLikelihoods.fromGLField(genotypeValues.get(i)).getAsPLs());
-                            }
-                        } else if (gtKey.equals(VCFConstants.DEPTH_KEY)) {
-                            gb.DP(Integer.parseInt(genotypeValues.get(i)));
-                        } else {
-                            gb.attribute(gtKey, genotypeValues.get(i));
+            byte[] gtBytes = bytes;
+            int gtStart = 0;
+            int gtEnd = 0;
+            gb.maxAttributes(genotypeKeys.length - 1);
+
+            for (int i = 0; i < genotypeKeys.length && i < nValues; i++) {
+                final String gtKey = genotypeKeys[i];
+
+                // the value, percent-decoded if necessary
+                byte[] value = bytes;
+                int valueStart = genotypeValueStarts[i];
+                int valueEnd = genotypeValueEnds[i];
+                if ( percentEncoded && VCFByteUtils.indexOf(bytes, valueStart, valueEnd, '%') != -1 ) {
+                    value = vcfTextTransformer.decodeText(VCFByteUtils.toString(bytes, valueStart, valueEnd)).getBytes(StandardCharsets.UTF_8);
+                    valueStart = 0;
+                    valueEnd = value.length;
+                }
+
+                // todo -- all of these on the fly parsing of the missing value should be static constants
+                if (gtKey.equals(VCFConstants.GENOTYPE_KEY)) {
+                    genotypeAlleleLocation = i;
+                    gtBytes = value;
+                    gtStart = valueStart;
+                    gtEnd = valueEnd;
+                } else if (gtKey.equals(VCFConstants.GENOTYPE_FILTER_KEY)) {
+                    final List<String> filters = parseFilters(getCachedString(value, valueStart, valueEnd));
+                    if ( filters != null ) gb.filters(filters);
+                } else if ( VCFByteUtils.equalsAscii(value, valueStart, valueEnd, VCFConstants.MISSING_VALUE_v4) ) {
+                    // don't add missing values to the map
+                } else {
+                    if (gtKey.equals(VCFConstants.GENOTYPE_QUALITY_KEY)) {
+                        if ( VCFByteUtils.equalsAscii(value, valueStart, valueEnd, VCFConstants.MISSING_GENOTYPE_QUALITY_v3) )
+                            gb.noGQ();
+                        else
+                            gb.GQ(decodeGenotypeQuality(value, valueStart, valueEnd));
+                    } else if (gtKey.equals(VCFConstants.GENOTYPE_ALLELE_DEPTHS)) {
+                        gb.AD(decodeInts(value, valueStart, valueEnd));
+                    } else if (gtKey.equals(VCFConstants.GENOTYPE_PL_KEY)) {
+                        gb.PL(decodeInts(value, valueStart, valueEnd));
+                        PlIsSet = true;
+                    } else if (gtKey.equals(VCFConstants.GENOTYPE_LIKELIHOODS_KEY)) {
+                        // Do not overwrite PL with data from GL
+                        if (!PlIsSet) {
+                            gb.PL(GenotypeLikelihoods.fromGLField(VCFByteUtils.toString(value, valueStart, valueEnd)).getAsPLs());
                         }
+                    } else if (gtKey.equals(VCFConstants.DEPTH_KEY)) {
+                        gb.DP(VCFByteUtils.parseInt(value, valueStart, valueEnd));
+                    } else {
+                        gb.attribute(gtKey, VCFByteUtils.toString(value, valueStart, valueEnd));
                     }
                 }
             }
+            // keys without values are truly missing, so they are not added to the attributes, but GT must still be found
+            for (int i = nValues; i < genotypeKeys.length && genotypeAlleleLocation == -1; i++) {
+                if (genotypeKeys[i].equals(VCFConstants.GENOTYPE_KEY)) genotypeAlleleLocation = i;
+            }
 
             // check to make sure we found a genotype field if our version is less than 4.1 file
             if ( ! version.isAtLeastAsRecentAs(VCFHeaderVersion.VCF4_1) && genotypeAlleleLocation == -1 )
@@ -831,27 +1262,115 @@ public abstract class AbstractVCFCodec extends AsciiFeatureCodec<VariantContext>
             if ( genotypeAlleleLocation > 0 )
                 generateException("Saw GT field at position " + genotypeAlleleLocation + ", but it must be at the first position for genotypes when present");
 
-            final List<Allele> GTalleles = (genotypeAlleleLocation == -1 ? new ArrayList<Allele>(0) : parseGenotypeAlleles(genotypeValues.get(genotypeAlleleLocation), alleles, alleleMap));
+            final List<Allele> GTalleles = (genotypeAlleleLocation == -1 ? new ArrayList<Allele>(0) : parseGenotypeAlleles(gtBytes, gtStart, gtEnd, alleles));
             gb.alleles(GTalleles);
-            gb.phased(genotypeAlleleLocation != -1 && genotypeValues.get(genotypeAlleleLocation).indexOf(VCFConstants.PHASED) != -1);
+            gb.phased(genotypeAlleleLocation != -1 && VCFByteUtils.indexOf(gtBytes, gtStart, gtEnd, VCFConstants.PHASED.charAt(0)) != -1);
 
             // add it to the list
             try {
-                genotypes.add(gb.make());
+                if ( columns != null )
+                    columns.add(gb);
+                else
+                    genotypes.add(gb.make());
             } catch (TribbleException e) {
                 throw new TribbleException.InternalCodecException(e.getMessage() + ", at position " + chr+":"+pos);
             }
         }
 
-        return new LazyGenotypesContext.LazyData(genotypes, header.getSampleNamesInOrder(), header.getSampleNameToOffset());
+        final List<String> sampleNamesInOrder = subset == null ? header.getSampleNamesInOrder() : subset.getSampleNamesInOrder();
+        final Map<String, Integer> sampleNameToOffset = subset == null ? header.getSampleNameToOffset() : subset.getSampleNameToOffset();
+        if ( columns != null )
+            return new LazyGenotypesContext.LazyData(columns.make(), sampleNamesInOrder, sampleNameToOffset);
+        return new LazyGenotypesContext.LazyData(genotypes, sampleNamesInOrder, sampleNameToOffset);
+    }
+
+    /**
+     * @return the keys of a FORMAT field, reusing the keys of the previous record if its FORMAT field was the same
+     */
+    private String[] getFormatKeys(final byte[] bytes, final int start, final int end) {
+        if ( lastFormatField != null && VCFByteUtils.equalsBytes(lastFormatField, bytes, start, end) )
+            return lastFormatKeys;
+
+        final String[] keys = new String[VCFByteUtils.count(bytes, start, end, VCFConstants.GENOTYPE_FIELD_SEPARATOR_CHAR) + 1];
+        int n = 0;
+        int keyEnd;
+        for (int keyStart = start; keyStart <= end; keyStart = keyEnd + 1) {
+            keyEnd = VCFByteUtils.indexOf(bytes, keyStart, end, VCFConstants.GENOTYPE_FIELD_SEPARATOR_CHAR);
+            if ( keyEnd == -1 ) keyEnd = end;
+            keys[n++] = getCachedString(bytes, keyStart, keyEnd);
+        }
+        lastFormatField = Arrays.copyOfRange(bytes, start, end);
+        lastFormatKeys = keys;
+        return keys;
+    }
+
+    /**
+     * @return true if the two lists hold the same Allele objects, as records with the same interned alleles do
+     */
+    private static boolean sameAlleles(final List<Allele> alleles, final List<Allele> other) {
+        if ( other == null || alleles.size() != other.size() )
+            return false;
+        for ( int i = 0; i < alleles.size(); i++ ) {
+            if ( alleles.get(i) != other.get(i) )
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * parse genotype alleles from the bytes of a GT field, caching the result for later records with the same alleles
+     * @param bytes      buffer holding the GT field
+     * @param start      offset of the first byte of the GT field
+     * @param end        offset one past the last byte of the GT field
+     * @param alleles    list of possible alleles
+     * @return the allele list for the GT field
+     */
+    private List<Allele> parseGenotypeAlleles(final byte[] bytes, final int start, final int end, final List<Allele> alleles) {
+        // cache results [since they are immutable] and return a single object for each genotype
+        List<Allele> GTAlleles = genotypeAlleleCache.get(bytes, start, end);
+
+        if ( GTAlleles == null ) {
+            GTAlleles = new ArrayList<Allele>(2);
+            // as with a StringTokenizer over the phasing tokens, empty tokens are skipped
+            int tokenStart = start;
+            for (int i = start; i <= end; i++) {
+                if ( i == end || VCFConstants.PHASING_TOKENS.indexOf(bytes[i]) != -1 ) {
+                    if ( i > tokenStart ) {
+                        final int index = bytes[tokenStart] - '0';
+                        if ( i - tokenStart == 1 && index >= 0 && index <= 9 && index < alleles.size() )
+                            GTAlleles.add(alleles.get(index));
+                        else if ( VCFByteUtils.equalsAscii(bytes, tokenStart, i, VCFConstants.EMPTY_ALLELE) )
+                            GTAlleles.add(Allele.NO_CALL);
+                        else
+                            GTAlleles.add(oneAllele(VCFByteUtils.toString(bytes, tokenStart, i), alleles));
+                    }
+                    tokenStart = i + 1;
+                }
+            }
+            genotypeAlleleCache.put(bytes, start, end, GTAlleles);
+        }
+
+        return GTAlleles;
     }
 
-    private static final int[] decodeInts(final String string) {
-        List<String> split = ParsingUtils.split(string, ',');
-        int [] values = new int[split.size()];
+    private static int decodeGenotypeQuality(final byte[] bytes, final int start, final int end) {
         try {
-            for (int i = 0; i < values.length; i++) {
-                values[i] = Integer.parseInt(split.get(i));
+            return VCFByteUtils.parseInt(bytes, start, end);
+        } catch (final NumberFormatException e) {
+            // not an integer, e.g. 12.5
+            return (int)Math.round(VCFUtils.parseVcfDouble(VCFByteUtils.toString(bytes, start, end)));
+        }
+    }
+
+    private static int[] decodeInts(final byte[] bytes, final int start, final int end) {
+        int [] values = new int[VCFByteUtils.count(bytes, start, end, ',') + 1];
+        try {
+            int n = 0;
+            int valueEnd;
+            for (int valueStart = start; valueStart <= end; valueStart = valueEnd + 1) {
+                valueEnd = VCFByteUtils.indexOf(bytes, valueStart, end, ',');
+                if ( valueEnd == -1 ) valueEnd = end;
+                values[n++] = VCFByteUtils.parseInt(bytes, valueStart, valueEnd);
             }
         } catch (final NumberFormatException e) {
             return null;
@@ -879,6 +1398,77 @@ public abstract class AbstractVCFCodec extends AsciiFeatureCodec<VariantContext>
         this.remappedSampleName = remappedSampleName;
     }
 
+    /**
+     * Decode genotypes into {@link ColumnarGenotypes}, which store GT, GQ, DP, AD and PL as primitive arrays across
+     * samples and create Genotype objects only on demand.  This greatly reduces the memory used by the genotypes of
+     * records with many samples.
+     *
+     * @param useColumnarGenotypes true to decode genotypes into columnar form
+     */
+    public void setUseColumnarGenotypes(final boolean useColumnarGenotypes) {
+        this.useColumnarGenotypes = useColumnarGenotypes;
+    }
+
+    /**
+     * @return true if genotypes are decoded into {@link ColumnarGenotypes}
+     */
+    public boolean getUseColumnarGenotypes() {
+        return useColumnarGenotypes;
+    }
+
+    /**
+     * Read only the site columns of records, up to and including INFO.  Decoded records have no genotypes, and the
+     * FORMAT and genotype columns are never tokenized.  Sources made by {@link #makeSourceFromStream(InputStream)}
+     * skip those columns as raw bytes, without creating a String of each full line, which makes reading the sites
+     * of a VCF with many samples much cheaper.  The header is unchanged, and still lists the samples of the file.
+     *
+     * Must be set before the source to read records from is made, to skip the genotype columns as bytes.
+     *
+     * @param sitesOnly true to read only the site columns of records
+     */
+    public void setSitesOnly(final boolean sitesOnly) {
+        this.sitesOnly = sitesOnly;
+    }
+
+    /**
+     * @return true if only the site columns of records are read
+     */
+    public boolean getSitesOnly() {
+        return sitesOnly;
+    }
+
+    /**
+     * Decode the genotypes of only the given samples.  The columns of the other samples are skipped without being
+     * parsed, so decoded records have genotypes for just the selected samples, in the order in which they appear
+     * in the file.  This is much cheaper than decoding all genotypes and then calling
+     * {@link VariantContext#subContextFromSamples(Set)}.  The header is unchanged, and still lists all samples.
+     *
+     * @param samples the samples whose genotypes to decode, or null to decode those of all samples
+     * @throws IllegalArgumentException if the header has been read and a sample is not in it
+     */
+    public void setSamplesToDecode(final Collection<String> samples) {
+        final Set<String> newSamples = samples == null ? null : new LinkedHashSet<String>(samples);
+        this.sampleSubset = newSamples == null || header == null ? null : new VCFSampleSubset(header, newSamples);
+        this.samplesToDecode = newSamples;
+    }
+
+    /**
+     * @return the samples whose genotypes are decoded, or null if those of all samples are
+     */
+    public Set<String> getSamplesToDecode() {
+        return samplesToDecode == null ? null : Collections.unmodifiableSet(samplesToDecode);
+    }
+
+    /**
+     * @return an iterator over the lines of the stream, which returns only the site columns of records if
+     * {@link #setSitesOnly(boolean)} is set.  Lines are read as bytes, and {@link #decode(LineIterator)} decodes
+     * records directly from those bytes.
+     */
+    @Override
+    public LineIterator makeSourceFromStream(final InputStream bufferedInputStream) {
+        return new VCFLineIterator(new VCFLineReader(bufferedInputStream, sitesOnly ? NUM_STANDARD_FIELDS : VCFLineReader.ALL_COLUMNS));
+    }
+
     protected void generateException(String message) {
         throw new TribbleException(String.format("The provided VCF file is malformed at approximately line number %d: %s", lineNo, message));
     }
@@ -0,0 +1,144 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.variant.vcf;
+
+import java.util.Arrays;
+
+/**
+ * A small open-addressing hash map keyed by a range of bytes, so that a value can be looked up directly from the text
+ * of a record without first creating a String for the key.  Used by the VCF codec to find canonical copies of
+ * contig names, INFO and FORMAT keys and filters, and the alleles for GT fields it has already seen.
+ *
+ * Once {@code maxSize} entries have been added further puts are ignored, which bounds the memory used if a file has
+ * an unexpectedly large number of distinct keys.  Not thread-safe.
+ */
+final class ByteKeyCache<V> {
+    private static final int INITIAL_CAPACITY = 64;
+
+    private final int maxSize;
+    private byte[][] keys = new byte[INITIAL_CAPACITY][];
+    private int[] hashes = new int[INITIAL_CAPACITY];
+    private Object[] values = new Object[INITIAL_CAPACITY];
+    private int size = 0;
+
+    ByteKeyCache(final int maxSize) {
+        this.maxSize = maxSize;
+    }
+
+    /** @return the value stored for the bytes in [start, end), or null */
+    @SuppressWarnings("unchecked")
+    V get(final byte[] bytes, final int start, final int end) {
+        final int hash = hash(bytes, start, end);
+        final int mask = keys.length - 1;
+        for (int i = hash & mask; keys[i] != null; i = (i + 1) & mask) {
+            if (hashes[i] == hash && rangeEquals(keys[i], bytes, start, end)) {
+                return (V) values[i];
+            }
+        }
+        return null;
+    }
+
+    /** Stores a value for the bytes in [start, end), replacing any existing value, unless the cache is full. */
+    void put(final byte[] bytes, final int start, final int end, final V value) {
+        final int hash = hash(bytes, start, end);
+        int mask = keys.length - 1;
+        int i = hash & mask;
+        for (; keys[i] != null; i = (i + 1) & mask) {
+            if (hashes[i] == hash && rangeEquals(keys[i], bytes, start, end)) {
+                values[i] = value;
+                return;
+            }
+        }
+        if (size >= maxSize) {
+            return;
+        }
+        if (2 * (size + 1) > keys.length) {
+            resize();
+            mask = keys.length - 1;
+            i = hash & mask;
+            while (keys[i] != null) {
+                i = (i + 1) & mask;
+            }
+        }
+        keys[i] = Arrays.copyOfRange(bytes, start, end);
+        hashes[i] = hash;
+        values[i] = value;
+        size++;
+    }
+
+    /** @return the number of entries */
+    int size() {
+        return size;
+    }
+
+    /** Removes every entry. */
+    void clear() {
+        if (size > 0) {
+            Arrays.fill(keys, null);
+            Arrays.fill(values, null);
+            size = 0;
+        }
+    }
+
+    private void resize() {
+        final byte[][] oldKeys = keys;
+        final int[] oldHashes = hashes;
+        final Object[] oldValues = values;
+        keys = new byte[oldKeys.length * 2][];
+        hashes = new int[keys.length];
+        values = new Object[keys.length];
+        final int mask = keys.length - 1;
+        for (int j = 0; j < oldKeys.length; j++) {
+            if (oldKeys[j] != null) {
+                int i = oldHashes[j] & mask;
+                while (keys[i] != null) {
+                    i = (i + 1) & mask;
+                }
+                keys[i] = oldKeys[j];
+                hashes[i] = oldHashes[j];
+                values[i] = oldValues[j];
+            }
+        }
+    }
+
+    private static int hash(final byte[] bytes, final int start, final int end) {
+        int h = 1;
+        for (int i = start; i < end; i++) {
+            h = 31 * h + bytes[i];
+        }
+        return h ^ (h >>> 16);
+    }
+
+    private static boolean rangeEquals(final byte[] key, final byte[] bytes, final int start, final int end) {
+        if (key.length != end - start) {
+            return false;
+        }
+        for (int i = 0; i < key.length; i++) {
+            if (key[i] != bytes[start + i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
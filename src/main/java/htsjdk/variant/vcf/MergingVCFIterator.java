@@ -0,0 +1,395 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.variant.vcf;
+
+import htsjdk.samtools.util.AbstractIterator;
+import htsjdk.samtools.util.CloserUtil;
+import htsjdk.samtools.util.FileExtensions;
+import htsjdk.samtools.util.IOUtil;
+import htsjdk.samtools.util.RuntimeIOException;
+import htsjdk.tribble.TribbleException;
+import htsjdk.utils.ValidationUtils;
+import htsjdk.variant.variantcontext.GenotypesContext;
+import htsjdk.variant.variantcontext.LazyGenotypesContext;
+import htsjdk.variant.variantcontext.VariantContext;
+import htsjdk.variant.variantcontext.VariantContextComparator;
+import htsjdk.variant.variantcontext.writer.Options;
+import htsjdk.variant.variantcontext.writer.VariantContextWriter;
+import htsjdk.variant.variantcontext.writer.VariantContextWriterBuilder;
+
+import java.io.IOException;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.LinkedHashSet;
+import java.util.List;
+import java.util.PriorityQueue;
+import java.util.Set;
+import java.util.concurrent.ExecutionException;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+
+/**
+ * Merges any number of coordinate-sorted VCF or BCF files into a single coordinate-sorted stream of records.
+ *
+ * The header of the merged stream is built from the headers of all of the inputs with
+ * {@link VCFUtils#smartMergeHeaders(java.util.Collection, boolean)}, and its samples are the union of the samples of
+ * the inputs, in the order in which they are first seen.  Records are not combined: each record of each input is
+ * returned once, ordered by the contig order of the merged header and then by start position, with ties returned in
+ * the order of the inputs.  Records from an input whose samples differ from those of the merged header have their
+ * genotypes decoded, so that a writer given the merged header does not copy their genotype columns through verbatim
+ * (samples absent from an input are written as missing).
+ *
+ * Every input must have contig header lines that agree with those of the merged header, and must be sorted in that
+ * order; an out of order record causes an {@link IllegalStateException}.
+ *
+ * At most {@code maxOpenInputs} inputs are open at once.  When there are more inputs than that, consecutive groups of
+ * them are first merged into temporary files, and so on until few enough remain, which are then merged into the
+ * returned stream.  A group of BCF inputs is merged into a BCF, so that its records are read back with the values read
+ * from the inputs (VCF would round their floating point values), and any other group into a block-compressed VCF,
+ * whose values are kept as the text of the inputs.  The temporary files are deleted as soon as they have been merged,
+ * or when this iterator is closed.
+ *
+ * If {@code prefetchThreads} is positive, the next batch of records of each input is read and decoded on a shared pool
+ * of that many threads while the current batch is being merged, so that inputs are read concurrently.  The genotypes
+ * of prefetched records are decoded on the pool too, as they could not otherwise be decoded lazily on the merging
+ * thread while the pool reads more records with the same codec.  Each input has at most two batches in memory at once.
+ *
+ * Not thread-safe: the iterator itself must be used from one thread.
+ */
+public final class MergingVCFIterator extends AbstractIterator<VariantContext> implements VCFIterator {
+    /** The default maximum number of inputs that are open at once */
+    public static final int DEFAULT_MAX_OPEN_INPUTS = 256;
+
+    /** The default number of records read from an input at a time */
+    static final int DEFAULT_RECORDS_PER_BATCH = 128;
+
+    private final VCFHeader header;
+    private final List<String> sampleNames;
+    private final VariantContextComparator comparator;
+    private final int recordsPerBatch;
+    private final ExecutorService executor;
+    private final List<MergeInput> inputs = new ArrayList<>();
+    private final PriorityQueue<MergeInput> queue;
+    private final List<Path> temporaryFiles = new ArrayList<>();
+    private boolean closed = false;
+
+    /**
+     * Merges the given inputs on the calling thread, with at most {@link #DEFAULT_MAX_OPEN_INPUTS} open at once.
+     *
+     * @param inputs the coordinate-sorted VCF or BCF files to merge
+     */
+    public MergingVCFIterator(final List<Path> inputs) throws IOException {
+        this(inputs, DEFAULT_MAX_OPEN_INPUTS, 0, null);
+    }
+
+    /**
+     * @param inputs the coordinate-sorted VCF or BCF files to merge
+     * @param maxOpenInputs the maximum number of inputs that are open at once.  Must be at least 2.
+     * @param prefetchThreads the number of threads reading ahead of the merge, or 0 to read inputs on the calling thread
+     * @param tmpDir the directory of any intermediate merges, or null for the default temporary directory
+     */
+    public MergingVCFIterator(final List<Path> inputs, final int maxOpenInputs, final int prefetchThreads, final Path tmpDir) throws IOException {
+        this(inputs, mergeHeaders(inputs), maxOpenInputs, prefetchThreads, tmpDir, DEFAULT_RECORDS_PER_BATCH);
+    }
+
+    MergingVCFIterator(final List<Path> inputs, final VCFHeader header, final int maxOpenInputs,
+                       final int prefetchThreads, final Path tmpDir, final int recordsPerBatch) throws IOException {
+        ValidationUtils.validateArg(maxOpenInputs > 1, "maxOpenInputs must be at least 2");
+        ValidationUtils.validateArg(prefetchThreads >= 0, "prefetchThreads must not be negative");
+        ValidationUtils.validateArg(recordsPerBatch > 0, "recordsPerBatch must be positive");
+        this.header = header;
+        this.sampleNames = header.getGenotypeSamples();
+        this.comparator = new VariantContextComparator(header.getContigLines());
+        this.recordsPerBatch = recordsPerBatch;
+        this.queue = new PriorityQueue<>(Math.max(1, Math.min(inputs.size(), maxOpenInputs)), (a, b) -> {
+            final int cmp = comparator.compare(a.head, b.head);
+            return cmp != 0 ? cmp : Integer.compare(a.order, b.order);
+        });
+
+        final List<Path> toMerge = reduceInputs(inputs, maxOpenInputs, prefetchThreads, tmpDir);
+        this.executor = prefetchThreads == 0 ? null : Executors.newFixedThreadPool(prefetchThreads, r -> {
+            final Thread t = Executors.defaultThreadFactory().newThread(r);
+            t.setDaemon(true);
+            return t;
+        });
+        try {
+            for (final Path path : toMerge) {
+                final MergeInput input = new MergeInput(path, this.inputs.size());
+                this.inputs.add(input);
+                input.requestBatch();
+            }
+            for (final MergeInput input : this.inputs) {
+                if (input.advance()) {
+                    queue.add(input);
+                }
+            }
+        } catch (final IOException | RuntimeException e) {
+            close();
+            throw e;
+        }
+    }
+
+    /**
+     * Reads the header of each input and merges them, checking that the inputs can be ordered consistently.
+     */
+    private static VCFHeader mergeHeaders(final List<Path> inputs) throws IOException {
+        ValidationUtils.nonEmpty(inputs, "inputs");
+        final List<VCFHeader> headers = new ArrayList<>(inputs.size());
+        final Set<String> samples = new LinkedHashSet<>();
+        for (final Path path : inputs) {
+            try (final VCFIterator it = new VCFIteratorBuilder().open(path)) {
+                headers.add(it.getHeader());
+                samples.addAll(it.getHeader().getGenotypeSamples());
+            }
+        }
+        final VCFHeader merged = new VCFHeader(VCFUtils.smartMergeHeaders(headers, false), new ArrayList<>(samples));
+        if (merged.getContigLines().isEmpty()) {
+            throw new IllegalArgumentException("Cannot merge VCFs without contig header lines");
+        }
+        final VariantContextComparator comparator = new VariantContextComparator(merged.getContigLines());
+        for (int i = 0; i < headers.size(); i++) {
+            if (!comparator.isCompatible(headers.get(i).getContigLines())) {
+                throw new IllegalArgumentException("The contig header lines of " + inputs.get(i) + " are not consistent with those of the other inputs");
+            }
+        }
+        return merged;
+    }
+
+    /**
+     * Merges consecutive groups of the inputs into temporary files until no more than maxOpenInputs remain.
+     */
+    private List<Path> reduceInputs(final List<Path> inputs, final int maxOpenInputs, final int prefetchThreads, final Path tmpDir) throws IOException {
+        List<Path> current = inputs;
+        List<Path> currentTemporaryFiles = Collections.emptyList();
+        try {
+            while (current.size() > maxOpenInputs) {
+                final List<Path> next = new ArrayList<>((current.size() + maxOpenInputs - 1) / maxOpenInputs);
+                for (int from = 0; from < current.size(); from += maxOpenInputs) {
+                    final List<Path> group = current.subList(from, Math.min(current.size(), from + maxOpenInputs));
+                    final boolean bcf = allBCF(group);
+                    final Path merged = IOUtil.newTempPath("merge.", bcf ? FileExtensions.BCF : FileExtensions.COMPRESSED_VCF,
+                            new Path[]{tmpDir != null ? tmpDir : Paths.get(System.getProperty("java.io.tmpdir"))});
+                    temporaryFiles.add(merged);
+                    next.add(merged);
+                    writeMerged(group, merged, bcf, maxOpenInputs, prefetchThreads, tmpDir);
+                }
+                deleteAll(currentTemporaryFiles);
+                current = next;
+                currentTemporaryFiles = next;
+            }
+        } catch (final IOException | RuntimeException e) {
+            deleteAll(temporaryFiles);
+            throw e;
+        }
+        return current;
+    }
+
+    private static boolean allBCF(final List<Path> paths) throws IOException {
+        for (final Path path : paths) {
+            if (!VCFIteratorBuilder.isBCF(path)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    private void writeMerged(final List<Path> group, final Path output, final boolean bcf, final int maxOpenInputs,
+                             final int prefetchThreads, final Path tmpDir) throws IOException {
+        try (final MergingVCFIterator it = new MergingVCFIterator(group, header, maxOpenInputs, prefetchThreads, tmpDir, recordsPerBatch);
+             final VariantContextWriter writer = new VariantContextWriterBuilder()
+                     .setOutputPath(output)
+                     .setOutputFileType(bcf ? VariantContextWriterBuilder.OutputType.BCF
+                             : VariantContextWriterBuilder.OutputType.BLOCK_COMPRESSED_VCF)
+                     .unsetOption(Options.INDEX_ON_THE_FLY)
+                     .build()) {
+            writer.writeHeader(new VCFHeader(header));
+            while (it.hasNext()) {
+                writer.add(it.next());
+            }
+        }
+    }
+
+    private void deleteAll(final List<Path> paths) {
+        for (final Path path : paths) {
+            try {
+                Files.deleteIfExists(path);
+            } catch (final IOException e) {
+                throw new RuntimeIOException("Could not delete temporary file " + path, e);
+            }
+        }
+        temporaryFiles.removeAll(paths);
+    }
+
+    @Override
+    public VCFHeader getHeader() {
+        return header;
+    }
+
+    @Override
+    protected VariantContext advance() {
+        if (closed) {
+            throw new IllegalStateException("iterator has been closed");
+        }
+        final MergeInput input = queue.poll();
+        if (input == null) {
+            return null;
+        }
+        final VariantContext vc = input.head;
+        if (input.advance()) {
+            queue.add(input);
+        } else {
+            input.close();
+        }
+        return vc;
+    }
+
+    @Override
+    public void close() {
+        if (!closed) {
+            closed = true;
+            if (executor != null) {
+                executor.shutdownNow();
+            }
+            queue.clear();
+            inputs.forEach(MergeInput::close);
+            deleteAll(new ArrayList<>(temporaryFiles));
+        }
+    }
+
+    /** One input of the merge, with the batch of records currently being merged and the read-ahead batch, if any */
+    private final class MergeInput {
+        private final Path path;
+        private final int order;
+        private final VCFIterator iterator;
+        // true if the genotypes of records are decoded as they are read
+        private final boolean decodeGenotypes;
+        private Future<RecordBatch> nextBatch = null;
+        private List<VariantContext> batch = Collections.emptyList();
+        private int batchIndex = 0;
+        private RuntimeException batchError = null;
+        private boolean exhausted = false;
+        private VariantContext head = null;
+
+        MergeInput(final Path path, final int order) throws IOException {
+            this.path = path;
+            this.order = order;
+            this.iterator = new VCFIteratorBuilder().open(path);
+            this.decodeGenotypes = executor != null || !iterator.getHeader().getGenotypeSamples().equals(sampleNames);
+        }
+
+        /** Starts reading the next batch of records, if there are any, on the prefetch pool if there is one */
+        void requestBatch() {
+            if (!exhausted && nextBatch == null && executor != null) {
+                nextBatch = executor.submit(this::readBatch);
+            }
+        }
+
+        /** Moves head to the next record of this input, returning false if there are none */
+        boolean advance() {
+            final VariantContext previous = head;
+            while (batchIndex == batch.size()) {
+                if (batchError != null) {
+                    final RuntimeException e = batchError;
+                    batchError = null;
+                    throw e;
+                }
+                if (exhausted && nextBatch == null) {
+                    head = null;
+                    return false;
+                }
+                final RecordBatch next = nextBatch != null ? getResult(nextBatch) : readBatch();
+                nextBatch = null;
+                batch = next.records;
+                batchIndex = 0;
+                batchError = next.error;
+                exhausted = next.last;
+                requestBatch();
+            }
+            head = batch.get(batchIndex++);
+            if (previous != null && comparator.compare(previous, head) > 0) {
+                throw new IllegalStateException(String.format("Records in %s are out of order: %s:%d is after %s:%d",
+                        path, head.getContig(), head.getStart(), previous.getContig(), previous.getStart()));
+            }
+            return true;
+        }
+
+        private RecordBatch readBatch() {
+            final List<VariantContext> records = new ArrayList<>(recordsPerBatch);
+            try {
+                while (records.size() < recordsPerBatch && iterator.hasNext()) {
+                    final VariantContext vc = iterator.next();
+                    if (decodeGenotypes) {
+                        final GenotypesContext genotypes = vc.getGenotypes();
+                        if (genotypes.isLazyWithData()) {
+                            ((LazyGenotypesContext) genotypes).decode();
+                        }
+                    }
+                    records.add(vc);
+                }
+                return new RecordBatch(records, null, !iterator.hasNext());
+            } catch (final RuntimeException e) {
+                return new RecordBatch(records, e, true);
+            }
+        }
+
+        void close() {
+            if (nextBatch != null) {
+                nextBatch.cancel(false);
+                nextBatch = null;
+            }
+            exhausted = true;
+            CloserUtil.close(iterator);
+        }
+    }
+
+    private static RecordBatch getResult(final Future<RecordBatch> future) {
+        try {
+            return future.get();
+        } catch (final InterruptedException e) {
+            Thread.currentThread().interrupt();
+            throw new TribbleException("Interrupted while reading VCF records", e);
+        } catch (final ExecutionException e) {
+            if (e.getCause() instanceof Error) {
+                throw (Error) e.getCause();
+            }
+            throw new TribbleException("Error reading VCF records", e.getCause());
+        }
+    }
+
+    private static final class RecordBatch {
+        private final List<VariantContext> records;
+        private final RuntimeException error;
+        private final boolean last;
+
+        RecordBatch(final List<VariantContext> records, final RuntimeException error, final boolean last) {
+            this.records = records;
+            this.error = error;
+            this.last = last;
+        }
+    }
+}
@@ -0,0 +1,235 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.variant.vcf;
+
+import htsjdk.samtools.util.AbstractIterator;
+import htsjdk.samtools.util.CloserUtil;
+import htsjdk.tribble.TribbleException;
+import htsjdk.tribble.readers.LineIterator;
+import htsjdk.utils.ValidationUtils;
+import htsjdk.variant.variantcontext.GenotypesContext;
+import htsjdk.variant.variantcontext.LazyGenotypesContext;
+import htsjdk.variant.variantcontext.VariantContext;
+
+import java.io.Closeable;
+import java.nio.charset.StandardCharsets;
+import java.util.ArrayDeque;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.Deque;
+import java.util.Iterator;
+import java.util.List;
+import java.util.concurrent.ArrayBlockingQueue;
+import java.util.concurrent.BlockingQueue;
+import java.util.concurrent.ExecutionException;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+
+/**
+ * Iterates over the records of a VCF, decoding them on a pool of worker threads.
+ *
+ * Lines are read on the calling thread and handed to the workers in batches, which are returned in the order they were
+ * read.  Each worker decodes with its own copy of the codec that read the header (see
+ * {@link AbstractVCFCodec#copyForDecoding()}), reused for all of the batches it decodes, and genotypes that are not
+ * decoded by the workers are decoded lazily by one more copy.  A bounded number of batches is decoded ahead of the
+ * caller, so memory use does not depend on the size of the file.
+ *
+ * Not thread-safe: the iterator itself must be used from one thread, and the genotypes of the records it returns
+ * must only be accessed from one thread at a time.
+ */
+final class ParallelVCFDecodingIterator extends AbstractIterator<VariantContext> implements VCFIterator {
+    /** The default number of lines decoded by each task */
+    static final int DEFAULT_LINES_PER_BATCH = 1000;
+
+    private final LineIterator lineIterator;
+    private final Closeable source;
+    private final AbstractVCFCodec codec;
+    private final int linesPerBatch;
+    private final int maxBatchesInFlight;
+    private final boolean decodeGenotypes;
+    private final ExecutorService executor;
+    // one codec for each worker thread
+    private final BlockingQueue<AbstractVCFCodec> codecs;
+
+    private final Deque<Future<DecodedBatch>> pending = new ArrayDeque<>();
+    private Iterator<VariantContext> currentBatch = Collections.emptyIterator();
+    private RuntimeException currentBatchError = null;
+    private int lineNo;
+    private boolean closed = false;
+
+    /**
+     * @param lineIterator the lines of the VCF, positioned after the header
+     * @param source closed along with lineIterator when this iterator is closed.  May be null.
+     * @param codec the codec that read the header
+     * @param numThreads the number of worker threads
+     * @param linesPerBatch the number of lines decoded by each task
+     * @param decodeGenotypes if true the genotypes of each record are decoded on the worker threads; otherwise they
+     *                        are decoded lazily, on the thread that first accesses them
+     */
+    ParallelVCFDecodingIterator(final LineIterator lineIterator, final Closeable source, final AbstractVCFCodec codec,
+                                final int numThreads, final int linesPerBatch, final boolean decodeGenotypes) {
+        ValidationUtils.nonNull(lineIterator, "lineIterator");
+        ValidationUtils.nonNull(codec.getHeader(), "codec header");
+        ValidationUtils.validateArg(numThreads > 0, "numThreads must be positive");
+        ValidationUtils.validateArg(linesPerBatch > 0, "linesPerBatch must be positive");
+        this.lineIterator = lineIterator;
+        this.source = source;
+        this.codec = codec;
+        this.linesPerBatch = linesPerBatch;
+        this.maxBatchesInFlight = 2 * numThreads;
+        this.decodeGenotypes = decodeGenotypes;
+        this.lineNo = codec.lineNo;
+        this.executor = Executors.newFixedThreadPool(numThreads, r -> {
+            final Thread t = Executors.defaultThreadFactory().newThread(r);
+            t.setDaemon(true);
+            return t;
+        });
+        final AbstractVCFCodec genotypeCodec = decodeGenotypes ? null : codec.copyForDecoding();
+        this.codecs = new ArrayBlockingQueue<>(numThreads);
+        for (int i = 0; i < numThreads; i++) {
+            final AbstractVCFCodec workerCodec = codec.copyForDecoding();
+            if (genotypeCodec != null) {
+                workerCodec.setGenotypeCodec(genotypeCodec);
+            }
+            codecs.add(workerCodec);
+        }
+    }
+
+    @Override
+    public VCFHeader getHeader() {
+        return codec.getHeader();
+    }
+
+    @Override
+    protected VariantContext advance() {
+        if (closed) {
+            throw new IllegalStateException("iterator has been closed");
+        }
+        while (!currentBatch.hasNext()) {
+            // errors are raised after the records of the batch that were decoded before the failing line
+            if (currentBatchError != null) {
+                final RuntimeException e = currentBatchError;
+                currentBatchError = null;
+                throw e;
+            }
+            submitBatches();
+            if (pending.isEmpty()) {
+                return null;
+            }
+            final DecodedBatch batch = getResult(pending.removeFirst());
+            currentBatch = batch.records.iterator();
+            currentBatchError = batch.error;
+            submitBatches();
+        }
+        return currentBatch.next();
+    }
+
+    /** Reads lines and submits them for decoding until the maximum number of batches are in flight */
+    private void submitBatches() {
+        while (pending.size() < maxBatchesInFlight && lineIterator.hasNext()) {
+            final List<byte[]> lines = new ArrayList<>(linesPerBatch);
+            while (lines.size() < linesPerBatch && lineIterator.hasNext()) {
+                lines.add(nextLine());
+            }
+            final int firstLineNo = lineNo;
+            lineNo += lines.size();
+            pending.add(executor.submit(() -> decode(lines, firstLineNo)));
+        }
+    }
+
+    /** @return a copy of the bytes of the next line, which are read as bytes if the source can return them */
+    private byte[] nextLine() {
+        if (lineIterator instanceof VCFLineIterator) {
+            final VCFLineIterator lines = (VCFLineIterator) lineIterator;
+            final int length = lines.nextLineBytes();
+            return Arrays.copyOf(lines.getLineBuffer(), length);
+        }
+        return lineIterator.next().getBytes(StandardCharsets.UTF_8);
+    }
+
+    private DecodedBatch decode(final List<byte[]> lines, final int firstLineNo) throws InterruptedException {
+        // there is one codec for each thread, so this never waits
+        final AbstractVCFCodec batchCodec = codecs.take();
+        batchCodec.lineNo = firstLineNo;
+        final List<VariantContext> records = new ArrayList<>(lines.size());
+        try {
+            for (final byte[] line : lines) {
+                final VariantContext vc = batchCodec.decode(line, line.length);
+                if (vc == null) {
+                    continue;
+                }
+                if (decodeGenotypes) {
+                    final GenotypesContext genotypes = vc.getGenotypes();
+                    if (genotypes.isLazyWithData()) {
+                        ((LazyGenotypesContext) genotypes).decode();
+                    }
+                }
+                records.add(vc);
+            }
+            return new DecodedBatch(records, null);
+        } catch (final RuntimeException e) {
+            return new DecodedBatch(records, e);
+        } finally {
+            codecs.add(batchCodec);
+        }
+    }
+
+    private static DecodedBatch getResult(final Future<DecodedBatch> future) {
+        try {
+            return future.get();
+        } catch (final InterruptedException e) {
+            Thread.currentThread().interrupt();
+            throw new TribbleException("Interrupted while decoding VCF records", e);
+        } catch (final ExecutionException e) {
+            if (e.getCause() instanceof Error) {
+                throw (Error) e.getCause();
+            }
+            throw new TribbleException("Error decoding VCF records", e.getCause());
+        }
+    }
+
+    @Override
+    public void close() {
+        if (!closed) {
+            closed = true;
+            executor.shutdownNow();
+            pending.clear();
+            currentBatch = Collections.emptyIterator();
+            CloserUtil.close(lineIterator);
+            CloserUtil.close(source);
+        }
+    }
+
+    private static final class DecodedBatch {
+        private final List<VariantContext> records;
+        private final RuntimeException error;
+
+        DecodedBatch(final List<VariantContext> records, final RuntimeException error) {
+            this.records = records;
+            this.error = error;
+        }
+    }
+}
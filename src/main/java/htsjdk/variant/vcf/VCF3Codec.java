@@ -133,4 +133,9 @@ public class VCF3Codec extends AbstractVCFCodec {
     public boolean canDecode(final String potentialInput) {
         return canDecodeFile(potentialInput, VCF3_MAGIC_HEADER);
     }
+
+    @Override
+    protected AbstractVCFCodec newCodec() {
+        return getClass() == VCF3Codec.class ? new VCF3Codec() : super.newCodec();
+    }
 }
@@ -0,0 +1,122 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.variant.vcf;
+
+import java.nio.charset.StandardCharsets;
+
+/**
+ * Helpers for tokenizing VCF text held in a byte array, where each token is identified by a half-open range
+ * [start, end) of the array rather than by a String.
+ */
+final class VCFByteUtils {
+    private VCFByteUtils() {
+    }
+
+    /** @return the index of the first occurrence of {@code c} in [from, to), or -1 */
+    static int indexOf(final byte[] bytes, final int from, final int to, final char c) {
+        for (int i = from; i < to; i++) {
+            if (bytes[i] == c) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /** @return the number of occurrences of {@code c} in [from, to) */
+    static int count(final byte[] bytes, final int from, final int to, final char c) {
+        int n = 0;
+        for (int i = from; i < to; i++) {
+            if (bytes[i] == c) {
+                n++;
+            }
+        }
+        return n;
+    }
+
+    /** @return true if the bytes in [start, end) are exactly the ASCII string {@code s} */
+    static boolean equalsAscii(final byte[] bytes, final int start, final int end, final String s) {
+        if (end - start != s.length()) {
+            return false;
+        }
+        for (int i = 0; i < s.length(); i++) {
+            if (bytes[start + i] != s.charAt(i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /** @return true if the bytes in [start, end) are the same as {@code expected} */
+    static boolean equalsBytes(final byte[] expected, final byte[] bytes, final int start, final int end) {
+        if (end - start != expected.length) {
+            return false;
+        }
+        for (int i = 0; i < expected.length; i++) {
+            if (bytes[start + i] != expected[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /** @return the bytes in [start, end) decoded as UTF-8 */
+    static String toString(final byte[] bytes, final int start, final int end) {
+        return new String(bytes, start, end - start, StandardCharsets.UTF_8);
+    }
+
+    /**
+     * Parses the bytes in [start, end) as a decimal integer, accepting exactly what {@link Integer#parseInt(String)}
+     * accepts.
+     * @throws NumberFormatException if the bytes are not a valid integer
+     */
+    static int parseInt(final byte[] bytes, final int start, final int end) {
+        int i = start;
+        boolean negative = false;
+        if (i < end && (bytes[i] == '-' || bytes[i] == '+')) {
+            negative = bytes[i] == '-';
+            i++;
+        }
+        if (i == end) {
+            throw numberFormatException(bytes, start, end);
+        }
+        // accumulate negatively, as Integer.parseInt does, so that Integer.MIN_VALUE can be represented
+        final long limit = negative ? Integer.MIN_VALUE : -Integer.MAX_VALUE;
+        long result = 0;
+        for (; i < end; i++) {
+            final int digit = bytes[i] - '0';
+            if (digit < 0 || digit > 9) {
+                throw numberFormatException(bytes, start, end);
+            }
+            result = result * 10 - digit;
+            if (result < limit) {
+                throw numberFormatException(bytes, start, end);
+            }
+        }
+        return (int) (negative ? result : -result);
+    }
+
+    private static NumberFormatException numberFormatException(final byte[] bytes, final int start, final int end) {
+        return new NumberFormatException("For input string: \"" + toString(bytes, start, end) + "\"");
+    }
+}
@@ -159,4 +159,9 @@ public class VCFCodec extends AbstractVCFCodec {
     public boolean canDecode(final String potentialInput) {
         return canDecodeFile(potentialInput, VCF4_MAGIC_HEADER);
     }
+
+    @Override
+    protected AbstractVCFCodec newCodec() {
+        return getClass() == VCFCodec.class ? new VCFCodec() : super.newCodec();
+    }
 }
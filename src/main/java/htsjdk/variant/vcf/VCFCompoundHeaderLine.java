@@ -59,6 +59,7 @@ public abstract class VCFCompoundHeaderLine extends VCFHeaderLine implements VCF
     private VCFHeaderLineType type;
     private String source;
     private String version;
+    private String idx;
 
     // access methods
     @Override
@@ -81,6 +82,15 @@ public abstract class VCFCompoundHeaderLine extends VCFHeaderLine implements VCF
         return version;
     }
 
+    /**
+     * @return the value of the IDX attribute that BCF 2.2 headers use to fix the dictionary offset of this field,
+     * or null if there is none.  IDX is not written back out, as the offset only means something in the file
+     * that defined it
+     */
+    public String getIDX() {
+        return idx;
+    }
+
     /**
      * Get the number of values expected for this header field, given the properties of VariantContext vc
      *
@@ -252,6 +262,7 @@ public abstract class VCFCompoundHeaderLine extends VCFHeaderLine implements VCF
             this.source = mapping.get("Source");
             this.version = mapping.get("Version");
         }
+        this.idx = mapping.get(VCFConstants.BCF_IDX_ATTRIBUTE);
 
         validate();
     }
@@ -108,6 +108,9 @@ public final class VCFConstants {
     public static final String META_HEADER_START = VCFHeader.METADATA_INDICATOR + META_HEADER_KEY;
     public static final int META_HEADER_OFFSET = META_HEADER_START.length() + 1;
 
+    // the BCF 2.2 attribute of FILTER, INFO, FORMAT and contig lines giving the offset of their ID in the BCF dictionaries
+    public static final String BCF_IDX_ATTRIBUTE = "IDX";
+
     // old indel alleles
     public static final char DELETION_ALLELE_v3 = 'D';
     public static final char INSERTION_ALLELE_v3 = 'I';
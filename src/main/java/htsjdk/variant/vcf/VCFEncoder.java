@@ -1,7 +1,6 @@
 package htsjdk.variant.vcf;
 
 import htsjdk.samtools.util.RuntimeIOException;
-import htsjdk.tribble.util.ParsingUtils;
 import htsjdk.variant.variantcontext.Allele;
 import htsjdk.variant.variantcontext.Genotype;
 import htsjdk.variant.variantcontext.GenotypeBuilder;
@@ -15,14 +14,19 @@ import java.lang.reflect.Array;
 import java.nio.charset.Charset;
 import java.nio.charset.StandardCharsets;
 import java.util.ArrayList;
+import java.util.Collections;
 import java.util.HashMap;
 import java.util.List;
-import java.util.Locale;
 import java.util.Map;
-import java.util.TreeMap;
 
 /**
  * Functions specific to encoding VCF records.
+ *
+ * <p>
+ * <b>This class is not thread-safe.</b> {@link #encode(VariantContext)} and {@link #write(Appendable, VariantContext)}
+ * reuse scratch buffers held by the encoder between records, so an instance must not be shared between threads.
+ * Code that encodes records concurrently should create one encoder per thread, as the VCF writer does when it is built
+ * with {@link htsjdk.variant.variantcontext.writer.VariantContextWriterBuilder#setEncodingThreads(int)}.
  */
 public class VCFEncoder {
 
@@ -30,7 +34,7 @@ public class VCFEncoder {
      * The encoding used for VCF files: ISO-8859-1. When writing VCF4.3 is implemented, this should change to UTF-8.
      */
     public static final Charset VCF_CHARSET = StandardCharsets.ISO_8859_1;
-    private static final String QUAL_FORMAT_STRING = "%.2f";
+    private static final int QUAL_DECIMALS = 2;
     private static final String QUAL_FORMAT_EXTENSION_TO_TRIM = ".00";
 
     private final IntGenotypeFieldAccessors GENOTYPE_FIELD_ACCESSORS = new IntGenotypeFieldAccessors();
@@ -41,6 +45,14 @@ public class VCFEncoder {
 
     private boolean outputTrailingFormatFields = false;
 
+    // scratch space reused across records, so that encoding does not allocate intermediate Strings;
+    // this state is what makes an encoder unsafe to share between threads (see the class javadoc)
+    private final StringBuilder scratch = new StringBuilder();
+    private final List<String> sortedKeys = new ArrayList<>();
+    private final List<StringBuilder> genotypeFieldValues = new ArrayList<>();
+    private boolean[] genotypeFieldPresent = new boolean[0];
+    private IntGenotypeFieldAccessors.Accessor[] genotypeFieldAccessors = new IntGenotypeFieldAccessors.Accessor[0];
+
     /**
      * Prepare a VCFEncoder that will encode records appropriate to the given VCF header, optionally
      * allowing missing fields in the header.
@@ -88,6 +100,18 @@ public class VCFEncoder {
         }
     }
 
+    /**
+     * @return true if the genotypes of the variant have not been decoded since they were read from a VCF, in which
+     * case they are written as they were read, without being decoded
+     */
+    public static boolean writesUnparsedGenotypes(final VariantContext context) {
+        final GenotypesContext gc = context.getGenotypes();
+        if (!gc.isLazyWithData()) {
+            return false;
+        }
+        final Object unparsedGenotypes = ((LazyGenotypesContext) gc).getUnparsedGenotypeData();
+        return unparsedGenotypes instanceof String || unparsedGenotypes instanceof AbstractVCFCodec.UnparsedGenotypes;
+    }
 
     /**
      * encodes a {@link VariantContext} context as VCF, and writes it directly to an {@link Appendable}
@@ -105,9 +129,10 @@ public class VCFEncoder {
             throw new NullPointerException("The header field must be set on the VCFEncoder before encoding records.");
         }
         // CHROM
-        vcfOutput.append(context.getContig()).append(VCFConstants.FIELD_SEPARATOR)
-                // POS
-                .append(String.valueOf(context.getStart())).append(VCFConstants.FIELD_SEPARATOR)
+        vcfOutput.append(context.getContig()).append(VCFConstants.FIELD_SEPARATOR);
+        // POS
+        VCFNumberFormatter.appendInt(vcfOutput, context.getStart());
+        vcfOutput.append(VCFConstants.FIELD_SEPARATOR)
                 // ID
                 .append(context.getID()).append(VCFConstants.FIELD_SEPARATOR)
                 // REF
@@ -135,29 +160,19 @@ public class VCFEncoder {
         if ( !context.hasLog10PError()) {
             vcfOutput.append(VCFConstants.MISSING_VALUE_v4);
         } else {
-            vcfOutput.append(formatQualValue(context.getPhredScaledQual()));
+            appendQualValue(vcfOutput, context.getPhredScaledQual());
         }
-        vcfOutput.append(VCFConstants.FIELD_SEPARATOR)
-                // FILTER
-                .append(getFilterString(context)).append(VCFConstants.FIELD_SEPARATOR);
+        vcfOutput.append(VCFConstants.FIELD_SEPARATOR);
+        // FILTER
+        writeFilterString(context, vcfOutput);
+        vcfOutput.append(VCFConstants.FIELD_SEPARATOR);
 
         // INFO
-        final Map<String, String> infoFields = new TreeMap<>();
-        for (final Map.Entry<String, Object> field : context.getAttributes().entrySet()) {
-            if (!this.header.hasInfoLine(field.getKey())) {
-                fieldIsMissingFromHeaderError(context, field.getKey(), "INFO");
-            }
-
-            final String outputValue = formatVCFField(field.getValue());
-            if (outputValue != null) {
-                infoFields.put(field.getKey(), outputValue);
-            }
-        }
-        writeInfoString(infoFields, vcfOutput);
+        writeInfoString(context, vcfOutput);
 
         // FORMAT
         final GenotypesContext gc = context.getGenotypes();
-        if (gc.isLazyWithData() && ((LazyGenotypesContext) gc).getUnparsedGenotypeData() instanceof String) {
+        if (writesUnparsedGenotypes(context)) {
             vcfOutput.append(VCFConstants.FIELD_SEPARATOR);
             vcfOutput.append(((LazyGenotypesContext) gc).getUnparsedGenotypeData().toString());
         } else {
@@ -168,10 +183,13 @@ public class VCFEncoder {
                         fieldIsMissingFromHeaderError(context, format, "FORMAT");
                     }
                 }
-                final String genotypeFormatString = ParsingUtils.join(VCFConstants.GENOTYPE_FIELD_SEPARATOR, genotypeAttributeKeys);
-
                 vcfOutput.append(VCFConstants.FIELD_SEPARATOR);
-                vcfOutput.append(genotypeFormatString);
+                for (int i = 0; i < genotypeAttributeKeys.size(); i++) {
+                    if (i > 0) {
+                        vcfOutput.append(VCFConstants.GENOTYPE_FIELD_SEPARATOR);
+                    }
+                    vcfOutput.append(genotypeAttributeKeys.get(i));
+                }
 
                 final Map<Allele, String> alleleStrings = buildAlleleStrings(context);
                 appendGenotypeData(context, alleleStrings, genotypeAttributeKeys, vcfOutput);
@@ -187,26 +205,40 @@ public class VCFEncoder {
         return this.allowMissingFieldsInHeader;
     }
 
-    private String getFilterString(final VariantContext vc) {
+    private void writeFilterString(final VariantContext vc, final Appendable vcfOutput) throws IOException {
         if (vc.isFiltered()) {
+            sortedKeys.clear();
             for (final String filter : vc.getFilters()) {
                 if (!this.header.hasFilterLine(filter)) {
                     fieldIsMissingFromHeaderError(vc, filter, "FILTER");
                 }
+                sortedKeys.add(filter);
+            }
+            Collections.sort(sortedKeys);
+            for (int i = 0; i < sortedKeys.size(); i++) {
+                if (i > 0) {
+                    vcfOutput.append(VCFConstants.FILTER_CODE_SEPARATOR);
+                }
+                vcfOutput.append(sortedKeys.get(i));
             }
-
-            return ParsingUtils.join(";", ParsingUtils.sortList(vc.getFilters()));
         } else {
-            return vc.filtersWereApplied() ? VCFConstants.PASSES_FILTERS_v4 : VCFConstants.UNFILTERED;
+            vcfOutput.append(vc.filtersWereApplied() ? VCFConstants.PASSES_FILTERS_v4 : VCFConstants.UNFILTERED);
         }
     }
 
-    private static String formatQualValue(final double qual) {
-        String s = String.format(Locale.US, QUAL_FORMAT_STRING, qual);
-        if (s.endsWith(QUAL_FORMAT_EXTENSION_TO_TRIM)) {
-            s = s.substring(0, s.length() - QUAL_FORMAT_EXTENSION_TO_TRIM.length());
+    /**
+     * Appends a QUAL value with two decimal places, dropping them if they are both zero
+     */
+    private void appendQualValue(final Appendable vcfOutput, final double qual) throws IOException {
+        scratch.setLength(0);
+        VCFNumberFormatter.appendFixed(scratch, qual, QUAL_DECIMALS);
+        final int length = scratch.length();
+        final int trimmedLength = length - QUAL_FORMAT_EXTENSION_TO_TRIM.length();
+        if (trimmedLength >= 0 && scratch.indexOf(QUAL_FORMAT_EXTENSION_TO_TRIM, trimmedLength) == trimmedLength) {
+            vcfOutput.append(scratch, 0, trimmedLength);
+        } else {
+            vcfOutput.append(scratch);
         }
-        return s;
     }
 
     private void fieldIsMissingFromHeaderError(final VariantContext vc, final String id, final String field) {
@@ -218,34 +250,84 @@ public class VCFEncoder {
         }
     }
 
-    @SuppressWarnings("rawtypes")
     String formatVCFField(final Object val) {
-        final String result;
+        final StringBuilder sb = new StringBuilder();
+        try {
+            return appendVCFField(sb, val) ? sb.toString() : null;
+        } catch (final IOException error) {
+            throw new RuntimeIOException("Cannot format VCF field", error);
+        }
+    }
+
+    /**
+     * Appends the VCF representation of an attribute value, without creating intermediate Strings for numbers,
+     * arrays or lists
+     *
+     * @return false if nothing should be written for the value, which is the case for a Boolean false
+     */
+    @SuppressWarnings("rawtypes")
+    static boolean appendVCFField(final Appendable out, final Object val) throws IOException {
         if (val == null) {
-            result = VCFConstants.MISSING_VALUE_v4;
+            out.append(VCFConstants.MISSING_VALUE_v4);
+        } else if (val instanceof String) {
+            out.append((String) val);
+        } else if (val instanceof Integer) {
+            VCFNumberFormatter.appendInt(out, (Integer) val);
         } else if (val instanceof Double) {
-            result = formatVCFDouble((Double) val);
+            appendVCFDouble(out, (Double) val);
         } else if (val instanceof Boolean) {
-            result = (Boolean) val ? "" : null; // empty string for true, null for false
+            return (Boolean) val; // nothing is written for true, and the field is omitted for false
         } else if (val instanceof List) {
-            result = formatVCFField(((List) val).toArray());
+            final List list = (List) val;
+            if (list.isEmpty()) {
+                out.append(VCFConstants.MISSING_VALUE_v4);
+            } else {
+                boolean first = true;
+                for (final Object element : list) {
+                    if (!first) {
+                        out.append(',');
+                    }
+                    first = false;
+                    appendVCFField(out, element);
+                }
+            }
+        } else if (val instanceof int[]) {
+            final int[] values = (int[]) val;
+            if (values.length == 0) {
+                out.append(VCFConstants.MISSING_VALUE_v4);
+            }
+            for (int i = 0; i < values.length; i++) {
+                if (i > 0) {
+                    out.append(',');
+                }
+                VCFNumberFormatter.appendInt(out, values[i]);
+            }
+        } else if (val instanceof double[]) {
+            final double[] values = (double[]) val;
+            if (values.length == 0) {
+                out.append(VCFConstants.MISSING_VALUE_v4);
+            }
+            for (int i = 0; i < values.length; i++) {
+                if (i > 0) {
+                    out.append(',');
+                }
+                appendVCFDouble(out, values[i]);
+            }
         } else if (val.getClass().isArray()) {
             final int length = Array.getLength(val);
             if (length == 0) {
-                return formatVCFField(null);
+                out.append(VCFConstants.MISSING_VALUE_v4);
             }
-            final StringBuilder sb = new StringBuilder(
-                formatVCFField(Array.get(val, 0)));
-            for (int i = 1; i < length; i++) {
-                sb.append(',');
-                sb.append(formatVCFField(Array.get(val, i)));
+            for (int i = 0; i < length; i++) {
+                if (i > 0) {
+                    out.append(',');
+                }
+                appendVCFField(out, Array.get(val, i));
             }
-            result = sb.toString();
         } else {
-            result = val.toString();
+            out.append(val.toString());
         }
-
-        return result;
+        return true;
     }
 
     /**
@@ -259,26 +341,36 @@ public class VCFEncoder {
      * @return
      */
     public static String formatVCFDouble(final double d) {
-        final String format;
+        final StringBuilder sb = new StringBuilder(12);
+        try {
+            appendVCFDouble(sb, d);
+        } catch (final IOException error) {
+            throw new RuntimeIOException("Cannot format double", error);
+        }
+        return sb.toString();
+    }
+
+    /**
+     * Appends a double formatted as by {@link #formatVCFDouble(double)}
+     */
+    static void appendVCFDouble(final Appendable out, final double d) throws IOException {
         if (d < 1) {
             if (d < 0.01) {
                 if (Math.abs(d) >= 1e-20) {
-                    format = "%.3e";
+                    VCFNumberFormatter.appendScientific(out, d, 3);
                 } else {
-                    // return a zero format
-                    return "0.00";
+                    // write a zero
+                    out.append("0.00");
                 }
             } else {
-                format = "%.3f";
+                VCFNumberFormatter.appendFixed(out, d, 3);
             }
         } else {
-            format = "%.2f";
+            VCFNumberFormatter.appendFixed(out, d, 2);
         }
-
-        return String.format(Locale.US, format, d);
     }
 
-    static int countOccurrences(final char c, final String s) {
+    static int countOccurrences(final char c, final CharSequence s) {
         int count = 0;
         for (int i = 0; i < s.length(); i++) {
             count += s.charAt(i) == c ? 1 : 0;
@@ -286,7 +378,7 @@ public class VCFEncoder {
         return count;
     }
 
-    static boolean isMissingValue(final String s) {
+    static boolean isMissingValue(final CharSequence s) {
         // we need to deal with the case that it's a list of missing values
         return (countOccurrences(VCFConstants.MISSING_VALUE_v4.charAt(0), s) + countOccurrences(',', s) == s.length());
     }
@@ -310,7 +402,22 @@ public class VCFEncoder {
      * @param vcfoutput VCF output
      * @throws IOException
      */
-    private void appendGenotypeData(final VariantContext vc, final Map<Allele, String> alleleMap, final List<String> genotypeFormatKeys, final Appendable vcfoutput) throws IOException {final int ploidy = vc.getMaxPloidy(2);
+    private void appendGenotypeData(final VariantContext vc, final Map<Allele, String> alleleMap, final List<String> genotypeFormatKeys, final Appendable vcfoutput) throws IOException {
+        final int ploidy = vc.getMaxPloidy(2);
+        final int nFields = genotypeFormatKeys.size();
+        final boolean hasGenotypeKey = genotypeFormatKeys.contains(VCFConstants.GENOTYPE_KEY);
+
+        // resolve how each field is encoded once per record rather than once per sample
+        if (genotypeFieldAccessors.length < nFields) {
+            genotypeFieldAccessors = new IntGenotypeFieldAccessors.Accessor[nFields];
+            genotypeFieldPresent = new boolean[nFields];
+        }
+        while (genotypeFieldValues.size() < nFields) {
+            genotypeFieldValues.add(new StringBuilder());
+        }
+        for (int f = 0; f < nFields; f++) {
+            genotypeFieldAccessors[f] = GENOTYPE_FIELD_ACCESSORS.getAccessor(genotypeFormatKeys.get(f));
+        }
 
         for (final String sample : this.header.getGenotypeSamples()) {
             vcfoutput.append(VCFConstants.FIELD_SEPARATOR);
@@ -320,8 +427,11 @@ public class VCFEncoder {
                 g = GenotypeBuilder.createMissing(sample, ploidy);
             }
 
-            final List<String> attrs = new ArrayList<>(genotypeFormatKeys.size());
-            for (final String field : genotypeFormatKeys) {
+            // GT is written immediately, the other fields are formatted first so that trailing missing values can be dropped
+            int lastField = -1;
+            for (int f = 0; f < nFields; f++) {
+                final String field = genotypeFormatKeys.get(f);
+                genotypeFieldPresent[f] = false;
                 if (field.equals(VCFConstants.GENOTYPE_KEY)) {
                     if (!g.isAvailable()) {
                         throw new IllegalStateException("GTs cannot be missing for some samples if they are available for others in the record");
@@ -333,87 +443,81 @@ public class VCFEncoder {
                         writeAllele(g.getAllele(i), alleleMap, vcfoutput);
                     }
                     continue;
-
-                } else {
-                    final String outputValue;
-                    if (field.equals(VCFConstants.GENOTYPE_FILTER_KEY)) {
-                        outputValue = g.isFiltered() ? g.getFilters() : VCFConstants.PASSES_FILTERS_v4;
-                    } else {
-                        final IntGenotypeFieldAccessors.Accessor accessor = GENOTYPE_FIELD_ACCESSORS.getAccessor(field);
-                        if (accessor != null) {
-                            final int[] intValues = accessor.getValues(g);
-                            if (intValues == null) {
-                                outputValue = VCFConstants.MISSING_VALUE_v4;
-                            } else if (intValues.length == 1) { // fast path
-                                outputValue = Integer.toString(intValues[0]);
-                            } else {
-                                final StringBuilder sb = new StringBuilder();
-                                sb.append(intValues[0]);
-                                for (int i = 1; i < intValues.length; i++) {
-                                    sb.append(',');
-                                    sb.append(intValues[i]);
-                                }
-                                outputValue = sb.toString();
-                            }
-                        } else {
-                            Object val = g.hasExtendedAttribute(field) ? g.getExtendedAttribute(field) : VCFConstants.MISSING_VALUE_v4;
-                            outputValue = formatVCFField(val);
-                        }
-                    }
-
-                    if (outputValue != null) {
-                        attrs.add(outputValue);
-                    }
                 }
-            }
 
-            // strip off trailing missing values
-            if (!outputTrailingFormatFields) {
-                for (int i = attrs.size() - 1; i >= 0; i--) {
-                    if (isMissingValue(attrs.get(i))) {
-                        attrs.remove(i);
+                final StringBuilder value = genotypeFieldValues.get(f);
+                value.setLength(0);
+                if (field.equals(VCFConstants.GENOTYPE_FILTER_KEY)) {
+                    value.append(g.isFiltered() ? g.getFilters() : VCFConstants.PASSES_FILTERS_v4);
+                } else if (genotypeFieldAccessors[f] != null) {
+                    final int[] intValues = genotypeFieldAccessors[f].getValues(g);
+                    if (intValues == null) {
+                        value.append(VCFConstants.MISSING_VALUE_v4);
                     } else {
-                        break;
+                        appendVCFField(value, intValues);
                     }
+                } else if (!appendVCFField(value, g.hasExtendedAttribute(field) ? g.getExtendedAttribute(field) : VCFConstants.MISSING_VALUE_v4)) {
+                    continue;
+                }
+                genotypeFieldPresent[f] = true;
+                if (outputTrailingFormatFields || !isMissingValue(value)) {
+                    lastField = f;
                 }
             }
 
-            for (int i = 0; i < attrs.size(); i++) {
-                if ( i > 0 || genotypeFormatKeys.contains(VCFConstants.GENOTYPE_KEY)) {
-                    vcfoutput.append(VCFConstants.GENOTYPE_FIELD_SEPARATOR);
+            boolean first = !hasGenotypeKey;
+            for (int f = 0; f <= lastField; f++) {
+                if (genotypeFieldPresent[f]) {
+                    if (!first) {
+                        vcfoutput.append(VCFConstants.GENOTYPE_FIELD_SEPARATOR);
+                    }
+                    first = false;
+                    vcfoutput.append(genotypeFieldValues.get(f));
                 }
-                vcfoutput.append(attrs.get(i));
             }
         }
     }
 
     /*
-     * Create the info string; assumes that no values are null
+     * Write the info string, with the keys in sorted order
      */
-    private void writeInfoString(final Map<String, String> infoFields, final Appendable vcfoutput) throws IOException {
-        if ( infoFields.isEmpty() ) {
-            vcfoutput.append(VCFConstants.EMPTY_INFO_FIELD);
-            return;
+    private void writeInfoString(final VariantContext vc, final Appendable vcfoutput) throws IOException {
+        final Map<String, Object> attributes = vc.getAttributes();
+        sortedKeys.clear();
+        for (final String key : attributes.keySet()) {
+            if (!this.header.hasInfoLine(key)) {
+                fieldIsMissingFromHeaderError(vc, key, "INFO");
+            }
+            sortedKeys.add(key);
         }
+        Collections.sort(sortedKeys);
 
         boolean isFirst = true;
-        for (final Map.Entry<String, String> entry : infoFields.entrySet()) {
+        for (final String key : sortedKeys) {
+            scratch.setLength(0);
+            if (!appendVCFField(scratch, attributes.get(key))) {
+                continue;
+            }
             if (isFirst) {
                 isFirst = false;
             } else {
                 vcfoutput.append(VCFConstants.INFO_FIELD_SEPARATOR);
             }
 
-            vcfoutput.append(entry.getKey());
+            vcfoutput.append(key);
 
-            if ( ! entry.getValue().isEmpty()) {
-                final VCFInfoHeaderLine metaData = this.header.getInfoHeaderLine(entry.getKey());
+            if (scratch.length() > 0) {
+                final VCFInfoHeaderLine metaData = this.header.getInfoHeaderLine(key);
                 if ( metaData == null || metaData.getCountType() != VCFHeaderLineCount.INTEGER || metaData.getCount() != 0 ) {
                     vcfoutput.append('=');
-                    vcfoutput.append(entry.getValue());
+                    vcfoutput.append(scratch);
                 }
             }
         }
+
+        if (isFirst) {
+            vcfoutput.append(VCFConstants.EMPTY_INFO_FIELD);
+        }
     }
 
     public Map<Allele, String> buildAlleleStrings(final VariantContext vc) {
@@ -25,6 +25,7 @@
 package htsjdk.variant.vcf;
 
 import htsjdk.samtools.SAMSequenceDictionary;
+import htsjdk.samtools.seekablestream.SeekablePathStream;
 import htsjdk.samtools.util.CloseableIterator;
 import htsjdk.samtools.util.FileExtensions;
 import htsjdk.samtools.util.Interval;
@@ -39,6 +40,7 @@ import htsjdk.variant.variantcontext.VariantContext;
 import java.io.File;
 import java.io.IOException;
 import java.nio.file.Path;
+import java.util.Collection;
 import java.util.Iterator;
 import java.util.concurrent.atomic.AtomicInteger;
 
@@ -48,6 +50,10 @@ import java.util.concurrent.atomic.AtomicInteger;
 public class VCFFileReader implements VCFReader {
 
     private final FeatureReader<VariantContext> reader;
+    private final FeatureCodec<VariantContext, ?> codec;
+    private final Path path;
+    private int decodingThreads = 1;
+    private boolean decodeGenotypes = false;
 
     /**
      * Returns true if the given file appears to be a BCF file.
@@ -142,9 +148,11 @@ public class VCFFileReader implements VCFReader {
      * Allows construction of a VCFFileReader that will or will not assert the presence of an index as desired.
      */
     public VCFFileReader(final Path path, final boolean requireIndex) {
+        this.path = path;
+        this.codec = getCodecForPath(path);
         this.reader = AbstractFeatureReader.getFeatureReader(
                 path.toUri().toString(),
-                getCodecForPath(path),
+                codec,
                 requireIndex);
     }
 
@@ -152,10 +160,12 @@ public class VCFFileReader implements VCFReader {
      * Allows construction of a VCFFileReader with a specified index path.
      */
     public VCFFileReader(final Path path, final Path indexPath, final boolean requireIndex) {
+        this.path = path;
+        this.codec = getCodecForPath(path);
         this.reader = AbstractFeatureReader.getFeatureReader(
                 path.toUri().toString(),
                 indexPath.toUri().toString(),
-                getCodecForPath(path),
+                codec,
                 requireIndex);
     }
 
@@ -320,12 +330,78 @@ public class VCFFileReader implements VCFReader {
         return getHeader();
     }
 
+    /**
+     * Sets the number of threads used to decode records returned by {@link #iterator()}.  With more than one thread,
+     * records are decoded in batches on a pool of worker threads, and returned in their order in the file.  Queries,
+     * all iteration over BCF files, and iteration with a codec that cannot be copied (see
+     * {@link AbstractVCFCodec#canCopyForDecoding()}) decode records on the calling thread.
+     *
+     * @param decodingThreads the number of decoding threads; 1, the default, decodes records on the calling thread
+     */
+    public void setDecodingThreads(final int decodingThreads) {
+        if (decodingThreads < 1) {
+            throw new IllegalArgumentException("decodingThreads must be at least 1");
+        }
+        this.decodingThreads = decodingThreads;
+    }
+
+    /**
+     * Sets whether the genotypes of each record are decoded by the decoding threads, rather than lazily on the thread
+     * that first accesses them.  Has no effect unless more than one decoding thread is used.
+     *
+     * @param decodeGenotypes true to decode genotypes on the decoding threads
+     */
+    public void setDecodeGenotypes(final boolean decodeGenotypes) {
+        this.decodeGenotypes = decodeGenotypes;
+    }
+
+    /**
+     * Sets whether only the site data of records is read, for consumers that do not need genotypes.  Records returned
+     * by iterators and queries created afterwards have no genotypes, and the genotype columns of a VCF (or genotype
+     * blocks of a BCF) are skipped without being decoded, which makes reading files with many samples much cheaper.
+     * The header still lists the samples of the file.
+     *
+     * @param sitesOnly true to read only the site data of records
+     */
+    public void setSitesOnly(final boolean sitesOnly) {
+        if (codec instanceof AbstractVCFCodec) {
+            ((AbstractVCFCodec) codec).setSitesOnly(sitesOnly);
+        } else {
+            ((BCF2Codec) codec).setSitesOnly(sitesOnly);
+        }
+    }
+
+    /**
+     * Sets the samples whose genotypes are decoded.  Records returned by iterators and queries created afterwards
+     * have genotypes for just these samples, and the genotypes of the other samples are skipped without being
+     * decoded.  The header still lists all samples of the file.
+     *
+     * @param samples the samples whose genotypes to decode, or null to decode those of all samples
+     * @throws IllegalArgumentException if a sample is not in the header
+     */
+    public void setSamplesToDecode(final Collection<String> samples) {
+        if (codec instanceof AbstractVCFCodec) {
+            ((AbstractVCFCodec) codec).setSamplesToDecode(samples);
+        } else {
+            ((BCF2Codec) codec).setSamplesToDecode(samples);
+        }
+    }
+
     /**
      * Returns an iterator over all records in this VCF/BCF file.
+     *
+     * If more than one decoding thread has been set, the iterator opens the file again, decodes its records with
+     * copies of this reader's codec, so with the same header and settings, and must be closed to stop its threads.
      */
     @Override
     public CloseableIterator<VariantContext> iterator() {
         try {
+            if (decodingThreads > 1 && codec instanceof AbstractVCFCodec && ((AbstractVCFCodec) codec).canCopyForDecoding()) {
+                return new VCFIteratorBuilder()
+                        .setDecodingThreads(decodingThreads)
+                        .setDecodeGenotypes(decodeGenotypes)
+                        .openParallel(new SeekablePathStream(path), (AbstractVCFCodec) codec);
+            }
             return reader.iterator();
         } catch (final IOException ioe) {
             throw new TribbleException("Could not create an iterator from a feature reader.", ioe);
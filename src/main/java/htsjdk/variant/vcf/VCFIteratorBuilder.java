@@ -29,6 +29,8 @@ import java.io.IOException;
 import java.io.InputStream;
 import java.nio.channels.SeekableByteChannel;
 import java.nio.file.Path;
+import java.util.ArrayList;
+import java.util.Collection;
 import java.util.function.Function;
 import java.util.zip.GZIPInputStream;
 
@@ -62,6 +64,62 @@ import htsjdk.variant.variantcontext.VariantContext;
  */
 
 public class VCFIteratorBuilder {
+    private int decodingThreads = 1;
+    private boolean decodeGenotypes = false;
+    private boolean sitesOnly = false;
+    private Collection<String> samplesToDecode = null;
+
+    /**
+     * Sets the number of threads used to decode VCF records.  With more than one thread, records are decoded in
+     * batches on a pool of worker threads, and returned in their order in the file.  BCF is always decoded on the
+     * calling thread.
+     *
+     * @param decodingThreads the number of decoding threads; 1, the default, decodes records on the calling thread
+     * @return this builder
+     */
+    public VCFIteratorBuilder setDecodingThreads(final int decodingThreads) {
+        if (decodingThreads < 1) {
+            throw new IllegalArgumentException("decodingThreads must be at least 1");
+        }
+        this.decodingThreads = decodingThreads;
+        return this;
+    }
+
+    /**
+     * Sets whether the genotypes of each record are decoded by the decoding threads.  By default they are decoded
+     * lazily, on the thread that first accesses them.  Has no effect unless more than one decoding thread is used.
+     *
+     * @param decodeGenotypes true to decode genotypes on the decoding threads
+     * @return this builder
+     */
+    public VCFIteratorBuilder setDecodeGenotypes(final boolean decodeGenotypes) {
+        this.decodeGenotypes = decodeGenotypes;
+        return this;
+    }
+
+    /**
+     * Sets whether only the site data of records is read.  Records have no genotypes, and the genotype columns of a
+     * VCF (or genotype blocks of a BCF) are skipped without being decoded.  The header still lists the samples.
+     *
+     * @param sitesOnly true to read only the site data of records
+     * @return this builder
+     */
+    public VCFIteratorBuilder setSitesOnly(final boolean sitesOnly) {
+        this.sitesOnly = sitesOnly;
+        return this;
+    }
+
+    /**
+     * Sets the samples whose genotypes are decoded.  Records have genotypes for just these samples, and the genotypes
+     * of the other samples are skipped without being decoded.  The header still lists all samples.
+     *
+     * @param samples the samples whose genotypes to decode, or null to decode those of all samples
+     * @return this builder
+     */
+    public VCFIteratorBuilder setSamplesToDecode(final Collection<String> samples) {
+        this.samplesToDecode = samples == null ? null : new ArrayList<>(samples);
+        return this;
+    }
 
     /**
      * creates a VCF iterator from an input stream It detects if the stream is a
@@ -71,31 +129,82 @@ public class VCFIteratorBuilder {
      * @return the VCFIterator
      * @throws IOException
      */
-    @SuppressWarnings("static-method")
     public VCFIterator open(final InputStream in) throws IOException {
         if (in == null) {
             throw new IllegalArgumentException("input stream is null");
             }
-        // wrap the input stream into a BufferedInputStream to reset/read a BCFHeader or a GZIP
-        // buffer must be large enough to contain the BCF header and/or GZIP signature
-        BufferedInputStream  bufferedinput = new BufferedInputStream(in, Math.max(BCF2Codec.SIZEOF_BCF_HEADER, IOUtil.GZIP_HEADER_READ_LENGTH));
-        // test for gzipped inputstream
-        if(IOUtil.isGZIPInputStream(bufferedinput)) {
-            // this is a gzipped input stream, wrap it into GZIPInputStream
-            // and re-wrap it into BufferedInputStream so we can test for the BCF header
-            bufferedinput = new BufferedInputStream(new GZIPInputStream(bufferedinput), BCF2Codec.SIZEOF_BCF_HEADER);
-        }
+        final BufferedInputStream bufferedinput = bufferAndDecompressIfNecessary(in);
 
         // try to read a BCF header
         final BCFVersion bcfVersion = BCF2Codec.tryReadBCFVersion(bufferedinput);
 
         if (bcfVersion != null) {
             //this is BCF
-            return new BCFInputStreamIterator(bufferedinput);
+            return new BCFInputStreamIterator(bufferedinput, sitesOnly, samplesToDecode);
+        } else if (decodingThreads > 1) {
+            //this is VCF, decoded in parallel
+            final VCFCodec codec = new VCFCodec();
+            codec.setSitesOnly(sitesOnly);
+            codec.setSamplesToDecode(samplesToDecode);
+            final LineIterator lineIterator = codec.makeSourceFromStream(bufferedinput);
+            codec.readActualHeader(lineIterator);
+            return new ParallelVCFDecodingIterator(lineIterator, bufferedinput, codec, decodingThreads,
+                    ParallelVCFDecodingIterator.DEFAULT_LINES_PER_BATCH, decodeGenotypes);
         } else {
             //this is VCF
-            return new VCFReaderIterator(bufferedinput);
+            return new VCFReaderIterator(bufferedinput, sitesOnly, samplesToDecode);
+        }
+    }
+
+    /**
+     * creates a VCF iterator that decodes the records of a VCF stream on the number of threads set by
+     * {@link #setDecodingThreads(int)}, with copies of a codec that has already read the header of the VCF, such as
+     * that of a {@link VCFFileReader}.  Records are decoded with the header and all of the settings of that codec,
+     * rather than the sites-only and sample settings of this builder.  The header lines of the stream are skipped.
+     *
+     * @param in the VCF, which may be gzipped
+     * @param codec the codec that read the header of the VCF
+     * @return the VCFIterator
+     * @throws IOException
+     */
+    VCFIterator openParallel(final InputStream in, final AbstractVCFCodec codec) throws IOException {
+        final BufferedInputStream bufferedinput = bufferAndDecompressIfNecessary(in);
+        final AbstractVCFCodec copy = codec.copyForDecoding();
+        final LineIterator lineIterator = copy.makeSourceFromStream(bufferedinput);
+        copy.lineNo = 0;
+        while (lineIterator.hasNext() && lineIterator.peek().startsWith(VCFHeader.HEADER_INDICATOR)) {
+            lineIterator.next();
+            copy.lineNo++;
+        }
+        return new ParallelVCFDecodingIterator(lineIterator, bufferedinput, copy, decodingThreads,
+                ParallelVCFDecodingIterator.DEFAULT_LINES_PER_BATCH, decodeGenotypes);
+    }
+
+    /**
+     * @param path the file path
+     * @return true if the file is BCF, which may be gzipped, rather than VCF
+     * @throws IOException
+     */
+    static boolean isBCF(final Path path) throws IOException {
+        try (final BufferedInputStream bufferedinput = bufferAndDecompressIfNecessary(new SeekablePathStream(path))) {
+            return BCF2Codec.tryReadBCFVersion(bufferedinput) != null;
+        }
+    }
+
+    /**
+     * wraps the input stream into a BufferedInputStream to reset/read a BCFHeader or a GZIP, and decompresses it if
+     * it is gzipped
+     */
+    private static BufferedInputStream bufferAndDecompressIfNecessary(final InputStream in) throws IOException {
+        // buffer must be large enough to contain the BCF header and/or GZIP signature
+        final BufferedInputStream bufferedinput = new BufferedInputStream(in, Math.max(BCF2Codec.SIZEOF_BCF_HEADER, IOUtil.GZIP_HEADER_READ_LENGTH));
+        // test for gzipped inputstream
+        if(IOUtil.isGZIPInputStream(bufferedinput)) {
+            // this is a gzipped input stream, wrap it into GZIPInputStream
+            // and re-wrap it into BufferedInputStream so we can test for the BCF header
+            return new BufferedInputStream(new GZIPInputStream(bufferedinput), BCF2Codec.SIZEOF_BCF_HEADER);
         }
+        return bufferedinput;
     }
 
     /**
@@ -153,7 +262,6 @@ public class VCFIteratorBuilder {
      * @return the VCFIterator
      * @throws IOException
      */
-    @SuppressWarnings("static-method")
     public VCFIterator open(final File file) throws IOException {
         return this.open(file.toPath());
     }
@@ -171,8 +279,10 @@ public class VCFIteratorBuilder {
         /** Iterator over the lines of the VCF */
         private final LineIterator lineIterator;
 
-        VCFReaderIterator(final InputStream inputStream) {
+        VCFReaderIterator(final InputStream inputStream, final boolean sitesOnly, final Collection<String> samplesToDecode) {
             this.inputStream = inputStream;
+            this.codec.setSitesOnly(sitesOnly);
+            this.codec.setSamplesToDecode(samplesToDecode);
             this.lineIterator = this.codec.makeSourceFromStream(this.inputStream);
             this.vcfHeader = (VCFHeader) this.codec.readActualHeader(this.lineIterator);
         }
@@ -184,7 +294,7 @@ public class VCFIteratorBuilder {
 
         @Override
         protected VariantContext advance() {
-            return this.lineIterator.hasNext() ? this.codec.decode(this.lineIterator.next()) : null;
+            return this.lineIterator.hasNext() ? this.codec.decode(this.lineIterator) : null;
         }
 
         @Override
@@ -205,7 +315,9 @@ public class VCFIteratorBuilder {
         /** the VCF header */
         private final VCFHeader vcfHeader;
 
-        BCFInputStreamIterator(final InputStream inputStream) {
+        BCFInputStreamIterator(final InputStream inputStream, final boolean sitesOnly, final Collection<String> samplesToDecode) {
+            this.codec.setSitesOnly(sitesOnly);
+            this.codec.setSamplesToDecode(samplesToDecode);
             this.inputStream = this.codec.makeSourceFromStream(inputStream);
             this.vcfHeader = (VCFHeader) this.codec.readHeader(this.inputStream).getHeaderValue();
         }
@@ -0,0 +1,118 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.variant.vcf;
+
+import htsjdk.tribble.readers.LineIterator;
+import htsjdk.utils.ValidationUtils;
+
+import java.io.Closeable;
+import java.nio.charset.StandardCharsets;
+import java.util.NoSuchElementException;
+
+/**
+ * A {@link LineIterator} over the lines of a {@link VCFLineReader}, which can also return each line as bytes, so
+ * that {@link AbstractVCFCodec#decode(htsjdk.tribble.readers.LineIterator)} decodes records without creating a String
+ * of each line.  A line is only converted to a String if it is returned by {@link #next()} or {@link #peek()}.
+ */
+final class VCFLineIterator implements LineIterator, Closeable {
+    private final VCFLineReader reader;
+
+    // the line that has been read but not yet returned, if lineLength is not -1, and its String if it was peeked
+    private int lineLength = -1;
+    private String line = null;
+    private boolean done = false;
+
+    /**
+     * @param reader the reader of the lines
+     */
+    VCFLineIterator(final VCFLineReader reader) {
+        ValidationUtils.nonNull(reader, "reader");
+        this.reader = reader;
+    }
+
+    @Override
+    public boolean hasNext() {
+        if (lineLength == -1 && !done) {
+            lineLength = reader.readLineBytes();
+            line = null;
+            done = lineLength == -1;
+        }
+        return !done;
+    }
+
+    @Override
+    public String peek() {
+        if (!hasNext()) {
+            throw new NoSuchElementException();
+        }
+        if (line == null) {
+            line = new String(reader.getLineBuffer(), 0, lineLength, StandardCharsets.UTF_8);
+        }
+        return line;
+    }
+
+    @Override
+    public String next() {
+        final String next = peek();
+        lineLength = -1;
+        return next;
+    }
+
+    /**
+     * Returns the next line as bytes, in the buffer returned by {@link #getLineBuffer()}, which holds it until the
+     * iterator is next used.
+     *
+     * @return the number of bytes of the line
+     */
+    int nextLineBytes() {
+        if (!hasNext()) {
+            throw new NoSuchElementException();
+        }
+        final int length = lineLength;
+        lineLength = -1;
+        return length;
+    }
+
+    /**
+     * @return the buffer holding the line last returned by {@link #nextLineBytes()}
+     */
+    byte[] getLineBuffer() {
+        return reader.getLineBuffer();
+    }
+
+    @Override
+    public void remove() {
+        throw new UnsupportedOperationException();
+    }
+
+    @Override
+    public void close() {
+        reader.close();
+    }
+
+    @Override
+    public String toString() {
+        return "VCFLineIterator(" + reader + ")";
+    }
+}
@@ -0,0 +1,186 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.variant.vcf;
+
+import htsjdk.samtools.util.CloserUtil;
+import htsjdk.samtools.util.RuntimeIOException;
+import htsjdk.tribble.readers.LineReader;
+import htsjdk.utils.ValidationUtils;
+
+import java.io.IOException;
+import java.io.InputStream;
+import java.nio.charset.StandardCharsets;
+import java.util.Arrays;
+
+/**
+ * A {@link LineReader} over a VCF that reads lines as bytes, so that records can be decoded without first being
+ * converted to Strings (see {@link AbstractVCFCodec#decode(byte[], int)}).  It may return only the leading columns
+ * of each record line, up to and including INFO, in which case the FORMAT and genotype columns that follow are
+ * skipped as raw bytes, without being decoded or copied, so reading the sites of a VCF with many samples does not
+ * create a String of each full line.  Header lines are returned whole.  Lines may end with '\n', '\r' or "\r\n", as for
+ * {@link java.io.BufferedReader#readLine()}.
+ */
+final class VCFLineReader implements LineReader {
+    /** The number of columns to read to return whole lines */
+    static final int ALL_COLUMNS = Integer.MAX_VALUE;
+
+    private static final int BUFFER_SIZE = 64 * 1024;
+    private static final byte HEADER_INDICATOR = (byte) VCFHeader.HEADER_INDICATOR.charAt(0);
+
+    private final InputStream stream;
+    private final int nColumns;
+    private final byte[] buffer = new byte[BUFFER_SIZE];
+    private int bufferPos = 0;
+    private int bufferLimit = 0;
+
+    private byte[] line = new byte[1024];
+    private int lineLength = 0;
+    // true if the last line ended with '\r', so that a '\n' that follows is part of its terminator
+    private boolean skipLineFeed = false;
+
+    /**
+     * @param stream the stream to read the VCF from, positioned at the start of a line
+     * @param nColumns the number of leading columns of each record line to return, or {@link #ALL_COLUMNS}
+     */
+    VCFLineReader(final InputStream stream, final int nColumns) {
+        ValidationUtils.nonNull(stream, "stream");
+        ValidationUtils.validateArg(nColumns > 0, "nColumns must be positive");
+        this.stream = stream;
+        this.nColumns = nColumns;
+    }
+
+    @Override
+    public String readLine() {
+        final int length = readLineBytes();
+        return length == -1 ? null : new String(line, 0, length, StandardCharsets.UTF_8);
+    }
+
+    /**
+     * Reads the next line into the buffer returned by {@link #getLineBuffer()}, which holds it until the next call.
+     *
+     * @return the number of bytes of the line, without its terminator, or -1 at the end of the stream
+     */
+    int readLineBytes() {
+        lineLength = 0;
+        if (skipLineFeed) {
+            skipLineFeed = false;
+            if (fillBuffer() && buffer[bufferPos] == '\n') {
+                bufferPos++;
+            }
+        }
+        if (!fillBuffer()) {
+            return -1;
+        }
+        final boolean wholeLine = nColumns == ALL_COLUMNS || buffer[bufferPos] == HEADER_INDICATOR;
+
+        // copy the line up to the tab that ends its last wanted column
+        int nTabs = 0;
+        while (true) {
+            if (!fillBuffer()) {
+                return lineLength;
+            }
+            int i = bufferPos;
+            while (i < bufferLimit && !isLineTerminator(buffer[i]) && (wholeLine || buffer[i] != VCFConstants.FIELD_SEPARATOR_CHAR)) {
+                i++;
+            }
+            append(bufferPos, i);
+            bufferPos = i;
+            if (i == bufferLimit) {
+                continue;
+            }
+            bufferPos++;
+            if (isLineTerminator(buffer[i])) {
+                skipLineFeed = buffer[i] == '\r';
+                return lineLength;
+            }
+            if (++nTabs == nColumns) {
+                break;
+            }
+            append(i, i + 1);
+        }
+
+        // skip the rest of it
+        while (fillBuffer()) {
+            int i = bufferPos;
+            while (i < bufferLimit && !isLineTerminator(buffer[i])) {
+                i++;
+            }
+            if (i < bufferLimit) {
+                skipLineFeed = buffer[i] == '\r';
+                bufferPos = i + 1;
+                break;
+            }
+            bufferPos = bufferLimit;
+        }
+        return lineLength;
+    }
+
+    private static boolean isLineTerminator(final byte b) {
+        return b == '\n' || b == '\r';
+    }
+
+    /**
+     * @return the buffer holding the line last read by {@link #readLineBytes()}
+     */
+    byte[] getLineBuffer() {
+        return line;
+    }
+
+    /** Ensures that the buffer holds unread bytes, reading more if needed; returns false at the end of the stream */
+    private boolean fillBuffer() {
+        if (bufferPos < bufferLimit) {
+            return true;
+        }
+        try {
+            int n;
+            do {
+                n = stream.read(buffer, 0, buffer.length);
+            } while (n == 0);
+            bufferPos = 0;
+            bufferLimit = Math.max(n, 0);
+            return n > 0;
+        } catch (final IOException e) {
+            throw new RuntimeIOException(e);
+        }
+    }
+
+    private void append(final int from, final int to) {
+        final int n = to - from;
+        if (lineLength + n > line.length) {
+            line = Arrays.copyOf(line, Math.max(2 * line.length, lineLength + n));
+        }
+        System.arraycopy(buffer, from, line, lineLength, n);
+        lineLength += n;
+    }
+
+    @Override
+    public void close() {
+        CloserUtil.close(stream);
+    }
+
+    @Override
+    public String toString() {
+        return "VCFLineReader";
+    }
+}
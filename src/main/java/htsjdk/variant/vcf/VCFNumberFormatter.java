@@ -0,0 +1,192 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.variant.vcf;
+
+import java.io.IOException;
+import java.math.BigDecimal;
+import java.math.MathContext;
+import java.math.RoundingMode;
+
+/**
+ * Formats numbers for VCF output directly into an {@link Appendable}, without creating Strings or using
+ * {@link java.util.Formatter}.
+ *
+ * Doubles are formatted exactly as {@code String.format(Locale.US, "%.Nf")} and {@code "%.Ne"} would format them: the
+ * shortest decimal representation of the value (as given by {@link Double#toString(double)}) is rounded half-up to
+ * the requested number of digits.  Most values are formatted with a little double arithmetic; values that are too
+ * large for it, or that are within rounding error of a tie, fall back to rounding the decimal representation exactly.
+ */
+final class VCFNumberFormatter {
+    private static final double[] POWERS_OF_TEN = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    // scaled values below this have an ulp small enough for the tie check below to be reliable
+    private static final double MAX_FAST_SCALED_VALUE = 1e9;
+    // a scaled value closer than this to a rounding tie is rounded exactly
+    private static final double TIE_TOLERANCE = 1e-5;
+
+    private VCFNumberFormatter() {
+    }
+
+    /** Appends the decimal representation of an int. */
+    static void appendInt(final Appendable out, final int value) throws IOException {
+        if (value == Integer.MIN_VALUE) {
+            out.append("-2147483648");
+            return;
+        }
+        int v = value;
+        if (v < 0) {
+            out.append('-');
+            v = -v;
+        }
+        appendNonNegativeLong(out, v);
+    }
+
+    private static void appendNonNegativeLong(final Appendable out, final long value) throws IOException {
+        long divisor = 1;
+        while (divisor <= value / 10) {
+            divisor *= 10;
+        }
+        for (; divisor > 0; divisor /= 10) {
+            out.append((char) ('0' + (value / divisor) % 10));
+        }
+    }
+
+    /** @return true if the value, which must be finite, is negative or negative zero, as Formatter prints a sign for both */
+    private static boolean isNegative(final double value) {
+        return Double.compare(value, 0.0) < 0;
+    }
+
+    /** @return true if NaN or infinity was appended, as Formatter prints them */
+    private static boolean appendNonFinite(final Appendable out, final double value) throws IOException {
+        if (Double.isNaN(value)) {
+            out.append("NaN");
+        } else if (Double.isInfinite(value)) {
+            out.append(value > 0 ? "Infinity" : "-Infinity");
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Appends a double with a fixed number of decimal places, as {@code String.format(Locale.US, "%.<decimals>f", value)}.
+     * @param decimals the number of decimal places, at most 8
+     */
+    static void appendFixed(final Appendable out, final double value, final int decimals) throws IOException {
+        if (appendNonFinite(out, value)) {
+            return;
+        }
+        if (isNegative(value)) {
+            out.append('-');
+        }
+        final double abs = Math.abs(value);
+        final double scaled = abs * POWERS_OF_TEN[decimals];
+        if (scaled < MAX_FAST_SCALED_VALUE) {
+            final long floor = (long) scaled;
+            final double fraction = scaled - floor;
+            if (Math.abs(fraction - 0.5) > TIE_TOLERANCE) {
+                final long rounded = fraction > 0.5 ? floor + 1 : floor;
+                final long unit = (long) POWERS_OF_TEN[decimals];
+                appendNonNegativeLong(out, rounded / unit);
+                if (decimals > 0) {
+                    out.append('.');
+                    appendPadded(out, rounded % unit, decimals);
+                }
+                return;
+            }
+        }
+        out.append(new BigDecimal(Double.toString(abs)).setScale(decimals, RoundingMode.HALF_UP).toPlainString());
+    }
+
+    /**
+     * Appends a double in scientific notation, as {@code String.format(Locale.US, "%.<decimals>e", value)}.
+     * @param decimals the number of digits after the decimal point of the mantissa, at most 8
+     */
+    static void appendScientific(final Appendable out, final double value, final int decimals) throws IOException {
+        if (appendNonFinite(out, value)) {
+            return;
+        }
+        if (isNegative(value)) {
+            out.append('-');
+        }
+        final double abs = Math.abs(value);
+        if (abs == 0.0) {
+            appendMantissaAndExponent(out, 0, decimals, 0);
+            return;
+        }
+        // the mantissa, scaled to an integer with decimals + 1 digits
+        final long unit = (long) POWERS_OF_TEN[decimals];
+        int exponent = (int) Math.floor(Math.log10(abs));
+        final int shift = decimals - exponent;
+        if (shift >= -POWERS_OF_TEN.length + 1 && shift < POWERS_OF_TEN.length) {
+            final double scaled = shift >= 0 ? abs * POWERS_OF_TEN[shift] : abs / POWERS_OF_TEN[-shift];
+            // log10 may be off by one near powers of ten, in which case the scaled value is out of range
+            if (scaled >= unit && scaled < 10 * unit) {
+                final long floor = (long) scaled;
+                final double fraction = scaled - floor;
+                if (Math.abs(fraction - 0.5) > TIE_TOLERANCE) {
+                    long rounded = fraction > 0.5 ? floor + 1 : floor;
+                    if (rounded == 10 * unit) {
+                        rounded = unit;
+                        exponent++;
+                    }
+                    appendMantissaAndExponent(out, rounded, decimals, exponent);
+                    return;
+                }
+            }
+        }
+        final BigDecimal rounded = new BigDecimal(Double.toString(abs)).round(new MathContext(decimals + 1, RoundingMode.HALF_UP));
+        final String digits = rounded.unscaledValue().toString();
+        exponent = digits.length() - 1 - rounded.scale();
+        long mantissa = Long.parseLong(digits);
+        for (int i = digits.length(); i < decimals + 1; i++) {
+            mantissa *= 10;
+        }
+        appendMantissaAndExponent(out, mantissa, decimals, exponent);
+    }
+
+    private static void appendMantissaAndExponent(final Appendable out, final long mantissa, final int decimals, final int exponent) throws IOException {
+        final long unit = (long) POWERS_OF_TEN[decimals];
+        appendNonNegativeLong(out, mantissa / unit);
+        if (decimals > 0) {
+            out.append('.');
+            appendPadded(out, mantissa % unit, decimals);
+        }
+        out.append('e').append(exponent < 0 ? '-' : '+');
+        final int absExponent = Math.abs(exponent);
+        if (absExponent < 10) {
+            out.append('0');
+        }
+        appendNonNegativeLong(out, absExponent);
+    }
+
+    /** Appends a non-negative value, left-padded with zeros to the given number of digits */
+    private static void appendPadded(final Appendable out, final long value, final int digits) throws IOException {
+        for (long divisor = (long) POWERS_OF_TEN[digits - 1]; divisor > 0; divisor /= 10) {
+            out.append((char) ('0' + (value / divisor) % 10));
+        }
+    }
+}
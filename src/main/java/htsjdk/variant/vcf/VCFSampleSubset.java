@@ -0,0 +1,150 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.variant.vcf;
+
+import htsjdk.tribble.util.ParsingUtils;
+import htsjdk.utils.ValidationUtils;
+
+import java.util.ArrayList;
+import java.util.Collection;
+import java.util.Collections;
+import java.util.HashMap;
+import java.util.HashSet;
+import java.util.List;
+import java.util.Set;
+
+/**
+ * A subset of the samples of a {@link VCFHeader}, for codecs that decode the genotypes of only some samples.  The
+ * selected samples keep the order in which they appear in the header, and are described by the same sorted name list
+ * and name to offset map as {@link VCFHeader#getSampleNamesInOrder()} and {@link VCFHeader#getSampleNameToOffset()},
+ * so that genotypes decoded for them can back a {@link htsjdk.variant.variantcontext.LazyGenotypesContext}.
+ *
+ * Instances are not modified once created, so they may be shared by codecs decoding on different threads.
+ */
+public final class VCFSampleSubset {
+    private final int nHeaderSamples;
+    private final boolean[] selected;
+    private final int[] sampleIndices;
+    private final List<String> sampleNames;
+    private final ArrayList<String> sampleNamesInOrder;
+    private final HashMap<String, Integer> sampleNameToOffset;
+    private final boolean samplesWereAlreadySorted;
+
+    /**
+     * @param header the header listing all of the samples
+     * @param samples the samples to select, each of which must be in the header
+     * @throws IllegalArgumentException if a sample is not in the header
+     */
+    public VCFSampleSubset(final VCFHeader header, final Collection<String> samples) {
+        ValidationUtils.nonNull(header, "header");
+        ValidationUtils.nonNull(samples, "samples");
+        final Set<String> wanted = new HashSet<>(samples);
+        final List<String> headerSamples = header.getGenotypeSamples();
+        nHeaderSamples = headerSamples.size();
+        selected = new boolean[nHeaderSamples];
+
+        final List<Integer> indices = new ArrayList<>(wanted.size());
+        for (int i = 0; i < nHeaderSamples; i++) {
+            if (wanted.remove(headerSamples.get(i))) {
+                selected[i] = true;
+                indices.add(i);
+            }
+        }
+        if (!wanted.isEmpty()) {
+            throw new IllegalArgumentException("Samples to decode are not in the header: " + wanted);
+        }
+
+        sampleIndices = new int[indices.size()];
+        final List<String> names = new ArrayList<>(indices.size());
+        sampleNameToOffset = new HashMap<>(indices.size());
+        for (int i = 0; i < sampleIndices.length; i++) {
+            sampleIndices[i] = indices.get(i);
+            final String name = headerSamples.get(sampleIndices[i]);
+            names.add(name);
+            sampleNameToOffset.put(name, i);
+        }
+        sampleNames = Collections.unmodifiableList(names);
+        sampleNamesInOrder = new ArrayList<>(names);
+        Collections.sort(sampleNamesInOrder);
+        samplesWereAlreadySorted = ParsingUtils.isSorted(names);
+    }
+
+    /**
+     * @return the number of selected samples
+     */
+    public int size() {
+        return sampleIndices.length;
+    }
+
+    /**
+     * @return the number of samples in the header
+     */
+    public int getNHeaderSamples() {
+        return nHeaderSamples;
+    }
+
+    /**
+     * @param headerIndex the index of a sample in the header
+     * @return true if the sample is selected
+     */
+    public boolean isSelected(final int headerIndex) {
+        return selected[headerIndex];
+    }
+
+    /**
+     * @param i the index of a selected sample, from 0 to {@link #size()}
+     * @return the index in the header of the i'th selected sample
+     */
+    public int getHeaderIndex(final int i) {
+        return sampleIndices[i];
+    }
+
+    /**
+     * @return the names of the selected samples, in the order in which they appear in the header
+     */
+    public List<String> getSampleNames() {
+        return sampleNames;
+    }
+
+    /**
+     * @return the names of the selected samples, sorted
+     */
+    public ArrayList<String> getSampleNamesInOrder() {
+        return sampleNamesInOrder;
+    }
+
+    /**
+     * @return a map from the name of each selected sample to its offset among the selected samples
+     */
+    public HashMap<String, Integer> getSampleNameToOffset() {
+        return sampleNameToOffset;
+    }
+
+    /**
+     * @return true if the selected samples appear in the header in sorted order
+     */
+    public boolean samplesWereAlreadySorted() {
+        return samplesWereAlreadySorted;
+    }
+}
@@ -542,6 +542,47 @@ public class BAMFileWriterTest extends HtsjdkTest {
         }
     }
 
+    @Test
+    public void testUnmodifiedBamRecordsAreCopiedAsIs() throws Exception {
+        final SAMRecordSetBuilder builder = new SAMRecordSetBuilder(true, SAMFileHeader.SortOrder.coordinate);
+        builder.addPair("pair", 0, 100, 150);
+        builder.addPair("half", 0, 300, 300, false, true, "20M5D10M2I4M", null, false, true, 30);
+        builder.addFrag("long", 0, 400, false, false,
+                Cigar.fromCigarOperators(getCigarOperatorsForTest(BAMRecord.MAX_CIGAR_OPERATORS + 1)).toString(), null, 30);
+        builder.addUnmappedFragment("unmapped");
+
+        final List<SAMRecord> records = new ArrayList<>();
+        final SAMFileHeader header;
+        try (final SamReader reader = builder.getSamReader()) {
+            header = reader.getFileHeader();
+            reader.iterator().forEachRemaining(records::add);
+        }
+
+        // records whose binary block is untouched are written from it, without being decoded
+        final ByteArrayOutputStream copied = new ByteArrayOutputStream();
+        try (final BAMFileWriter writer = new BAMFileWriter(copied, null)) {
+            writer.setHeader(header);
+            for (final SAMRecord record : records) {
+                Assert.assertNotNull(record.getVariableBinaryRepresentation());
+                writer.addAlignment(record);
+                Assert.assertNotNull(record.getVariableBinaryRepresentation());
+            }
+        }
+
+        final ByteArrayOutputStream reencoded = new ByteArrayOutputStream();
+        try (final BAMFileWriter writer = new BAMFileWriter(reencoded, null)) {
+            writer.setHeader(header);
+            for (final SAMRecord record : records) {
+                // make the binary block stale so that the record is encoded from its fields
+                record.setReadName(record.getReadName());
+                Assert.assertNull(record.getVariableBinaryRepresentation());
+                writer.addAlignment(record);
+            }
+        }
+
+        Assert.assertEquals(copied.toByteArray(), reencoded.toByteArray());
+    }
+
     @Test
     public void testWriteHeader() throws IOException {
         final SAMRecordSetBuilder builder = new SAMRecordSetBuilder(true, SAMFileHeader.SortOrder.coordinate);
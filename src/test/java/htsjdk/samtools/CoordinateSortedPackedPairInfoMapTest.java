@@ -0,0 +1,107 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.samtools;
+
+import htsjdk.HtsjdkTest;
+import htsjdk.samtools.util.CloseableIterator;
+import org.testng.Assert;
+import org.testng.annotations.Test;
+
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.Random;
+
+public class CoordinateSortedPackedPairInfoMapTest extends HtsjdkTest {
+    private static final int WIDTH = 3;
+
+    private static long[] recordFor(final String name, final int sequenceIndex) {
+        return new long[]{name.hashCode(), sequenceIndex, -name.length()};
+    }
+
+    /**
+     * Simulates mate pairing over a coordinate sorted file: each read either completes a pair put earlier for its
+     * sequence, or puts itself under the sequence of its mate, which may be this sequence or a later one.
+     */
+    @Test
+    public void testMatchesHashMap() {
+        final Random random = new Random(5);
+        final CoordinateSortedPackedPairInfoMap map = new CoordinateSortedPackedPairInfoMap(4, WIDTH);
+        final List<Map<String, long[]>> expected = new ArrayList<>();
+        final int numSequences = 6;
+        for (int i = 0; i < numSequences; i++) {
+            expected.add(new HashMap<>());
+        }
+        final long[] removed = new long[WIDTH];
+        int nextName = 0;
+        for (int sequenceIndex = 0; sequenceIndex < numSequences; sequenceIndex++) {
+            final List<String> pending = new ArrayList<>(expected.get(sequenceIndex).keySet());
+            for (int i = 0; i < 20000; i++) {
+                if (!pending.isEmpty() && random.nextInt(3) == 0) {
+                    final String name = pending.remove(random.nextInt(pending.size()));
+                    Assert.assertTrue(map.remove(sequenceIndex, name, removed));
+                    Assert.assertEquals(removed, expected.get(sequenceIndex).remove(name));
+                } else {
+                    final String name = "read:" + Integer.toHexString(nextName++ * 0x9E3779B1);
+                    Assert.assertFalse(map.remove(sequenceIndex, name, removed));
+                    final int mateSequenceIndex = random.nextInt(4) == 0
+                            ? sequenceIndex + random.nextInt(numSequences - sequenceIndex) : sequenceIndex;
+                    map.put(mateSequenceIndex, name, recordFor(name, mateSequenceIndex));
+                    expected.get(mateSequenceIndex).put(name, recordFor(name, mateSequenceIndex));
+                    if (mateSequenceIndex == sequenceIndex) {
+                        pending.add(name);
+                    }
+                }
+            }
+        }
+
+        final Map<String, long[]> remaining = new HashMap<>();
+        expected.forEach(remaining::putAll);
+        Assert.assertEquals(map.size(), remaining.size());
+        try (final CloseableIterator<Map.Entry<String, long[]>> it = map.iterator()) {
+            while (it.hasNext()) {
+                final Map.Entry<String, long[]> entry = it.next();
+                Assert.assertEquals(entry.getValue(), remaining.remove(entry.getKey()), entry.getKey());
+            }
+        }
+        Assert.assertTrue(remaining.isEmpty());
+    }
+
+    @Test(expectedExceptions = IllegalArgumentException.class)
+    public void testPutTwice() {
+        final CoordinateSortedPackedPairInfoMap map = new CoordinateSortedPackedPairInfoMap(4, WIDTH);
+        map.remove(0, "read", new long[WIDTH]);
+        map.put(0, "read", recordFor("read", 0));
+        map.put(0, "read", recordFor("read", 0));
+    }
+
+    @Test(expectedExceptions = SAMException.class)
+    public void testPutTwiceOnDisk() {
+        final CoordinateSortedPackedPairInfoMap map = new CoordinateSortedPackedPairInfoMap(4, WIDTH);
+        map.put(1, "read", recordFor("read", 1));
+        map.put(1, "read", recordFor("read", 1));
+        map.remove(1, "read", new long[WIDTH]);
+    }
+}
@@ -29,8 +29,10 @@ import org.testng.Assert;
 import org.testng.annotations.DataProvider;
 import org.testng.annotations.Test;
 
+import java.io.File;
 import java.util.ArrayList;
 import java.util.Collection;
+import java.util.Iterator;
 import java.util.List;
 
 /**
@@ -384,6 +386,59 @@ public class MergingSamRecordIteratorGroupCollisionTest extends HtsjdkTest {
         CloserUtil.close(readers);
     }
 
+    /**
+     * Colliding read group IDs of BAM records are rewritten in the binary tag block, so the records can still be
+     * written out without being re-encoded.
+     */
+    @Test
+    public void testRemappedReadGroupsAreWrittenFromBinaryBlock() throws Exception {
+        final SAMRecordSetBuilder builder1 = new SAMRecordSetBuilder(false, SAMFileHeader.SortOrder.queryname, false);
+        builder1.setReadGroup(createSAMReadGroupRecord("a1"));
+        builder1.addFrag("read1", 20, 28833, false);
+
+        final SAMRecordSetBuilder builder2 = new SAMRecordSetBuilder(false, SAMFileHeader.SortOrder.queryname, false);
+        builder2.setReadGroup(createSAMReadGroupRecord("a1"));
+        builder2.addFrag("read2", 19, 28833, false).setAttribute(SAMTag.NM, 0);
+
+        final List<SamReader> readers = new ArrayList<SamReader>();
+        readers.add(builder1.getSamReader());
+        readers.add(builder2.getSamReader());
+
+        final List<SAMFileHeader> headers = new ArrayList<SAMFileHeader>();
+        headers.add(readers.get(0).getFileHeader());
+        headers.add(readers.get(1).getFileHeader());
+
+        final SamFileHeaderMerger headerMerger = new SamFileHeaderMerger(SAMFileHeader.SortOrder.queryname, headers, false);
+        Assert.assertTrue(headerMerger.hasReadGroupCollisions());
+
+        final File output = File.createTempFile("remappedReadGroups", ".bam");
+        output.deleteOnExit();
+        final MergingSamRecordIterator iterator = new MergingSamRecordIterator(headerMerger, readers, false);
+        try (final SAMFileWriter writer = new SAMFileWriterFactory().makeBAMWriter(headerMerger.getMergedHeader(), true, output)) {
+            while (iterator.hasNext()) {
+                final SAMRecord samRecord = iterator.next();
+                Assert.assertTrue(samRecord instanceof BAMRecord);
+                Assert.assertNotNull(samRecord.getVariableBinaryRepresentation());
+                writer.addAlignment(samRecord);
+            }
+        }
+        iterator.close();
+        CloserUtil.close(readers);
+
+        try (final SamReader reader = SamReaderFactory.makeDefault().open(output)) {
+            final Iterator<SAMRecord> records = reader.iterator();
+            SAMRecord samRecord = records.next();
+            Assert.assertEquals(samRecord.getReadName(), "read1");
+            Assert.assertEquals(samRecord.getAttribute(SAMTag.RG), "a1");
+            samRecord = records.next();
+            Assert.assertEquals(samRecord.getReadName(), "read2");
+            Assert.assertEquals(samRecord.getAttribute(SAMTag.RG), "a1.1");
+            Assert.assertEquals(samRecord.getAttribute(SAMTag.NM), 0);
+            Assert.assertNotNull(samRecord.getReadGroup());
+            Assert.assertFalse(records.hasNext());
+        }
+    }
+
     private SAMReadGroupRecord createSAMReadGroupRecord(String id) {
         SAMReadGroupRecord readGroupRecord = new SAMReadGroupRecord(id);
         readGroupRecord.setAttribute(SAMTag.SM, Double.toString(Math.random()));
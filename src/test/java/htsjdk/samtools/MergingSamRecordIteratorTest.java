@@ -32,6 +32,7 @@ import java.util.ArrayList;
 import java.util.Arrays;
 import java.util.HashSet;
 import java.util.List;
+import java.util.Random;
 import java.util.Set;
 
 /**
@@ -310,4 +311,45 @@ public class MergingSamRecordIteratorTest extends HtsjdkTest {
         samReader1.close();
         samReader2.close();
     }
+
+    @Test
+    public void testPrefetchMatchesSynchronousMerge() throws Exception {
+        // room for 2 of the 6 inputs to prefetch at once
+        final long memoryBudget = 2L * 2 * MergingSamRecordIterator.RECORDS_PER_PREFETCH_BATCH *
+                MergingSamRecordIterator.ESTIMATED_BYTES_PER_RECORD;
+        Assert.assertEquals(mergeRandomReads(0, 0), mergeRandomReads(3, memoryBudget));
+        Assert.assertEquals(mergeRandomReads(0, 0), mergeRandomReads(1, Long.MAX_VALUE));
+    }
+
+    private static List<String> mergeRandomReads(final int prefetchThreads, final long memoryBudget) throws Exception {
+        final Random random = new Random(42);
+        final List<SamReader> readerList = new ArrayList<>();
+        final List<SAMFileHeader> headerList = new ArrayList<>();
+        for (int i = 0; i < 6; i++) {
+            final SAMRecordSetBuilder builder = new SAMRecordSetBuilder();
+            // a different number of reads per input, so that inputs are exhausted at different times
+            for (int j = 0; j < 200 * (i + 1); j++) {
+                builder.addFrag("read_" + i + "_" + j, random.nextInt(3), 1 + random.nextInt(1000), random.nextBoolean());
+            }
+            final SamReader reader = builder.getSamReader();
+            readerList.add(reader);
+            headerList.add(reader.getFileHeader());
+        }
+        final SamFileHeaderMerger fileHeaderMerger = new SamFileHeaderMerger(SAMFileHeader.SortOrder.coordinate, headerList, false);
+        final MergingSamRecordIterator iterator = new MergingSamRecordIterator(fileHeaderMerger, readerList, false);
+        if (prefetchThreads > 0) {
+            iterator.enablePrefetch(prefetchThreads, memoryBudget);
+        }
+        final List<String> merged = new ArrayList<>();
+        while (iterator.hasNext()) {
+            final SAMRecord record = iterator.next();
+            merged.add(record.getReadName() + " " + record.getReferenceIndex() + ":" + record.getAlignmentStart());
+        }
+        iterator.close();
+        for (final SamReader reader : readerList) {
+            reader.close();
+        }
+        Assert.assertEquals(merged.size(), 200 * 21);
+        return merged;
+    }
 }
@@ -0,0 +1,156 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.samtools;
+
+import htsjdk.HtsjdkTest;
+import org.testng.Assert;
+import org.testng.annotations.DataProvider;
+import org.testng.annotations.Test;
+
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.Iterator;
+import java.util.List;
+import java.util.Random;
+
+public class StreamingDuplicateSetIteratorTest extends HtsjdkTest {
+    private static final String[] CIGARS = {"50M", "5S45M", "45M5S", "3S20M2D25M2S", "20M1I29M"};
+
+    private static SAMRecordSetBuilder makeRecords() {
+        final Random random = new Random(13);
+        final SAMRecordSetBuilder builder = new SAMRecordSetBuilder(true, SAMFileHeader.SortOrder.coordinate);
+        for (int i = 0; i < 600; i++) {
+            if (i == 300) {
+                final SAMReadGroupRecord readGroup = new SAMReadGroupRecord("library2");
+                readGroup.setLibrary("library2");
+                builder.setReadGroup(readGroup);
+            }
+            final int contig = random.nextInt(2);
+            final int start = 10 + random.nextInt(60);
+            switch (random.nextInt(6)) {
+                case 0:
+                case 1:
+                    builder.addPair("pair" + i, contig, start, start + random.nextInt(100));
+                    break;
+                case 2:
+                    builder.addFrag("unmapped" + i, contig, start, random.nextBoolean(), true, null, null, 30);
+                    break;
+                case 3:
+                    builder.addFrag("secondary" + i, contig, start, random.nextBoolean(), false,
+                            CIGARS[random.nextInt(CIGARS.length)], null, -1, true);
+                    break;
+                default:
+                    builder.addFrag("frag" + i, contig, start, random.nextBoolean(), false,
+                            CIGARS[random.nextInt(CIGARS.length)], null, -1);
+            }
+        }
+        // unmapped reads placed on the reverse strand, such as next to a mapped mate, have no alignment end
+        for (int i = 0; i < 4; i++) {
+            final SAMRecord reverseUnmapped = new SAMRecord(builder.getHeader());
+            reverseUnmapped.setReadName("reverseUnmapped" + i);
+            reverseUnmapped.setReferenceIndex(i % 2);
+            reverseUnmapped.setAlignmentStart(20 + 15 * i);
+            reverseUnmapped.setReadUnmappedFlag(true);
+            reverseUnmapped.setReadNegativeStrandFlag(true);
+            reverseUnmapped.setReadString("ACGTACGTAC");
+            reverseUnmapped.setBaseQualityString("##########");
+            builder.addRecord(reverseUnmapped);
+        }
+        builder.addUnmappedFragment("unplaced1");
+        builder.addUnmappedFragment("unplaced2");
+        return builder;
+    }
+
+    private static List<String> describeSets(final Iterator<DuplicateSet> iterator) {
+        final List<String> sets = new ArrayList<>();
+        while (iterator.hasNext()) {
+            final StringBuilder set = new StringBuilder();
+            for (final SAMRecord record : iterator.next().getRecords()) {
+                set.append(record.getReadName())
+                        .append(record.getReadPairedFlag() && record.getSecondOfPairFlag() ? "/2" : "")
+                        .append(record.getDuplicateReadFlag() ? "(dup) " : " ");
+            }
+            sets.add(set.toString());
+        }
+        Collections.sort(sets);
+        return sets;
+    }
+
+    @DataProvider
+    public Object[][] windowSizes() {
+        return new Object[][]{{StreamingDuplicateSetIterator.DEFAULT_WINDOW_SIZE}, {5}};
+    }
+
+    @Test(dataProvider = "windowSizes")
+    public void testSameSetsAsSortingIterator(final int windowSize) {
+        final SAMRecordSetBuilder records = makeRecords();
+        final SAMFileHeader header = records.getHeader();
+
+        final List<String> expected = describeSets(new DuplicateSetIterator(records.iterator(), header, false));
+        final List<String> actual = describeSets(new StreamingDuplicateSetIterator(records.iterator(), header, null, windowSize));
+
+        Assert.assertEquals(actual, expected);
+        Assert.assertTrue(actual.stream().anyMatch(set -> set.contains("(dup)")));
+    }
+
+    @Test
+    public void testSetsComeOutInPositionOrder() {
+        final SAMRecordSetBuilder records = makeRecords();
+        final StreamingDuplicateSetIterator iterator = new StreamingDuplicateSetIterator(records.iterator(), records.getHeader());
+        int lastReferenceIndex = 0;
+        while (iterator.hasNext()) {
+            final SAMRecord representative = iterator.next().getRepresentative();
+            final int referenceIndex = representative.getReferenceIndex();
+            if (referenceIndex != SAMRecord.NO_ALIGNMENT_REFERENCE_INDEX) {
+                Assert.assertTrue(referenceIndex >= lastReferenceIndex);
+                lastReferenceIndex = referenceIndex;
+            }
+        }
+        iterator.close();
+    }
+
+    @Test(expectedExceptions = SAMException.class)
+    public void testClipLongerThanWindow() {
+        final SAMRecordSetBuilder records = new SAMRecordSetBuilder(true, SAMFileHeader.SortOrder.coordinate);
+        records.addFrag("read1", 0, 100, false, false, "50M", null, 30);
+        records.addFrag("read2", 0, 200, false, false, "50M", null, 30);
+        // the 5' end of read3 is at 190, before the window of 5 bases behind read2
+        records.addFrag("read3", 0, 210, false, false, "20S30M", null, 30);
+        final StreamingDuplicateSetIterator iterator = new StreamingDuplicateSetIterator(records.iterator(), records.getHeader(), null, 5);
+        while (iterator.hasNext()) {
+            iterator.next();
+        }
+    }
+
+    @Test(expectedExceptions = SAMException.class)
+    public void testUnsortedInput() {
+        final SAMRecordSetBuilder records = new SAMRecordSetBuilder(false, SAMFileHeader.SortOrder.unsorted);
+        records.addFrag("read1", 0, 200, false);
+        records.addFrag("read2", 0, 100, false);
+        final StreamingDuplicateSetIterator iterator = new StreamingDuplicateSetIterator(records.iterator(), records.getHeader());
+        while (iterator.hasNext()) {
+            iterator.next();
+        }
+    }
+}
@@ -0,0 +1,85 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.samtools;
+
+import htsjdk.HtsjdkTest;
+import htsjdk.samtools.util.BinaryCodec;
+import org.testng.Assert;
+import org.testng.annotations.Test;
+
+import java.io.ByteArrayOutputStream;
+import java.util.HashMap;
+import java.util.Map;
+
+public class StringTagRemappingTest extends HtsjdkTest {
+    private static final byte[] PREFIX = {1, 2, 3};
+
+    private static byte[] makeBlock(final Object... tagsAndValues) {
+        final ByteArrayOutputStream bytes = new ByteArrayOutputStream();
+        bytes.write(PREFIX, 0, PREFIX.length);
+        final BinaryTagCodec codec = new BinaryTagCodec(new BinaryCodec(bytes));
+        for (int i = 0; i < tagsAndValues.length; i += 2) {
+            codec.writeTag(SAMTag.makeBinaryTag((String) tagsAndValues[i]), tagsAndValues[i + 1], false);
+        }
+        return bytes.toByteArray();
+    }
+
+    private static StringTagRemapping makeRemapping() {
+        final Map<String, String> readGroups = new HashMap<>();
+        readGroups.put("a", "a.1");
+        readGroups.put("b", "b");
+        final Map<String, String> programs = new HashMap<>();
+        programs.put("0", "0.1");
+        return new StringTagRemapping()
+                .addTag(SAMTag.RG.getBinaryTag(), readGroups)
+                .addTag(SAMTag.PG.getBinaryTag(), programs);
+    }
+
+    @Test
+    public void testRemapValues() {
+        final byte[] block = makeBlock("NM", 3, "RG", "a", "XA", new int[]{1, 2, 3}, "PG", "0", "XZ", "a");
+        final byte[] remapped = makeRemapping().remap(block, PREFIX.length);
+        Assert.assertEquals(remapped, makeBlock("NM", 3, "RG", "a.1", "XA", new int[]{1, 2, 3}, "PG", "0.1", "XZ", "a"));
+    }
+
+    @Test
+    public void testUnchangedValuesKeepBlock() {
+        final byte[] block = makeBlock("RG", "b", "XB", new short[]{1, 2}, "XH", new byte[]{10, 11});
+        Assert.assertSame(makeRemapping().remap(block, PREFIX.length), block);
+    }
+
+    @Test
+    public void testUnknownValuesAreRemoved() {
+        final byte[] block = makeBlock("RG", "unknown", "NM", 1, "PG", "unknown");
+        Assert.assertEquals(makeRemapping().remap(block, PREFIX.length), makeBlock("NM", 1));
+    }
+
+    @Test
+    public void testRemapSingleValue() {
+        final StringTagRemapping remapping = makeRemapping();
+        Assert.assertEquals(remapping.remap(SAMTag.RG.getBinaryTag(), "a"), "a.1");
+        Assert.assertNull(remapping.remap(SAMTag.PG.getBinaryTag(), "unknown"));
+        Assert.assertEquals(remapping.remap(SAMTag.NM.getBinaryTag(), "a"), "a");
+    }
+}
@@ -608,6 +608,78 @@ public class ValidateSamFileTest extends HtsjdkTest {
         Assert.assertEquals(samFileValidator.getNumErrors(), numErrors);
     }
 
+    @DataProvider(name = "multiThreadedValidationData")
+    public Object[][] multiThreadedValidationData() {
+        return new Object[][]{
+                {"invalid_coord_sort_order.sam", null},
+                {"invalid_queryname_sort_order.sam", null},
+                {"invalid_mate_cigar_string.sam", null},
+                {"not_stored_qualities_more_than_100.sam", null},
+                {"duplicated_reads.sam", null},
+                {"truncated.bam", null},
+                {"nm_tag_validation.cram", "nm_tag_validation.fa"}
+        };
+    }
+
+    @Test(dataProvider = "multiThreadedValidationData")
+    public void testMultiThreadedValidationMatchesSingleThreaded(final String inputFile, final String referenceFile) throws IOException {
+        final File reference = referenceFile == null ? null : new File(TEST_DATA_DIR, referenceFile);
+        final String expected = validateVerbose(new File(TEST_DATA_DIR, inputFile), reference, 1);
+        Assert.assertEquals(validateVerbose(new File(TEST_DATA_DIR, inputFile), reference, 4), expected);
+    }
+
+    @Test
+    public void testMultiThreadedValidationOfManyBatches() throws IOException {
+        final SAMRecordSetBuilder samBuilder = new SAMRecordSetBuilder();
+        for (int i = 0; i < 5000; i++) {
+            samBuilder.addPair("pair" + i, i % 3, 1 + i, 100 + i);
+            if (i % 17 == 0) {
+                samBuilder.addFrag("frag" + i, i % 3, 1 + i, false);
+            }
+        }
+        int i = 0;
+        for (final SAMRecord record : samBuilder) {
+            if (i % 13 == 0) {
+                record.setMateNegativeStrandFlag(!record.getMateNegativeStrandFlag());
+            }
+            if (i % 29 == 0) {
+                record.setProperPairFlag(true);
+            }
+            if (i % 31 == 0) {
+                record.setAttribute(SAMTag.U2.name(), "AAA");
+            }
+            i++;
+        }
+
+        final String[] results = new String[2];
+        for (final int numThreads : new int[]{1, 3}) {
+            final StringWriter out = new StringWriter();
+            final SamFileValidator validator = new SamFileValidator(new PrintWriter(out), 8000);
+            validator.setVerbose(true, 100000);
+            validator.setNumThreads(numThreads);
+            validator.validateSamFileVerbose(samBuilder.getSamReader(), null);
+            results[numThreads == 1 ? 0 : 1] = out.toString();
+        }
+        Assert.assertTrue(results[0].contains("MATE_NOT_FOUND"));
+        Assert.assertTrue(results[0].contains("MISMATCH_FLAG_MATE_NEG_STRAND"));
+        Assert.assertEquals(results[1], results[0]);
+    }
+
+    private static String validateVerbose(final File input, final File reference, final int numThreads) throws IOException {
+        final StringWriter out = new StringWriter();
+        final SamFileValidator validator = new SamFileValidator(new PrintWriter(out), 8000);
+        validator.setVerbose(true, 100000);
+        validator.setNumThreads(numThreads);
+        final SamReaderFactory factory = SamReaderFactory.makeDefault().validationStringency(ValidationStringency.SILENT);
+        if (reference != null) {
+            factory.referenceSequence(reference);
+        }
+        try (final SamReader samReader = factory.open(input)) {
+            validator.validateSamFileVerbose(samReader, reference == null ? null : new FastaSequenceFile(reference, true));
+        }
+        return out.toString();
+    }
+
     private Histogram<String> executeValidation(final SamReader samReader, final ReferenceSequenceFile reference,
                                                 final IndexValidationStringency stringency) throws IOException {
         return executeValidationWithErrorIgnoring(samReader, reference, stringency, Collections.EMPTY_LIST, false);
@@ -0,0 +1,91 @@
+package htsjdk.samtools.util;
+
+import htsjdk.HtsjdkTest;
+import org.testng.Assert;
+import org.testng.annotations.DataProvider;
+import org.testng.annotations.Test;
+
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.Iterator;
+import java.util.List;
+import java.util.Random;
+
+public class ImplicitIntervalTreeTest extends HtsjdkTest {
+
+    @Test
+    public void testEmpty() {
+        final ImplicitIntervalTree<String> tree = new ImplicitIntervalTree.Builder<String>().build();
+        Assert.assertEquals(tree.size(), 0);
+        Assert.assertTrue(tree.getOverlappers(1, 100).isEmpty());
+        Assert.assertFalse(tree.overlapsAny(1, 100));
+    }
+
+    @Test
+    public void testSimpleOverlaps() {
+        final ImplicitIntervalTree.Builder<String> builder = new ImplicitIntervalTree.Builder<>();
+        builder.add(150, 400, "b");
+        builder.add(100, 200, "a");
+        builder.add(500, 500, "c");
+        final ImplicitIntervalTree<String> tree = builder.build();
+
+        Assert.assertEquals(tree.size(), 3);
+        Assert.assertEquals(tree.getStart(0), 100);
+        Assert.assertEquals(tree.getEnd(0), 200);
+        Assert.assertEquals(tree.getValue(0), "a");
+
+        Assert.assertEquals(tree.getOverlappers(180, 190), CollectionUtil.makeList("a", "b"));
+        Assert.assertEquals(tree.getOverlappers(200, 200), CollectionUtil.makeList("a", "b"));
+        Assert.assertEquals(tree.getOverlappers(201, 499), CollectionUtil.makeList("b"));
+        Assert.assertEquals(tree.getOverlappers(500, 600), CollectionUtil.makeList("c"));
+        Assert.assertEquals(tree.getOverlappers(1, 99), Collections.emptyList());
+        Assert.assertTrue(tree.overlapsAny(400, 400));
+        Assert.assertFalse(tree.overlapsAny(401, 499));
+    }
+
+    @DataProvider(name = "randomTrees")
+    public Object[][] randomTrees() {
+        return new Object[][]{
+                {1, 100}, {2, 100}, {7, 1000}, {8, 1000}, {9, 1000}, {100, 1000}, {1023, 10000}, {1024, 10000}, {5000, 100000}
+        };
+    }
+
+    @Test(dataProvider = "randomTrees")
+    public void testMatchesIntervalTree(final int nIntervals, final int span) {
+        final Random random = new Random(nIntervals);
+        final ImplicitIntervalTree.Builder<Integer> builder = new ImplicitIntervalTree.Builder<>();
+        final IntervalTree<Integer> reference = new IntervalTree<>();
+        for (int i = 0; i < nIntervals; i++) {
+            final int start = 1 + random.nextInt(span);
+            final int end = start + random.nextInt(random.nextBoolean() ? 10 : span / 10);
+            builder.add(start, end, i);
+            reference.put(start, end, i);
+        }
+        final ImplicitIntervalTree<Integer> tree = builder.build();
+        Assert.assertEquals(tree.size(), nIntervals);
+
+        for (int q = 0; q < 1000; q++) {
+            final int start = random.nextInt(span + 10);
+            final int end = start + random.nextInt(100);
+
+            // IntervalTree collapses intervals with identical coordinates, so compare the sets of coordinates
+            final List<String> expected = new ArrayList<>();
+            final Iterator<IntervalTree.Node<Integer>> it = reference.overlappers(start, end);
+            while (it.hasNext()) {
+                final IntervalTree.Node<Integer> node = it.next();
+                expected.add(node.getStart() + "-" + node.getEnd());
+            }
+            final List<String> actual = new ArrayList<>();
+            tree.forEachOverlapper(start, end, i -> {
+                final String coordinates = tree.getStart(i) + "-" + tree.getEnd(i);
+                if (!actual.contains(coordinates)) {
+                    actual.add(coordinates);
+                }
+            });
+            Collections.sort(expected);
+            Collections.sort(actual);
+            Assert.assertEquals(actual, expected, "query " + start + "-" + end);
+            Assert.assertEquals(tree.overlapsAny(start, end), !expected.isEmpty());
+        }
+    }
+}
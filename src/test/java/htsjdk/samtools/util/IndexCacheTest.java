@@ -0,0 +1,179 @@
+package htsjdk.samtools.util;
+
+import htsjdk.HtsjdkTest;
+import htsjdk.samtools.BAMIndex;
+import htsjdk.samtools.SAMRecord;
+import htsjdk.samtools.SAMRecordIterator;
+import htsjdk.samtools.SamInputResource;
+import htsjdk.samtools.SamReader;
+import htsjdk.samtools.SamReaderFactory;
+import org.testng.Assert;
+import org.testng.annotations.AfterMethod;
+import org.testng.annotations.Test;
+
+import java.io.File;
+import java.io.IOException;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.StandardCopyOption;
+import java.nio.file.attribute.FileTime;
+import java.util.concurrent.atomic.AtomicInteger;
+
+public class IndexCacheTest extends HtsjdkTest {
+    private static final File BAM_FILE = new File("src/test/resources/htsjdk/samtools/BAMFileIndexTest/index_test.bam");
+    private static final File CRAM_DIR = new File("src/test/resources/htsjdk/samtools/cram");
+    private static final File CRAM_FILE = new File(CRAM_DIR, "cramQueryWithCRAI.cram");
+    private static final File CRAM_REFERENCE = new File(CRAM_DIR, "human_g1k_v37.20.21.10M-10M200k.fasta");
+
+    @AfterMethod
+    public void resetCache() {
+        IndexCache.setMaximumSize(0);
+    }
+
+    private static Path createIndexFile(final String contents) throws IOException {
+        final Path path = Files.createTempFile("IndexCacheTest", ".idx");
+        IOUtil.deleteOnExit(path);
+        Files.write(path, contents.getBytes());
+        return path;
+    }
+
+    @Test
+    public void testDisabledCacheAlwaysLoads() throws IOException {
+        IndexCache.setMaximumSize(0);
+        final Path path = createIndexFile("a");
+        final AtomicInteger loads = new AtomicInteger();
+        IndexCache.get(path, Object.class, null, () -> loads.incrementAndGet());
+        IndexCache.get(path, Object.class, null, () -> loads.incrementAndGet());
+        Assert.assertEquals(loads.get(), 2);
+        Assert.assertEquals(IndexCache.size(), 0);
+    }
+
+    @Test
+    public void testIndexLoadedOnce() throws IOException {
+        IndexCache.setMaximumSize(4);
+        final Path path = createIndexFile("a");
+        final AtomicInteger loads = new AtomicInteger();
+        final Object first = IndexCache.get(path, Object.class, null, () -> { loads.incrementAndGet(); return new Object(); });
+        final Object second = IndexCache.get(path, Object.class, null, () -> { loads.incrementAndGet(); return new Object(); });
+        Assert.assertSame(second, first);
+        Assert.assertEquals(loads.get(), 1);
+
+        // a different type or discriminator is a different entry
+        IndexCache.get(path, String.class, null, () -> { loads.incrementAndGet(); return "s"; });
+        IndexCache.get(path, Object.class, "other", () -> { loads.incrementAndGet(); return new Object(); });
+        Assert.assertEquals(loads.get(), 3);
+    }
+
+    @Test
+    public void testModifiedIndexIsReloaded() throws IOException {
+        IndexCache.setMaximumSize(4);
+        final Path path = createIndexFile("a");
+        final Object first = IndexCache.get(path, Object.class, null, Object::new);
+        Files.write(path, "ab".getBytes());
+        Files.setLastModifiedTime(path, FileTime.fromMillis(Files.getLastModifiedTime(path).toMillis() + 10000));
+        final Object second = IndexCache.get(path, Object.class, null, Object::new);
+        Assert.assertNotSame(second, first);
+    }
+
+    @Test
+    public void testLeastRecentlyUsedEvicted() throws IOException {
+        IndexCache.setMaximumSize(2);
+        final Path a = createIndexFile("a");
+        final Path b = createIndexFile("b");
+        final Path c = createIndexFile("c");
+        final Object objectA = IndexCache.get(a, Object.class, null, Object::new);
+        final Object objectB = IndexCache.get(b, Object.class, null, Object::new);
+        Assert.assertSame(IndexCache.get(a, Object.class, null, Object::new), objectA);
+        IndexCache.get(c, Object.class, null, Object::new);
+        Assert.assertEquals(IndexCache.size(), 2);
+        Assert.assertSame(IndexCache.get(a, Object.class, null, Object::new), objectA);
+        Assert.assertNotSame(IndexCache.get(b, Object.class, null, Object::new), objectB);
+
+        IndexCache.setMaximumSize(1);
+        Assert.assertEquals(IndexCache.size(), 1);
+    }
+
+    @Test
+    public void testFailureNotCached() throws IOException {
+        IndexCache.setMaximumSize(4);
+        final Path path = createIndexFile("a");
+        Assert.assertThrows(IllegalStateException.class,
+                () -> IndexCache.get(path, Object.class, null, () -> { throw new IllegalStateException("bad index"); }));
+        Assert.assertEquals(IndexCache.size(), 0);
+        Assert.assertNotNull(IndexCache.get(path, Object.class, null, Object::new));
+    }
+
+    @Test
+    public void testNegativeSizeRejected() {
+        Assert.assertThrows(IllegalArgumentException.class, () -> IndexCache.setMaximumSize(-1));
+    }
+
+    @Test
+    public void testGetCacheablePath() {
+        Assert.assertNotNull(IndexCache.getCacheablePath("src/test/resources/htsjdk/samtools/BAMFileIndexTest/index_test.bam.bai"));
+        Assert.assertNull(IndexCache.getCacheablePath("http://broadinstitute.github.io/picard/testdata/index_test.bam.bai"));
+        Assert.assertNull(IndexCache.getCacheablePath(null));
+    }
+
+    @Test
+    public void testBAMIndexSharedBetweenReaders() throws IOException {
+        IndexCache.setMaximumSize(4);
+        final SamReaderFactory factory = SamReaderFactory.makeDefault();
+        try (final SamReader reader1 = factory.open(BAM_FILE)) {
+            final BAMIndex index1 = reader1.indexing().getIndex();
+            try (final SamReader reader2 = factory.open(BAM_FILE)) {
+                Assert.assertSame(reader2.indexing().getIndex(), index1);
+            }
+            // closing one reader must leave the shared index usable by the other
+            final int count1 = countRecords(reader1, "chr1", 1, 100000000);
+            final int count2 = countRecords(reader1, "chr2", 1, 100000000);
+            Assert.assertEquals(count1, countRecordsUncached("chr1"));
+            Assert.assertEquals(count2, countRecordsUncached("chr2"));
+        }
+    }
+
+    @Test
+    public void testCRAIWithUnconventionalNameDetectedByContent() throws IOException {
+        // the index type cannot be told from this name, so both the cached and uncached paths must look at the content
+        final Path index = Files.createTempFile("IndexCacheTest", ".idx");
+        IOUtil.deleteOnExit(index);
+        Files.copy(new File(CRAM_FILE.getPath() + FileExtensions.CRAM_INDEX).toPath(), index,
+                StandardCopyOption.REPLACE_EXISTING);
+        final SamReaderFactory factory = SamReaderFactory.makeDefault().referenceSequence(CRAM_REFERENCE);
+
+        final int uncached;
+        try (final SamReader reader = factory.open(SamInputResource.of(CRAM_FILE).index(index.toFile()))) {
+            Assert.assertTrue(reader.hasIndex());
+            uncached = countRecords(reader, "20", 100009, 100011);
+        }
+        Assert.assertTrue(uncached > 0);
+
+        IndexCache.setMaximumSize(4);
+        try (final SamReader reader = factory.open(SamInputResource.of(CRAM_FILE).index(index.toFile()))) {
+            Assert.assertNotNull(reader.indexing().getIndex());
+            Assert.assertEquals(countRecords(reader, "20", 100009, 100011), uncached);
+        }
+    }
+
+    private static int countRecordsUncached(final String contig) throws IOException {
+        final int size = IndexCache.getMaximumSize();
+        IndexCache.setMaximumSize(0);
+        try (final SamReader reader = SamReaderFactory.makeDefault().open(BAM_FILE)) {
+            return countRecords(reader, contig, 1, 100000000);
+        } finally {
+            IndexCache.setMaximumSize(size);
+        }
+    }
+
+    private static int countRecords(final SamReader reader, final String contig, final int start, final int end) {
+        int count = 0;
+        try (final SAMRecordIterator it = reader.queryOverlapping(contig, start, end)) {
+            while (it.hasNext()) {
+                final SAMRecord rec = it.next();
+                Assert.assertEquals(rec.getContig(), contig);
+                count++;
+            }
+        }
+        return count;
+    }
+}
@@ -1,6 +1,7 @@
 package htsjdk.samtools.util;
 
 import htsjdk.HtsjdkTest;
+import htsjdk.samtools.SAMException;
 import htsjdk.samtools.SAMFileHeader;
 import htsjdk.variant.utils.SAMSequenceDictionaryExtractor;
 import org.testng.Assert;
@@ -11,7 +12,10 @@ import org.testng.annotations.Test;
 import java.io.IOException;
 import java.util.ArrayList;
 import java.util.Iterator;
+import java.util.Arrays;
+import java.util.Collections;
 import java.util.List;
+import java.util.Random;
 
 public class IntervalUtilTest extends HtsjdkTest {
 
@@ -48,4 +52,60 @@ public class IntervalUtilTest extends HtsjdkTest {
         Assert.assertEquals(expectedResult, combiner.combine(intervalList));
 
     }
-}
\ No newline at end of file
+
+    private IntervalList randomSortedList(final Random random, final int n) {
+        final IntervalList list = new IntervalList(header.clone());
+        for (int i = 0; i < n; i++) {
+            final String contig = String.valueOf(1 + random.nextInt(3));
+            final int start = 1 + random.nextInt(2000);
+            list.add(new Interval(contig, start, start + random.nextInt(100), false, "i" + i));
+        }
+        return list.sorted();
+    }
+
+    private static List<Interval> toList(final Iterator<Interval> iterator) {
+        return new ArrayList<>(CollectionUtil.makeCollection(iterator));
+    }
+
+    @Test
+    public void testSortedOperationsMatchIntervalList() {
+        final Random random = new Random(42);
+        for (int i = 0; i < 50; i++) {
+            final IntervalList list1 = randomSortedList(random, random.nextInt(60));
+            final IntervalList list2 = randomSortedList(random, random.nextInt(60));
+            final IntervalList list3 = randomSortedList(random, random.nextInt(60));
+
+            Assert.assertEquals(
+                    toList(IntervalUtil.intersectSorted(header.getSequenceDictionary(), list1.iterator(), list2.iterator())),
+                    IntervalList.intersection(list1, list2).getIntervals());
+            Assert.assertEquals(
+                    toList(IntervalUtil.subtractSorted(header.getSequenceDictionary(), list1.iterator(), list2.iterator())),
+                    IntervalList.subtract(list1, list2).getIntervals());
+            Assert.assertEquals(
+                    toList(IntervalUtil.unionSorted(header.getSequenceDictionary(),
+                            Arrays.asList(list1.iterator(), list2.iterator(), list3.iterator()), true)),
+                    IntervalList.union(Arrays.asList(list1, list2, list3)).getIntervals());
+            Assert.assertEquals(
+                    toList(IntervalUtil.intersectSorted(header.getSequenceDictionary(),
+                            Arrays.asList(list1.iterator(), list2.iterator(), list3.iterator()))),
+                    IntervalList.intersection(Arrays.asList(list1, list2, list3)).getIntervals());
+        }
+    }
+
+    @Test
+    public void testMergeSorted() {
+        final List<Interval> merged = toList(IntervalUtil.mergeSorted(header.getSequenceDictionary(), Arrays.asList(
+                Arrays.asList(new Interval("1", 10, 20), new Interval("2", 5, 6)).iterator(),
+                Arrays.asList(new Interval("1", 15, 30), new Interval("3", 1, 2)).iterator())));
+        Assert.assertEquals(merged, Arrays.asList(
+                new Interval("1", 10, 20), new Interval("1", 15, 30), new Interval("2", 5, 6), new Interval("3", 1, 2)));
+        Assert.assertFalse(IntervalUtil.mergeSorted(header.getSequenceDictionary(), Collections.emptyList()).hasNext());
+    }
+
+    @Test(expectedExceptions = SAMException.class)
+    public void testIntersectSortedUnsortedInput() {
+        final Iterator<Interval> unsorted = Arrays.asList(new Interval("2", 10, 20), new Interval("1", 15, 30)).iterator();
+        toList(IntervalUtil.intersectSorted(header.getSequenceDictionary(), unsorted,
+                Collections.singletonList(new Interval("1", 1, 100)).iterator()));
+    }
+}
@@ -0,0 +1,111 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.samtools.util;
+
+import htsjdk.HtsjdkTest;
+import org.testng.Assert;
+import org.testng.annotations.DataProvider;
+import org.testng.annotations.Test;
+
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.Comparator;
+import java.util.Iterator;
+import java.util.List;
+import java.util.Random;
+import java.util.function.ToLongFunction;
+
+public class LoserTreeTest extends HtsjdkTest {
+
+    /** An element of a source: the value compared, plus the source it came from */
+    private static final class Element {
+        final int value;
+        final int source;
+
+        Element(final int value, final int source) {
+            this.value = value;
+            this.source = source;
+        }
+    }
+
+    private static final Comparator<Element> BY_VALUE = Comparator.comparingInt(e -> e.value);
+
+    @DataProvider(name = "numSources")
+    public Object[][] numSources() {
+        return new Object[][]{{1}, {2}, {3}, {7}, {8}, {33}, {100}};
+    }
+
+    @Test(dataProvider = "numSources")
+    public void testMergeMatchesStableSort(final int numSources) {
+        // the key only distinguishes values by tens, leaving the rest to the comparator
+        testMerge(numSources, null);
+        testMerge(numSources, e -> e.value / 10);
+    }
+
+    private void testMerge(final int numSources, final ToLongFunction<Element> key) {
+        final Random random = new Random(numSources);
+        final List<Iterator<Element>> sources = new ArrayList<>();
+        final List<Element> all = new ArrayList<>();
+        for (int source = 0; source < numSources; source++) {
+            final List<Element> elements = new ArrayList<>();
+            // some sources are empty
+            final int size = random.nextInt(4) == 0 ? 0 : random.nextInt(50);
+            for (int i = 0; i < size; i++) {
+                elements.add(new Element(random.nextInt(100), source));
+            }
+            elements.sort(BY_VALUE);
+            all.addAll(elements);
+            sources.add(elements.iterator());
+        }
+        // a stable sort of the elements in source order is the expected merge, as ties are broken by source
+        all.sort(BY_VALUE);
+
+        final List<Element> heads = new ArrayList<>();
+        for (final Iterator<Element> source : sources) {
+            heads.add(source.hasNext() ? source.next() : null);
+        }
+        final LoserTree<Element> tree = new LoserTree<>(heads, BY_VALUE, key);
+        Assert.assertEquals(tree.numSources(), numSources);
+        final List<Element> merged = new ArrayList<>();
+        while (!tree.isEmpty()) {
+            final Iterator<Element> source = sources.get(tree.peekSource());
+            Assert.assertEquals(tree.peek().source, tree.peekSource());
+            merged.add(tree.replaceTop(source.hasNext() ? source.next() : null));
+        }
+        Assert.assertNull(tree.peek());
+        Assert.assertEquals(merged, all);
+    }
+
+    @Test
+    public void testAllSourcesEmpty() {
+        final LoserTree<Element> tree = new LoserTree<>(Collections.<Element>nCopies(5, null), BY_VALUE);
+        Assert.assertTrue(tree.isEmpty());
+        Assert.assertNull(tree.peek());
+    }
+
+    @Test(expectedExceptions = IllegalArgumentException.class)
+    public void testNoSources() {
+        new LoserTree<>(Collections.<Element>emptyList(), BY_VALUE);
+    }
+}
@@ -117,6 +117,37 @@ public class OverlapDetectorTest extends HtsjdkTest {
         Assert.assertEquals(new HashSet<>(targetDetector.getAll()), new HashSet<>(input));
     }
 
+    @Test(dataProvider = "intervalsSameContig")
+    public void testOverlapFrozen(final List<Locatable> input, final Interval query, final List<Locatable> expected) throws Exception {
+        final OverlapDetector<Locatable> targetDetector = OverlapDetector.createFrozen(input);
+        Assert.assertTrue(targetDetector.isFrozen());
+
+        final Set<Locatable> actual = targetDetector.getOverlaps(query);
+        Assert.assertEquals(actual, new HashSet<>(expected));
+
+        Assert.assertEquals(targetDetector.overlapsAny(query), !expected.isEmpty());
+
+        Assert.assertEquals(new HashSet<>(targetDetector.getAll()), new HashSet<>(input));
+    }
+
+    @Test(dataProvider = "intervalsMultipleContigs")
+    public void testOverlapFrozenMultipleContigs(final List<Locatable> input, final Locatable query, final Collection<Locatable> expected) throws Exception {
+        final OverlapDetector<Locatable> targetDetector = new OverlapDetector<>(0, 0);
+        targetDetector.addAll(input, input);
+        targetDetector.freeze();
+
+        Assert.assertEquals(targetDetector.getOverlaps(query), new HashSet<>(expected));
+    }
+
+    @Test(expectedExceptions = IllegalStateException.class)
+    public void testAddAfterFreeze() throws Exception {
+        final List<Locatable> input = Arrays.asList(
+                new Interval("1",10,100)
+        );
+        final OverlapDetector<Locatable> targetDetector = OverlapDetector.createFrozen(input);
+        targetDetector.addLhs(new Interval("2",10,100), new Interval("2",10,100));
+    }
+
     @Test(expectedExceptions = IllegalArgumentException.class)
     public void testOverlapsNullArg() throws Exception {
         final List<Locatable> input = Arrays.asList(
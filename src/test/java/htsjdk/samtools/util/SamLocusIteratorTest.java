@@ -25,8 +25,13 @@ package htsjdk.samtools.util;
 
 import htsjdk.samtools.SAMRecordSetBuilder;
 import org.testng.Assert;
+import org.testng.annotations.DataProvider;
 import org.testng.annotations.Test;
 
+import java.util.ArrayList;
+import java.util.List;
+import java.util.Random;
+
 /**
  * @author alecw@broadinstitute.org
  * @author Mariia_Zueva@epam.com, EPAM Systems, Inc. <www.epam.com>
@@ -813,4 +818,85 @@ public class SamLocusIteratorTest extends AbstractLocusIteratorTestTemplate {
         }
     }
 
+    /** Builds reads with random starts, strands, qualities and gapped CIGARs, some spanning more than 1024 loci */
+    private static SAMRecordSetBuilder getRandomRecordBuilder() {
+        final SAMRecordSetBuilder builder = getRecordBuilder();
+        final Random random = new Random(42);
+        final String[] cigars = {"36M", "10M5D26M", "5S31M", "10M2I24M", "20M100N16M", "10M2000N26M"};
+        for (int i = 0; i < 300; i++) {
+            builder.addFrag("record" + i, 0, 1 + random.nextInt(3000), random.nextBoolean(), false,
+                    cigars[random.nextInt(cigars.length)], null, -1, i % 50 == 0);
+        }
+        return builder;
+    }
+
+    private static List<String> describeLocusInfos(final SamLocusIterator sli) {
+        final List<String> loci = new ArrayList<>();
+        for (final SamLocusIterator.LocusInfo li : sli) {
+            final StringBuilder locus = new StringBuilder(li.toString());
+            for (final SamLocusIterator.RecordAndOffset rao : li.getRecordAndOffsets()) {
+                locus.append(' ').append(rao.getReadName()).append('/').append(rao.getOffset()).append('/')
+                        .append((char) rao.getReadBase()).append('/').append(rao.getBaseQuality()).append('/')
+                        .append(rao.getRecord().getReadNegativeStrandFlag());
+            }
+            loci.add(locus.toString());
+        }
+        sli.close();
+        return loci;
+    }
+
+    private static List<String> describePileups(final SamLocusIterator sli) {
+        final List<String> loci = new ArrayList<>();
+        sli.forEachPileup(pileup -> {
+            final StringBuilder locus = new StringBuilder(pileup.toString());
+            for (int i = 0; i < pileup.size(); i++) {
+                locus.append(' ').append(pileup.getRecord(i).getReadName()).append('/').append(pileup.getReadOffset(i)).append('/')
+                        .append((char) pileup.getBase(i)).append('/').append(pileup.getBaseQuality(i)).append('/')
+                        .append(pileup.isNegativeStrand(i));
+            }
+            loci.add(locus.toString());
+        });
+        sli.close();
+        return loci;
+    }
+
+    @DataProvider
+    public Object[][] pileupParameters() {
+        final IntervalList intervals = new IntervalList(header);
+        intervals.add(new Interval("chrM", 1, 50));
+        intervals.add(new Interval("chrM", 500, 1500));
+        intervals.add(new Interval("chrM", 4000, 6000));
+        return new Object[][]{
+                // intervals, emitUncoveredLoci, qualityScoreCutoff, maxReadsToAccumulatePerLocus
+                {null, false, 0, Integer.MAX_VALUE},
+                {null, true, 0, Integer.MAX_VALUE},
+                {null, false, 20, Integer.MAX_VALUE},
+                {null, false, 0, 3},
+                {intervals, false, 0, Integer.MAX_VALUE},
+                {intervals, true, 10, Integer.MAX_VALUE},
+        };
+    }
+
+    @Test(dataProvider = "pileupParameters")
+    public void testForEachPileupMatchesLocusInfos(final IntervalList intervals, final boolean emitUncoveredLoci,
+                                                   final int qualityScoreCutoff, final int maxReadsToAccumulatePerLocus) {
+        final SAMRecordSetBuilder builder = getRandomRecordBuilder();
+        final List<List<String>> results = new ArrayList<>();
+        for (final boolean usePileups : new boolean[]{false, true}) {
+            final SamLocusIterator sli = new SamLocusIterator(builder.getSamReader(), intervals);
+            sli.setEmitUncoveredLoci(emitUncoveredLoci);
+            sli.setQualityScoreCutoff(qualityScoreCutoff);
+            sli.setMaxReadsToAccumulatePerLocus(maxReadsToAccumulatePerLocus);
+            results.add(usePileups ? describePileups(sli) : describeLocusInfos(sli));
+        }
+        Assert.assertFalse(results.get(0).isEmpty());
+        Assert.assertEquals(results.get(1), results.get(0));
+    }
+
+    @Test(expectedExceptions = IllegalStateException.class)
+    public void testForEachPileupAfterIterating() {
+        final SamLocusIterator sli = createSamLocusIterator(getRandomRecordBuilder());
+        sli.iterator();
+        sli.forEachPileup(pileup -> {});
+    }
 }
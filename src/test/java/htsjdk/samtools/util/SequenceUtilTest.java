@@ -653,4 +653,31 @@ public class SequenceUtilTest extends HtsjdkTest {
         final Random random = new Random(42);
         Assert.assertEquals(SequenceUtil.getRandomBases(random, 100), "GAGACTCGGATCCCCGCTTTTACCGTCTAAGCACTCAAGCTGGAGATTACCATACTTAGGCTCATGTAGCCACCCGCGCTCGTAAATTCTCGACATTCCG".getBytes());
     }
+
+    @Test
+    public void testCountMismatchesInRangesMatchesBasesEqual() {
+        final Random random = new Random(17);
+        // a mix of upper and lower case bases, IUPAC codes, no-calls and bytes that are not bases at all
+        final byte[] alphabet = "ACGTacgtNnRYMKSWBDHV.*-=\u0000\u007f".getBytes();
+        for (int trial = 0; trial < 100; trial++) {
+            final byte[] read = new byte[200];
+            final byte[] reference = new byte[220];
+            for (int i = 0; i < reference.length; i++) {
+                reference[i] = random.nextInt(10) == 0 ? (byte) random.nextInt(256) : alphabet[random.nextInt(alphabet.length)];
+            }
+            for (int i = 0; i < read.length; i++) {
+                // mostly identical to the reference, as real reads are
+                read[i] = random.nextInt(4) == 0 ? alphabet[random.nextInt(alphabet.length)] : reference[i + 20];
+            }
+            final int readStart = random.nextInt(50);
+            final int length = random.nextInt(read.length - readStart);
+            int expected = 0;
+            for (int i = 0; i < length; i++) {
+                if (!SequenceUtil.basesEqual(read[readStart + i], reference[readStart + 20 + i])) {
+                    expected++;
+                }
+            }
+            Assert.assertEquals(SequenceUtil.countMismatches(read, readStart, reference, readStart + 20, length), expected);
+        }
+    }
 }
@@ -0,0 +1,215 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.samtools.util;
+
+import htsjdk.HtsjdkTest;
+import htsjdk.samtools.SAMFileHeader;
+import htsjdk.samtools.SAMFileWriter;
+import htsjdk.samtools.SAMFileWriterFactory;
+import htsjdk.samtools.SAMRecord;
+import htsjdk.samtools.SAMRecordSetBuilder;
+import htsjdk.samtools.SAMSequenceDictionary;
+import htsjdk.samtools.SAMSequenceRecord;
+import htsjdk.samtools.SamReader;
+import htsjdk.samtools.SamReaderFactory;
+import org.testng.Assert;
+import org.testng.annotations.BeforeClass;
+import org.testng.annotations.DataProvider;
+import org.testng.annotations.Test;
+
+import java.io.File;
+import java.io.IOException;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.Random;
+import java.util.function.BiFunction;
+import java.util.function.Supplier;
+
+public class ShardedLocusWalkerTest extends HtsjdkTest {
+    private File bam;
+    private SAMFileHeader header;
+
+    @BeforeClass
+    public void writeBam() throws IOException {
+        header = new SAMFileHeader();
+        header.setSortOrder(SAMFileHeader.SortOrder.coordinate);
+        final SAMSequenceDictionary dict = new SAMSequenceDictionary();
+        dict.addSequence(new SAMSequenceRecord("chrA", 5000));
+        dict.addSequence(new SAMSequenceRecord("chrB", 3000));
+        header.setSequenceDictionary(dict);
+
+        final SAMRecordSetBuilder builder = new SAMRecordSetBuilder();
+        builder.setHeader(header);
+        builder.setReadLength(36);
+        final Random random = new Random(7);
+        final String[] cigars = {"36M", "10M5D26M", "5S31M", "20M300N16M"};
+        for (int i = 0; i < 400; i++) {
+            final int contig = random.nextInt(2);
+            builder.addFrag("read" + i, contig, 1 + random.nextInt(contig == 0 ? 4500 : 2500), random.nextBoolean(),
+                    false, cigars[random.nextInt(cigars.length)], null, 30);
+        }
+
+        bam = File.createTempFile("ShardedLocusWalkerTest.", ".bam");
+        bam.deleteOnExit();
+        new File(bam.getPath().replaceAll("\\.bam$", ".bai")).deleteOnExit();
+        try (final SAMFileWriter writer = new SAMFileWriterFactory().setCreateIndex(true).makeBAMWriter(header, false, bam)) {
+            for (final SAMRecord rec : builder.getRecords()) {
+                writer.addAlignment(rec);
+            }
+        }
+    }
+
+    private Supplier<SamReader> readers() {
+        return () -> SamReaderFactory.makeDefault().open(bam);
+    }
+
+    private static BiFunction<SamReader, IntervalList, SamLocusIterator> locusIterators(final boolean emitUncoveredLoci) {
+        return (reader, intervals) -> {
+            final SamLocusIterator iterator = new SamLocusIterator(reader, intervals, true);
+            iterator.setEmitUncoveredLoci(emitUncoveredLoci);
+            return iterator;
+        };
+    }
+
+    private static String describe(final SamLocusIterator.LocusInfo locus) {
+        final StringBuilder description = new StringBuilder(locus.toString());
+        for (final SamLocusIterator.RecordAndOffset rao : locus.getRecordAndOffsets()) {
+            description.append(' ').append(rao.getReadName()).append('/').append(rao.getOffset());
+        }
+        return description.toString();
+    }
+
+    private List<String> walkSerially(final IntervalList intervals, final boolean emitUncoveredLoci) throws IOException {
+        final List<String> loci = new ArrayList<>();
+        try (final SamReader reader = readers().get();
+             final SamLocusIterator iterator = locusIterators(emitUncoveredLoci).apply(reader, intervals)) {
+            iterator.forEachRemaining(locus -> loci.add(describe(locus)));
+        }
+        return loci;
+    }
+
+    @DataProvider
+    public Object[][] shardingParameters() {
+        return new Object[][]{
+                // use intervals, emitUncoveredLoci, numThreads, shardSize
+                {false, false, 1, 1000},
+                {false, false, 4, 100},
+                {false, true, 4, 333},
+                {true, false, 3, 50},
+                {true, true, 2, 7},
+                // shards with more loci than are buffered for the iterator
+                {false, true, 2, ShardedLocusWalker.DEFAULT_SHARD_SIZE},
+        };
+    }
+
+    private IntervalList intervals(final boolean useIntervals) {
+        if (!useIntervals) {
+            return null;
+        }
+        final IntervalList intervals = new IntervalList(header);
+        intervals.add(new Interval("chrA", 100, 1200));
+        intervals.add(new Interval("chrA", 4000, 4600));
+        intervals.add(new Interval("chrB", 1, 400));
+        return intervals;
+    }
+
+    @Test(dataProvider = "shardingParameters")
+    public void testIteratorMatchesSerialWalk(final boolean useIntervals, final boolean emitUncoveredLoci,
+                                              final int numThreads, final int shardSize) throws IOException {
+        final IntervalList intervals = intervals(useIntervals);
+        final List<String> expected = walkSerially(intervals, emitUncoveredLoci);
+        final List<String> actual = new ArrayList<>();
+        try (final ShardedLocusWalker<SamLocusIterator.LocusInfo> walker = new ShardedLocusWalker<>(
+                readers(), locusIterators(emitUncoveredLoci), intervals, numThreads, shardSize);
+             final CloseableIterator<SamLocusIterator.LocusInfo> loci = walker.iterator()) {
+            loci.forEachRemaining(locus -> actual.add(describe(locus)));
+        }
+        Assert.assertFalse(expected.isEmpty());
+        Assert.assertEquals(actual, expected);
+    }
+
+    @Test(dataProvider = "shardingParameters")
+    public void testReduceShards(final boolean useIntervals, final boolean emitUncoveredLoci,
+                                 final int numThreads, final int shardSize) throws IOException {
+        final IntervalList intervals = intervals(useIntervals);
+        long expectedDepth = 0;
+        for (final String locus : walkSerially(intervals, emitUncoveredLoci)) {
+            expectedDepth += locus.split(" ").length - 1;
+        }
+        try (final ShardedLocusWalker<SamLocusIterator.LocusInfo> walker = new ShardedLocusWalker<>(
+                readers(), locusIterators(emitUncoveredLoci), intervals, numThreads, shardSize)) {
+            final List<Long> depths = walker.reduceShards((shard, loci) -> {
+                long depth = 0;
+                while (loci.hasNext()) {
+                    final SamLocusIterator.LocusInfo locus = loci.next();
+                    Assert.assertTrue(shard.getContig().equals(locus.getContig()) &&
+                            shard.getStart() <= locus.getPosition() && locus.getPosition() <= shard.getEnd());
+                    depth += locus.getRecordAndOffsets().size();
+                }
+                return depth;
+            });
+            Assert.assertEquals(depths.size(), walker.getShards().size());
+            Assert.assertEquals(depths.stream().mapToLong(Long::longValue).sum(), expectedDepth);
+        }
+    }
+
+    @Test
+    public void testCloseIteratorWithShardsInFlight() {
+        try (final ShardedLocusWalker<SamLocusIterator.LocusInfo> walker = new ShardedLocusWalker<>(
+                readers(), locusIterators(true), null, 2, ShardedLocusWalker.DEFAULT_SHARD_SIZE)) {
+            // the workers are waiting for the iterator to take their loci, and must stop once it is closed
+            for (int i = 0; i < 3; i++) {
+                try (final CloseableIterator<SamLocusIterator.LocusInfo> loci = walker.iterator()) {
+                    Assert.assertEquals(loci.next().getPosition(), 1);
+                }
+            }
+        }
+    }
+
+    @Test(expectedExceptions = IllegalStateException.class)
+    public void testIteratorRaisesErrorWalkingShard() {
+        final BiFunction<SamReader, IntervalList, SamLocusIterator> failing = (reader, intervals) -> {
+            throw new IllegalStateException("cannot walk " + intervals.getIntervals());
+        };
+        try (final ShardedLocusWalker<SamLocusIterator.LocusInfo> walker = new ShardedLocusWalker<>(
+                readers(), failing, null, 2, 1000);
+             final CloseableIterator<SamLocusIterator.LocusInfo> loci = walker.iterator()) {
+            loci.hasNext();
+        }
+    }
+
+    @Test
+    public void testShards() {
+        try (final ShardedLocusWalker<SamLocusIterator.LocusInfo> walker = new ShardedLocusWalker<>(
+                readers(), locusIterators(false), null, 1, 2000)) {
+            final List<Interval> expected = new ArrayList<>();
+            expected.add(new Interval("chrA", 1, 2000));
+            expected.add(new Interval("chrA", 2001, 4000));
+            expected.add(new Interval("chrA", 4001, 5000));
+            expected.add(new Interval("chrB", 1, 2000));
+            expected.add(new Interval("chrB", 2001, 3000));
+            Assert.assertEquals(walker.getShards(), expected);
+        }
+    }
+}
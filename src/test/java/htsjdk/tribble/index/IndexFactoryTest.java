@@ -32,6 +32,8 @@ import htsjdk.samtools.SAMSequenceRecord;
 import htsjdk.samtools.util.IOUtil;
 import htsjdk.samtools.util.Interval;
 import htsjdk.tribble.AbstractFeatureReader;
+import htsjdk.tribble.Feature;
+import htsjdk.tribble.FeatureCodec;
 import htsjdk.tribble.TestUtils;
 import htsjdk.tribble.Tribble;
 import htsjdk.tribble.TribbleException;
@@ -40,6 +42,7 @@ import htsjdk.tribble.bed.BEDCodec;
 import htsjdk.tribble.index.tabix.TabixFormat;
 import htsjdk.tribble.index.tabix.TabixIndex;
 import htsjdk.tribble.readers.LineIterator;
+import htsjdk.tribble.util.LittleEndianOutputStream;
 import htsjdk.variant.bcf2.BCF2Codec;
 import htsjdk.variant.variantcontext.VariantContext;
 import htsjdk.variant.vcf.VCFCodec;
@@ -48,13 +51,23 @@ import org.testng.Assert;
 import org.testng.annotations.DataProvider;
 import org.testng.annotations.Test;
 
+import java.io.ByteArrayOutputStream;
 import java.io.File;
 import java.io.IOException;
 import java.nio.file.FileSystem;
 import java.nio.file.Path;
 import java.nio.file.Paths;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.HashMap;
 import java.util.Iterator;
 import java.util.List;
+import java.util.Map;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.function.Supplier;
 
 /**
  * User: jacob
@@ -273,4 +286,111 @@ public class IndexFactoryTest extends HtsjdkTest {
             IOUtil.recursiveDelete(dir.toPath());
         }
     }
+
+    @DataProvider(name = "lazyIndexProvider")
+    public Object[][] getLazyIndexData() {
+        final File vcf = new File(TestUtils.DATA_DIR, "trioDup.vcf");
+        final File bed = new File(TestUtils.DATA_DIR, "bed/NA12878.deletions.10kbp.het.gq99.hand_curated.hg19_fixed.bed");
+        final Supplier<FeatureCodec<? extends Feature, LineIterator>> vcfCodec = VCFCodec::new;
+        final Supplier<FeatureCodec<? extends Feature, LineIterator>> bedCodec = BEDCodec::new;
+        return new Object[][] {
+                { vcf, vcfCodec, IndexFactory.IndexType.LINEAR },
+                { vcf, vcfCodec, IndexFactory.IndexType.INTERVAL_TREE },
+                { bed, bedCodec, IndexFactory.IndexType.LINEAR },
+                { bed, bedCodec, IndexFactory.IndexType.INTERVAL_TREE }
+        };
+    }
+
+    @Test(dataProvider = "lazyIndexProvider")
+    public void testLoadIndexLazily(final File input, final Supplier<FeatureCodec<? extends Feature, LineIterator>> codec, final IndexFactory.IndexType type) throws IOException {
+        final File idxFile = File.createTempFile("lazyIndex", ".idx");
+        idxFile.deleteOnExit();
+        IndexFactory.createIndex(input, codec.get(), type).write(idxFile.toPath());
+
+        final Index eager = IndexFactory.loadIndex(idxFile.getAbsolutePath());
+        final Index lazy = IndexFactory.loadIndexLazily(idxFile.toPath());
+        Assert.assertEquals(lazy.getClass(), eager.getClass());
+        Assert.assertTrue(eager.getSequenceNames().size() > 1);
+        Assert.assertEquals(lazy.getSequenceNames(), eager.getSequenceNames());
+        Assert.assertFalse(lazy.containsChromosome("no_such_contig"));
+
+        // query the chromosomes in reverse order, so they are not loaded in file order
+        final List<String> contigs = new ArrayList<>(eager.getSequenceNames());
+        Collections.reverse(contigs);
+        for (final String contig : contigs) {
+            Assert.assertTrue(lazy.containsChromosome(contig));
+            Assert.assertEquals(lazy.getBlocks(contig, 1, 300_000_000), eager.getBlocks(contig, 1, 300_000_000), contig);
+        }
+        Assert.assertEquals(lazy.getSequenceNames(), eager.getSequenceNames());
+        Assert.assertEquals(serialize(lazy), serialize(eager));
+    }
+
+    private static byte[] serialize(final Index index) throws IOException {
+        final ByteArrayOutputStream bytes = new ByteArrayOutputStream();
+        try (final LittleEndianOutputStream out = new LittleEndianOutputStream(bytes)) {
+            index.write(out);
+        }
+        return bytes.toByteArray();
+    }
+
+    @Test(dataProvider = "lazyIndexProvider")
+    public void testLazyIndexSharedBetweenReaders(final File input, final Supplier<FeatureCodec<? extends Feature, LineIterator>> codec, final IndexFactory.IndexType type) throws Exception {
+        final File idxFile = File.createTempFile("lazyIndex", ".idx");
+        idxFile.deleteOnExit();
+        IndexFactory.createIndex(input, codec.get(), type).write(idxFile.toPath());
+        final Index lazy = IndexFactory.loadIndexLazily(idxFile.toPath());
+
+        final Map<String, Long> expected = new HashMap<>();
+        try (final AbstractFeatureReader<? extends Feature, LineIterator> reader = AbstractFeatureReader.getFeatureReader(input.getAbsolutePath(), codec.get(), false)) {
+            for (final Feature feature : reader.iterator()) {
+                expected.merge(feature.getContig(), 1L, Long::sum);
+            }
+        }
+
+        // several readers on different threads querying through the same index
+        final ExecutorService executor = Executors.newFixedThreadPool(4);
+        try {
+            final List<Future<Map<String, Long>>> results = new ArrayList<>();
+            for (int i = 0; i < 4; i++) {
+                results.add(executor.submit(() -> {
+                    final Map<String, Long> counts = new HashMap<>();
+                    try (final AbstractFeatureReader<? extends Feature, LineIterator> reader = AbstractFeatureReader.getFeatureReader(input.getAbsolutePath(), codec.get(), lazy)) {
+                        for (final String contig : reader.getSequenceNames()) {
+                            counts.put(contig, reader.query(contig, 1, 300_000_000).stream().count());
+                        }
+                    }
+                    return counts;
+                }));
+            }
+            for (final Future<Map<String, Long>> result : results) {
+                Assert.assertEquals(result.get(), expected);
+            }
+        } finally {
+            executor.shutdownNow();
+        }
+    }
+
+    @Test
+    public void testLoadIndexLazilyOnNonDefaultFileSystem() throws IOException {
+        final File input = new File(TestUtils.DATA_DIR, "trioDup.vcf");
+        final Index index = IndexFactory.createIndex(input, new VCFCodec(), IndexFactory.IndexType.INTERVAL_TREE);
+        try (final FileSystem fs = Jimfs.newFileSystem("test", Configuration.unix())) {
+            final Path idxPath = fs.getPath("trioDup.vcf.idx");
+            index.write(idxPath);
+            final Index lazy = IndexFactory.loadIndexLazily(idxPath);
+            Assert.assertEquals(lazy.getSequenceNames(), index.getSequenceNames());
+            Assert.assertEquals(lazy.getBlocks("20", 1, 300_000_000), index.getBlocks("20", 1, 300_000_000));
+        }
+    }
+
+    @Test(expectedExceptions = TribbleException.CorruptedIndexFile.class)
+    public void testLoadIndexLazilyTruncated() throws IOException {
+        final File input = new File(TestUtils.DATA_DIR, "trioDup.vcf");
+        final File idxFile = File.createTempFile("lazyIndex", ".idx");
+        idxFile.deleteOnExit();
+        IndexFactory.createIndex(input, new VCFCodec(), IndexFactory.IndexType.LINEAR).write(idxFile.toPath());
+        final byte[] bytes = java.nio.file.Files.readAllBytes(idxFile.toPath());
+        java.nio.file.Files.write(idxFile.toPath(), Arrays.copyOf(bytes, bytes.length - 16));
+        IndexFactory.loadIndexLazily(idxFile.toPath());
+    }
 }
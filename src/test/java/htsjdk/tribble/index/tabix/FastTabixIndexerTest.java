@@ -0,0 +1,89 @@
+package htsjdk.tribble.index.tabix;
+
+import htsjdk.HtsjdkTest;
+import htsjdk.samtools.util.BlockCompressedOutputStream;
+import htsjdk.tribble.FeatureCodec;
+import htsjdk.tribble.TestUtils;
+import htsjdk.tribble.TribbleException;
+import htsjdk.tribble.bed.BEDCodec;
+import htsjdk.tribble.index.IndexFactory;
+import htsjdk.variant.vcf.VCFCodec;
+import org.testng.Assert;
+import org.testng.annotations.DataProvider;
+import org.testng.annotations.Test;
+
+import java.io.File;
+import java.io.IOException;
+import java.io.OutputStream;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Path;
+
+public class FastTabixIndexerTest extends HtsjdkTest {
+
+    @DataProvider(name = "indexableFiles")
+    public Object[][] indexableFiles() {
+        final File yri = new File(TestUtils.DATA_DIR, "tabix/YRI.trio.2010_07.indel.sites.vcf.gz");
+        final File small = new File(TestUtils.DATA_DIR, "tabix/testTabixIndex.vcf.gz");
+        final File hg38 = new File(TestUtils.DATA_DIR, "tabix/4featuresHG38Header.vcf.gz");
+        final File bed = new File(TestUtils.DATA_DIR, "bed/Unigene.sample.bed.gz");
+        return new Object[][]{
+                {yri, new VCFCodec(), TabixFormat.VCF, 1, FastTabixIndexer.DEFAULT_BLOCKS_PER_TASK},
+                {yri, new VCFCodec(), TabixFormat.VCF, 4, FastTabixIndexer.DEFAULT_BLOCKS_PER_TASK},
+                {yri, new VCFCodec(), TabixFormat.VCF, 4, 1},
+                {yri, new VCFCodec(), TabixFormat.VCF, 3, 2},
+                {small, new VCFCodec(), TabixFormat.VCF, 2, 1},
+                {hg38, new VCFCodec(), TabixFormat.VCF, 2, 1},
+                {bed, new BEDCodec(), TabixFormat.BED, 1, 1},
+                {bed, new BEDCodec(), TabixFormat.BED, 2, 1},
+        };
+    }
+
+    @Test(dataProvider = "indexableFiles")
+    public void testMatchesCodecBasedIndex(final File input, final FeatureCodec<?, ?> codec, final TabixFormat format,
+                                           final int numThreads, final int blocksPerTask) {
+        final TabixIndex expected = IndexFactory.createTabixIndex(input.toPath(), codec, format, null);
+        final TabixIndex actual = new FastTabixIndexer(format, null, numThreads, blocksPerTask).createIndex(input.toPath());
+        Assert.assertEquals(actual, expected);
+    }
+
+    @Test
+    public void testIndexFactoryEntryPoint() {
+        final Path input = new File(TestUtils.DATA_DIR, "tabix/YRI.trio.2010_07.indel.sites.vcf.gz").toPath();
+        Assert.assertEquals(
+                IndexFactory.createTabixIndexWithoutDecoding(input, TabixFormat.VCF, null, 2),
+                IndexFactory.createTabixIndex(input, new VCFCodec(), TabixFormat.VCF, null));
+    }
+
+    @Test
+    public void testEndKeyAndCarriageReturns() throws IOException {
+        final File vcf = File.createTempFile("fastTabixIndexer", ".vcf.gz");
+        vcf.deleteOnExit();
+        final String text = "##fileformat=VCFv4.2\r\n" +
+                "##INFO=<ID=END,Number=1,Type=Integer,Description=\"End\">\r\n" +
+                "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\r\n" +
+                "1\t100\t.\tA\t<DEL>\t.\t.\tEND=5000\r\n" +
+                "1\t200\t.\tACGT\tA\t.\t.\t.\r\n" +
+                "2\t10\t.\tA\tC\t.\t.\tAB=1;END=20000\r\n";
+        try (final OutputStream out = new BlockCompressedOutputStream(vcf)) {
+            out.write(text.getBytes(StandardCharsets.US_ASCII));
+        }
+        Assert.assertEquals(
+                new FastTabixIndexer(TabixFormat.VCF, null, 1).createIndex(vcf.toPath()),
+                IndexFactory.createTabixIndex(vcf.toPath(), new VCFCodec(), TabixFormat.VCF, null));
+    }
+
+    @Test(expectedExceptions = TribbleException.MalformedFeatureFile.class)
+    public void testUnsorted() throws IOException {
+        final File bed = File.createTempFile("fastTabixIndexer", ".bed.gz");
+        bed.deleteOnExit();
+        try (final OutputStream out = new BlockCompressedOutputStream(bed)) {
+            out.write("chr1\t100\t200\nchr1\t50\t60\n".getBytes(StandardCharsets.US_ASCII));
+        }
+        new FastTabixIndexer(TabixFormat.BED, null, 1).createIndex(bed.toPath());
+    }
+
+    @Test(expectedExceptions = IllegalArgumentException.class)
+    public void testSamFormatNotSupported() {
+        new FastTabixIndexer(TabixFormat.SAM, null, 1);
+    }
+}
@@ -63,23 +63,23 @@ public class BCF2EncoderDecoderUnitTest extends VariantBaseTest {
         primitives.add(new BCF2TypedValue(-1, BCF2Type.INT8));
         primitives.add(new BCF2TypedValue(100, BCF2Type.INT8));
         primitives.add(new BCF2TypedValue(-100, BCF2Type.INT8));
-        primitives.add(new BCF2TypedValue(-127, BCF2Type.INT8));    // last value in range
+        primitives.add(new BCF2TypedValue(-120, BCF2Type.INT8));    // last value in range
         primitives.add(new BCF2TypedValue( 127, BCF2Type.INT8));    // last value in range
 
         // medium ints
         primitives.add(new BCF2TypedValue(-1000, BCF2Type.INT16));
         primitives.add(new BCF2TypedValue(1000, BCF2Type.INT16));
-        primitives.add(new BCF2TypedValue(-128, BCF2Type.INT16));    // first value in range
+        primitives.add(new BCF2TypedValue(-121, BCF2Type.INT16));    // first value in range, -128 to -121 are reserved in INT8
         primitives.add(new BCF2TypedValue( 128, BCF2Type.INT16));    // first value in range
-        primitives.add(new BCF2TypedValue(-32767, BCF2Type.INT16)); // last value in range
+        primitives.add(new BCF2TypedValue(-32760, BCF2Type.INT16)); // last value in range
         primitives.add(new BCF2TypedValue( 32767, BCF2Type.INT16)); // last value in range
 
         // larger ints
-        primitives.add(new BCF2TypedValue(-32768, BCF2Type.INT32)); // first value in range
+        primitives.add(new BCF2TypedValue(-32761, BCF2Type.INT32)); // first value in range
         primitives.add(new BCF2TypedValue( 32768, BCF2Type.INT32)); // first value in range
         primitives.add(new BCF2TypedValue(-100000, BCF2Type.INT32));
         primitives.add(new BCF2TypedValue(100000, BCF2Type.INT32));
-        primitives.add(new BCF2TypedValue(-2147483647, BCF2Type.INT32));
+        primitives.add(new BCF2TypedValue(-2147483640, BCF2Type.INT32));
         primitives.add(new BCF2TypedValue(2147483647, BCF2Type.INT32));
 
         // floats
@@ -514,6 +514,55 @@ public class BCF2EncoderDecoderUnitTest extends VariantBaseTest {
         }
     }
 
+    @Test(dataProvider = "IntArrays")
+    public void testIntArraysPaddedWithEndOfVector(final List<Integer> ints) throws IOException {
+        int nValues = 0;
+        while ( nValues < ints.size() && ints.get(nValues) != null )
+            nValues++;
+
+        // BCF 2.2 pads vectors with END_OF_VECTOR rather than MISSING values
+        final BCF2Encoder encoder = new BCF2Encoder(BCF2Codec.BCF_VERSION_2_2);
+        encoder.encodeType(ints.size(), BCF2Type.INT16);
+        for ( int i = 0; i < nValues; i++ )
+            encoder.encodeRawInt(ints.get(i), BCF2Type.INT16);
+        encoder.encodeRawPadding(nValues, ints.size(), BCF2Type.INT16);
+
+        final BCF2Decoder decoder = new BCF2Decoder(encoder.getRecordBytes());
+        decoder.setBCFVersion(BCF2Codec.BCF_VERSION_2_2);
+        final byte typeDescriptor = decoder.readTypeDescriptor();
+        final int size = decoder.decodeNumberOfElements(typeDescriptor);
+        Assert.assertEquals(size, ints.size());
+        final int[] decoded = decoder.decodeIntArray(typeDescriptor, size);
+
+        if ( nValues == 0 ) {
+            Assert.assertNull(decoded);
+        } else {
+            Assert.assertEquals(decoded.length, nValues);
+            for ( int i = 0; i < nValues; i++ )
+                Assert.assertEquals(decoded[i], (int)ints.get(i));
+        }
+        Assert.assertTrue(decoder.blockIsFullyDecoded());
+    }
+
+    @Test
+    public void testEndOfVectorValuesAreOnlyReservedInBCF22() throws IOException {
+        final BCF2Encoder encoder = new BCF2Encoder(BCF2Codec.BCF_VERSION_2_2);
+        encoder.encodeType(3, BCF2Type.INT8);
+        encoder.encodeRawInt(5, BCF2Type.INT8);
+        encoder.encodeRawPadding(1, 3, BCF2Type.INT8);
+        final byte[] bytes = encoder.getRecordBytes();
+        Assert.assertEquals(bytes[2], (byte)0x81);
+        Assert.assertEquals(bytes[3], (byte)0x81);
+
+        final BCF2Decoder decoder22 = new BCF2Decoder(bytes);
+        decoder22.setBCFVersion(BCF2Codec.BCF_VERSION_2_2);
+        Assert.assertEquals(decoder22.decodeTypedValue(), Collections.singletonList(5));
+
+        // in BCF 2.1 the same bytes are the value -127
+        final BCF2Decoder decoder21 = new BCF2Decoder(bytes);
+        Assert.assertEquals(decoder21.decodeTypedValue(), Arrays.asList(5, -127, -127));
+    }
+
     // -----------------------------------------------------------------
     //
     // Helper routines
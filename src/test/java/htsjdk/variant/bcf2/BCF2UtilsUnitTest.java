@@ -25,6 +25,7 @@
 
 package htsjdk.variant.bcf2;
 
+import htsjdk.tribble.TribbleException;
 import htsjdk.variant.VariantBaseTest;
 import htsjdk.variant.utils.GeneralUtils;
 import htsjdk.variant.vcf.VCFContigHeaderLine;
@@ -34,6 +35,7 @@ import htsjdk.variant.vcf.VCFHeader;
 import htsjdk.variant.vcf.VCFHeaderLine;
 import htsjdk.variant.vcf.VCFHeaderLineCount;
 import htsjdk.variant.vcf.VCFHeaderLineType;
+import htsjdk.variant.vcf.VCFHeaderVersion;
 import htsjdk.variant.vcf.VCFIDHeaderLine;
 import htsjdk.variant.vcf.VCFInfoHeaderLine;
 import htsjdk.variant.vcf.VCFSimpleHeaderLine;
@@ -46,6 +48,7 @@ import java.util.Arrays;
 import java.util.Collections;
 import java.util.LinkedHashSet;
 import java.util.List;
+import java.util.Set;
 
 /**
  * Tests for BCF2Utils
@@ -93,6 +96,49 @@ public final class BCF2UtilsUnitTest extends VariantBaseTest {
         Assert.assertEquals(7,dict_size);
     }
 
+    @Test
+    public void testCreateDictionaryFromIDX() {
+        final Set<VCFHeaderLine> lines = new LinkedHashSet<VCFHeaderLine>();
+        lines.add(new VCFFilterHeaderLine("<ID=PASS,Description=\"All filters passed\",IDX=0>", VCFHeaderVersion.VCF4_2));
+        lines.add(new VCFInfoHeaderLine("<ID=DP,Number=1,Type=Integer,Description=\"depth\",IDX=3>", VCFHeaderVersion.VCF4_2));
+        lines.add(new VCFFilterHeaderLine("<ID=q10,Description=\"low quality\",IDX=1>", VCFHeaderVersion.VCF4_2));
+        lines.add(new VCFFormatHeaderLine("<ID=DP,Number=1,Type=Integer,Description=\"depth\",IDX=3>", VCFHeaderVersion.VCF4_2));
+        lines.add(new VCFFormatHeaderLine("<ID=GT,Number=1,Type=String,Description=\"genotype\",IDX=5>", VCFHeaderVersion.VCF4_2));
+        final VCFHeader header = new VCFHeader(lines);
+
+        Assert.assertEquals(BCF2Utils.makeDictionaryFromIDX(header), Arrays.asList("PASS", "q10", null, "DP", null, "GT"));
+        // without IDX the dictionary follows the order of the header lines
+        Assert.assertEquals(BCF2Utils.makeDictionary(header), Arrays.asList("PASS", "DP", "q10", "GT"));
+    }
+
+    @Test(expectedExceptions = TribbleException.class)
+    public void testCreateDictionaryWithConflictingIDX() {
+        final Set<VCFHeaderLine> lines = new LinkedHashSet<VCFHeaderLine>();
+        lines.add(new VCFFilterHeaderLine("<ID=q10,Description=\"low quality\",IDX=1>", VCFHeaderVersion.VCF4_2));
+        lines.add(new VCFInfoHeaderLine("<ID=DP,Number=1,Type=Integer,Description=\"depth\",IDX=1>", VCFHeaderVersion.VCF4_2));
+        BCF2Utils.makeDictionaryFromIDX(new VCFHeader(lines));
+    }
+
+    @Test
+    public void testRemoveIDX() {
+        final Set<VCFHeaderLine> lines = new LinkedHashSet<VCFHeaderLine>();
+        lines.add(new VCFFilterHeaderLine("<ID=q10,Description=\"low quality\",IDX=1>", VCFHeaderVersion.VCF4_2));
+        lines.add(new VCFContigHeaderLine("<ID=20,length=1000,IDX=0>", VCFHeaderVersion.VCF4_2, "contig", 0));
+        lines.add(new VCFInfoHeaderLine("<ID=DP,Number=1,Type=Integer,Description=\"depth\",IDX=2>", VCFHeaderVersion.VCF4_2));
+        lines.add(new VCFHeaderLine("source", "test"));
+
+        final List<VCFHeaderLine> removed = new ArrayList<VCFHeaderLine>(BCF2Utils.removeIDX(lines));
+        Assert.assertEquals(removed.size(), lines.size());
+        for ( final VCFHeaderLine line : removed )
+            Assert.assertFalse(line.toString().contains("IDX"), line.toString());
+
+        Assert.assertEquals(((VCFFilterHeaderLine)removed.get(0)).getDescription(), "low quality");
+        final VCFContigHeaderLine contig = (VCFContigHeaderLine)removed.get(1);
+        Assert.assertEquals(contig.getID(), "20");
+        Assert.assertEquals(contig.getSAMSequenceRecord().getSequenceLength(), 1000);
+        Assert.assertEquals((int)contig.getContigIndex(), 0);
+    }
+
     /**
      * Wrapper class for HeaderOrderTestProvider test cases to prevent TestNG from calling toString()
      * on the VCFHeaders and spamming the log output.
@@ -1,27 +1,330 @@
 package htsjdk.variant.bcf2;
 
+import htsjdk.tribble.AbstractFeatureReader;
+import htsjdk.tribble.CloseableTribbleIterator;
 import htsjdk.tribble.FeatureCodecHeader;
+import htsjdk.tribble.FeatureReader;
 import htsjdk.tribble.TribbleException;
 import htsjdk.tribble.readers.PositionalBufferedStream;
 import htsjdk.variant.VariantBaseTest;
+import htsjdk.variant.variantcontext.Allele;
+import htsjdk.variant.variantcontext.Genotype;
+import htsjdk.variant.variantcontext.GenotypeBuilder;
+import htsjdk.variant.variantcontext.VariantContext;
+import htsjdk.variant.variantcontext.VariantContextBuilder;
+import htsjdk.variant.variantcontext.writer.Options;
+import htsjdk.variant.variantcontext.writer.VariantContextWriter;
+import htsjdk.variant.variantcontext.writer.VariantContextWriterBuilder;
+import htsjdk.variant.vcf.VCFConstants;
+import htsjdk.variant.vcf.VCFContigHeaderLine;
+import htsjdk.variant.vcf.VCFFormatHeaderLine;
 import htsjdk.variant.vcf.VCFHeader;
+import htsjdk.variant.vcf.VCFHeaderLine;
+import htsjdk.variant.vcf.VCFHeaderLineCount;
+import htsjdk.variant.vcf.VCFHeaderLineType;
+import htsjdk.variant.vcf.VCFInfoHeaderLine;
+import htsjdk.variant.vcf.VCFStandardHeaderLines;
 import org.testng.Assert;
+import org.testng.annotations.DataProvider;
 import org.testng.annotations.Test;
 
+import java.io.ByteArrayInputStream;
 import java.io.File;
 import java.io.FileInputStream;
 import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.EnumSet;
+import java.util.HashSet;
+import java.util.LinkedHashSet;
+import java.util.List;
+import java.util.Set;
 
 public class BCFCodecTest extends VariantBaseTest {
     final String TEST_DATA_DIR = "src/test/resources/htsjdk/variant/";
 
-    // should reject bcf v2.2 on read, see issue https://github.com/samtools/htsjdk/issues/1323
+    @Test
+    public void testReadBCFVersion22() throws IOException {
+        final List<VariantContext> vcs = readAll(new File(TEST_DATA_DIR, "BCFVersion22Uncompressed.bcf"), new BCF2Codec());
+        Assert.assertEquals(vcs.size(), 26);
+
+        final VariantContext first = vcs.get(0);
+        Assert.assertEquals(first.getContig(), "1");
+        Assert.assertEquals(first.getStart(), 100);
+        Assert.assertEquals(first.getEnd(), 100);
+        Assert.assertEquals(first.getID(), "a");
+        Assert.assertTrue(first.filtersWereApplied());
+        Assert.assertFalse(first.isFiltered());
+
+        final VariantContext last = vcs.get(vcs.size() - 1);
+        Assert.assertEquals(last.getContig(), "4");
+        Assert.assertEquals(last.getStart(), 776);
+        Assert.assertEquals(last.getEnd(), 779);
+        Assert.assertEquals(last.getID(), "z");
+    }
+
+    // minor versions from the future are still rejected
     @Test(expectedExceptions = TribbleException.class)
-    private void testRejectBCFVersion22() throws IOException {
-        BCF2Codec bcfCodec = new BCF2Codec();
-        try (final FileInputStream fis = new FileInputStream(new File(TEST_DATA_DIR, "BCFVersion22Uncompressed.bcf"));
-             final PositionalBufferedStream pbs = new PositionalBufferedStream(fis)) {
-            bcfCodec.readHeader(pbs);
+    public void testRejectBCFVersion23() throws IOException {
+        final byte[] bytes = Files.readAllBytes(new File(TEST_DATA_DIR, "BCFVersion22Uncompressed.bcf").toPath());
+        bytes[BCFVersion.MAGIC_HEADER_START.length + 1] = 3;
+        try (final PositionalBufferedStream pbs = new PositionalBufferedStream(new ByteArrayInputStream(bytes))) {
+            new BCF2Codec().readHeader(pbs);
+        }
+    }
+
+    @Test
+    public void testWriteBCFVersion22() throws IOException {
+        final File input = new File(TEST_DATA_DIR, "BCFVersion22Uncompressed.bcf");
+        final File output = File.createTempFile("testWriteBCFVersion22.", ".bcf");
+        output.deleteOnExit();
+
+        final List<VariantContext> expected = readAll(input, new BCF2Codec());
+        final VCFHeader header;
+        try (final FeatureReader<VariantContext> reader = AbstractFeatureReader.getFeatureReader(input.getAbsolutePath(), new BCF2Codec(), false)) {
+            header = (VCFHeader) reader.getHeader();
+        }
+        try (final VariantContextWriter writer = new VariantContextWriterBuilder()
+                .setOutputFile(output)
+                .setOptions(EnumSet.of(Options.WRITE_BCF_2_2))
+                .build()) {
+            writer.writeHeader(header);
+            expected.forEach(writer::add);
+        }
+
+        final BCF2Codec codec = new BCF2Codec();
+        final List<VariantContext> actual = readAll(output, codec);
+        Assert.assertEquals(codec.getBCFVersion(), BCF2Codec.BCF_VERSION_2_2);
+        Assert.assertEquals(actual.size(), expected.size());
+        for ( int i = 0; i < actual.size(); i++ ) {
+            assertVariantContextsAreEqual(actual.get(i), expected.get(i));
+        }
+    }
+
+    @DataProvider
+    public Object[][] getBCFWriteOptions() {
+        return new Object[][]{
+                {EnumSet.noneOf(Options.class)},
+                {EnumSet.of(Options.WRITE_BCF_2_2)},
+        };
+    }
+
+    private static VCFHeader makeGenotypesHeader(final VCFHeaderLine... extraLines) {
+        final Set<VCFHeaderLine> lines = new LinkedHashSet<>(Arrays.asList(
+                new VCFContigHeaderLine(Collections.singletonMap("ID", "1"), 0),
+                new VCFInfoHeaderLine("AF", VCFHeaderLineCount.A, VCFHeaderLineType.Float, "x"),
+                VCFStandardHeaderLines.getFormatLine(VCFConstants.GENOTYPE_KEY),
+                VCFStandardHeaderLines.getFormatLine(VCFConstants.GENOTYPE_QUALITY_KEY),
+                VCFStandardHeaderLines.getFormatLine(VCFConstants.DEPTH_KEY),
+                VCFStandardHeaderLines.getFormatLine(VCFConstants.GENOTYPE_PL_KEY),
+                new VCFFormatHeaderLine("XI", 1, VCFHeaderLineType.Integer, "x")));
+        lines.addAll(Arrays.asList(extraLines));
+        return new VCFHeader(lines, Arrays.asList("s1", "s2", "s3"));
+    }
+
+    private static VariantContext makeGenotypesRecord() {
+        final Allele ref = Allele.create("A", true);
+        final Allele alt = Allele.create("C");
+        final List<Genotype> genotypes = Arrays.asList(
+                new GenotypeBuilder("s1", Arrays.asList(ref, alt)).GQ(30).DP(10).PL(new int[]{30, 0, 300}).attribute("XI", 7).make(),
+                // a haploid sample, and a value that needs INT16 because INT8 reserves -128 to -121
+                new GenotypeBuilder("s2", Collections.singletonList(alt)).GQ(45).DP(12).PL(new int[]{45, 0}).attribute("XI", -125).make(),
+                new GenotypeBuilder("s3", Arrays.asList(ref, ref)).DP(4).make());
+        return new VariantContextBuilder("test", "1", 10, 10, Arrays.asList(ref, alt))
+                .attribute("AF", 0.5).genotypes(genotypes).make();
+    }
+
+    private static void write(final File output, final EnumSet<Options> options, final VCFHeader header,
+                              final List<VariantContext> vcs) {
+        try (final VariantContextWriter writer = new VariantContextWriterBuilder()
+                .setOutputFile(output)
+                .setOptions(options)
+                .build()) {
+            writer.writeHeader(header);
+            vcs.forEach(writer::add);
+        }
+    }
+
+    private static VCFHeader readHeader(final File file) throws IOException {
+        try (final FeatureReader<VariantContext> reader = AbstractFeatureReader.getFeatureReader(file.getAbsolutePath(), new BCF2Codec(), false)) {
+            return (VCFHeader) reader.getHeader();
+        }
+    }
+
+    @Test(dataProvider = "getBCFWriteOptions")
+    public void testDecodeSelectedGenotypeFields(final EnumSet<Options> options) throws IOException {
+        final VariantContext vc = makeGenotypesRecord();
+        final List<Genotype> genotypes = vc.getGenotypes();
+
+        final File output = File.createTempFile("testDecodeSelectedGenotypeFields.", ".bcf");
+        output.deleteOnExit();
+        write(output, options, makeGenotypesHeader(), Collections.singletonList(vc));
+
+        final List<VariantContext> all = readAll(output, new BCF2Codec());
+        Assert.assertEquals(all.size(), 1);
+        assertVariantContextsAreEqual(all.get(0), vc);
+
+        final BCF2Codec codec = new BCF2Codec();
+        codec.setGenotypeFieldsToDecode(Arrays.asList(VCFConstants.GENOTYPE_KEY, VCFConstants.DEPTH_KEY));
+        final List<VariantContext> selected = readAll(output, codec);
+        Assert.assertEquals(selected.size(), 1);
+        for ( final Genotype expected : genotypes ) {
+            final Genotype actual = selected.get(0).getGenotype(expected.getSampleName());
+            Assert.assertEquals(actual.getAlleles(), expected.getAlleles());
+            Assert.assertEquals(actual.getDP(), expected.getDP());
+            Assert.assertFalse(actual.hasGQ());
+            Assert.assertFalse(actual.hasPL());
+            Assert.assertFalse(actual.hasExtendedAttribute("XI"));
+        }
+    }
+
+    @Test(dataProvider = "getBCFWriteOptions")
+    public void testDecodeSelectedSamples(final EnumSet<Options> options) throws IOException {
+        final Allele ref = Allele.create("A", true);
+        final Allele alt = Allele.create("C");
+        final List<String> samples = Arrays.asList("s1", "s2", "s3", "s4", "s5");
+        final VCFHeader header = new VCFHeader(new LinkedHashSet<>(Arrays.asList(
+                new VCFContigHeaderLine(Collections.singletonMap("ID", "1"), 0),
+                VCFStandardHeaderLines.getFormatLine(VCFConstants.GENOTYPE_KEY),
+                VCFStandardHeaderLines.getFormatLine(VCFConstants.GENOTYPE_QUALITY_KEY),
+                VCFStandardHeaderLines.getFormatLine(VCFConstants.GENOTYPE_PL_KEY),
+                new VCFFormatHeaderLine("XS", 1, VCFHeaderLineType.String, "x"))),
+                samples);
+        final List<Genotype> genotypes = new ArrayList<>();
+        for ( int i = 0; i < samples.size(); i++ ) {
+            final GenotypeBuilder gb = new GenotypeBuilder(samples.get(i), i % 2 == 0 ? Arrays.asList(ref, alt) : Arrays.asList(alt, alt))
+                    .GQ(10 * i).PL(new int[]{10 * i, i, 0});
+            if ( i != 3 ) gb.attribute("XS", "value" + i);
+            genotypes.add(gb.make());
+        }
+        final VariantContext vc = new VariantContextBuilder("test", "1", 10, 10, Arrays.asList(ref, alt)).genotypes(genotypes).make();
+
+        final File output = File.createTempFile("testDecodeSelectedSamples.", ".bcf");
+        output.deleteOnExit();
+        try (final VariantContextWriter writer = new VariantContextWriterBuilder()
+                .setOutputFile(output)
+                .setOptions(options)
+                .build()) {
+            writer.writeHeader(header);
+            writer.add(vc);
+            writer.add(new VariantContextBuilder(vc).start(20).stop(20).make());
+        }
+
+        // a run of one sample, and a run of two at the end of the samples
+        final Set<String> selectedSamples = new HashSet<>(Arrays.asList("s4", "s2", "s5"));
+        final BCF2Codec codec = new BCF2Codec();
+        codec.setSamplesToDecode(selectedSamples);
+        final List<VariantContext> selected = readAll(output, codec);
+        Assert.assertEquals(selected.size(), 2);
+        for ( final VariantContext actual : selected ) {
+            Assert.assertEquals(actual.getNSamples(), 3);
+            Assert.assertEquals(actual.getSampleNamesOrderedByName(), Arrays.asList("s2", "s4", "s5"));
+            assertVariantContextsAreEqual(actual, new VariantContextBuilder(vc.subContextFromSamples(selectedSamples, false))
+                    .start(actual.getStart()).stop(actual.getEnd()).make());
+        }
+    }
+
+    // the records read from a BCF 2.2 file are padded with END_OF_VECTOR values, which BCF 2.1 does not have
+    @Test
+    public void testWriteBCFVersion22As21() throws IOException {
+        final VariantContext vc = makeGenotypesRecord();
+        final File input = File.createTempFile("testWriteBCFVersion22As21.", ".bcf");
+        input.deleteOnExit();
+        write(input, EnumSet.of(Options.WRITE_BCF_2_2), makeGenotypesHeader(), Collections.singletonList(vc));
+
+        final File output = File.createTempFile("testWriteBCFVersion22As21.", ".bcf");
+        output.deleteOnExit();
+        write(output, EnumSet.noneOf(Options.class), readHeader(input), readAll(input, new BCF2Codec()));
+
+        final BCF2Codec codec = new BCF2Codec();
+        final List<VariantContext> actual = readAll(output, codec);
+        Assert.assertEquals(codec.getBCFVersion(), BCF2Codec.ALLOWED_BCF_VERSION);
+        Assert.assertEquals(actual.size(), 1);
+        assertVariantContextsAreEqual(actual.get(0), vc);
+    }
+
+    // the FORMAT keys of the records are offsets into a dictionary with a gap, which the writer does not reproduce
+    @Test
+    public void testWriteBCFVersion22WithGappedIDX() throws IOException {
+        final VariantContext vc = makeGenotypesRecord();
+        final File input = File.createTempFile("testWriteBCFVersion22WithGappedIDX.", ".bcf");
+        input.deleteOnExit();
+        // the FORMAT line AA sorts before the others, and is dropped from the header after the records are written
+        write(input, EnumSet.of(Options.WRITE_BCF_2_2),
+                makeGenotypesHeader(new VCFFormatHeaderLine("AA", 1, VCFHeaderLineType.Integer, "x")),
+                Collections.singletonList(vc));
+        dropHeaderLineLeavingIDXGap(input, "##FORMAT=<ID=AA,");
+        Assert.assertNull(BCF2Utils.makeDictionaryFromIDX(readHeader(input)).get(1));
+
+        final File output = File.createTempFile("testWriteBCFVersion22WithGappedIDX.", ".bcf");
+        output.deleteOnExit();
+        write(output, EnumSet.of(Options.WRITE_BCF_2_2), readHeader(input), readAll(input, new BCF2Codec()));
+
+        final List<VariantContext> actual = readAll(output, new BCF2Codec());
+        Assert.assertEquals(actual.size(), 1);
+        assertVariantContextsAreEqual(actual.get(0), vc);
+    }
+
+    /**
+     * Rewrites the header of an uncompressed BCF file without the line starting with droppedLinePrefix, and with
+     * IDX attributes that keep the dictionary offsets of the other lines, so that the dictionary has a gap
+     */
+    private static void dropHeaderLineLeavingIDXGap(final File bcf, final String droppedLinePrefix) throws IOException {
+        final byte[] bytes = Files.readAllBytes(bcf.toPath());
+        final ByteBuffer buffer = ByteBuffer.wrap(bytes).order(ByteOrder.LITTLE_ENDIAN);
+        final int textStart = BCF2Codec.SIZEOF_BCF_HEADER + Integer.BYTES;
+        final int textLength = buffer.getInt(BCF2Codec.SIZEOF_BCF_HEADER);
+        // the text is null terminated
+        final String text = new String(bytes, textStart, textLength - 1, StandardCharsets.UTF_8);
+
+        final List<String> dictionary = new ArrayList<>(Collections.singletonList(VCFConstants.PASSES_FILTERS_v4));
+        final StringBuilder newText = new StringBuilder();
+        for ( final String line : text.split("\n") ) {
+            if ( line.startsWith("##FILTER=<") || line.startsWith("##INFO=<") || line.startsWith("##FORMAT=<") ) {
+                final int idStart = line.indexOf("ID=") + 3;
+                int idEnd = idStart;
+                while ( line.charAt(idEnd) != ',' && line.charAt(idEnd) != '>' ) idEnd++;
+                final String id = line.substring(idStart, idEnd);
+                if ( !dictionary.contains(id) ) dictionary.add(id);
+                if ( !line.startsWith(droppedLinePrefix) ) {
+                    final int end = line.lastIndexOf('>');
+                    newText.append(line, 0, end).append(",IDX=").append(dictionary.indexOf(id)).append(line.substring(end)).append('\n');
+                }
+            } else {
+                newText.append(line).append('\n');
+            }
+        }
+        newText.append('\0');
+
+        final byte[] newTextBytes = newText.toString().getBytes(StandardCharsets.UTF_8);
+        final ByteBuffer newBytes = ByteBuffer.allocate(bytes.length - textLength + newTextBytes.length).order(ByteOrder.LITTLE_ENDIAN);
+        newBytes.put(bytes, 0, BCF2Codec.SIZEOF_BCF_HEADER);
+        newBytes.putInt(newTextBytes.length);
+        newBytes.put(newTextBytes);
+        newBytes.put(bytes, textStart + textLength, bytes.length - textStart - textLength);
+        Files.write(bcf.toPath(), newBytes.array());
+    }
+
+    @Test(expectedExceptions = IllegalArgumentException.class)
+    public void testDecodeSamplesNotInHeader() throws IOException {
+        final BCF2Codec codec = new BCF2Codec();
+        try (final PositionalBufferedStream in = new PositionalBufferedStream(new FileInputStream(variantTestDataRoot + "serialization_test.bcf"))) {
+            codec.readHeader(in);
+        }
+        codec.setSamplesToDecode(Collections.singletonList("notASample"));
+    }
+
+    private static List<VariantContext> readAll(final File file, final BCF2Codec codec) throws IOException {
+        try (final FeatureReader<VariantContext> reader = AbstractFeatureReader.getFeatureReader(file.getAbsolutePath(), codec, false);
+             final CloseableTribbleIterator<VariantContext> it = reader.iterator()) {
+            final List<VariantContext> vcs = new ArrayList<>();
+            it.forEachRemaining(vcs::add);
+            return vcs;
         }
     }
 
@@ -34,8 +337,7 @@ public class BCFCodecTest extends VariantBaseTest {
             }
         };
 
-        // the default BCF2Codec version compatibility policy is to reject BCF 2.2 input; but make sure we can
-        // provide a codec that implements a more tolerant custom policy that accepts
+        // make sure we can provide a codec that implements a custom version compatibility policy
         try (final FileInputStream fis = new FileInputStream(new File(TEST_DATA_DIR, "BCFVersion22Uncompressed.bcf"));
              final PositionalBufferedStream pbs = new PositionalBufferedStream(fis)) {
             final FeatureCodecHeader featureCodecHeader = (FeatureCodecHeader)  bcfCodec.readHeader(pbs);
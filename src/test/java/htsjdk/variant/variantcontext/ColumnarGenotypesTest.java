@@ -0,0 +1,167 @@
+package htsjdk.variant.variantcontext;
+
+import htsjdk.tribble.AbstractFeatureReader;
+import htsjdk.tribble.CloseableTribbleIterator;
+import htsjdk.tribble.FeatureCodec;
+import htsjdk.tribble.FeatureReader;
+import htsjdk.variant.VariantBaseTest;
+import htsjdk.variant.bcf2.BCF2Codec;
+import htsjdk.variant.vcf.VCFCodec;
+import org.testng.Assert;
+import org.testng.annotations.DataProvider;
+import org.testng.annotations.Test;
+
+import java.io.IOException;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.Iterator;
+import java.util.List;
+
+public class ColumnarGenotypesTest extends VariantBaseTest {
+    private static final Allele A = Allele.create("A", true);
+    private static final Allele C = Allele.create("C");
+    private static final Allele G = Allele.create("G");
+
+    private static List<Genotype> makeGenotypes() {
+        final List<Genotype> genotypes = new ArrayList<>();
+        genotypes.add(new GenotypeBuilder("s1", Arrays.asList(A, A)).GQ(30).DP(10).AD(new int[]{10, 0}).PL(new int[]{0, 30, 300}).make());
+        genotypes.add(new GenotypeBuilder("s2", Arrays.asList(A, C)).phased(true).DP(12).make());
+        genotypes.add(new GenotypeBuilder("s3", Arrays.asList(A, C)).GQ(99).PL(new int[]{99, 0, 200}).attribute("XX", "x").make());
+        genotypes.add(new GenotypeBuilder("s4", Arrays.asList(Allele.NO_CALL, Allele.NO_CALL)).filter("LowQual").make());
+        genotypes.add(new GenotypeBuilder("s5", Arrays.asList(C, G, G)).AD(new int[]{0, 1, 2}).make());
+        genotypes.add(new GenotypeBuilder("s6", Collections.<Allele>emptyList()).make());
+        return genotypes;
+    }
+
+    private static ColumnarGenotypes makeColumns(final List<Genotype> genotypes) {
+        final ColumnarGenotypes.Builder builder = new ColumnarGenotypes.Builder(2);
+        for (final Genotype g : genotypes) {
+            builder.add(g);
+        }
+        Assert.assertEquals(builder.size(), genotypes.size());
+        return builder.make();
+    }
+
+    @Test
+    public void testGenotypeViews() {
+        final List<Genotype> genotypes = makeGenotypes();
+        final ColumnarGenotypes columns = makeColumns(genotypes);
+        Assert.assertEquals(columns.size(), genotypes.size());
+        for (int i = 0; i < genotypes.size(); i++) {
+            assertGenotypesAreEqual(columns.getGenotype(i), genotypes.get(i));
+            Assert.assertEquals(columns.getSampleName(i), genotypes.get(i).getSampleName());
+        }
+        Assert.assertEquals(columns.getMaxPloidy(), 3);
+        Assert.assertEquals(columns.getExtendedAttributeKeys(), Collections.singletonList("XX"));
+        Assert.assertEquals(columns.getGenotype(2).getExtendedAttribute("XX"), "x");
+        Assert.assertFalse(columns.getGenotype(0).hasExtendedAttribute("XX"));
+    }
+
+    @Test
+    public void testFromGenotypeBuilder() {
+        final ColumnarGenotypes.Builder builder = new ColumnarGenotypes.Builder(2);
+        final GenotypeBuilder gb = new GenotypeBuilder();
+        final List<Genotype> expected = new ArrayList<>();
+        for (int i = 0; i < 5; i++) {
+            gb.reset(false);
+            gb.name("s" + i).alleles(Arrays.asList(A, i % 2 == 0 ? A : C));
+            if (i != 2) gb.PL(new int[]{i, i + 1, i + 2});
+            expected.add(gb.make());
+            builder.add(gb);
+        }
+        final ColumnarGenotypes columns = builder.make();
+        for (int i = 0; i < expected.size(); i++) {
+            assertGenotypesAreEqual(columns.getGenotype(i), expected.get(i));
+        }
+        Assert.assertFalse(columns.hasPL(2));
+        Assert.assertFalse(columns.hasAD(0));
+        Assert.assertEquals(columns.getGQ(0), -1);
+    }
+
+    @Test
+    public void testArraysAreCopied() {
+        final int[] pl = {0, 10, 100};
+        final ColumnarGenotypes columns = makeColumns(Collections.singletonList(
+                new GenotypeBuilder("s1", Arrays.asList(A, A)).PL(pl).make()));
+        pl[0] = 5;
+        Assert.assertEquals(columns.getPL(0)[0], 0);
+        columns.getPL(0)[1] = 5;
+        Assert.assertEquals(columns.getPL(0)[1], 10);
+    }
+
+    @Test
+    public void testGenotypesContext() {
+        final List<Genotype> genotypes = makeGenotypes();
+        final GenotypesContext context = GenotypesContext.create(makeColumns(genotypes));
+        Assert.assertEquals(context.size(), genotypes.size());
+        Assert.assertEquals(context.getMaxPloidy(2), 3);
+        Assert.assertEquals(context.getSampleNamesOrderedByName(), Arrays.asList("s1", "s2", "s3", "s4", "s5", "s6"));
+        assertGenotypesAreEqual(context.get("s3"), genotypes.get(2));
+        final Iterator<Genotype> it = context.iterator();
+        for (final Genotype expected : genotypes) {
+            assertGenotypesAreEqual(it.next(), expected);
+        }
+        Assert.assertFalse(it.hasNext());
+
+        // modifying the context converts it to a list of genotypes
+        final Genotype replacement = new GenotypeBuilder("s2", Arrays.asList(C, C)).make();
+        context.replace(replacement);
+        Assert.assertEquals(context.size(), genotypes.size());
+        Assert.assertSame(context.get("s2"), replacement);
+        assertGenotypesAreEqual(context.get("s1"), genotypes.get(0));
+        context.remove(0);
+        Assert.assertEquals(context.size(), genotypes.size() - 1);
+        Assert.assertNull(context.get("s1"));
+    }
+
+    @Test
+    public void testGenotypesContextFindsItsViews() {
+        final List<Genotype> genotypes = makeGenotypes();
+        final GenotypesContext context = GenotypesContext.create(makeColumns(genotypes));
+        for (int i = 0; i < genotypes.size(); i++) {
+            Assert.assertSame(context.get(i), context.get(genotypes.get(i).getSampleName()));
+            Assert.assertTrue(context.contains(context.get(i)));
+            Assert.assertEquals(context.indexOf(context.get(i)), i);
+        }
+        final Genotype s3 = context.get("s3");
+        Assert.assertSame(context.iterator().next(), context.get(0));
+        Assert.assertTrue(context.remove(s3));
+        Assert.assertEquals(context.size(), genotypes.size() - 1);
+        Assert.assertNull(context.get("s3"));
+        Assert.assertFalse(context.contains(s3));
+    }
+
+    @DataProvider
+    public Object[][] getColumnarFiles() {
+        return new Object[][]{
+                {variantTestDataRoot + "ILLUMINA.wex.broad_phase2_baseline.20111114.both.exome.genotypes.1000.vcf", new VCFCodec(), new VCFCodec()},
+                {variantTestDataRoot + "test_withGLandPL.vcf", new VCFCodec(), new VCFCodec()},
+                {variantTestDataRoot + "phased.vcf", new VCFCodec(), new VCFCodec()},
+                {variantTestDataRoot + "serialization_test.bcf", new BCF2Codec(), new BCF2Codec()},
+        };
+    }
+
+    @Test(dataProvider = "getColumnarFiles")
+    public void testColumnarDecodingMatchesRowDecoding(final String path, final FeatureCodec<VariantContext, ?> rowCodec,
+                                                       final FeatureCodec<VariantContext, ?> columnarCodec) throws IOException {
+        if (columnarCodec instanceof VCFCodec) {
+            ((VCFCodec) columnarCodec).setUseColumnarGenotypes(true);
+        } else {
+            ((BCF2Codec) columnarCodec).setUseColumnarGenotypes(true);
+        }
+        int nRecords = 0;
+        try (final FeatureReader<VariantContext> rowReader = AbstractFeatureReader.getFeatureReader(path, rowCodec, false);
+             final FeatureReader<VariantContext> columnarReader = AbstractFeatureReader.getFeatureReader(path, columnarCodec, false);
+             final CloseableTribbleIterator<VariantContext> rows = rowReader.iterator();
+             final CloseableTribbleIterator<VariantContext> columns = columnarReader.iterator()) {
+            while (rows.hasNext()) {
+                Assert.assertTrue(columns.hasNext());
+                assertVariantContextsAreEqual(columns.next(), rows.next());
+                nRecords++;
+            }
+            Assert.assertFalse(columns.hasNext());
+        }
+        Assert.assertTrue(nRecords > 0);
+    }
+}
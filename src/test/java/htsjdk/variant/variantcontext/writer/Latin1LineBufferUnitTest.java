@@ -0,0 +1,44 @@
+package htsjdk.variant.variantcontext.writer;
+
+import htsjdk.HtsjdkTest;
+import htsjdk.variant.vcf.VCFEncoder;
+import org.testng.Assert;
+import org.testng.annotations.DataProvider;
+import org.testng.annotations.Test;
+
+import java.io.ByteArrayOutputStream;
+import java.io.IOException;
+
+public class Latin1LineBufferUnitTest extends HtsjdkTest {
+
+    @DataProvider(name = "strings")
+    public Object[][] makeStrings() {
+        return new Object[][]{
+                {""},
+                {"1\t100\t.\tA\tC\t.\tPASS\t.\n"},
+                {"caf\u00e9 \u00ff"},
+                {"greek \u03b1 and emoji \ud83d\ude00 end"},
+                {"lone surrogates \ud83d x \ude00 y \ud83d"},
+        };
+    }
+
+    @Test(dataProvider = "strings")
+    public void testMatchesCharsetEncoding(final String s) throws IOException {
+        final Latin1LineBuffer buffer = new Latin1LineBuffer(4);
+        buffer.append(s.substring(0, s.length() / 2)).append(s, s.length() / 2, s.length());
+        Assert.assertEquals(buffer.size(), s.getBytes(VCFEncoder.VCF_CHARSET).length);
+
+        final ByteArrayOutputStream out = new ByteArrayOutputStream();
+        buffer.writeTo(out);
+        Assert.assertEquals(out.toByteArray(), s.getBytes(VCFEncoder.VCF_CHARSET));
+
+        buffer.reset();
+        Assert.assertEquals(buffer.size(), 0);
+        for (int i = 0; i < s.length(); i++) {
+            buffer.append(s.charAt(i));
+        }
+        out.reset();
+        buffer.writeTo(out);
+        Assert.assertEquals(out.toByteArray(), s.getBytes(VCFEncoder.VCF_CHARSET));
+    }
+}
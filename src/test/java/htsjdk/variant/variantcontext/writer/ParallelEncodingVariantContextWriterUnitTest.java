@@ -0,0 +1,173 @@
+package htsjdk.variant.variantcontext.writer;
+
+import htsjdk.samtools.util.CloseableIterator;
+import htsjdk.samtools.util.FileExtensions;
+import htsjdk.tribble.Tribble;
+import htsjdk.variant.VariantBaseTest;
+import htsjdk.variant.variantcontext.VariantContext;
+import htsjdk.variant.variantcontext.VariantContextBuilder;
+import htsjdk.variant.vcf.VCFFileReader;
+import htsjdk.variant.vcf.VCFHeader;
+import org.testng.Assert;
+import org.testng.annotations.DataProvider;
+import org.testng.annotations.Test;
+
+import java.io.File;
+import java.io.IOException;
+import java.nio.file.Files;
+import java.util.ArrayList;
+import java.util.List;
+
+public class ParallelEncodingVariantContextWriterUnitTest extends VariantBaseTest {
+    private static final File INPUT = new File(variantTestDataRoot + "ILLUMINA.wex.broad_phase2_baseline.20111114.both.exome.genotypes.1000.vcf");
+
+    private VCFHeader header;
+    private List<VariantContext> records;
+
+    private void readInput() {
+        if (records == null) {
+            try (final VCFFileReader reader = new VCFFileReader(INPUT, false)) {
+                header = reader.getFileHeader();
+                records = new ArrayList<>();
+                for (final VariantContext vc : reader) {
+                    records.add(vc);
+                }
+            }
+        }
+    }
+
+    private VariantContextWriterBuilder newBuilder(final File output) {
+        return new VariantContextWriterBuilder()
+                .clearOptions()
+                .setOption(Options.INDEX_ON_THE_FLY)
+                .setReferenceDictionary(header.getSequenceDictionary())
+                .setOutputFile(output);
+    }
+
+    private static File createTempFile(final String extension) throws IOException {
+        final File file = File.createTempFile("ParallelEncodingVariantContextWriterUnitTest", extension);
+        file.deleteOnExit();
+        return file;
+    }
+
+    private static void write(final VariantContextWriter writer, final VCFHeader header, final List<VariantContext> records) {
+        try (final VariantContextWriter w = writer) {
+            w.writeHeader(header);
+            for (final VariantContext vc : records) {
+                w.add(vc);
+            }
+        }
+    }
+
+    @DataProvider(name = "ParallelEncoding")
+    public Object[][] getParallelEncodingData() {
+        return new Object[][]{
+                {FileExtensions.VCF, 1, 1},
+                {FileExtensions.VCF, 4, 7},
+                {FileExtensions.VCF, 3, 1000},
+                {FileExtensions.COMPRESSED_VCF, 4, 7},
+                {FileExtensions.BCF, 4, 7},
+                {FileExtensions.BCF, 2, 50},
+        };
+    }
+
+    @Test(dataProvider = "ParallelEncoding")
+    public void testMatchesSequentialWriter(final String extension, final int numThreads, final int recordsPerBatch) throws IOException {
+        readInput();
+        final File expected = createTempFile(extension);
+        final File actual = createTempFile(extension);
+        final File actualIndex = Tribble.indexFile(actual);
+        actualIndex.deleteOnExit();
+        Tribble.indexFile(expected).deleteOnExit();
+        new File(expected.getAbsolutePath() + FileExtensions.TABIX_INDEX).deleteOnExit();
+        new File(actual.getAbsolutePath() + FileExtensions.TABIX_INDEX).deleteOnExit();
+
+        write(newBuilder(expected).build(), header, records);
+        final IndexingVariantContextWriter underlying = (IndexingVariantContextWriter) newBuilder(actual).build();
+        write(new ParallelEncodingVariantContextWriter(underlying, numThreads, recordsPerBatch), header, records);
+
+        Assert.assertEquals(Files.readAllBytes(actual.toPath()), Files.readAllBytes(expected.toPath()));
+        if (extension.equals(FileExtensions.COMPRESSED_VCF)) {
+            // tabix indices do not record the name of the file, so they can be compared directly
+            Assert.assertEquals(
+                    Files.readAllBytes(new File(actual.getAbsolutePath() + FileExtensions.TABIX_INDEX).toPath()),
+                    Files.readAllBytes(new File(expected.getAbsolutePath() + FileExtensions.TABIX_INDEX).toPath()));
+        } else {
+            Assert.assertTrue(actualIndex.exists());
+        }
+    }
+
+    /** writes the records of the input as they are read, so that their genotypes have not been decoded yet */
+    private static void copyInput(final VariantContextWriter writer) {
+        try (final VCFFileReader reader = new VCFFileReader(INPUT, false);
+             final VariantContextWriter w = writer) {
+            w.writeHeader(reader.getFileHeader());
+            for (final VariantContext vc : reader) {
+                w.add(vc);
+            }
+        }
+    }
+
+    @Test(dataProvider = "ParallelEncoding")
+    public void testEncodesRecordsWithUndecodedGenotypes(final String extension, final int numThreads, final int recordsPerBatch) throws IOException {
+        readInput();
+        final File expected = createTempFile(extension);
+        final File actual = createTempFile(extension);
+        Tribble.indexFile(expected).deleteOnExit();
+        Tribble.indexFile(actual).deleteOnExit();
+        new File(expected.getAbsolutePath() + FileExtensions.TABIX_INDEX).deleteOnExit();
+        new File(actual.getAbsolutePath() + FileExtensions.TABIX_INDEX).deleteOnExit();
+
+        copyInput(newBuilder(expected).build());
+        copyInput(new ParallelEncodingVariantContextWriter((IndexingVariantContextWriter) newBuilder(actual).build(), numThreads, recordsPerBatch));
+
+        Assert.assertEquals(Files.readAllBytes(actual.toPath()), Files.readAllBytes(expected.toPath()));
+    }
+
+    @Test
+    public void testBuilderCreatesParallelWriter() throws IOException {
+        readInput();
+        final File output = createTempFile(FileExtensions.VCF);
+        Tribble.indexFile(output).deleteOnExit();
+        final VariantContextWriter writer = newBuilder(output).setEncodingThreads(3).build();
+        Assert.assertTrue(writer instanceof ParallelEncodingVariantContextWriter);
+        write(writer, header, records);
+
+        try (final VCFFileReader reader = new VCFFileReader(output, false);
+             final CloseableIterator<VariantContext> it = reader.iterator()) {
+            int n = 0;
+            while (it.hasNext()) {
+                assertVariantContextsAreEqual(it.next(), records.get(n++));
+            }
+            Assert.assertEquals(n, records.size());
+        }
+    }
+
+    @Test(expectedExceptions = IllegalArgumentException.class)
+    public void testZeroEncodingThreads() {
+        new VariantContextWriterBuilder().setEncodingThreads(0);
+    }
+
+    @Test
+    public void testErrorsAreRaisedInOrder() throws IOException {
+        readInput();
+        final int badRecord = 11;
+        final List<VariantContext> withBadRecord = new ArrayList<>(records.subList(0, 20));
+        withBadRecord.set(badRecord, new VariantContextBuilder(withBadRecord.get(badRecord)).attribute("NOT_IN_HEADER", 1).make());
+
+        final File output = createTempFile(FileExtensions.VCF);
+        final VariantContextWriter writer = new ParallelEncodingVariantContextWriter(
+                (IndexingVariantContextWriter) newBuilder(output).unsetOption(Options.INDEX_ON_THE_FLY).build(), 3, 4);
+        Assert.assertThrows(IllegalStateException.class, () -> write(writer, header, withBadRecord));
+
+        // the records before the bad one are written
+        try (final VCFFileReader reader = new VCFFileReader(output, false);
+             final CloseableIterator<VariantContext> it = reader.iterator()) {
+            int n = 0;
+            while (it.hasNext()) {
+                assertVariantContextsAreEqual(it.next(), records.get(n++));
+            }
+            Assert.assertEquals(n, badRecord);
+        }
+    }
+}
@@ -45,6 +45,7 @@ import java.io.File;
 import java.io.FileNotFoundException;
 import java.io.IOException;
 import java.util.ArrayList;
+import java.util.Arrays;
 import java.util.EnumSet;
 import java.util.List;
 
@@ -82,7 +83,24 @@ public class VariantContextWritersUnitTest extends VariantBaseTest {
         VariantContextTestProvider.testReaderWriterWithMissingGenotypes(new BCFIOTester(), testData);
     }
 
+    @Test(dataProvider = "VariantContextTest_SingleContexts")
+    public void testBCF22WriterReader(final VariantContextTestProvider.VariantContextTestData testData) throws IOException {
+        VariantContextTestProvider.testReaderWriter(new BCFIOTester(Options.WRITE_BCF_2_2), testData);
+    }
+
+    @Test(dataProvider = "VariantContextTest_SingleContexts")
+    public void testBCF22WriterReaderMissingGenotypes(final VariantContextTestProvider.VariantContextTestData testData) throws IOException {
+        VariantContextTestProvider.testReaderWriterWithMissingGenotypes(new BCFIOTester(Options.WRITE_BCF_2_2), testData);
+    }
+
     private class BCFIOTester extends VariantContextTestProvider.VariantContextIOTest<BCF2Codec> {
+        // options added to the base options of each writer
+        private final Options[] extraOptions;
+
+        BCFIOTester(final Options... extraOptions) {
+            this.extraOptions = extraOptions;
+        }
+
         @Override
         public String getExtension() {
             return ".bcf";
@@ -95,10 +113,12 @@ public class VariantContextWritersUnitTest extends VariantBaseTest {
 
         @Override
         public VariantContextWriter makeWriter(final File file, final EnumSet<Options> baseOptions) {
+            final EnumSet<Options> options = EnumSet.copyOf(baseOptions);
+            options.addAll(Arrays.asList(extraOptions));
             return new VariantContextWriterBuilder()
                     .setOutputFile(file)
                     .setReferenceDictionary(dictionary)
-                    .setOptions(baseOptions)
+                    .setOptions(options)
                     .build();
         }
 
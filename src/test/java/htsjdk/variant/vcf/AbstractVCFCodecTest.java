@@ -3,15 +3,32 @@ package htsjdk.variant.vcf;
 import htsjdk.tribble.TribbleException;
 import htsjdk.tribble.index.tabix.TabixFormat;
 import htsjdk.variant.VariantBaseTest;
+import htsjdk.tribble.readers.LineIterator;
+import htsjdk.tribble.readers.LineIteratorImpl;
+import htsjdk.tribble.readers.SynchronousLineReader;
 import htsjdk.variant.variantcontext.Allele;
+import htsjdk.variant.variantcontext.Genotype;
+import htsjdk.variant.variantcontext.LazyGenotypesContext;
 import htsjdk.variant.variantcontext.VariantContext;
+import htsjdk.variant.variantcontext.VariantContextBuilder;
 import org.testng.Assert;
 import org.testng.annotations.DataProvider;
 import org.testng.annotations.Test;
 
+import java.io.ByteArrayInputStream;
 import java.io.File;
+import java.io.FilterInputStream;
+import java.io.IOException;
+import java.io.InputStream;
+import java.io.StringReader;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.HashSet;
 import java.util.Iterator;
 import java.util.List;
+import java.util.Set;
 
 public class AbstractVCFCodecTest extends VariantBaseTest {
 
@@ -93,4 +110,324 @@ public class AbstractVCFCodecTest extends VariantBaseTest {
             }
         }
     }
+
+    private static final String BYTE_DECODE_HEADER =
+            "##fileformat=VCFv4.2\n" +
+            "##INFO=<ID=DP,Number=1,Type=Integer,Description=\"Depth\">\n" +
+            "##INFO=<ID=AF,Number=A,Type=Float,Description=\"Allele Frequency\">\n" +
+            "##INFO=<ID=DB,Number=0,Type=Flag,Description=\"dbSNP\">\n" +
+            "##FILTER=<ID=LowQual,Description=\"Low quality\">\n" +
+            "##FORMAT=<ID=GT,Number=1,Type=String,Description=\"Genotype\">\n" +
+            "##FORMAT=<ID=AD,Number=R,Type=Integer,Description=\"Allelic depths\">\n" +
+            "##FORMAT=<ID=DP,Number=1,Type=Integer,Description=\"Depth\">\n" +
+            "##FORMAT=<ID=GQ,Number=1,Type=Integer,Description=\"Genotype Quality\">\n" +
+            "##FORMAT=<ID=PL,Number=G,Type=Integer,Description=\"Likelihoods\">\n" +
+            "##FORMAT=<ID=XX,Number=1,Type=String,Description=\"Other\">\n" +
+            "##contig=<ID=chr1,length=1000>\n" +
+            "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT\ts1\ts2\ts3\n";
+
+    private static VCFCodec codecWithHeader() {
+        final VCFCodec codec = new VCFCodec();
+        codec.readActualHeader(new LineIteratorImpl(new SynchronousLineReader(new StringReader(BYTE_DECODE_HEADER))));
+        return codec;
+    }
+
+    @Test
+    public void testDecodeBytes() {
+        final String line = "chr1\t100\trs1\ta\tC,G\t50\tLowQual\tDP=20;AF=0.5,0.25;DB=0;Z\tGT:AD:DP:GQ:PL:XX\t" +
+                "0|1:3,4,0:7:12.6:10,0,20,30,40,50:foo\t./.:.:.:.:.:.\t1/2:1,2,3";
+        final byte[] bytes = Arrays.copyOf(line.getBytes(StandardCharsets.UTF_8), line.length() + 10);
+        final VCFCodec codec = codecWithHeader();
+        final VariantContext fromBytes = codec.decode(bytes, line.length());
+        final VariantContext fromString = codecWithHeader().decode(line);
+        VariantBaseTest.assertVariantContextsAreEqual(fromBytes, fromString);
+
+        Assert.assertEquals(fromBytes.getContig(), "chr1");
+        Assert.assertEquals(fromBytes.getStart(), 100);
+        Assert.assertEquals(fromBytes.getID(), "rs1");
+        Assert.assertEquals(fromBytes.getReference(), Allele.create("A", true));
+        Assert.assertEquals(fromBytes.getFilters(), Collections.singleton("LowQual"));
+        Assert.assertEquals(fromBytes.getAttribute("DP"), "20");
+        Assert.assertEquals(fromBytes.getAttribute("AF"), Arrays.asList("0.5", "0.25"));
+        Assert.assertFalse(fromBytes.hasAttribute("DB"));
+        Assert.assertEquals(fromBytes.getAttribute("Z"), true);
+
+        // keys are the header's own strings
+        final String dpKey = fromBytes.getAttributes().keySet().stream().filter("DP"::equals).findFirst().get();
+        Assert.assertSame(dpKey, codec.getHeader().getInfoHeaderLine("DP").getID());
+
+        final Genotype g1 = fromBytes.getGenotype("s1");
+        Assert.assertTrue(g1.isPhased());
+        Assert.assertEquals(g1.getAlleles(), Arrays.asList(fromBytes.getReference(), fromBytes.getAlternateAllele(0)));
+        Assert.assertEquals(g1.getAD(), new int[]{3, 4, 0});
+        Assert.assertEquals(g1.getDP(), 7);
+        Assert.assertEquals(g1.getGQ(), 13);
+        Assert.assertEquals(g1.getPL(), new int[]{10, 0, 20, 30, 40, 50});
+        Assert.assertEquals(g1.getExtendedAttribute("XX"), "foo");
+
+        final Genotype g2 = fromBytes.getGenotype("s2");
+        Assert.assertTrue(g2.isNoCall());
+        Assert.assertFalse(g2.hasAD() || g2.hasDP() || g2.hasGQ() || g2.hasPL());
+        Assert.assertFalse(g2.hasExtendedAttribute("XX"));
+
+        final Genotype g3 = fromBytes.getGenotype("s3");
+        Assert.assertFalse(g3.isPhased());
+        Assert.assertEquals(g3.getAlleles(), fromBytes.getAlternateAlleles());
+        Assert.assertEquals(g3.getAD(), new int[]{1, 2, 3});
+        Assert.assertFalse(g3.hasDP());
+    }
+
+    @Test
+    public void testDecodeFromByteSource() {
+        final String line = "chr1\t100\trs1\tA\tC\t50\tPASS\tDP=20\tGT:AD:DP\t0|1:3,4:7\t./.:.:.\t1/1:0,5:5";
+        final String vcf = BYTE_DECODE_HEADER + line + "\r\n";
+        final VCFCodec codec = new VCFCodec();
+        final LineIterator source = codec.makeSourceFromStream(new ByteArrayInputStream(vcf.getBytes(StandardCharsets.UTF_8)));
+        codec.readActualHeader(source);
+        final VariantContext vc = codec.decode(source);
+        Assert.assertFalse(source.hasNext());
+
+        // the genotype columns are kept as bytes, and written out as they are
+        final Object unparsed = ((LazyGenotypesContext) vc.getGenotypes()).getUnparsedGenotypeData();
+        Assert.assertTrue(unparsed instanceof AbstractVCFCodec.UnparsedGenotypes);
+        Assert.assertEquals(new VCFEncoder(codec.getHeader(), false, false).encode(vc), line);
+        VariantBaseTest.assertVariantContextsAreEqual(vc, codecWithHeader().decode(line));
+    }
+
+    @Test
+    public void testDecodeBytesMatchesDecodeString() throws IOException {
+        final File vcf = new File(VariantBaseTest.variantTestDataRoot + "ex2.vcf");
+        final VCFCodec stringCodec = new VCFCodec();
+        final VCFCodec byteCodec = new VCFCodec();
+        try (final LineIteratorImpl lines = new LineIteratorImpl(new SynchronousLineReader(Files.newBufferedReader(vcf.toPath())))) {
+            stringCodec.readActualHeader(lines);
+        }
+        try (final LineIteratorImpl lines = new LineIteratorImpl(new SynchronousLineReader(Files.newBufferedReader(vcf.toPath())))) {
+            byteCodec.readActualHeader(lines);
+        }
+        int nRecords = 0;
+        for (final String line : Files.readAllLines(vcf.toPath())) {
+            if (line.startsWith(VCFHeader.HEADER_INDICATOR)) {
+                Assert.assertNull(byteCodec.decode(line.getBytes(StandardCharsets.UTF_8), line.length()));
+                continue;
+            }
+            final VariantContext expected = stringCodec.decode(line);
+            final VariantContext actual = byteCodec.decode(line.getBytes(StandardCharsets.UTF_8), line.length());
+            VariantBaseTest.assertVariantContextsAreEqual(actual, expected);
+            nRecords++;
+        }
+        Assert.assertTrue(nRecords > 0);
+    }
+
+    @Test(expectedExceptions = TribbleException.class)
+    public void testDecodeBytesWrongNumberOfGenotypes() {
+        final String line = "chr1\t100\t.\tA\tC\t50\tPASS\t.\tGT\t0/1\t0/0";
+        codecWithHeader().decode(line.getBytes(StandardCharsets.UTF_8), line.length()).getGenotype("s1");
+    }
+
+    @Test(expectedExceptions = TribbleException.class)
+    public void testDecodeBytesBadPosition() {
+        final String line = "chr1\t1x0\t.\tA\tC\t50\tPASS\t.\tGT\t0/1\t0/0\t0/0";
+        codecWithHeader().decode(line.getBytes(StandardCharsets.UTF_8), line.length());
+    }
+
+    @Test
+    public void testDecodeStringsOfDifferentLengths() {
+        final VCFCodec codec = codecWithHeader();
+        final String longLine = "chr1\t100\trs" + String.join("", Collections.nCopies(2000, "1")) +
+                "\tA\tC,G\t50\tPASS\tDP=20\tGT:AD\t0|1:3,4,0\t./.:.\t1/2:1,2,3";
+        final String shortLine = "chr1\t101\trs2\tA\tC\t50\tPASS\tDP=5\tGT\t0/1\t0/0\t1/1";
+        // a line that is not ASCII has more UTF-8 bytes than chars
+        final String nonAsciiLine = "chr1\t102\trs\u00e9\tA\tC\t50\tPASS\tDP=6\tGT\t0/1\t0/0\t1/1";
+        for (final String line : Arrays.asList(longLine, shortLine, nonAsciiLine, shortLine)) {
+            VariantBaseTest.assertVariantContextsAreEqual(codec.decode(line),
+                    codecWithHeader().decode(line.getBytes(StandardCharsets.UTF_8), line.getBytes(StandardCharsets.UTF_8).length));
+        }
+        Assert.assertEquals(codec.decode(nonAsciiLine).getID(), "rs\u00e9");
+        Assert.assertEquals(codec.decode(longLine).getGenotype("s3").getAD(), new int[]{1, 2, 3});
+    }
+
+    @Test
+    public void testCopySubclassForDecoding() {
+        Assert.assertTrue(codecWithHeader().canCopyForDecoding());
+        // a subclass may have state of its own, so is only copied if it says how
+        final VCFCodec subclass = new VCFCodec() {};
+        Assert.assertFalse(subclass.canCopyForDecoding());
+    }
+
+    @Test
+    public void testDecodeSitesOnly() {
+        final String line = "chr1\t100\trs1\tA\tC,G\t50\tPASS\tDP=20;Z\tGT:AD\t0|1:3,4,0\t./.:.\t1/2:1,2,3";
+        final VariantContext full = codecWithHeader().decode(line);
+        final VCFCodec codec = codecWithHeader();
+        codec.setSitesOnly(true);
+        Assert.assertTrue(codec.getSitesOnly());
+        Assert.assertTrue(codec.copyForDecoding().getSitesOnly());
+        for (final VariantContext sites : Arrays.asList(codec.decode(line), codec.decode(line.getBytes(StandardCharsets.UTF_8), line.length()))) {
+            Assert.assertFalse(sites.hasGenotypes());
+            Assert.assertEquals(sites.getAttribute("Z"), true);
+            VariantBaseTest.assertVariantContextsAreEqual(sites, new VariantContextBuilder(full).noGenotypes().make());
+        }
+
+        // lines already cut after INFO are accepted as well
+        final String sitesLine = line.substring(0, line.indexOf("\tGT:AD"));
+        VariantBaseTest.assertVariantContextsAreEqual(codec.decode(sitesLine), new VariantContextBuilder(full).noGenotypes().make());
+    }
+
+    @Test(expectedExceptions = TribbleException.class)
+    public void testDecodeSitesOnlyTooFewColumns() {
+        final VCFCodec codec = codecWithHeader();
+        codec.setSitesOnly(true);
+        codec.decode("chr1\t100\t.\tA\tC\t50\tPASS");
+    }
+
+    @Test
+    public void testAllelesAreInterned() {
+        final String longAllele = "ACGTACGTACGTACGTACGTACGTACGTACGTA";
+        final VCFCodec codec = codecWithHeader();
+        final VariantContext vc1 = codec.decode("chr1\t100\t.\tac\tA,<DEL>,AT," + longAllele + "\t.\tPASS\t.\tGT\t0/1\t1/2\t0/0");
+        final VariantContext vc2 = codec.decode("chr1\t200\t.\tAC\tA,<DEL>,AT," + longAllele + "\t.\tPASS\t.\tGT\t0/1\t1/2\t0/0");
+        Assert.assertEquals(vc1.getAlleles(), Arrays.asList(Allele.create("AC", true), Allele.create("A"), Allele.create("<DEL>"),
+                Allele.create("AT"), Allele.create(longAllele)));
+        Assert.assertEquals(vc2.getAlleles(), vc1.getAlleles());
+
+        // short alleles are shared by the two records, but an allele that is too long to intern is not
+        for (int i = 1; i < 4; i++) {
+            Assert.assertSame(vc2.getAlleles().get(i), vc1.getAlleles().get(i));
+        }
+        Assert.assertNotSame(vc2.getAlleles().get(4), vc1.getAlleles().get(4));
+        // the lower case reference is a different key, but the same allele once upper cased
+        Assert.assertEquals(vc2.getReference(), vc1.getReference());
+
+        Assert.assertEquals(vc1.getGenotype("s2").getAlleles(), Arrays.asList(vc1.getAlternateAllele(0), vc1.getAlternateAllele(1)));
+        Assert.assertEquals(vc2.getGenotype("s2").getAlleles(), Arrays.asList(vc2.getAlternateAllele(0), vc2.getAlternateAllele(1)));
+    }
+
+    @Test
+    public void testGenotypeAllelesOfRecordsWithDifferentAlleles() {
+        final VCFCodec codec = codecWithHeader();
+        final VariantContext vc1 = codec.decode("chr1\t100\t.\tA\tC\t.\tPASS\t.\tGT\t0/1\t1/1\t0/0");
+        final VariantContext vc2 = codec.decode("chr1\t200\t.\tA\tG\t.\tPASS\t.\tGT\t0/1\t1/1\t0/0");
+        final VariantContext vc3 = codec.decode("chr1\t300\t.\tA\tC\t.\tPASS\t.\tGT\t0/1\t1/1\t0/0");
+        // genotypes are decoded lazily, in a different order from the records
+        for (final VariantContext vc : Arrays.asList(vc2, vc1, vc3, vc2)) {
+            Assert.assertEquals(vc.getGenotype("s1").getAlleles(), Arrays.asList(vc.getReference(), vc.getAlternateAllele(0)));
+            Assert.assertEquals(vc.getGenotype("s2").getAlleles(), Arrays.asList(vc.getAlternateAllele(0), vc.getAlternateAllele(0)));
+        }
+    }
+
+    @Test
+    public void testDecodeSelectedSamples() {
+        final String line = "chr1\t100\trs1\tA\tC,G\t50\tPASS\tDP=20\tGT:AD:XX\t0|1:3,4,0:foo\t./.:.:.\t1/2:1,2,3";
+        final VariantContext full = codecWithHeader().decode(line);
+        final Set<String> samples = new HashSet<>(Arrays.asList("s3", "s1"));
+        for (final boolean columnar : new boolean[]{false, true}) {
+            final VCFCodec codec = codecWithHeader();
+            codec.setUseColumnarGenotypes(columnar);
+            codec.setSamplesToDecode(samples);
+            Assert.assertEquals(codec.getSamplesToDecode(), samples);
+            Assert.assertEquals(codec.copyForDecoding().getSamplesToDecode(), samples);
+
+            final VariantContext vc = codec.decode(line);
+            Assert.assertEquals(vc.getNSamples(), 2);
+            Assert.assertEquals(vc.getSampleNamesOrderedByName(), Arrays.asList("s1", "s3"));
+            Assert.assertNull(vc.getGenotype("s2"));
+            VariantBaseTest.assertVariantContextsAreEqual(vc, full.subContextFromSamples(samples, false));
+        }
+    }
+
+    @Test(expectedExceptions = IllegalArgumentException.class)
+    public void testDecodeSamplesNotInHeader() {
+        codecWithHeader().setSamplesToDecode(Arrays.asList("s1", "notASample"));
+    }
+
+    @Test
+    public void testLineReader() throws IOException {
+        final String vcf = "##fileformat=VCFv4.2\n" +
+                "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT\ts1\r\n" +
+                "chr1\t1\t.\tA\tC\t.\tPASS\tDP=1\tGT\t0/1\r\n" +
+                "\n" +
+                "chr1\t2\t.\tA\tC\t.\tPASS\tDP=2\r\n" +
+                "chr1\t3\t.\tA\tC\t.\tPASS\t.\tGT\t0/1";
+        final List<String> expected = Arrays.asList(
+                "##fileformat=VCFv4.2",
+                "#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT\ts1",
+                "chr1\t1\t.\tA\tC\t.\tPASS\tDP=1",
+                "",
+                "chr1\t2\t.\tA\tC\t.\tPASS\tDP=2",
+                "chr1\t3\t.\tA\tC\t.\tPASS\t.");
+        try (final VCFLineReader reader = new VCFLineReader(new ByteArrayInputStream(vcf.getBytes(StandardCharsets.UTF_8)), 8)) {
+            for (final String line : expected) {
+                Assert.assertEquals(reader.readLine(), line);
+            }
+            Assert.assertNull(reader.readLine());
+        }
+
+        // genotype columns and INFO columns longer than the buffer of the reader
+        final StringBuilder genotypes = new StringBuilder("GT");
+        final StringBuilder info = new StringBuilder("X=");
+        for (int i = 0; i < 100000; i++) {
+            genotypes.append("\t0/1");
+            info.append(i % 10);
+        }
+        final String input = "#CHROM\n" +
+                "chr1\t4\t.\tA\tC\t.\tPASS\tDP=4\t" + genotypes + "\n" +
+                "chr1\t5\t.\tA\tC\t.\tPASS\t" + info + "\t" + genotypes + "\n";
+        try (final VCFLineReader reader = new VCFLineReader(new ByteArrayInputStream(input.getBytes(StandardCharsets.UTF_8)), 8)) {
+            Assert.assertEquals(reader.readLine(), "#CHROM");
+            Assert.assertEquals(reader.readLine(), "chr1\t4\t.\tA\tC\t.\tPASS\tDP=4");
+            Assert.assertEquals(reader.readLine(), "chr1\t5\t.\tA\tC\t.\tPASS\t" + info);
+            Assert.assertNull(reader.readLine());
+        }
+
+        // whole lines
+        try (final VCFLineReader reader = new VCFLineReader(new ByteArrayInputStream(input.getBytes(StandardCharsets.UTF_8)), VCFLineReader.ALL_COLUMNS)) {
+            Assert.assertEquals(reader.readLine(), "#CHROM");
+            Assert.assertEquals(reader.readLine(), "chr1\t4\t.\tA\tC\t.\tPASS\tDP=4\t" + genotypes);
+            Assert.assertEquals(reader.readLine(), "chr1\t5\t.\tA\tC\t.\tPASS\t" + info + "\t" + genotypes);
+            Assert.assertNull(reader.readLine());
+        }
+
+        // lines ending with a lone '\r', as in classic Mac OS files, read a few bytes at a time so that "\r\n" is
+        // split between reads
+        final String mac = "##fileformat=VCFv4.2\r#CHROM\tPOS\r\n" +
+                "chr1\t6\t.\tA\tC\t.\tPASS\tDP=6\tGT\t0/1\r" +
+                "\r" +
+                "chr1\t7\t.\tA\tC\t.\tPASS\tDP=7\tGT\t0/1\r\n" +
+                "chr1\t8\t.\tA\tC\t.\tPASS\tDP=8\r";
+        final List<String> macLines = Arrays.asList(
+                "##fileformat=VCFv4.2",
+                "#CHROM\tPOS",
+                "chr1\t6\t.\tA\tC\t.\tPASS\tDP=6",
+                "",
+                "chr1\t7\t.\tA\tC\t.\tPASS\tDP=7",
+                "chr1\t8\t.\tA\tC\t.\tPASS\tDP=8");
+        for (int chunk = 1; chunk <= 4; chunk++) {
+            final int maxRead = chunk;
+            final InputStream in = new FilterInputStream(new ByteArrayInputStream(mac.getBytes(StandardCharsets.UTF_8))) {
+                @Override
+                public int read(final byte[] b, final int off, final int len) throws IOException {
+                    return super.read(b, off, Math.min(len, maxRead));
+                }
+            };
+            try (final VCFLineReader reader = new VCFLineReader(in, 8)) {
+                for (final String line : macLines) {
+                    Assert.assertEquals(reader.readLine(), line);
+                }
+                Assert.assertNull(reader.readLine());
+            }
+        }
+    }
+
+    @Test
+    public void testParseIntFromBytes() {
+        for (final String s : new String[]{"0", "7", "-12", "+5", "2147483647", "-2147483648"}) {
+            final byte[] b = s.getBytes(StandardCharsets.US_ASCII);
+            Assert.assertEquals(VCFByteUtils.parseInt(b, 0, b.length), Integer.parseInt(s));
+        }
+        for (final String s : new String[]{"", "-", "1.5", "2147483648", "-2147483649", "12a"}) {
+            final byte[] b = s.getBytes(StandardCharsets.US_ASCII);
+            Assert.assertThrows(NumberFormatException.class, () -> VCFByteUtils.parseInt(b, 0, b.length));
+        }
+    }
 }
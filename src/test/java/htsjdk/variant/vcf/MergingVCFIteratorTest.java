@@ -0,0 +1,248 @@
+/*
+ * The MIT License
+ *
+ * Copyright (c) 2020 The Broad Institute
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+package htsjdk.variant.vcf;
+
+import htsjdk.samtools.util.Tuple;
+import htsjdk.variant.VariantBaseTest;
+import htsjdk.variant.variantcontext.Genotype;
+import htsjdk.variant.variantcontext.VariantContext;
+import htsjdk.variant.variantcontext.VariantContextBuilder;
+import htsjdk.variant.variantcontext.VariantContextComparator;
+import htsjdk.variant.variantcontext.writer.Options;
+import htsjdk.variant.variantcontext.writer.VariantContextWriter;
+import htsjdk.variant.variantcontext.writer.VariantContextWriterBuilder;
+import org.testng.Assert;
+import org.testng.annotations.DataProvider;
+import org.testng.annotations.Test;
+
+import java.io.IOException;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.HashSet;
+import java.util.List;
+import java.util.Set;
+import java.util.stream.Collectors;
+import java.util.stream.IntStream;
+import java.util.stream.Stream;
+
+public class MergingVCFIteratorTest extends VariantBaseTest {
+    private static final Path TEST_VCF = Paths.get(variantTestDataRoot, "ILLUMINA.wex.broad_phase2_baseline.20111114.both.exome.genotypes.1000.vcf");
+
+    private static Path writeShard(final VCFHeader header, final List<VariantContext> records) {
+        return writeShard(header, records, ".vcf");
+    }
+
+    private static Path writeShard(final VCFHeader header, final List<VariantContext> records, final String extension) {
+        final Path shard = createTempFile("merging.shard.", extension).toPath();
+        try (final VariantContextWriter writer = new VariantContextWriterBuilder()
+                .setOutputPath(shard)
+                .unsetOption(Options.INDEX_ON_THE_FLY)
+                .build()) {
+            writer.writeHeader(header);
+            records.forEach(writer::add);
+        }
+        return shard;
+    }
+
+    /** Splits the records of the test VCF round-robin into numShards sorted shards */
+    private static List<Path> writeShards(final Tuple<VCFHeader, List<VariantContext>> vcf, final int numShards) {
+        final List<Path> shards = new ArrayList<>(numShards);
+        for (int shard = 0; shard < numShards; shard++) {
+            final int s = shard;
+            shards.add(writeShard(vcf.a, IntStream.range(0, vcf.b.size())
+                    .filter(i -> i % numShards == s)
+                    .mapToObj(vcf.b::get)
+                    .collect(Collectors.toList())));
+        }
+        return shards;
+    }
+
+    private static String key(final VariantContext vc) {
+        return vc.getContig() + ":" + vc.getStart() + ":" + vc.getID() + ":" + vc.getAlleles();
+    }
+
+    @DataProvider
+    public Object[][] mergeParameters() {
+        return new Object[][]{
+                // shards, maxOpenInputs, prefetchThreads
+                {1, 256, 0},
+                {7, 256, 0},
+                {7, 256, 3},
+                {20, 3, 0},
+                {20, 3, 2},
+                {20, 2, 4},
+        };
+    }
+
+    @Test(dataProvider = "mergeParameters")
+    public void testMergeShards(final int numShards, final int maxOpenInputs, final int prefetchThreads) throws IOException {
+        final Tuple<VCFHeader, List<VariantContext>> vcf = readEntireVCFIntoMemory(TEST_VCF);
+        final List<Path> shards = writeShards(vcf, numShards);
+
+        // ties are returned in input order, so the expected order is stable in shard and then original order
+        final VariantContextComparator comparator = new VariantContextComparator(vcf.a.getContigLines());
+        final List<VariantContext> expected = IntStream.range(0, vcf.b.size()).boxed()
+                .sorted((i, j) -> {
+                    final int cmp = comparator.compare(vcf.b.get(i), vcf.b.get(j));
+                    return cmp != 0 ? cmp : Integer.compare(i % numShards, j % numShards);
+                })
+                .map(vcf.b::get)
+                .collect(Collectors.toList());
+
+        final List<VariantContext> merged = new ArrayList<>();
+        try (final MergingVCFIterator it = new MergingVCFIterator(shards, maxOpenInputs, prefetchThreads, null)) {
+            Assert.assertEquals(it.getHeader().getGenotypeSamples(), vcf.a.getGenotypeSamples());
+            // genotypes are checked as records are returned, while inputs are still being read ahead
+            while (it.hasNext()) {
+                final VariantContext vc = it.next();
+                Assert.assertTrue(merged.size() < expected.size());
+                assertVariantContextsAreEqual(vc, expected.get(merged.size()));
+                merged.add(vc);
+            }
+        }
+        Assert.assertEquals(merged.stream().map(MergingVCFIteratorTest::key).collect(Collectors.toList()),
+                expected.stream().map(MergingVCFIteratorTest::key).collect(Collectors.toList()));
+        Assert.assertEquals(merged.get(0).getGenotypes().size(), vcf.a.getNGenotypeSamples());
+    }
+
+    @Test
+    public void testMergeDeletesIntermediateFiles() throws IOException {
+        final Tuple<VCFHeader, List<VariantContext>> vcf = readEntireVCFIntoMemory(TEST_VCF);
+        final List<Path> shards = writeShards(vcf, 9);
+        final Path tmpDir = Files.createTempDirectory("merging.tmp.");
+        try (final MergingVCFIterator it = new MergingVCFIterator(shards, 2, 0, tmpDir)) {
+            Assert.assertEquals(it.toList().size(), vcf.b.size());
+            try (final Stream<Path> files = Files.list(tmpDir)) {
+                Assert.assertTrue(files.count() > 0);
+            }
+        }
+        try (final Stream<Path> files = Files.list(tmpDir)) {
+            Assert.assertEquals(files.count(), 0L);
+        }
+        Files.delete(tmpDir);
+    }
+
+    private static List<VariantContext> mergeAll(final List<Path> inputs, final int maxOpenInputs) throws IOException {
+        try (final MergingVCFIterator it = new MergingVCFIterator(inputs, maxOpenInputs, 0, null)) {
+            return it.toList();
+        }
+    }
+
+    // BCF inputs are merged into BCF intermediates, as VCF would round their floating point values
+    @Test
+    public void testIntermediateMergesKeepBCFValues() throws IOException {
+        final Tuple<VCFHeader, List<VariantContext>> vcf = readEntireVCFIntoMemory(TEST_VCF);
+        final VCFHeader header = new VCFHeader(vcf.a);
+        header.addMetaDataLine(new VCFInfoHeaderLine("XF", 1, VCFHeaderLineType.Float, "more digits than VCF writes"));
+        final List<VariantContext> records = IntStream.range(0, vcf.b.size())
+                .mapToObj(i -> new VariantContextBuilder(vcf.b.get(i)).attribute("XF", 0.123456 + i).make())
+                .collect(Collectors.toList());
+        final int numShards = 7;
+        final List<Path> shards = new ArrayList<>(numShards);
+        for (int shard = 0; shard < numShards; shard++) {
+            final int s = shard;
+            shards.add(writeShard(header, IntStream.range(0, records.size())
+                    .filter(i -> i % numShards == s)
+                    .mapToObj(records::get)
+                    .collect(Collectors.toList()), ".bcf"));
+        }
+
+        final List<VariantContext> direct = mergeAll(shards, 256);
+        final List<VariantContext> intermediate = mergeAll(shards, 2);
+        Assert.assertEquals(intermediate.size(), direct.size());
+        Assert.assertEquals(direct.size(), records.size());
+        for (int i = 0; i < direct.size(); i++) {
+            Assert.assertEquals(key(intermediate.get(i)), key(direct.get(i)));
+            Assert.assertEquals(intermediate.get(i).getAttributeAsDouble("XF", -1), direct.get(i).getAttributeAsDouble("XF", -1));
+            assertVariantContextsAreEqual(intermediate.get(i), direct.get(i));
+        }
+    }
+
+    @Test
+    public void testMergeUnionsSamples() throws IOException {
+        final Tuple<VCFHeader, List<VariantContext>> vcf = readEntireVCFIntoMemory(TEST_VCF);
+        final List<String> samples = vcf.a.getGenotypeSamples();
+        final List<String> firstSamples = samples.subList(0, 2);
+        final List<String> secondSamples = samples.subList(2, 4);
+
+        final List<Path> shards = new ArrayList<>();
+        for (final List<String> shardSamples : Arrays.asList(firstSamples, secondSamples)) {
+            final Set<String> sampleSet = new HashSet<>(shardSamples);
+            final int parity = shards.size();
+            shards.add(writeShard(new VCFHeader(vcf.a.getMetaDataInInputOrder(), shardSamples),
+                    IntStream.range(0, vcf.b.size())
+                            .filter(i -> i % 2 == parity)
+                            .mapToObj(i -> vcf.b.get(i).subContextFromSamples(sampleSet, false))
+                            .collect(Collectors.toList())));
+        }
+
+        final Path mergedVcf = createTempFile("merging.samples.", ".vcf").toPath();
+        try (final MergingVCFIterator it = new MergingVCFIterator(shards);
+             final VariantContextWriter writer = new VariantContextWriterBuilder()
+                     .setOutputPath(mergedVcf)
+                     .unsetOption(Options.INDEX_ON_THE_FLY)
+                     .build()) {
+            Assert.assertEquals(it.getHeader().getGenotypeSamples(), samples.subList(0, 4));
+            writer.writeHeader(it.getHeader());
+            it.forEachRemaining(writer::add);
+        }
+
+        final Tuple<VCFHeader, List<VariantContext>> merged = readEntireVCFIntoMemory(mergedVcf);
+        Assert.assertEquals(merged.a.getGenotypeSamples(), samples.subList(0, 4));
+        Assert.assertEquals(merged.b.size(), vcf.b.size());
+        for (final VariantContext vc : merged.b) {
+            final VariantContext original = vcf.b.stream().filter(o -> key(o).equals(key(vc))).findFirst().get();
+            final int index = vcf.b.indexOf(original);
+            final List<String> present = index % 2 == 0 ? firstSamples : secondSamples;
+            final List<String> absent = index % 2 == 0 ? secondSamples : firstSamples;
+            for (final String sample : present) {
+                final Genotype genotype = vc.getGenotype(sample);
+                Assert.assertEquals(genotype.getGenotypeString(), original.getGenotype(sample).getGenotypeString());
+            }
+            for (final String sample : absent) {
+                Assert.assertTrue(vc.getGenotype(sample).isNoCall());
+            }
+        }
+    }
+
+    @Test(expectedExceptions = IllegalStateException.class)
+    public void testUnsortedInput() throws IOException {
+        final Tuple<VCFHeader, List<VariantContext>> vcf = readEntireVCFIntoMemory(TEST_VCF);
+        final List<VariantContext> reversed = new ArrayList<>(vcf.b);
+        Collections.reverse(reversed);
+        final Path unsorted = writeShard(vcf.a, reversed);
+        try (final MergingVCFIterator it = new MergingVCFIterator(Arrays.asList(unsorted, writeShards(vcf, 1).get(0)))) {
+            it.toList();
+        }
+    }
+
+    @Test(expectedExceptions = IllegalArgumentException.class)
+    public void testMaxOpenInputsTooSmall() throws IOException {
+        new MergingVCFIterator(Collections.singletonList(TEST_VCF), 1, 0, null);
+    }
+}
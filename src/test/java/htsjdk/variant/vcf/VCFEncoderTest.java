@@ -145,6 +145,62 @@ public class VCFEncoderTest extends HtsjdkTest {
         Assert.assertEquals(columns[nCol-1], expectedLastColumn, "Format fields don't handle missing data in the expected way");
     }
 
+    @DataProvider(name = "VCFFieldFormatTestData")
+    public Object[][] makeVCFFieldFormatTestData() {
+        return new Object[][]{
+                {null, "."},
+                {"abc", "abc"},
+                {-12, "-12"},
+                {Integer.MIN_VALUE, "-2147483648"},
+                {0.25, "0.250"},
+                {Boolean.TRUE, ""},
+                {Boolean.FALSE, null},
+                {Collections.emptyList(), "."},
+                {Arrays.asList(1, null, "x"), "1,.,x"},
+                {Arrays.asList(0.5, 0.001, 12.0), "0.500,1.000e-03,12.00"},
+                {new int[0], "."},
+                {new int[]{0, -1, 100}, "0,-1,100"},
+                {new double[]{1.0, 0.05}, "1.00,0.050"},
+                {new Object[]{"a", 2}, "a,2"},
+                {new long[]{3L, 4L}, "3,4"},
+        };
+    }
+
+    @Test(dataProvider = "VCFFieldFormatTestData")
+    public void testFormatVCFField(final Object value, final String expected) {
+        final VCFEncoder encoder = new VCFEncoder(createSyntheticHeader(Collections.singletonList("Sample1")), true, false);
+        Assert.assertEquals(encoder.formatVCFField(value), expected);
+    }
+
+    @Test
+    public void testEncodeRecord() {
+        final VCFEncoder encoder = new VCFEncoder(createSyntheticHeader(Arrays.asList("Sample1", "Sample2")), true, false);
+        final Allele ref = Allele.create("A", true);
+        final Allele alt = Allele.create("C");
+        final Map<String, Object> attributes = new HashMap<>();
+        attributes.put("ZZ", 1.5);
+        attributes.put("AF", Arrays.asList(0.5, 0.001));
+        attributes.put("FL", true);
+        attributes.put("F2", "1");
+        attributes.put("NO", false);
+        attributes.put("IA", new int[]{1, 2});
+        final VariantContext vc = new VariantContextBuilder("test", "1", 100, 100, Arrays.asList(ref, alt))
+                .log10PError(-3.5)
+                .filters("q10", "a5")
+                .attributes(attributes)
+                .genotypes(
+                        new GenotypeBuilder("Sample1", Arrays.asList(ref, alt)).AD(new int[]{3, 4}).DP(7).GQ(20)
+                                .PL(new int[]{0, 10, 100}).attribute("XD", 0.25).make(),
+                        new GenotypeBuilder("Sample2", Arrays.asList(ref, ref)).DP(5).make())
+                .make();
+
+        // reuse the encoder to check that no state leaks between records
+        for (int i = 0; i < 2; i++) {
+            Assert.assertEquals(encoder.encode(vc),
+                    "1\t100\t.\tA\tC\t35\ta5;q10\tAF=0.500,1.000e-03;F2;FL;IA=1,2;ZZ=1.50\tGT:AD:DP:GQ:PL:XD\t0/1:3,4:7:20:0,10,100:0.250\t0/0:.:5");
+        }
+    }
+
     private static Set<VCFHeaderLine> createSyntheticMetadata() {
         final Set<VCFHeaderLine> metaData = new TreeSet<>();
 
@@ -154,6 +210,8 @@ public class VCFEncoderTest extends HtsjdkTest {
         metaData.add(new VCFFormatHeaderLine("AA", 1, VCFHeaderLineType.String, "aa"));
         metaData.add(new VCFFormatHeaderLine("BB", 1, VCFHeaderLineType.Integer, "bb"));
         metaData.add(new VCFFormatHeaderLine("CC", 3, VCFHeaderLineType.Integer, "CC"));
+        metaData.add(new VCFInfoHeaderLine("FL", 0, VCFHeaderLineType.Flag, "flag"));
+        metaData.add(new VCFInfoHeaderLine("F2", 0, VCFHeaderLineType.Flag, "flag with a value"));
         return metaData;
     }
 
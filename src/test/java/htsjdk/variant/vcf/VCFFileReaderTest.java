@@ -5,8 +5,12 @@ import com.google.common.jimfs.Jimfs;
 import htsjdk.HtsjdkTest;
 import htsjdk.samtools.seekablestream.SeekableStream;
 import htsjdk.samtools.seekablestream.SeekableStreamFactory;
+import htsjdk.samtools.util.CloseableIterator;
 import htsjdk.samtools.util.IOUtil;
 import htsjdk.tribble.TestUtils;
+import htsjdk.variant.VariantBaseTest;
+import htsjdk.variant.variantcontext.VariantContext;
+import htsjdk.variant.variantcontext.VariantContextBuilder;
 import org.testng.Assert;
 import org.testng.annotations.DataProvider;
 import org.testng.annotations.Test;
@@ -19,6 +23,7 @@ import java.nio.file.Paths;
 import java.util.ArrayList;
 import java.util.Iterator;
 import java.util.List;
+import java.util.stream.Collectors;
 
 /**
  * Created by farjoun on 10/12/17.
@@ -73,9 +78,9 @@ public class VCFFileReaderTest extends HtsjdkTest {
 //
 //                // testing that v4.2 parses Source/Version fields, see issue #517
                 {TEST_DATA_DIR + "Vcf4.2WithSourceVersionInfoFields.vcf", null, false, true},
-//
-//                // should reject bcf v2.2 on read, see issue https://github.com/samtools/htsjdk/issues/1323
-                {TEST_DATA_DIR + "BCFVersion22Uncompressed.bcf", null, false, false}
+
+                // BCF 2.2, as written by bcftools
+                {TEST_DATA_DIR + "BCFVersion22Uncompressed.bcf", null, false, true}
         };
     }
 
@@ -102,6 +107,38 @@ public class VCFFileReaderTest extends HtsjdkTest {
         Assert.assertTrue(shouldSucceed, "Test should have failed but succeeded");
     }
 
+    @Test
+    public void testSitesOnly() {
+        final File vcf = new File(TEST_DATA_DIR, "HiSeq.10000.vcf.bgz");
+        try (final VCFFileReader fullReader = new VCFFileReader(vcf);
+             final VCFFileReader sitesReader = new VCFFileReader(vcf)) {
+            sitesReader.setSitesOnly(true);
+            Assert.assertEquals(sitesReader.getFileHeader().getGenotypeSamples(), fullReader.getFileHeader().getGenotypeSamples());
+
+            final List<VariantContext> expected;
+            try (final CloseableIterator<VariantContext> it = fullReader.iterator()) {
+                expected = it.stream().map(vc -> new VariantContextBuilder(vc).noGenotypes().make()).collect(Collectors.toList());
+            }
+            final List<VariantContext> actual;
+            try (final CloseableIterator<VariantContext> it = sitesReader.iterator()) {
+                actual = it.toList();
+            }
+            Assert.assertEquals(actual.size(), expected.size());
+            for (int i = 0; i < expected.size(); i++) {
+                Assert.assertFalse(actual.get(i).hasGenotypes());
+                VariantBaseTest.assertVariantContextsAreEqual(actual.get(i), expected.get(i));
+            }
+
+            // queries read whole lines from the index, whose genotype columns are then ignored
+            final VariantContext first = expected.get(0);
+            try (final CloseableIterator<VariantContext> it = sitesReader.query(first.getContig(), first.getStart(), first.getStart())) {
+                final VariantContext queried = it.next();
+                Assert.assertFalse(queried.hasGenotypes());
+                VariantBaseTest.assertVariantContextsAreEqual(queried, first);
+            }
+        }
+    }
+
     @Test
     public void testTabixFileWithEmbeddedSpaces() throws IOException {
         final File testVCF =  new File(TEST_DATA_DIR, "HiSeq.10000.vcf.bgz");
@@ -23,14 +23,21 @@
 */
 package htsjdk.variant.vcf;
 
+import java.io.ByteArrayInputStream;
 import java.io.File;
 import java.io.FileInputStream;
 import java.io.FileOutputStream;
 import java.io.IOException;
 import java.io.InputStream;
 import java.io.OutputStream;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
 import java.nio.file.Path;
 import java.nio.file.Paths;
+import java.util.ArrayList;
+import java.util.HashSet;
+import java.util.List;
+import java.util.Set;
 import java.util.function.Function;
 import java.util.zip.GZIPOutputStream;
 
@@ -40,11 +47,18 @@ import org.testng.annotations.Test;
 
 import htsjdk.samtools.util.BlockCompressedInputStream;
 import htsjdk.samtools.util.BlockCompressedOutputStream;
+import htsjdk.samtools.util.CloseableIterator;
 import htsjdk.samtools.util.CloserUtil;
 import htsjdk.samtools.util.FileExtensions;
 import htsjdk.samtools.util.IOUtil;
 import htsjdk.samtools.util.RuntimeIOException;
+import htsjdk.tribble.TribbleException;
+import htsjdk.tribble.readers.LineIterator;
 import htsjdk.variant.VariantBaseTest;
+import htsjdk.variant.variantcontext.VariantContext;
+import htsjdk.variant.variantcontext.VariantContextBuilder;
+import htsjdk.variant.variantcontext.writer.VariantContextWriter;
+import htsjdk.variant.variantcontext.writer.VariantContextWriterBuilder;
 
 public class VCFIteratorTest extends VariantBaseTest {
 
@@ -141,4 +155,221 @@ public class VCFIteratorTest extends VariantBaseTest {
         final VCFIterator r = new VCFIteratorBuilder().open(a_path);
         assertExpectedNumberOfVariants(r, nVariants);
     }
+
+    @DataProvider(name = "ParallelDecoding")
+    public Object[][] getParallelDecodingTests() {
+        final String file = "src/test/resources/htsjdk/tribble/tabix/testTabixIndex.vcf";
+        return new Object[][] {
+                new Object[] { file, 1, 1, false },
+                new Object[] { file, 4, 3, false },
+                new Object[] { file, 4, 3, true },
+                new Object[] { file, 2, 100, true },
+                new Object[] { variantTestDataRoot + "ILLUMINA.wex.broad_phase2_baseline.20111114.both.exome.genotypes.1000.vcf", 3, 64, true }
+        };
+    }
+
+    @Test(dataProvider = "ParallelDecoding")
+    public void testParallelDecodingMatchesSequentialDecoding(final String path, final int nThreads, final int linesPerBatch,
+                                                              final boolean decodeGenotypes) throws IOException {
+        final List<VariantContext> expected = new ArrayList<>();
+        try (final VCFIterator r = new VCFIteratorBuilder().open(path)) {
+            r.forEachRemaining(expected::add);
+        }
+        try (final VCFIterator r = openParallel(new FileInputStream(path), nThreads, linesPerBatch, decodeGenotypes)) {
+            Assert.assertNotNull(r.getHeader());
+            for (final VariantContext vc : expected) {
+                Assert.assertTrue(r.hasNext());
+                assertVariantContextsAreEqual(r.next(), vc);
+            }
+            Assert.assertFalse(r.hasNext());
+        }
+    }
+
+    @Test
+    public void testParallelDecodingWithBuilder() throws IOException {
+        final String path = "src/test/resources/htsjdk/tribble/tabix/testTabixIndex.vcf.gz";
+        try (final VCFIterator r = new VCFIteratorBuilder().setDecodingThreads(4).setDecodeGenotypes(true).open(path)) {
+            Assert.assertTrue(r instanceof ParallelVCFDecodingIterator);
+            assertExpectedNumberOfVariants(r, 25);
+        }
+        try (final VCFFileReader reader = new VCFFileReader(Paths.get(path), false)) {
+            reader.setDecodingThreads(4);
+            try (final CloseableIterator<VariantContext> it = reader.iterator()) {
+                Assert.assertEquals(it.stream().count(), 25);
+            }
+        }
+    }
+
+    @Test
+    public void testParallelFileReaderDecodesWithItsCodec() {
+        final Path path = Paths.get(variantTestDataRoot + "ILLUMINA.wex.broad_phase2_baseline.20111114.both.exome.genotypes.1000.vcf");
+        try (final VCFFileReader sequential = new VCFFileReader(path, false);
+             final VCFFileReader parallel = new VCFFileReader(path, false)) {
+            final List<String> samples = sequential.getHeader().getGenotypeSamples().subList(0, 3);
+            sequential.setSamplesToDecode(samples);
+            parallel.setSamplesToDecode(samples);
+            parallel.setDecodingThreads(3);
+            final List<VariantContext> expected;
+            try (final CloseableIterator<VariantContext> it = sequential.iterator()) {
+                expected = it.toList();
+            }
+            // the genotypes of all records are decoded after the workers have decoded every batch
+            final List<VariantContext> actual;
+            try (final CloseableIterator<VariantContext> it = parallel.iterator()) {
+                actual = it.toList();
+            }
+            Assert.assertEquals(actual.size(), expected.size());
+            for (int i = 0; i < expected.size(); i++) {
+                Assert.assertEquals(actual.get(i).getSampleNames(), new HashSet<>(samples));
+                assertVariantContextsAreEqual(actual.get(i), expected.get(i));
+            }
+        }
+    }
+
+    @DataProvider(name = "SitesOnly")
+    public Object[][] getSitesOnlyTests() {
+        return new Object[][] {
+                new Object[] { "src/test/resources/htsjdk/tribble/tabix/testTabixIndex.vcf", 1 },
+                new Object[] { "src/test/resources/htsjdk/tribble/tabix/testTabixIndex.vcf.gz", 1 },
+                new Object[] { "src/test/resources/htsjdk/tribble/tabix/testTabixIndex.vcf.gz", 4 },
+                new Object[] { "src/test/resources/htsjdk/variant/serialization_test.bcf", 1 }
+        };
+    }
+
+    @Test(dataProvider = "SitesOnly")
+    public void testSitesOnlyMatchesSitesOfFullDecoding(final String path, final int nThreads) throws IOException {
+        final List<VariantContext> expected = new ArrayList<>();
+        final VCFHeader expectedHeader;
+        try (final VCFIterator r = new VCFIteratorBuilder().open(path)) {
+            expectedHeader = r.getHeader();
+            r.forEachRemaining(vc -> expected.add(new VariantContextBuilder(vc).noGenotypes().make()));
+        }
+        try (final VCFIterator r = new VCFIteratorBuilder().setDecodingThreads(nThreads).setSitesOnly(true).open(path)) {
+            Assert.assertEquals(r.getHeader().getGenotypeSamples(), expectedHeader.getGenotypeSamples());
+            for (final VariantContext vc : expected) {
+                Assert.assertTrue(r.hasNext());
+                final VariantContext actual = r.next();
+                Assert.assertFalse(actual.hasGenotypes());
+                assertVariantContextsAreEqual(actual, vc);
+            }
+            Assert.assertFalse(r.hasNext());
+        }
+    }
+
+    @DataProvider(name = "SamplesToDecode")
+    public Object[][] getSamplesToDecodeTests() {
+        final String file = variantTestDataRoot + "ILLUMINA.wex.broad_phase2_baseline.20111114.both.exome.genotypes.1000.vcf";
+        return new Object[][] {
+                new Object[] { file, 1 },
+                new Object[] { file, 3 },
+                new Object[] { "src/test/resources/htsjdk/variant/serialization_test.bcf", 1 }
+        };
+    }
+
+    @Test(dataProvider = "SamplesToDecode")
+    public void testSamplesToDecodeMatchesSubContext(final String path, final int nThreads) throws IOException {
+        final List<VariantContext> all = new ArrayList<>();
+        final List<String> headerSamples;
+        try (final VCFIterator r = new VCFIteratorBuilder().open(path)) {
+            headerSamples = r.getHeader().getGenotypeSamples();
+            r.forEachRemaining(all::add);
+        }
+        // every other sample, so that the selected samples are not contiguous
+        final Set<String> samples = new HashSet<>();
+        for (int i = 0; i < headerSamples.size(); i += 2) {
+            samples.add(headerSamples.get(i));
+        }
+        try (final VCFIterator r = new VCFIteratorBuilder().setDecodingThreads(nThreads).setSamplesToDecode(samples).open(path)) {
+            Assert.assertEquals(r.getHeader().getGenotypeSamples(), headerSamples);
+            for (final VariantContext vc : all) {
+                Assert.assertTrue(r.hasNext());
+                final VariantContext actual = r.next();
+                Assert.assertEquals(actual.getSampleNames(), samples);
+                assertVariantContextsAreEqual(actual, vc.subContextFromSamples(samples, false));
+            }
+            Assert.assertFalse(r.hasNext());
+        }
+    }
+
+    @Test(dataProvider = "SamplesToDecode")
+    public void testSamplesToDecodeRoundTrip(final String path, final int nThreads) throws IOException {
+        final List<VariantContext> all = new ArrayList<>();
+        final VCFHeader header;
+        try (final VCFIterator r = new VCFIteratorBuilder().open(path)) {
+            header = r.getHeader();
+            r.forEachRemaining(all::add);
+        }
+        final List<String> samples = new ArrayList<>();
+        for (int i = 0; i < header.getNGenotypeSamples(); i += 2) {
+            samples.add(header.getGenotypeSamples().get(i));
+        }
+
+        // records read with only some samples are written with a header listing just those samples
+        final String extension = path.endsWith(FileExtensions.BCF) ? FileExtensions.BCF : FileExtensions.VCF;
+        final File output = File.createTempFile("samplesToDecode", extension);
+        output.deleteOnExit();
+        try (final VCFIterator r = new VCFIteratorBuilder().setDecodingThreads(nThreads).setSamplesToDecode(samples).open(path);
+             final VariantContextWriter writer = new VariantContextWriterBuilder()
+                     .clearOptions()
+                     .setOutputFile(output)
+                     .build()) {
+            writer.writeHeader(new VCFHeader(header.getMetaDataInInputOrder(), samples));
+            r.forEachRemaining(writer::add);
+        }
+
+        try (final VCFIterator r = new VCFIteratorBuilder().open(output.toPath())) {
+            Assert.assertEquals(r.getHeader().getGenotypeSamples(), samples);
+            for (final VariantContext vc : all) {
+                Assert.assertTrue(r.hasNext());
+                assertVariantContextsAreEqual(r.next(), vc.subContextFromSamples(new HashSet<>(samples), false));
+            }
+            Assert.assertFalse(r.hasNext());
+        }
+    }
+
+    @Test(expectedExceptions = IllegalArgumentException.class)
+    public void testZeroDecodingThreads() {
+        new VCFIteratorBuilder().setDecodingThreads(0);
+    }
+
+    @Test
+    public void testParallelDecodingRaisesErrorsInOrder() throws IOException {
+        // corrupt the position of the 11th record
+        final List<String> lines = Files.readAllLines(Paths.get("src/test/resources/htsjdk/tribble/tabix/testTabixIndex.vcf"));
+        int nRecords = 0;
+        for (int i = 0; i < lines.size(); i++) {
+            if (!lines.get(i).startsWith("#") && ++nRecords == 11) {
+                lines.set(i, lines.get(i).replace("\t327\t", "\tnotAPosition\t"));
+            }
+        }
+        final byte[] vcf = (String.join("\n", lines) + "\n").getBytes(StandardCharsets.UTF_8);
+
+        final int nSequential = countUntilError(new VCFIteratorBuilder().open(new ByteArrayInputStream(vcf)));
+        final int nParallel = countUntilError(openParallel(new ByteArrayInputStream(vcf), 4, 3, false));
+        Assert.assertEquals(nParallel, nSequential);
+        Assert.assertTrue(nParallel > 0);
+    }
+
+    private static int countUntilError(final VCFIterator r) {
+        int n = 0;
+        try {
+            while (r.hasNext()) {
+                r.next();
+                n++;
+            }
+            Assert.fail("Expected the malformed record to raise an exception");
+        } catch (final TribbleException e) {
+            // expected
+        } finally {
+            r.close();
+        }
+        return n;
+    }
+
+    private static VCFIterator openParallel(final InputStream in, final int nThreads, final int linesPerBatch, final boolean decodeGenotypes) {
+        final VCFCodec codec = new VCFCodec();
+        final LineIterator lineIterator = codec.makeSourceFromStream(in);
+        codec.readActualHeader(lineIterator);
+        return new ParallelVCFDecodingIterator(lineIterator, in, codec, nThreads, linesPerBatch, decodeGenotypes);
+    }
 }
@@ -0,0 +1,68 @@
+package htsjdk.variant.vcf;
+
+import htsjdk.HtsjdkTest;
+import org.testng.Assert;
+import org.testng.annotations.DataProvider;
+import org.testng.annotations.Test;
+
+import java.io.IOException;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.Locale;
+import java.util.Random;
+
+public class VCFNumberFormatterTest extends HtsjdkTest {
+
+    @DataProvider(name = "doubles")
+    public Object[][] makeDoubles() {
+        final List<Object[]> tests = new ArrayList<>();
+        final double[] special = {
+                0.0, -0.0, 1.0, -1.0, 0.5, 0.125, 0.375, 2.5, 10.015, 10.005, 1.005, 0.0005, 0.9995, 0.99995,
+                9.9995, 99.995, 999.5, 1e-20, 1.5e-20, 9.9995e-5, 123456789.125, 1e9, 1e15, 1.7976931348623157e308,
+                Double.MIN_VALUE, Double.MIN_NORMAL, 4.35, 1.45, 2.675, 0.045, 5e-5,
+                Double.NaN, Double.POSITIVE_INFINITY, Double.NEGATIVE_INFINITY};
+        for (final double d : special) {
+            tests.add(new Object[]{d});
+        }
+
+        final Random random = new Random(42);
+        for (int i = 0; i < 2000; i++) {
+            // spread the values over many orders of magnitude
+            final double d = random.nextDouble() * Math.pow(10, random.nextInt(30) - 15);
+            tests.add(new Object[]{random.nextBoolean() ? d : -d});
+        }
+        // values with few significant digits, many of which are exact ties
+        for (int i = 0; i < 2000; i++) {
+            final double d = random.nextInt(100000) / Math.pow(10, random.nextInt(8));
+            tests.add(new Object[]{d});
+        }
+        return tests.toArray(new Object[0][]);
+    }
+
+    @Test(dataProvider = "doubles")
+    public void testFixedMatchesFormatter(final double d) throws IOException {
+        for (int decimals = 0; decimals <= 4; decimals++) {
+            final StringBuilder sb = new StringBuilder();
+            VCFNumberFormatter.appendFixed(sb, d, decimals);
+            Assert.assertEquals(sb.toString(), String.format(Locale.US, "%." + decimals + "f", d), "decimals=" + decimals);
+        }
+    }
+
+    @Test(dataProvider = "doubles")
+    public void testScientificMatchesFormatter(final double d) throws IOException {
+        for (int decimals = 0; decimals <= 4; decimals++) {
+            final StringBuilder sb = new StringBuilder();
+            VCFNumberFormatter.appendScientific(sb, d, decimals);
+            Assert.assertEquals(sb.toString(), String.format(Locale.US, "%." + decimals + "e", d), "decimals=" + decimals);
+        }
+    }
+
+    @Test
+    public void testAppendInt() throws IOException {
+        for (final int i : new int[]{0, 1, -1, 9, 10, 99, 100, -100, 123456789, Integer.MAX_VALUE, Integer.MIN_VALUE}) {
+            final StringBuilder sb = new StringBuilder();
+            VCFNumberFormatter.appendInt(sb, i);
+            Assert.assertEquals(sb.toString(), Integer.toString(i));
+        }
+    }
+}